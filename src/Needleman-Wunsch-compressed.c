@@ -0,0 +1,264 @@
+/**
+ * \file Needleman-Wunsch-compressed.c
+ * \brief Needleman-Wunsch over block compressed sequences: tiles memoized by blocks and input boundaries
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see Needleman-Wunsch-recmemo.h and block_container.h
+ *
+ * Notations: as in Needleman-Wunsch-tiled.c, D[i][j] is the distance between the prefixes A[0..i-1] and
+ * B[0..j-1]; row[1..N] is the bottom boundary of the last tiles computed and col[1..h] the right boundary
+ * of the last tile of the current band of rows.
+ * A tile is stored as 2 (h + w) differences between consecutive values (int8_t, in [-INSERTION_COST, INSERTION_COST]):
+ *    top[k]    = D[i0][j0+k+1] - D[i0][j0+k]     left[r]  = D[i0+r+1][j0] - D[i0+r][j0]      (inputs, the key)
+ *    bottom[k] = D[i0+h][j0+k+1] - D[i0+h][j0+k]  right[r] = D[i0+r+1][j0+w] - D[i0+r][j0+w] (outputs)
+ */
+
+#include "Needleman-Wunsch-recmemo.h"
+#include "Needleman-Wunsch-kernel.h" /* tile kernels */
+#include "block_container.h"		 /* compressed sequences */
+#include "metrics.h"				 /* for NW_MetricsCache */
+#include "probes.h"				 /* USDT probes */
+#include "arena.h"				 /* row, col and the tile keys */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h> /* for int8_t */
+#include <string.h> /* for memcmp and memcpy */
+
+#include "characters_to_base.h" /* mapping from char to base */
+
+/** \struct _memo_entry
+ * \brief header of a tile in the arena, followed by its 2 (h + w) differences top, left, bottom, right
+ */
+struct _memo_entry
+{
+	uint64_t hash;	   /*!< hash of the key */
+	uint32_t ida, idb; /*!< the blocks of the tile */
+	uint32_t h, w;	   /*!< the lengths of the blocks */
+};
+
+/* NW_BlockMemo : see .h file for documentation */
+struct NW_BlockMemo
+{
+	char *arena;		/*!< the tiles, one after the other */
+	size_t used;		/*!< number of bytes used in arena */
+	size_t capacity;	/*!< size of arena */
+	size_t *table;		/*!< hash table: offset in arena + 1 of a tile, 0 if empty */
+	size_t table_size;	/*!< size of table, a power of 2 */
+	size_t count;		/*!< number of tiles in table */
+	size_t tiles, hits; /*!< statistics */
+	size_t cells;		/*!< number of cells computed by the kernel */
+};
+
+/* NW_BlockMemoCreate : see .h file for documentation
+ */
+struct NW_BlockMemo *NW_BlockMemoCreate(size_t bytes)
+{
+	struct NW_BlockMemo *memo = (struct NW_BlockMemo *)calloc(1, sizeof(struct NW_BlockMemo));
+	if (memo == NULL)
+	{
+		perror("NW_BlockMemoCreate: calloc of memo");
+		exit(EXIT_FAILURE);
+	}
+	// about 1/8 of the memory for the table, with one entry for 64 bytes of tiles at most
+	memo->table_size = 1024;
+	while (memo->table_size * sizeof(size_t) * 8 < bytes)
+		memo->table_size *= 2;
+	memo->capacity = bytes - bytes / 8;
+	memo->arena = (char *)malloc(memo->capacity);
+	memo->table = (size_t *)calloc(memo->table_size, sizeof(size_t));
+	if (memo->arena == NULL || memo->table == NULL)
+	{
+		perror("NW_BlockMemoCreate: malloc of arena and table");
+		exit(EXIT_FAILURE);
+	}
+	return memo;
+}
+
+/* NW_BlockMemoFree : see .h file for documentation
+ */
+void NW_BlockMemoFree(struct NW_BlockMemo *memo)
+{
+	free(memo->arena);
+	free(memo->table);
+	free(memo);
+}
+
+/* NW_BlockMemoStats : see .h file for documentation
+ */
+void NW_BlockMemoStats(const struct NW_BlockMemo *memo, size_t *tiles, size_t *hits, size_t *cells)
+{
+	*tiles = memo->tiles;
+	*hits = memo->hits;
+	*cells = memo->cells;
+}
+
+/*
+ * static uint64_t _hash_key(uint32_t ida, uint32_t idb, const int8_t *diff, size_t n)
+ * \brief hash of the key of a tile: its blocks and its n = h + w input differences
+ */
+static uint64_t _hash_key(uint32_t ida, uint32_t idb, const int8_t *diff, size_t n)
+{
+	uint64_t h = ((uint64_t)ida << 32 | idb) * 0x9e3779b97f4a7c15ull;
+	size_t k = 0;
+	for (; k + 8 <= n; k += 8)
+	{
+		uint64_t v;
+		memcpy(&v, diff + k, 8);
+		h = (h ^ v) * 0x100000001b3ull;
+		h ^= h >> 29;
+	}
+	for (; k < n; ++k)
+		h = (h ^ (uint8_t)diff[k]) * 0x100000001b3ull;
+	return h ^ (h >> 32);
+}
+
+/*
+ * static const int8_t *_lookup(const struct NW_BlockMemo *memo, uint64_t hash, uint32_t ida, uint32_t idb, const int8_t *key, size_t h, size_t w, size_t *slot)
+ * \brief returns the outputs bottom, right of the tile with this key, or NULL and the slot where to insert it
+ */
+static const int8_t *_lookup(const struct NW_BlockMemo *memo, uint64_t hash, uint32_t ida, uint32_t idb,
+							 const int8_t *key, size_t h, size_t w, size_t *slot)
+{
+	size_t mask = memo->table_size - 1;
+	size_t k;
+	for (k = hash & mask; memo->table[k] != 0; k = (k + 1) & mask)
+	{
+		const struct _memo_entry *e = (const struct _memo_entry *)(memo->arena + memo->table[k] - 1);
+		const int8_t *diff = (const int8_t *)(e + 1);
+		if (e->hash == hash && e->ida == ida && e->idb == idb && e->h == h && e->w == w &&
+			memcmp(diff, key, h + w) == 0)
+			return diff + h + w;
+	}
+	*slot = k;
+	return NULL;
+}
+
+/*
+ * static void _insert(struct NW_BlockMemo *memo, size_t slot, uint64_t hash, uint32_t ida, uint32_t idb, const int8_t *diff, size_t h, size_t w)
+ * \brief adds the tile diff (inputs then outputs) in memo; the memo is emptied first when it is full
+ */
+static void _insert(struct NW_BlockMemo *memo, size_t slot, uint64_t hash, uint32_t ida, uint32_t idb,
+					const int8_t *diff, size_t h, size_t w)
+{
+	size_t size = (sizeof(struct _memo_entry) + 2 * (h + w) + 7) & ~(size_t)7;
+	if (size > memo->capacity)
+		return;
+	if (memo->used + size > memo->capacity || 2 * (memo->count + 1) > memo->table_size)
+	{
+		memset(memo->table, 0, memo->table_size * sizeof(size_t));
+		memo->used = 0;
+		memo->count = 0;
+		slot = hash & (memo->table_size - 1);
+	}
+	struct _memo_entry *e = (struct _memo_entry *)(memo->arena + memo->used);
+	e->hash = hash;
+	e->ida = ida;
+	e->idb = idb;
+	e->h = (uint32_t)h;
+	e->w = (uint32_t)w;
+	memcpy(e + 1, diff, 2 * (h + w));
+	memo->table[slot] = memo->used + 1;
+	memo->used += size;
+	memo->count++;
+}
+
+/* EditDistance_NW_compressed : tiles of the block pairs, memoized.
+ * See .h file for documentation
+ */
+long EditDistance_NW_compressed(const struct NWZ_Container *c, const struct NWZ_Seq *A, const struct NWZ_Seq *B,
+								struct NW_BlockMemo *memo)
+{
+	const struct NW_Kernel *kernel = NW_DefaultKernel();
+	size_t N = B->length;
+	size_t hmax = 0;
+	for (size_t a = 0; a < A->nb; ++a)
+		if (c->blocks[A->ids[a]].length > hmax)
+			hmax = c->blocks[A->ids[a]].length;
+	for (size_t b = 0; b < B->nb; ++b)
+		if (c->blocks[B->ids[b]].length > hmax)
+			hmax = c->blocks[B->ids[b]].length;
+
+	struct NW_ArenaMark mark = NW_ArenaGet();
+	long *row = (long *)NW_ArenaAlloc((N + 1) * sizeof(long));
+	long *col = (long *)NW_ArenaAlloc((hmax + 1) * sizeof(long));
+	int8_t *diff = (int8_t *)NW_ArenaAlloc(4 * hmax + 8);
+	// bordure : première ligne
+	row[0] = 0;
+	{
+		size_t j = 0;
+		for (size_t b = 0; b < B->nb; ++b)
+		{
+			size_t w;
+			const char *y = NWZ_BlockText(c, B->ids[b], &w);
+			for (size_t k = 0; k < w; ++k, ++j)
+				row[j + 1] = row[j] + (isBase(y[k]) ? INSERTION_COST : 0);
+		}
+	}
+
+	size_t tiles = memo->tiles, hits = memo->hits;
+	long first = 0; // D[i0][0]
+	for (size_t a = 0; a < A->nb; ++a)
+	{
+		size_t h;
+		const char *x = NWZ_BlockText(c, A->ids[a], &h);
+		col[0] = first; // première colonne de la bande
+		for (size_t r = 0; r < h; ++r)
+			col[r + 1] = col[r] + (isBase(x[r]) ? INSERTION_COST : 0);
+		first = col[h];
+
+		long corner = row[0];
+		size_t j0 = 0;
+		for (size_t b = 0; b < B->nb; ++b)
+		{
+			size_t w;
+			const char *y = NWZ_BlockText(c, B->ids[b], &w);
+			long *top = row + j0 + 1, *left = col + 1;
+			long next_corner = top[w - 1]; // D[i0][j0+w], overwritten by the tile
+			long top_last = top[w - 1], left_last = left[h - 1];
+			int8_t *key = diff, *out = diff + h + w;
+			key[0] = (int8_t)(top[0] - corner);
+			for (size_t k = 1; k < w; ++k)
+				key[k] = (int8_t)(top[k] - top[k - 1]);
+			key[w] = (int8_t)(left[0] - corner);
+			for (size_t r = 1; r < h; ++r)
+				key[w + r] = (int8_t)(left[r] - left[r - 1]);
+
+			uint64_t hash = _hash_key(A->ids[a], B->ids[b], key, h + w);
+			size_t slot = 0; // set by _lookup when the tile is not found
+			const int8_t *found = _lookup(memo, hash, A->ids[a], B->ids[b], key, h, w, &slot);
+			memo->tiles++;
+			NW_PROBE4(cache_lookup, A->ids[a], B->ids[b], h * w, found != NULL);
+			if (found != NULL)
+			{
+				memo->hits++;
+				long v = left_last; // D[i0+h][j0]
+				for (size_t k = 0; k < w; ++k)
+					top[k] = v += found[k];
+				v = top_last; // D[i0][j0+w]
+				for (size_t r = 0; r < h; ++r)
+					left[r] = v += found[w + r];
+			}
+			else
+			{
+				kernel->tile(x, h, y, w, corner, top, left);
+				memo->cells += h * w;
+				out[0] = (int8_t)(top[0] - left_last);
+				for (size_t k = 1; k < w; ++k)
+					out[k] = (int8_t)(top[k] - top[k - 1]);
+				out[w] = (int8_t)(left[0] - top_last);
+				for (size_t r = 1; r < h; ++r)
+					out[w + r] = (int8_t)(left[r] - left[r - 1]);
+				_insert(memo, slot, hash, A->ids[a], B->ids[b], diff, h, w);
+			}
+			corner = next_corner;
+			j0 += w;
+		}
+		row[0] = first;
+	}
+
+	NW_MetricsCache(memo->hits - hits, (memo->tiles - tiles) - (memo->hits - hits));
+	long res = (N == 0) ? first : row[N];
+	NW_ArenaRelease(mark);
+	return res;
+}
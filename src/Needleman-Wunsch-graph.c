@@ -0,0 +1,594 @@
+/**
+ * \file Needleman-Wunsch-graph.c
+ * \brief alignment of a sequence to a directed acyclic graph of sequences (a reference and its variants)
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see Needleman-Wunsch-graph.h
+ * Costs are the ones of the tile kernels: INSERTION_COST for an insertion, SUBSTITUTION_COST between two
+ * different bases (the unknown base N matches N); a char that is not a base is skipped.
+ */
+
+#include "Needleman-Wunsch-graph.h"
+#include "Needleman-Wunsch-recmemo.h"	 /* for the costs */
+#include "Needleman-Wunsch-kernel.h"	 /* for NW_DefaultKernel */
+#include "Needleman-Wunsch-traceback.h" /* for enum NW_Move */
+#include "arena.h"						 /* left column of the tiles */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h> /* for uint32_t */
+#include <string.h> /* for strtok_r, strcmp */
+#include <errno.h>
+#include <limits.h> /* for LONG_MAX */
+
+#include "characters_to_base.h" /* mapping from char to base */
+
+/** \struct _named
+ * \brief a segment of the file, sorted by name to resolve the links
+ */
+struct _named
+{
+	const char *name;
+	size_t index; /*!< rank of the segment in the file */
+};
+
+/*
+ * static int _compare_named(const void *x, const void *y)
+ * \brief order of the names, for qsort and bsearch
+ */
+static int _compare_named(const void *x, const void *y)
+{
+	return strcmp(((const struct _named *)x)->name, ((const struct _named *)y)->name);
+}
+
+/*
+ * static void *_grow(void *array, size_t *capacity, size_t needed, size_t element)
+ * \brief reallocates array so that it contains at least needed elements
+ */
+static void *_grow(void *array, size_t *capacity, size_t needed, size_t element)
+{
+	if (needed <= *capacity)
+		return array;
+	*capacity = (needed > 2 * *capacity) ? needed : 2 * *capacity;
+	array = realloc(array, *capacity * element);
+	if (array == NULL)
+	{
+		perror("NW_GraphLoad: realloc");
+		exit(EXIT_FAILURE);
+	}
+	return array;
+}
+
+/*
+ * static char *_strdup(const char *s)
+ * \brief copy of s
+ */
+static char *_strdup(const char *s)
+{
+	char *copy = strdup(s);
+	if (copy == NULL)
+	{
+		perror("NW_GraphLoad: strdup");
+		exit(EXIT_FAILURE);
+	}
+	return copy;
+}
+
+/*
+ * static int _sort(struct NW_Graph *g, struct NW_GraphNode *segments, size_t n, const size_t *links, size_t nlinks)
+ * \brief sets the nodes of g to the n segments in topological order (Kahn: the sources in the order of the
+ * file, then first in first out), the links being the pairs (links[2k], links[2k+1]) of ranks of segments
+ * \return : 0 on success, 1 if the graph has a cycle
+ */
+static int _sort(struct NW_Graph *g, struct NW_GraphNode *segments, size_t n, const size_t *links, size_t nlinks)
+{
+	size_t *first = (size_t *)calloc(n + 1, sizeof(size_t)); // successors of s: succ[first[s] .. first[s+1]-1]
+	size_t *succ = (size_t *)malloc((nlinks + 1) * sizeof(size_t));
+	size_t *indegree = (size_t *)calloc(n, sizeof(size_t)), *order = (size_t *)malloc(n * sizeof(size_t));
+	size_t *rank = (size_t *)malloc(n * sizeof(size_t));
+	if (first == NULL || succ == NULL || indegree == NULL || order == NULL || rank == NULL)
+	{
+		perror("NW_GraphLoad: malloc of the edges");
+		exit(EXIT_FAILURE);
+	}
+	for (size_t k = 0; k < nlinks; ++k)
+	{
+		++first[links[2 * k] + 1];
+		++indegree[links[2 * k + 1]];
+	}
+	for (size_t s = 0; s < n; ++s)
+		first[s + 1] += first[s];
+	for (size_t k = 0; k < nlinks; ++k)
+		succ[first[links[2 * k]]++] = links[2 * k + 1];
+	for (size_t s = n; s > 0; --s) // first[s] was moved to first[s+1]
+		first[s] = first[s - 1];
+	first[0] = 0;
+
+	size_t head = 0, tail = 0;
+	for (size_t s = 0; s < n; ++s)
+		if (indegree[s] == 0)
+			order[tail++] = s;
+	while (head < tail)
+	{
+		size_t s = order[head++];
+		rank[s] = head - 1;
+		for (size_t e = first[s]; e < first[s + 1]; ++e)
+			if (--indegree[succ[e]] == 0)
+				order[tail++] = succ[e];
+	}
+	int status = (tail < n);
+	if (!status)
+	{
+		g->nnodes = n;
+		g->nedges = nlinks;
+		g->nodes = (struct NW_GraphNode *)malloc(n * sizeof(struct NW_GraphNode));
+		g->edges = (size_t *)malloc((nlinks + 1) * sizeof(size_t));
+		if (g->nodes == NULL || g->edges == NULL)
+		{
+			perror("NW_GraphLoad: malloc of the nodes");
+			exit(EXIT_FAILURE);
+		}
+		g->length = 0;
+		for (size_t v = 0; v < n; ++v)
+		{
+			g->nodes[v] = segments[order[v]];
+			g->nodes[v].npred = 0;
+			g->nodes[v].nsucc = first[order[v] + 1] - first[order[v]];
+			g->length += g->nodes[v].length;
+		}
+		for (size_t k = 0; k < nlinks; ++k)
+			++g->nodes[rank[links[2 * k + 1]]].npred;
+		size_t position = 0;
+		for (size_t v = 0; v < n; ++v)
+		{
+			g->nodes[v].pred = g->edges + position;
+			position += g->nodes[v].npred;
+			g->nodes[v].npred = 0;
+		}
+		for (size_t k = 0; k < nlinks; ++k)
+		{
+			struct NW_GraphNode *node = &g->nodes[rank[links[2 * k + 1]]];
+			size_t p = rank[links[2 * k]], i = node->npred++;
+			for (; i > 0 && node->pred[i - 1] > p; --i) // predecessors in increasing order
+				node->pred[i] = node->pred[i - 1];
+			node->pred[i] = p;
+		}
+	}
+	free(first);
+	free(succ);
+	free(indegree);
+	free(order);
+	free(rank);
+	return status;
+}
+
+/* NW_GraphLoad : see .h file for documentation
+ */
+int NW_GraphLoad(struct NW_Graph *g, const char *path)
+{
+	memset(g, 0, sizeof(struct NW_Graph));
+	FILE *in = fopen(path, "r");
+	if (in == NULL)
+	{
+		fprintf(stderr, "Error: %s: %s.\n", path, strerror(errno));
+		return 1;
+	}
+	struct NW_GraphNode *segments = NULL;
+	char **ends = NULL; // names of the ends of the links
+	size_t n = 0, nlinks = 0, capacity = 0, link_capacity = 0, line_number = 0, line_size = 0;
+	char *line = NULL;
+	int status = 0;
+	while (status == 0 && getline(&line, &line_size, in) != -1)
+	{
+		++line_number;
+		char *field[6], *saveptr;
+		int nfields = 0;
+		for (char *tok = strtok_r(line, "\t\r\n", &saveptr); tok != NULL && nfields < 6;
+			 tok = strtok_r(NULL, "\t\r\n", &saveptr))
+			field[nfields++] = tok;
+		if (nfields == 0 || (strcmp(field[0], "S") != 0 && strcmp(field[0], "L") != 0))
+			continue;
+		if (field[0][0] == 'S' && (nfields < 3 || strcmp(field[2], "*") == 0))
+		{
+			fprintf(stderr, "Error: %s:%zu: a segment without sequence.\n", path, line_number);
+			status = 1;
+		}
+		else if (field[0][0] == 'S')
+		{
+			segments = (struct NW_GraphNode *)_grow(segments, &capacity, n + 1, sizeof(struct NW_GraphNode));
+			segments[n].name = _strdup(field[1]);
+			segments[n].seq = _strdup(field[2]);
+			segments[n].length = strlen(field[2]);
+			++n;
+		}
+		else if (nfields < 5 || strcmp(field[2], "+") != 0 || strcmp(field[4], "+") != 0 ||
+				 (nfields == 6 && strcmp(field[5], "0M") != 0 && strcmp(field[5], "*") != 0))
+		{
+			fprintf(stderr, "Error: %s:%zu: only the links + to + without overlap are supported.\n", path,
+					line_number);
+			status = 1;
+		}
+		else
+		{
+			ends = (char **)_grow(ends, &link_capacity, 2 * nlinks + 2, sizeof(char *));
+			ends[2 * nlinks] = _strdup(field[1]);
+			ends[2 * nlinks + 1] = _strdup(field[3]);
+			++nlinks;
+		}
+	}
+	free(line);
+	fclose(in);
+	if (status == 0 && n == 0)
+	{
+		fprintf(stderr, "Error: no segment in %s.\n", path);
+		status = 1;
+	}
+
+	struct _named *named = (struct _named *)malloc((n + 1) * sizeof(struct _named));
+	size_t *links = (size_t *)malloc((2 * nlinks + 1) * sizeof(size_t));
+	if (named == NULL || links == NULL)
+	{
+		perror("NW_GraphLoad: malloc of the names");
+		exit(EXIT_FAILURE);
+	}
+	for (size_t s = 0; s < n; ++s)
+		named[s] = (struct _named){segments[s].name, s};
+	qsort(named, n, sizeof(struct _named), _compare_named);
+	for (size_t s = 1; status == 0 && s < n; ++s)
+		if (strcmp(named[s - 1].name, named[s].name) == 0)
+		{
+			fprintf(stderr, "Error: %s: two segments named %s.\n", path, named[s].name);
+			status = 1;
+		}
+	for (size_t k = 0; status == 0 && k < 2 * nlinks; ++k)
+	{
+		struct _named key = {ends[k], 0};
+		const struct _named *found = (const struct _named *)bsearch(&key, named, n, sizeof(struct _named), _compare_named);
+		if (found == NULL)
+		{
+			fprintf(stderr, "Error: %s: a link to the unknown segment %s.\n", path, ends[k]);
+			status = 1;
+		}
+		else
+			links[k] = found->index;
+	}
+	if (status == 0 && _sort(g, segments, n, links, nlinks) != 0)
+	{
+		fprintf(stderr, "Error: the graph of %s has a cycle.\n", path);
+		status = 1;
+	}
+	if (status != 0)
+		for (size_t s = 0; s < n; ++s)
+		{
+			free(segments[s].name);
+			free(segments[s].seq);
+		}
+	for (size_t k = 0; k < 2 * nlinks; ++k)
+		free(ends[k]);
+	free(ends);
+	free(links);
+	free(named);
+	free(segments);
+	return status;
+}
+
+/* NW_GraphFree : see .h file for documentation
+ */
+void NW_GraphFree(struct NW_Graph *g)
+{
+	for (size_t v = 0; v < g->nnodes; ++v)
+	{
+		free(g->nodes[v].name);
+		free(g->nodes[v].seq);
+	}
+	free(g->nodes);
+	free(g->edges);
+	memset(g, 0, sizeof(struct NW_Graph));
+}
+
+/** \struct _rows
+ * \brief rows of lengthB + 1 longs: the last rows of the nodes waiting for a successor, reused
+ */
+struct _rows
+{
+	size_t width;
+	long **free;
+	size_t nfree, capacity;
+};
+
+/*
+ * static long *_row_get(struct _rows *rows)
+ * \brief returns a free row
+ */
+static long *_row_get(struct _rows *rows)
+{
+	if (rows->nfree > 0)
+		return rows->free[--rows->nfree];
+	long *row = (long *)malloc(rows->width * sizeof(long));
+	if (row == NULL)
+	{
+		perror("EditDistance_NW_graph: malloc of a row");
+		exit(EXIT_FAILURE);
+	}
+	return row;
+}
+
+/*
+ * static void _row_put(struct _rows *rows, long *row)
+ * \brief gives back row
+ */
+static void _row_put(struct _rows *rows, long *row)
+{
+	if (rows->nfree == rows->capacity)
+	{
+		rows->capacity = (rows->capacity == 0) ? 16 : 2 * rows->capacity;
+		rows->free = (long **)realloc(rows->free, rows->capacity * sizeof(long *));
+		if (rows->free == NULL)
+		{
+			perror("EditDistance_NW_graph: realloc of the rows");
+			exit(EXIT_FAILURE);
+		}
+	}
+	rows->free[rows->nfree++] = row;
+}
+
+/** \struct _trace
+ * \brief tables of NW_GraphAlign
+ */
+struct _trace
+{
+	unsigned char *moves;  /*!< moves of the cells, by node, row after row, 2 bits per cell */
+	size_t *move_offset;   /*!< position of the moves of each node */
+	uint32_t *choice;	   /*!< for the nodes of several predecessors: the one of the minimum of each column */
+	size_t *choice_offset; /*!< position of the choices of each node */
+};
+
+/*
+ * static void _node_tile(const struct NW_GraphNode *node, const char *B, size_t N, long *row, long *left)
+ * \brief computes the rows of node from the row before it (row, replaced by its last row) with the kernel
+ * \param left : a buffer of node->length longs
+ */
+static void _node_tile(const struct NW_GraphNode *node, const char *B, size_t N, long *row, long *left)
+{
+	size_t h = node->length;
+	if (h == 0)
+		return;
+	long corner = row[0], col = corner;
+	for (size_t r = 0; r < h; ++r)
+		left[r] = col += isBase(node->seq[r]) ? INSERTION_COST : 0;
+	row[0] = col;
+	if (N > 0)
+		NW_DefaultKernel()->tile(node->seq, h, B, N, corner, row + 1, left);
+}
+
+/*
+ * static void _node_traced(const struct NW_GraphNode *node, const char *B, size_t N, long *row, unsigned char *moves)
+ * \brief computes the rows of node from the row before it (row, replaced by its last row) and sets the moves
+ * of its cells (r, j), r = 1 .. length, at the position (r - 1) (N + 1) + j of moves (zeroed)
+ */
+static void _node_traced(const struct NW_GraphNode *node, const char *B, size_t N, long *row, unsigned char *moves)
+{
+	for (size_t r = 1, k = 0; r <= node->length; ++r)
+	{
+		char x = node->seq[r - 1];
+		long diag = row[0];
+		row[0] += isBase(x) ? INSERTION_COST : 0;
+		moves[k / 4] |= (unsigned char)(NW_MOVE_UP << (2 * (k % 4)));
+		++k;
+		for (size_t j = 1; j <= N; ++j, ++k)
+		{
+			long up = row[j], lf = row[j - 1], v;
+			unsigned m;
+			if (!isBase(x)) /* une ligne qui n'est pas une base recopie la ligne du dessus */
+			{
+				v = up;
+				m = NW_MOVE_UP;
+			}
+			else if (!isBase(B[j - 1])) /* une colonne qui n'est pas une base recopie son voisin gauche */
+			{
+				v = lf;
+				m = NW_MOVE_LEFT;
+			}
+			else
+			{
+				v = diag + (isSameBase(x, B[j - 1]) ? 0 : SUBSTITUTION_COST);
+				m = NW_MOVE_DIAGONAL;
+				if (up + INSERTION_COST < v)
+				{
+					v = up + INSERTION_COST;
+					m = NW_MOVE_UP;
+				}
+				if (lf + INSERTION_COST < v)
+				{
+					v = lf + INSERTION_COST;
+					m = NW_MOVE_LEFT;
+				}
+			}
+			diag = up;
+			row[j] = v;
+			moves[k / 4] |= (unsigned char)(m << (2 * (k % 4)));
+		}
+	}
+}
+
+/*
+ * static long _forward(const struct NW_Graph *g, const char *B, size_t N, struct _trace *trace, size_t *sink)
+ * \brief computes the nodes in topological order and returns the distance; if trace is not NULL, sets its
+ * tables and the best sink
+ */
+static long _forward(const struct NW_Graph *g, const char *B, size_t N, struct _trace *trace, size_t *sink)
+{
+	struct _rows rows = {N + 1, NULL, 0, 0};
+	long **last = (long **)calloc(g->nnodes, sizeof(long *)); // last rows of the nodes
+	size_t *pending = (size_t *)malloc(g->nnodes * sizeof(size_t)), longest = 1;
+	if (last == NULL || pending == NULL)
+	{
+		perror("EditDistance_NW_graph: malloc of the nodes");
+		exit(EXIT_FAILURE);
+	}
+	for (size_t v = 0; v < g->nnodes; ++v)
+	{
+		pending[v] = g->nodes[v].nsucc;
+		if (g->nodes[v].length > longest)
+			longest = g->nodes[v].length;
+	}
+	struct NW_ArenaMark mark = NW_ArenaGet();
+	long *left = (long *)NW_ArenaAlloc(longest * sizeof(long));
+	long *empty = _row_get(&rows); // row of the empty prefix
+	empty[0] = 0;
+	for (size_t j = 1; j <= N; ++j)
+		empty[j] = empty[j - 1] + (isBase(B[j - 1]) ? INSERTION_COST : 0);
+
+	long best = LONG_MAX;
+	for (size_t v = 0; v < g->nnodes; ++v)
+	{
+		const struct NW_GraphNode *node = &g->nodes[v];
+		long *row = _row_get(&rows);
+		memcpy(row, (node->npred == 0) ? empty : last[node->pred[0]], (N + 1) * sizeof(long));
+		uint32_t *choice = (trace != NULL && node->npred > 1) ? trace->choice + trace->choice_offset[v] : NULL;
+		for (size_t k = 1; k < node->npred; ++k)
+		{
+			const long *other = last[node->pred[k]];
+			if (choice == NULL)
+				for (size_t j = 0; j <= N; ++j)
+					row[j] = (other[j] < row[j]) ? other[j] : row[j];
+			else
+				for (size_t j = 0; j <= N; ++j)
+					if (other[j] < row[j])
+					{
+						row[j] = other[j];
+						choice[j] = (uint32_t)k;
+					}
+		}
+		for (size_t k = 0; k < node->npred; ++k)
+			if (--pending[node->pred[k]] == 0)
+			{
+				_row_put(&rows, last[node->pred[k]]);
+				last[node->pred[k]] = NULL;
+			}
+
+		if (trace == NULL)
+			_node_tile(node, B, N, row, left);
+		else
+			_node_traced(node, B, N, row, trace->moves + trace->move_offset[v]);
+
+		if (node->nsucc > 0)
+			last[v] = row;
+		else
+		{
+			if (row[N] < best)
+			{
+				best = row[N];
+				if (sink != NULL)
+					*sink = v;
+			}
+			_row_put(&rows, row);
+		}
+	}
+	_row_put(&rows, empty);
+	for (size_t k = 0; k < rows.nfree; ++k)
+		free(rows.free[k]);
+	free(rows.free);
+	free(last);
+	free(pending);
+	NW_ArenaRelease(mark);
+	return best;
+}
+
+/* EditDistance_NW_graph : see .h file for documentation
+ */
+long EditDistance_NW_graph(const struct NW_Graph *g, const char *B, size_t lengthB)
+{
+	return _forward(g, B, lengthB, NULL, NULL);
+}
+
+/* NW_GraphAlignBytes : see .h file for documentation
+ */
+size_t NW_GraphAlignBytes(const struct NW_Graph *g, size_t lengthB)
+{
+	size_t bytes = 2 * (g->nnodes + 1) * sizeof(size_t);
+	for (size_t v = 0; v < g->nnodes; ++v)
+	{
+		bytes += (g->nodes[v].length * (lengthB + 1) + 3) / 4;
+		if (g->nodes[v].npred > 1)
+			bytes += (lengthB + 1) * sizeof(uint32_t);
+	}
+	return bytes;
+}
+
+/* NW_GraphAlign : see .h file for documentation
+ */
+long NW_GraphAlign(const struct NW_Graph *g, const char *B, size_t lengthB, size_t *path, size_t *npath,
+				   unsigned char *moves, size_t *nmoves)
+{
+	size_t N = lengthB, n = g->nnodes;
+	struct _trace trace;
+	trace.move_offset = (size_t *)malloc((n + 1) * sizeof(size_t));
+	trace.choice_offset = (size_t *)malloc((n + 1) * sizeof(size_t));
+	if (trace.move_offset == NULL || trace.choice_offset == NULL)
+	{
+		perror("NW_GraphAlign: malloc of the offsets");
+		exit(EXIT_FAILURE);
+	}
+	trace.move_offset[0] = trace.choice_offset[0] = 0;
+	for (size_t v = 0; v < n; ++v)
+	{
+		trace.move_offset[v + 1] = trace.move_offset[v] + (g->nodes[v].length * (N + 1) + 3) / 4;
+		trace.choice_offset[v + 1] = trace.choice_offset[v] + ((g->nodes[v].npred > 1) ? N + 1 : 0);
+	}
+	trace.moves = (unsigned char *)calloc(trace.move_offset[n] + 1, 1);
+	trace.choice = (uint32_t *)calloc(trace.choice_offset[n] + 1, sizeof(uint32_t));
+	if (trace.moves == NULL || trace.choice == NULL)
+	{
+		perror("NW_GraphAlign: calloc of the moves");
+		exit(EXIT_FAILURE);
+	}
+	size_t v = 0;
+	long best = _forward(g, B, N, &trace, &v);
+
+	// from the end of the best sink back to a source: the cell (r, j) of the node v
+	size_t r = g->nodes[v].length, j = N, count = 0, nodes = 0;
+	for (;;)
+	{
+		const struct NW_GraphNode *node = &g->nodes[v];
+		if (r > 0)
+		{
+			size_t k = (r - 1) * (N + 1) + j;
+			unsigned char m = (trace.moves[trace.move_offset[v] + k / 4] >> (2 * (k % 4))) & 3;
+			moves[count++] = m;
+			if (m != NW_MOVE_LEFT)
+				--r;
+			if (m != NW_MOVE_UP)
+				--j;
+			continue;
+		}
+		path[nodes++] = v;
+		if (node->npred == 0) // the row of the empty prefix: B[0 .. j-1] inserted
+		{
+			for (; j > 0; --j)
+				moves[count++] = NW_MOVE_LEFT;
+			break;
+		}
+		v = node->pred[(node->npred > 1) ? trace.choice[trace.choice_offset[v] + j] : 0];
+		r = g->nodes[v].length;
+	}
+	for (size_t k = 0; k < count / 2; ++k) // from the first move
+	{
+		unsigned char t = moves[k];
+		moves[k] = moves[count - 1 - k];
+		moves[count - 1 - k] = t;
+	}
+	for (size_t k = 0; k < nodes / 2; ++k) // from the source
+	{
+		size_t t = path[k];
+		path[k] = path[nodes - 1 - k];
+		path[nodes - 1 - k] = t;
+	}
+	*nmoves = count;
+	*npath = nodes;
+	free(trace.moves);
+	free(trace.choice);
+	free(trace.move_offset);
+	free(trace.choice_offset);
+	return best;
+}
@@ -0,0 +1,97 @@
+/**
+ * \file Needleman-Wunsch-graph.h
+ * \brief alignment of a sequence to a directed acyclic graph of sequences (a reference and its variants)
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * A graph file is a GFA 1 subset, one record per line, the fields separated by tabs:
+ *    S  name  sequence             a node (segment) and its sequence
+ *    L  from  +  to  +  0M         an edge (link) from the end of from to the beginning of to
+ * The other records (H, P, W, comments) are ignored. The links are forward and without overlap (0M or *),
+ * and the graph is acyclic: typically a reference cut at the variants, each variant being a bubble of
+ * alternative nodes (a deletion is an edge skipping the node of the reference).
+ *
+ * The distance between the graph and a sequence B is the least edit distance between B and the sequence
+ * spelled by a path from a source (a node without predecessor) to a sink (a node without successor). The
+ * table of D is the one of the linear alignment, its rows being the characters of the nodes taken in
+ * topological order: the row before the first character of a node is the minimum of the last rows of its
+ * predecessors (the row of the empty prefix for a source). Each node is a tile of its length by the length
+ * of B, computed by the kernel of NW_DefaultKernel (cf Needleman-Wunsch-kernel.h), so that a graph of a few
+ * variants costs about one linear alignment with the reference. The last row of a node is kept until its
+ * last successor is computed.
+ *
+ * The alignment keeps the move of each cell on 2 bits (cf Needleman-Wunsch-traceback.h) and, for the nodes
+ * of several predecessors, the predecessor giving the minimum of each column: the traceback goes from the
+ * best sink back to a source through the predecessors, and returns the path and the moves of the
+ * alignment of B with the sequence spelled by the path.
+ */
+
+#ifndef __NEEDLEMAN_WUNSCH_GRAPH_H__
+#define __NEEDLEMAN_WUNSCH_GRAPH_H__
+
+#include <stdlib.h> /* for size_t */
+
+/** \struct NW_GraphNode
+ * \brief a node of the graph
+ */
+struct NW_GraphNode
+{
+	char *name;		/*!< name of the segment */
+	char *seq;		/*!< its sequence */
+	size_t length;	/*!< its length */
+	size_t npred;	/*!< number of predecessors */
+	size_t *pred;	/*!< their indexes (smaller than the index of the node) */
+	size_t nsucc;	/*!< number of successors */
+};
+
+/** \struct NW_Graph
+ * \brief a graph, its nodes in topological order
+ */
+struct NW_Graph
+{
+	size_t nnodes;
+	struct NW_GraphNode *nodes;
+	size_t nedges;
+	size_t *edges;	/*!< the predecessors of all the nodes */
+	size_t length;	/*!< sum of the lengths of the nodes */
+};
+
+/**
+ * \fn int NW_GraphLoad(struct NW_Graph *g, const char *path);
+ * \brief reads the graph file path (cf above) and sorts its nodes in topological order
+ * \return : 0 on success, >0 (with a message on stderr) if it cannot be read, is not supported or has a cycle
+ */
+int NW_GraphLoad(struct NW_Graph *g, const char *path);
+
+/**
+ * \fn void NW_GraphFree(struct NW_Graph *g);
+ * \brief frees the nodes and the edges of g
+ */
+void NW_GraphFree(struct NW_Graph *g);
+
+/**
+ * \fn long EditDistance_NW_graph(const struct NW_Graph *g, const char *B, size_t lengthB);
+ * \brief computes the distance between the graph g and B[0 .. lengthB-1] (cf above)
+ */
+long EditDistance_NW_graph(const struct NW_Graph *g, const char *B, size_t lengthB);
+
+/**
+ * \fn size_t NW_GraphAlignBytes(const struct NW_Graph *g, size_t lengthB);
+ * \brief returns the memory (in bytes) of the tables of NW_GraphAlign with these arguments
+ */
+size_t NW_GraphAlignBytes(const struct NW_Graph *g, size_t lengthB);
+
+/**
+ * \fn long NW_GraphAlign(const struct NW_Graph *g, const char *B, size_t lengthB, size_t *path, size_t *npath, unsigned char *moves, size_t *nmoves);
+ * \brief computes the distance between the graph g and B[0 .. lengthB-1] and an optimal alignment
+ * \param path : receives the indexes of the nodes of the best path, from its source; at most g->nnodes
+ * \param npath : receives the number of nodes of the path
+ * \param moves : receives the moves (enum NW_Move of Needleman-Wunsch-traceback.h) of the alignment of the
+ *        sequence spelled by the path (A) with B, from the first one; at most g->length + lengthB
+ * \param nmoves : receives the number of moves
+ * \return : the distance, as EditDistance_NW_graph
+ */
+long NW_GraphAlign(const struct NW_Graph *g, const char *B, size_t lengthB, size_t *path, size_t *npath,
+				   unsigned char *moves, size_t *nmoves);
+
+#endif /* __NEEDLEMAN_WUNSCH_GRAPH_H__ */
@@ -0,0 +1,184 @@
+/**
+ * \file Needleman-Wunsch-kernel.c
+ * \brief tile kernels shared by all the linear space drivers of Needleman-Wunsch
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see Needleman-Wunsch-kernel.h
+ * Costs are the ones of EditDistance_NW_iteratif: INSERTION_COST for an insertion, SUBSTITUTION_COST
+ * between two different bases (the unknown base N matches N); a char that is not a base is skipped.
+ */
+
+#include "Needleman-Wunsch-kernel.h"
+#include "Needleman-Wunsch-recmemo.h" /* for the costs */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>	 /* for strcmp */
+#include <pthread.h> /* for pthread_once */
+
+#include "characters_to_base.h" /* mapping from char to base */
+
+/*
+ * static void _nw_tile_scalar(const char *X, size_t h, const char *Y, size_t w, long corner, long *top, long *left)
+ * \brief scalar kernel: row by row, the left and diagonal values are kept in registers
+ */
+static void _nw_tile_scalar(const char *X, size_t h, const char *Y, size_t w, long corner, long *top, long *left)
+{
+	long diag = corner;
+	for (size_t r = 0; r < h; ++r)
+	{
+		char x = X[r];
+		long cur = left[r]; // D[i][j0]
+		long d = diag;		// D[i-1][j0]
+		diag = cur;
+		if (!isBase(x)) /* une ligne qui n'est pas une base recopie la ligne du dessus */
+		{
+			left[r] = top[w - 1];
+			continue;
+		}
+		for (size_t k = 0; k < w; ++k)
+		{
+			long up = top[k];
+			if (isBase(Y[k]))
+			{
+				long min = ((up < cur) ? up : cur) + INSERTION_COST;
+				long delta = d + (isSameBase(x, Y[k]) ? 0 : SUBSTITUTION_COST);
+				cur = (min < delta) ? min : delta;
+			} /* else : une colonne qui n'est pas une base recopie son voisin gauche */
+			d = up;
+			top[k] = cur;
+		}
+		left[r] = cur;
+	}
+}
+
+/** \def NW_ANTIDIAG_ROWS
+ * \brief maximal number of rows of a band computed by _nw_band_antidiag (bounds its arrays on the stack)
+ */
+#define NW_ANTIDIAG_ROWS 256
+
+/*
+ * static void _nw_band_antidiag(const char *X, size_t h, const char *Y, size_t w, long corner, long *top, long *left)
+ * \brief anti-diagonal kernel for h <= NW_ANTIDIAG_ROWS: the cells (r, k) with r + k = d only depend on the anti-diagonals d-1 and d-2,
+ * so that the loop on an anti-diagonal has no dependency and no branch, and is vectorized.
+ *
+ * The anti-diagonals are stored indexed by row: diag[r + 1] = D(r, d - r) for -1 <= r <= h, the entries
+ * r = -1 and r = d being the top and left boundaries. The characters of Y are reversed so that the
+ * characters Y[d - r] of an anti-diagonal are contiguous.
+ */
+static void _nw_band_antidiag(const char *X, size_t h, const char *Y, size_t w, long corner, long *top, long *left)
+{
+	unsigned char xb[h], yr[w]; // bases (SKIP_BASE = 0 if not a base)
+	long buf[3][h + 2];
+	long *pp = buf[0], *p = buf[1], *c = buf[2];
+	for (size_t r = 0; r < h; ++r)
+		xb[r] = (unsigned char)CharToBase((unsigned char)X[r]);
+	for (size_t k = 0; k < w; ++k)
+		yr[w - 1 - k] = (unsigned char)CharToBase((unsigned char)Y[k]);
+
+	long top_prev = corner, left_prev = corner; // D(-1, d-1) and D(d-1, -1), saved before being overwritten
+	for (size_t d = 0; d < h + w - 1; ++d)
+	{
+		long top_cur = (d < w) ? top[d] : 0;
+		long left_cur = (d < h) ? left[d] : 0;
+		p[0] = top_cur; // D(-1, d)
+		pp[0] = top_prev;
+		if (d < h)
+		{
+			p[d + 1] = left_cur; // D(d, -1)
+			pp[d] = left_prev;
+		}
+		top_prev = top_cur;
+		left_prev = left_cur;
+
+		size_t rlo = (d < w) ? 0 : d - w + 1;
+		size_t rhi = (d < h) ? d : h - 1;
+		for (size_t r = rlo; r <= rhi; ++r)
+		{
+			long up = p[r], lf = p[r + 1], dg = pp[r];
+			unsigned char x = xb[r], b = yr[r + w - 1 - d]; // base of Y[d - r]
+			long min = ((up < lf) ? up : lf) + INSERTION_COST;
+			long delta = dg + ((x == b) ? 0 : SUBSTITUTION_COST);
+			long v = (min < delta) ? min : delta;
+			v = (x == SKIP_BASE) ? up : v;
+			c[r + 1] = (b == SKIP_BASE) ? lf : v;
+		}
+		if (d >= h - 1) // bottom boundary: cell (h - 1, d - h + 1)
+			top[d - (h - 1)] = c[h];
+		if (d >= w - 1) // right boundary: cell (d - w + 1, w - 1)
+			left[d - (w - 1)] = c[d - (w - 1) + 1];
+
+		long *t = pp;
+		pp = p;
+		p = c;
+		c = t;
+	}
+}
+
+/*
+ * static void _nw_tile_antidiag(const char *X, size_t h, const char *Y, size_t w, long corner, long *top, long *left)
+ * \brief anti-diagonal kernel: the tile is computed by bands of at most NW_ANTIDIAG_ROWS rows
+ */
+static void _nw_tile_antidiag(const char *X, size_t h, const char *Y, size_t w, long corner, long *top, long *left)
+{
+	for (size_t r0 = 0; r0 < h; r0 += NW_ANTIDIAG_ROWS)
+	{
+		size_t hb = (h - r0 < NW_ANTIDIAG_ROWS) ? h - r0 : NW_ANTIDIAG_ROWS;
+		long next_corner = left[r0 + hb - 1]; // D[i0+r0+hb][j0], overwritten by the band
+		_nw_band_antidiag(X + r0, hb, Y, w, corner, top, left + r0);
+		corner = next_corner;
+	}
+}
+
+/* the available kernels, indexed by enum NW_KernelId */
+static const struct NW_Kernel _nw_kernels[NW_KERNEL_COUNT] = {
+	{"scalar", _nw_tile_scalar, 1},
+	{"antidiag", _nw_tile_antidiag, NW_ANTIDIAG_ROWS},
+};
+
+/* NW_KernelGet : see .h file for documentation
+ */
+const struct NW_Kernel *NW_KernelGet(enum NW_KernelId id)
+{
+	return ((size_t)id < NW_KERNEL_COUNT) ? &_nw_kernels[id] : NULL;
+}
+
+/* NW_KernelFromName : see .h file for documentation
+ */
+const struct NW_Kernel *NW_KernelFromName(const char *name)
+{
+	for (int k = 0; k < NW_KERNEL_COUNT; ++k)
+		if (strcmp(name, _nw_kernels[k].name) == 0)
+			return &_nw_kernels[k];
+	return NULL;
+}
+
+/* kernel used by the drivers, set once from NW_KERNEL or by NW_SetDefaultKernel */
+static const struct NW_Kernel *_nw_default_kernel = NULL;
+static pthread_once_t _nw_default_once = PTHREAD_ONCE_INIT;
+
+static void _nw_default_from_env(void)
+{
+	const char *name = getenv(NW_KERNEL_ENV);
+	const struct NW_Kernel *k = (name == NULL) ? NULL : NW_KernelFromName(name);
+	if (name != NULL && k == NULL)
+		fprintf(stderr, "Warning: unknown kernel %s=%s; the scalar kernel is used.\n", NW_KERNEL_ENV, name);
+	if (_nw_default_kernel == NULL)
+		_nw_default_kernel = (k == NULL) ? &_nw_kernels[NW_KERNEL_SCALAR] : k;
+}
+
+/* NW_DefaultKernel : see .h file for documentation
+ */
+const struct NW_Kernel *NW_DefaultKernel(void)
+{
+	pthread_once(&_nw_default_once, _nw_default_from_env);
+	return _nw_default_kernel;
+}
+
+/* NW_SetDefaultKernel : see .h file for documentation
+ */
+void NW_SetDefaultKernel(const struct NW_Kernel *kernel)
+{
+	pthread_once(&_nw_default_once, _nw_default_from_env);
+	_nw_default_kernel = kernel;
+}
@@ -0,0 +1,78 @@
+/**
+ * \file Needleman-Wunsch-kernel.h
+ * \brief tile kernels: the leaf computation shared by the iterative, cache aware, cache oblivious and multilevel drivers
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Notations: D[i][j] is the distance between the prefixes X[0..i-1] and Y[0..j-1].
+ * A tile kernel computes the block of rows i0+1..i0+h and columns j0+1..j0+w of D from its top and left
+ * boundaries and returns its bottom and right boundaries in place:
+ *    corner            : D[i0][j0]
+ *    top[0..w-1]       : on entry D[i0][j0+1..j0+w],   on return D[i0+h][j0+1..j0+w]
+ *    left[0..h-1]      : on entry D[i0+1..i0+h][j0],   on return D[i0+1..i0+h][j0+w]
+ * with X = first row character X[i0] and Y = first column character Y[j0].
+ * The drivers only deal with the order of the tiles and the storage of the boundaries, so that any kernel
+ * (chosen at run time) speeds up every driver.
+ */
+
+#ifndef __NEEDLEMAN_WUNSCH_KERNEL_H__
+#define __NEEDLEMAN_WUNSCH_KERNEL_H__
+
+#include <stdlib.h> /* for size_t */
+
+/** \typedef NW_TileKernel
+ * \brief computes a tile of h rows and w columns (h, w >= 1), cf the notations above
+ */
+typedef void (*NW_TileKernel)(const char *X, size_t h, const char *Y, size_t w, long corner, long *top, long *left);
+
+/** \struct NW_Kernel
+ * \brief a tile kernel and its preferred shape
+ */
+struct NW_Kernel
+{
+	const char *name;  /*!< name of the kernel, as accepted by NW_KernelFromName */
+	NW_TileKernel tile; /*!< the function computing a tile */
+	size_t rows;	   /*!< preferred number of rows of a tile, used by the iterative driver to group rows */
+};
+
+/** \enum NW_KernelId
+ * \brief the available kernels
+ */
+enum NW_KernelId
+{
+	NW_KERNEL_SCALAR = 0, /*!< row by row, the left and diagonal neighbours kept in registers */
+	NW_KERNEL_ANTIDIAG,	  /*!< anti-diagonal by anti-diagonal, branch-free: the cells of an anti-diagonal are independent and vectorized */
+	NW_KERNEL_COUNT		  /*!< number of kernels */
+};
+
+/** \def NW_KERNEL_ENV
+ *  \brief name of the environment variable that selects the default kernel ("scalar" or "antidiag")
+ */
+#define NW_KERNEL_ENV "NW_KERNEL"
+
+/**
+ * \fn const struct NW_Kernel *NW_KernelGet(enum NW_KernelId id);
+ * \brief returns the kernel id
+ */
+const struct NW_Kernel *NW_KernelGet(enum NW_KernelId id);
+
+/**
+ * \fn const struct NW_Kernel *NW_KernelFromName(const char *name);
+ * \brief returns the kernel named name, or NULL if there is none
+ */
+const struct NW_Kernel *NW_KernelFromName(const char *name);
+
+/**
+ * \fn const struct NW_Kernel *NW_DefaultKernel(void);
+ * \brief returns the kernel used by the drivers: the one set by NW_SetDefaultKernel, else the one named
+ * by the environment variable NW_KERNEL, else the scalar kernel
+ */
+const struct NW_Kernel *NW_DefaultKernel(void);
+
+/**
+ * \fn void NW_SetDefaultKernel(const struct NW_Kernel *kernel);
+ * \brief sets the kernel used by the drivers; has to be called before the computations start
+ */
+void NW_SetDefaultKernel(const struct NW_Kernel *kernel);
+
+#endif /* __NEEDLEMAN_WUNSCH_KERNEL_H__ */
@@ -0,0 +1,245 @@
+/**
+ * \file Needleman-Wunsch-masked.c
+ * \brief policy of alignment of the soft-masked (lowercase) intervals of the sequences
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see Needleman-Wunsch-masked.h
+ */
+
+#include "Needleman-Wunsch-masked.h"
+#include "sequence_map.h" /* for SeqMaskIntervals */
+#include "arena.h"		  /* work buffers of the threads */
+#include <stdio.h>
+#include <string.h>	 /* for strncmp */
+#include <math.h>	 /* for llround */
+#include <limits.h>	 /* for LONG_MAX */
+#include <assert.h>	 /* for the check of the full band */
+#include <pthread.h> /* for pthread_once */
+
+#include "characters_to_base.h" /* mapping from char to base */
+
+/** \def _INFINITE
+ *  \brief distance of the cells out of the band (the sums of a few costs do not overflow)
+ */
+#define _INFINITE (LONG_MAX / 4)
+
+/* policy of EditDistance_NW, set once from NW_MASK or by NW_SetDefaultMask */
+static struct NW_Mask _nw_default_mask = {NW_MASK_ALIGN, NW_MASK_WIDTH, NW_MASK_COST};
+static int _nw_default_set = 0;
+static pthread_once_t _nw_default_once = PTHREAD_ONCE_INIT;
+
+static void _nw_default_from_env(void)
+{
+	const char *name = getenv(NW_MASK_ENV);
+	struct NW_Mask mask;
+	if (name != NULL && NW_MaskFromName(name, &mask) != 0)
+		fprintf(stderr, "Warning: unknown mask policy %s=%s; the masked bases are aligned.\n", NW_MASK_ENV, name);
+	else if (name != NULL && !_nw_default_set)
+		_nw_default_mask = mask;
+}
+
+/* NW_MaskFromName : see .h file for documentation
+ */
+int NW_MaskFromName(const char *name, struct NW_Mask *mask)
+{
+	mask->policy = NW_MASK_ALIGN;
+	mask->width = NW_MASK_WIDTH;
+	mask->cost = NW_MASK_COST;
+	const char *parameter = strchr(name, ':');
+	size_t length = (parameter == NULL) ? strlen(name) : (size_t)(parameter - name);
+	char *end = NULL;
+	if (length == 5 && strncmp(name, "align", 5) == 0 && parameter == NULL)
+		return 0;
+	if (length == 4 && strncmp(name, "band", 4) == 0)
+	{
+		mask->policy = NW_MASK_BAND;
+		if (parameter != NULL)
+		{
+			long width = strtol(parameter + 1, &end, 10);
+			if (*end != '\0' || end == parameter + 1 || width < 1)
+				return -1;
+			mask->width = (size_t)width;
+		}
+		return 0;
+	}
+	if (length == 4 && strncmp(name, "skip", 4) == 0)
+	{
+		mask->policy = NW_MASK_SKIP;
+		if (parameter != NULL)
+		{
+			mask->cost = strtod(parameter + 1, &end);
+			if (*end != '\0' || end == parameter + 1 || mask->cost < 0)
+				return -1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+/* NW_DefaultMask : see .h file for documentation
+ */
+const struct NW_Mask *NW_DefaultMask(void)
+{
+	pthread_once(&_nw_default_once, _nw_default_from_env);
+	return &_nw_default_mask;
+}
+
+/* NW_SetDefaultMask : see .h file for documentation
+ */
+void NW_SetDefaultMask(const struct NW_Mask *mask)
+{
+	pthread_once(&_nw_default_once, _nw_default_from_env);
+	_nw_default_mask = *mask;
+	if (_nw_default_mask.width == 0)
+		_nw_default_mask.width = NW_MASK_WIDTH;
+	_nw_default_set = 1;
+}
+
+/*
+ * static size_t _masked_bases(const char *S, const struct SeqInterval *mask, size_t n)
+ * \brief number of bases of S in the n intervals mask
+ */
+static size_t _masked_bases(const char *S, const struct SeqInterval *mask, size_t n)
+{
+	size_t bases = 0;
+	for (size_t k = 0; k < n; ++k)
+		for (size_t p = mask[k].begin; p < mask[k].end; ++p)
+			bases += isBase(S[p]);
+	return bases;
+}
+
+/*
+ * static size_t _unmasked(const char *S, size_t length, const struct SeqInterval *mask, size_t n, char *out)
+ * \brief copies in out the characters of S out of the n intervals mask, returns their number
+ */
+static size_t _unmasked(const char *S, size_t length, const struct SeqInterval *mask, size_t n, char *out)
+{
+	size_t copied = 0, p = 0;
+	for (size_t k = 0; k <= n; ++k)
+	{
+		size_t end = (k < n) ? mask[k].begin : length;
+		memcpy(out + copied, S + p, end - p);
+		copied += end - p;
+		if (k < n)
+			p = mask[k].end;
+	}
+	return copied;
+}
+
+/*
+ * static long _banded(const char *X, size_t M, const struct SeqInterval *mask, size_t n, const char *Y, size_t N, size_t width)
+ * \brief distance between X and Y, the rows of X in the n intervals mask being computed within the band
+ * of half width width around the column following the best cell of the previous row
+ *
+ * One row of D is kept: tab[j] = D[i][j], the cells out of the window [lo, hi] of the last row computed
+ * being _INFINITE. A row of bases of X out of the masks is computed entirely.
+ */
+static long _banded(const char *X, size_t M, const struct SeqInterval *mask, size_t n, const char *Y, size_t N,
+					size_t width)
+{
+	struct NW_ArenaMark mark = NW_ArenaGet();
+	long *tab = (long *)NW_ArenaAlloc((N + 1) * sizeof(long));
+	tab[0] = 0;
+	for (size_t j = 1; j <= N; ++j)
+		tab[j] = tab[j - 1] + INSERTION_COST * isBase(Y[j - 1]);
+	size_t lo = 0, hi = N, best = 0, m = 0;
+	for (size_t i = 1; i <= M; ++i)
+	{
+		char x = X[i - 1];
+		if (!isBase(x)) // D[i] = D[i-1]
+			continue;
+		while (m < n && mask[m].end <= i - 1)
+			++m;
+		size_t nlo = 0, nhi = N;
+		if (m < n && mask[m].begin <= i - 1) // masked row
+		{
+			size_t center = (best < N) ? best + 1 : N;
+			nlo = (center > width) ? center - width : 0;
+			nhi = (center + width < N) ? center + width : N;
+		}
+		long diag = (nlo > 0) ? tab[nlo - 1] : 0, left = _INFINITE, best_value = _INFINITE;
+		for (size_t j = nlo; j <= nhi; ++j)
+		{
+			long up = tab[j], v;
+			if (j == 0)
+				v = up + INSERTION_COST;
+			else if (!isBase(Y[j - 1])) // D[i][j] = D[i][j-1]
+				v = left;
+			else
+			{
+				long sub = diag + (isSameBase(x, Y[j - 1]) ? 0 : SUBSTITUTION_COST); // as the tile kernels
+				v = up + INSERTION_COST;
+				if (left + INSERTION_COST < v)
+					v = left + INSERTION_COST;
+				if (sub < v)
+					v = sub;
+			}
+			if (v > _INFINITE)
+				v = _INFINITE;
+			diag = up;
+			tab[j] = left = v;
+			if (v < best_value)
+			{
+				best_value = v;
+				best = j;
+			}
+		}
+		for (size_t j = lo; j < nlo && j <= hi; ++j) // the cells of the previous window out of this one
+			tab[j] = _INFINITE;
+		for (size_t j = (nhi + 1 > lo) ? nhi + 1 : lo; j <= hi; ++j)
+			tab[j] = _INFINITE;
+		lo = nlo;
+		hi = nhi;
+	}
+	long res = tab[N];
+	if (res >= _INFINITE) // X ends in a band short of N: the rest of Y is inserted
+		for (size_t j = N, inserted = 0;; --j)
+		{
+			if (j <= hi && tab[j] + (long)inserted < res)
+				res = tab[j] + (long)inserted;
+			if (j == lo)
+				break;
+			inserted += INSERTION_COST * isBase(Y[j - 1]);
+		}
+	NW_ArenaRelease(mark);
+	return res;
+}
+
+/* EditDistance_NW_masked : see .h file for documentation
+ */
+long EditDistance_NW_masked(enum NW_Engine engine, char *A, size_t lengthA, char *B, size_t lengthB,
+							const struct NW_Mask *mask)
+{
+	if (mask->policy == NW_MASK_ALIGN)
+		return EditDistance_NW_engine(engine, A, lengthA, B, lengthB);
+	struct NW_ArenaMark mark = NW_ArenaGet();
+	size_t nA = SeqMaskIntervals(A, lengthA, NULL), nB = SeqMaskIntervals(B, lengthB, NULL);
+	struct SeqInterval *mA = (struct SeqInterval *)NW_ArenaAlloc((nA + 1) * sizeof(struct SeqInterval));
+	struct SeqInterval *mB = (struct SeqInterval *)NW_ArenaAlloc((nB + 1) * sizeof(struct SeqInterval));
+	SeqMaskIntervals(A, lengthA, mA);
+	SeqMaskIntervals(B, lengthB, mB);
+	size_t basesA = _masked_bases(A, mA, nA), basesB = _masked_bases(B, mB, nB);
+	long res;
+	if (nA + nB == 0)
+		res = EditDistance_NW_engine(engine, A, lengthA, B, lengthB);
+	else if (mask->policy == NW_MASK_SKIP)
+	{
+		char *a = (char *)NW_ArenaAlloc(lengthA + 1), *b = (char *)NW_ArenaAlloc(lengthB + 1);
+		size_t la = _unmasked(A, lengthA, mA, nA, a), lb = _unmasked(B, lengthB, mB, nB, b);
+		res = EditDistance_NW_engine(engine, a, la, b, lb) + (long)llround(mask->cost * (double)(basesA + basesB));
+	}
+	else
+	{
+		size_t width = (mask->width == 0) ? NW_MASK_WIDTH : mask->width;
+		if (basesA >= basesB) // the rows: the sequence of the most masked bases
+			res = _banded(A, lengthA, mA, nA, B, lengthB, width);
+		else
+			res = _banded(B, lengthB, mB, nB, A, lengthA, width);
+		// a band as wide as the columns computes every cell: the distance of align
+		assert(width < ((basesA >= basesB) ? lengthB : lengthA) ||
+			   res == EditDistance_NW_engine(engine, A, lengthA, B, lengthB));
+	}
+	NW_ArenaRelease(mark);
+	return res;
+}
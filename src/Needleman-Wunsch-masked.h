@@ -0,0 +1,92 @@
+/**
+ * \file Needleman-Wunsch-masked.h
+ * \brief policy of alignment of the soft-masked (lowercase) intervals of the sequences
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * The repeats of the genome assemblies are soft-masked: written in lowercase. They are aligned as the
+ * other bases by default (_base_match does not distinguish the case), but they are where the alignments
+ * are the most expensive and the least informative. The intervals of lowercase bases are given by the
+ * decoder (SeqMaskIntervals, cf sequence_map.h) and aligned according to a policy:
+ *    align      : as the other bases (the exact distance)
+ *    band[:w]   : the rows of the masked intervals of one of the sequences (the one with the most masked
+ *                 bases) are computed only within w columns on each side (default NW_MASK_WIDTH) of the
+ *                 column following the best cell of the previous row, so each costs O(w) instead of O(N);
+ *                 the distance is an upper bound of the exact one
+ *    skip[:c]   : the masked bases of both sequences are removed before the alignment, and each costs c
+ *                 (default NW_MASK_COST: half a substitution, as if all the masked columns were mismatches)
+ * The policy of EditDistance_NW is the default mask, set from the environment variable NW_MASK (eg
+ * NW_MASK=band:32) or by NW_SetDefaultMask.
+ */
+
+#ifndef __NEEDLEMAN_WUNSCH_MASKED_H__
+#define __NEEDLEMAN_WUNSCH_MASKED_H__
+
+#include <stdlib.h> /* for size_t */
+
+#include "Needleman-Wunsch-recmemo.h" /* for enum NW_Engine */
+
+/** \def NW_MASK_ENV
+ *  \brief name of the environment variable that selects the default mask policy
+ */
+#define NW_MASK_ENV "NW_MASK"
+
+/** \def NW_MASK_WIDTH
+ *  \brief default half width of the band of the masked rows
+ */
+#define NW_MASK_WIDTH 64
+
+/** \def NW_MASK_COST
+ *  \brief default cost of a skipped masked base
+ */
+#define NW_MASK_COST 0.5
+
+/** \enum NW_MaskPolicy
+ * \brief alignment of the masked intervals
+ */
+enum NW_MaskPolicy
+{
+	NW_MASK_ALIGN = 0, /*!< aligned as the other bases */
+	NW_MASK_BAND,	   /*!< aligned within a narrow band */
+	NW_MASK_SKIP,	   /*!< removed, at a fixed cost per base */
+};
+
+/** \struct NW_Mask
+ * \brief a policy and its parameter
+ */
+struct NW_Mask
+{
+	enum NW_MaskPolicy policy;
+	size_t width; /*!< NW_MASK_BAND: half width of the band (0 for NW_MASK_WIDTH) */
+	double cost;  /*!< NW_MASK_SKIP: cost of a masked base */
+};
+
+/**
+ * \fn int NW_MaskFromName(const char *name, struct NW_Mask *mask);
+ * \brief sets mask from its name "align", "band[:width]" or "skip[:cost]"
+ * \return : 0 on success, -1 if name is not a policy
+ */
+int NW_MaskFromName(const char *name, struct NW_Mask *mask);
+
+/**
+ * \fn const struct NW_Mask *NW_DefaultMask(void);
+ * \brief returns the policy of EditDistance_NW: set by NW_SetDefaultMask, else from NW_MASK, else align
+ */
+const struct NW_Mask *NW_DefaultMask(void);
+
+/**
+ * \fn void NW_SetDefaultMask(const struct NW_Mask *mask);
+ * \brief sets the policy of EditDistance_NW (to be called before the workers start)
+ */
+void NW_SetDefaultMask(const struct NW_Mask *mask);
+
+/**
+ * \fn long EditDistance_NW_masked(enum NW_Engine engine, char *A, size_t lengthA, char *B, size_t lengthB, const struct NW_Mask *mask);
+ * \brief computes the distance between A and B, their masked intervals being aligned according to mask
+ * \param engine : the implementation of the alignments of policies align and skip
+ * \return : the distance (cf the policies above)
+ */
+long EditDistance_NW_masked(enum NW_Engine engine, char *A, size_t lengthA, char *B, size_t lengthB,
+							const struct NW_Mask *mask);
+
+#endif /* __NEEDLEMAN_WUNSCH_MASKED_H__ */
@@ -11,6 +11,10 @@
  */
 
 #include "Needleman-Wunsch-recmemo.h"
+#include "Needleman-Wunsch-kernel.h" /* tile kernels of the linear space versions */
+#include "probes.h"					 /* USDT probes */
+#include "arena.h"					 /* work buffers of the threads */
+#include "Needleman-Wunsch-masked.h"	 /* mask policy of EditDistance_NW */
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h> /* for strchr */
@@ -105,7 +109,6 @@ static long EditDistance_NW_RecMemo(struct NW_MemoContext *c, size_t i, size_t j
  */
 long EditDistance_NW_Rec(char *A, size_t lengthA, char *B, size_t lengthB)
 {
-	_init_base_match();
 	struct NW_MemoContext ctx;
 	if (lengthA >= lengthB) /* X is the longest sequence, Y the shortest */
 	{
@@ -123,26 +126,18 @@ long EditDistance_NW_Rec(char *A, size_t lengthA, char *B, size_t lengthB)
 	}
 	size_t M = ctx.M;
 	size_t N = ctx.N;
+	struct NW_ArenaMark mark = NW_ArenaGet();
 	{ /* Allocation and initialization of ctx.memo to NOT_YET_COMPUTED*/
-		/* Note: memo is of size (N+1)*(M+1) but is stored as (M+1) distinct arrays each with (N+1) continuous elements 
-       * It would have been possible to allocate only one big array memezone of (M+1)*(N+1) elements 
-       * and then memo as an array of (M+1) pointers, the memo[i] being the address of memzone[i*(N+1)].
+		/* Note: memo is of size (N+1)*(M+1), allocated as one big array memzone of (M+1)*(N+1) elements
+       * in the arena of the thread, and memo is an array of (M+1) pointers, memo[i] being the address of
+       * memzone[i*(N+1)]: no call to malloc once the arena is large enough.
        */
-		ctx.memo = (long **)malloc((M + 1) * sizeof(long *));
-		if (ctx.memo == NULL)
+		ctx.memo = (long **)NW_ArenaAlloc((M + 1) * sizeof(long *));
+		long *memzone = (long *)NW_ArenaAlloc((M + 1) * (N + 1) * sizeof(long));
+		for (size_t i = 0; i <= M; ++i)
 		{
-			perror("EditDistance_NW_Rec: malloc of ctx_memo");
-			exit(EXIT_FAILURE);
-		}
-		for (int i = 0; i <= M; ++i)
-		{
-			ctx.memo[i] = (long *)malloc((N + 1) * sizeof(long));
-			if (ctx.memo[i] == NULL)
-			{
-				perror("EditDistance_NW_Rec: malloc of ctx_memo[i]");
-				exit(EXIT_FAILURE);
-			}
-			for (int j = 0; j <= N; ++j)
+			ctx.memo[i] = memzone + i * (N + 1);
+			for (size_t j = 0; j <= N; ++j)
 				ctx.memo[i][j] = NOT_YET_COMPUTED;
 		}
 	}
@@ -150,11 +145,7 @@ long EditDistance_NW_Rec(char *A, size_t lengthA, char *B, size_t lengthB)
 	/* Compute phi(0,0) = ctx.memo[0][0] by calling the recursive function EditDistance_NW_RecMemo */
 	long res = EditDistance_NW_RecMemo(&ctx, 0, 0);
 
-	{ /* Deallocation of ctx.memo */
-		for (int i = 0; i <= M; ++i)
-			free(ctx.memo[i]);
-		free(ctx.memo);
-	}
+	NW_ArenaRelease(mark); /* Deallocation of ctx.memo */
 	return res;
 }
 
@@ -163,8 +154,18 @@ long EditDistance_NW_Rec(char *A, size_t lengthA, char *B, size_t lengthB)
  */
 long EditDistance_NW_iteratif(char *A, size_t lengthA, char *B, size_t lengthB)
 {
-	_init_base_match();
+	return EditDistance_NW_iteratif_profile(A, lengthA, B, lengthB, NULL);
+}
+
+/* EditDistance_NW_iteratif_profile : la version itérative, avec la dernière ligne et la dernière colonne.
+ * See .h file for documentation
+ */
+long EditDistance_NW_iteratif_profile(char *A, size_t lengthA, char *B, size_t lengthB, const struct NW_Profile *profile)
+{
+	const struct NW_Kernel *kernel = NW_DefaultKernel();
 	struct NW_MemoContext ctx;
+	struct NW_Profile xy;
+	NW_ProfileOrient(profile, lengthA < lengthB, &xy);
 	if (lengthA >= lengthB) /* X is the longest sequence, Y the shortest */
 	{
 		ctx.X = A;
@@ -181,57 +182,68 @@ long EditDistance_NW_iteratif(char *A, size_t lengthA, char *B, size_t lengthB)
 	}
 	size_t M = ctx.M;
 	size_t N = ctx.N;
-	long tab[N + 1];
-	long min;
-	int delta;
-	int prev_value;
-	tab[0] = 0;
+	long first_col = 0; // D[i][0]
+	NW_PROFILE_PUT(&xy, row, 0, 0); // D[M][0] si M == 0, réécrit sinon
+	NW_PROFILE_PUT(&xy, col, 0, 0);
+	if (N == 0)
+	{
+		for (size_t i = 0; i < M; i++)
+		{
+			first_col += INSERTION_COST * isBase(ctx.X[i]);
+			NW_PROFILE_PUT(&xy, col, i + 1, first_col);
+		}
+		NW_PROFILE_PUT(&xy, row, 0, first_col);
+		return first_col;
+	}
+	long tab[N];			 // tab[j-1] = D[i][j] : la dernière ligne calculée
+	long col[kernel->rows]; // colonne gauche puis droite des kernel->rows lignes traitées ensemble
 	//on initialise notre tableau
-	for (int j = 1; j < N + 1; j++)
+	tab[0] = INSERTION_COST * isBase(ctx.Y[0]);
+	for (size_t j = 1; j < N; j++)
 	{
-		tab[j] = tab[j - 1] + (isBase(ctx.Y[N - j]) * 2);
+		tab[j] = tab[j - 1] + INSERTION_COST * isBase(ctx.Y[j]);
 	}
-	//pour chaque parcours, on remet a jour le tableau
-	for (int i = 1; i < M + 1; i++)
+	NW_PROFILE_PUT(&xy, col, 0, tab[N - 1]); // D[0][N]
+	//pour chaque parcours de kernel->rows lignes, on remet a jour le tableau
+	for (size_t i = 0; i < M; i += kernel->rows)
 	{
-		//prev_value nous permet de stocker l'ancienne valeur du voisin gauche de notre element
-		prev_value = tab[0];
-		tab[0] = tab[0] + 2 * isBase(ctx.X[M - i]);
-		for (int j = 1; j < N + 1; j++)
+		size_t h = (M - i < kernel->rows) ? M - i : kernel->rows;
+		long corner = first_col;
+		for (size_t r = 0; r < h; r++)
 		{
-			if (!isBase(ctx.Y[N - j]))
-			{
-				prev_value = tab[j];
-				tab[j] = tab[j - 1];
-			}
-			else if (!isBase(ctx.X[M - i]))
-			{
-				prev_value = tab[j];
-			}
-			else
-			{
-				min = (tab[j] < tab[j - 1]) ? tab[j] : tab[j - 1];
-				min += INSERTION_COST;
-				// delta est égale au cout du mismatch si c'est le cas
-				delta = (int)!isSameBase(ctx.X[M - i], ctx.Y[N - j]);
-				delta += prev_value;
-				prev_value = tab[j];
-				//on retrouve le min pour la nouvelle valeur
-				tab[j] = (min < delta) ? min : delta;
-			}
+			first_col += INSERTION_COST * isBase(ctx.X[i + r]);
+			col[r] = first_col;
 		}
+		NW_PROBE3(strip_start, i, h, N);
+		kernel->tile(ctx.X + i, h, ctx.Y, N, corner, tab, col);
+		NW_PROBE2(strip_end, i, h);
+		for (size_t r = 0; r < h; r++) // colonne droite : D[i+r+1][N]
+			NW_PROFILE_PUT(&xy, col, i + r + 1, col[r]);
 	}
-	return tab[N];
+	// dernière ligne : D[M][0..N]
+	NW_PROFILE_PUT(&xy, row, 0, first_col);
+	for (size_t j = 0; j < N; j++)
+		NW_PROFILE_PUT(&xy, row, j + 1, tab[j]);
+	return tab[N - 1];
 }
 
-
 /* EditDistance_NW_cache_aware : la version cache aware de l'algorithme.
  * See .h file for documentation
  */
 long EditDistance_NW_cache_aware(char *A, size_t lengthA, char *B, size_t lengthB, int Z)
 {
-	_init_base_match();
+	return EditDistance_NW_cache_aware_profile(A, lengthA, B, lengthB, Z, NULL);
+}
+
+/* EditDistance_NW_cache_aware_profile : la version cache aware, avec la dernière ligne et la dernière colonne.
+ * See .h file for documentation
+ */
+long EditDistance_NW_cache_aware_profile(char *A, size_t lengthA, char *B, size_t lengthB, int Z, const struct NW_Profile *profile)
+{
+	const struct NW_Kernel *kernel = NW_DefaultKernel();
 	struct NW_MemoContext ctx;
+	struct NW_Profile xy;
+	NW_ProfileOrient(profile, lengthA < lengthB, &xy);
 	if (lengthA >= lengthB) /* X is the longest sequence, Y the shortest */
 	{
 		ctx.X = A;
@@ -247,67 +259,47 @@ long EditDistance_NW_cache_aware(char *A, size_t lengthA, char *B, size_t length
 		ctx.N = lengthA;
 	}
 	size_t M = ctx.M;
-	int nb_case = (int)Z / (5 * sizeof(long));
-	long N = ctx.N;
-	long tab[nb_case + 1];
-	long col[M + 1];
-	long min;
-	int delta;
-	long int bordure;
-	int prev_value;
-	tab[0] = 0;
-	col[0] = 0;
+	size_t N = ctx.N;
+	size_t nb_case = (size_t)Z / (5 * sizeof(long));
+	if (nb_case == 0)
+		nb_case = 1;
+	NW_PROFILE_PUT(&xy, row, 0, 0);
+	NW_PROFILE_PUT(&xy, col, 0, 0);
+	if (M == 0)
+		return 0;
+	long tab[nb_case];
+	long col[M];
+	long corner = 0; // D[0][j0] : coin en haut à gauche de la bande
 	// on initialise notre col qui permet de stocker l'ancienne valeur du dernier element calculé pour chaque parcours
-	for (int i = 1; i < M + 1; i++)
+	col[0] = INSERTION_COST * isBase(ctx.X[0]);
+	for (size_t i = 1; i < M; i++)
 	{
-		col[i] = col[i - 1] + (isBase(ctx.X[M - i]) * 2);
+		col[i] = col[i - 1] + INSERTION_COST * isBase(ctx.X[i]);
 	}
-	//le calcul se fait par nb_cases elements au fur et à mesure jusqu'à atteindre N
-	while (N > 0)
+	NW_PROFILE_PUT(&xy, row, 0, col[M - 1]); // D[M][0]
+	//le calcul se fait par nb_cases colonnes au fur et à mesure jusqu'à atteindre N
+	for (size_t j0 = 0; j0 < N; j0 += nb_case)
 	{
-		bordure = (N < nb_case) ? N : nb_case;
-		tab[0] = col[0];
-		// on initialise le tableau 
-		for (int j = 1; j < bordure + 1; j++)
+		size_t bordure = (N - j0 < nb_case) ? N - j0 : nb_case;
+		// on initialise le tableau avec la première ligne de la bande
+		long first_row = corner;
+		for (size_t j = 0; j < bordure; j++)
 		{
-			tab[j] = tab[j - 1] + (isBase(ctx.Y[N - j]) * 2);
+			first_row += INSERTION_COST * isBase(ctx.Y[j0 + j]);
+			tab[j] = first_row;
 		}
-		// mise à jour de la valeur de col[0] 
-		col[0] = tab[bordure];
-
-		//pour chaque parcours, on remet a jour le tableau
-		for (int i = 1; i < M + 1; i++)
-		{
-			prev_value = tab[0];
-			tab[0] = col[i];
-			for (int j = 1; j < bordure + 1; j++)
-			{
-				if (!isBase(ctx.Y[N - j]))
-				{
-					prev_value = tab[j];
-					tab[j] = tab[j - 1];
-				}
-				else if (!isBase(ctx.X[M - i]))
-				{
-					prev_value = tab[j];
-				}
-				else
-				{
-					min = (tab[j] < tab[j - 1]) ? tab[j] : tab[j - 1];
-					min += INSERTION_COST;
-					delta = (int)!isSameBase(ctx.X[M - i], ctx.Y[N - j]);
-					delta += prev_value;
-					prev_value = tab[j];
-					tab[j] = (min < delta) ? min : delta;
-				}
-			}
-			//mise à jour de la valeur de col[i] pour les prochains calculs 
-			col[i] = tab[bordure];
-		}
-		N = N - nb_case;
+		// col est mis à jour par le noyau : il contient en sortie la colonne droite de la bande
+		kernel->tile(ctx.X, M, ctx.Y + j0, bordure, corner, tab, col);
+		corner = first_row;
+		for (size_t j = 0; j < bordure; j++) // dernière ligne de la bande : D[M][j0+j+1]
+			NW_PROFILE_PUT(&xy, row, j0 + j + 1, tab[j]);
 	}
-	//col[M] represente la dernière valeur calculé à la fin de la sequence Y 
-	return col[M];
+	// dernière colonne : D[0..M][N]
+	NW_PROFILE_PUT(&xy, col, 0, corner);
+	for (size_t i = 0; i < M; i++)
+		NW_PROFILE_PUT(&xy, col, i + 1, col[i]);
+	//col[M-1] represente la dernière valeur calculé à la fin de la sequence Y 
+	return col[M - 1];
 }
 
 /* EditDistance_NW_cache_oblivious : la version cache oblivious de l'algorithme.
@@ -315,8 +307,18 @@ long EditDistance_NW_cache_aware(char *A, size_t lengthA, char *B, size_t length
  */
 long EditDistance_NW_cache_oblivious(char *A, size_t lengthA, char *B, size_t lengthB, int seuil)
 {
-	_init_base_match();
+	return EditDistance_NW_cache_oblivious_profile(A, lengthA, B, lengthB, seuil, NULL);
+}
+
+/* EditDistance_NW_cache_oblivious_profile : la version cache oblivious, avec la dernière ligne et la dernière colonne.
+ * See .h file for documentation
+ */
+long EditDistance_NW_cache_oblivious_profile(char *A, size_t lengthA, char *B, size_t lengthB, int seuil, const struct NW_Profile *profile)
+{
+	const struct NW_Kernel *kernel = NW_DefaultKernel();
 	struct NW_MemoContext ctx;
+	struct NW_Profile xy;
+	NW_ProfileOrient(profile, lengthA < lengthB, &xy);
 	if (lengthA >= lengthB) // X is the longest sequence, Y the shortest
 	{
 		ctx.X = A;
@@ -333,25 +335,42 @@ long EditDistance_NW_cache_oblivious(char *A, size_t lengthA, char *B, size_t le
 	}
 	size_t M = ctx.M;
 	long N = ctx.N;
-	long col[M + 1];
-	col[0] = 0;
+	NW_PROFILE_PUT(&xy, row, 0, 0);
+	NW_PROFILE_PUT(&xy, col, 0, 0);
+	if (M == 0)
+		return 0;
+	if (seuil < 1)
+		seuil = 1;
+	long col[M];
+	col[0] = INSERTION_COST * isBase(ctx.X[0]);
 	//on initialise le tableau colonne;
-	for (int i = 1; i < M + 1; i++)
+	for (size_t i = 1; i < M; i++)
 	{
-		col[i] = col[i - 1] + (isBase(ctx.X[M - i]) * 2);
+		col[i] = col[i - 1] + INSERTION_COST * isBase(ctx.X[i]);
 	}
+	NW_PROFILE_PUT(&xy, row, 0, col[M - 1]); // D[M][0]
 	//on appelle la fonction qui fera les calculs en prenant en considération le seuil
-	cache_oblivious_helper(ctx.X, ctx.M, ctx.Y, ctx.N, col, seuil, 0, N);
-	return col[M];
+	cache_oblivious_helper(ctx.X, M, ctx.Y, col, seuil, 0, N, 0, kernel, &xy);
+	// dernière colonne : D[0..M][N]
+	long first_row = 0;
+	for (long j = 0; j < N; j++)
+		first_row += INSERTION_COST * isBase(ctx.Y[j]);
+	NW_PROFILE_PUT(&xy, col, 0, first_row);
+	for (size_t i = 0; i < M; i++)
+		NW_PROFILE_PUT(&xy, col, i + 1, col[i]);
+	return col[M - 1];
 }
 
 /* EditDistance_NW_oblivious_helper : une fonction utilisé pour la version cache oblivious.
  * See .h file for documentation
  */
-void cache_oblivious_helper(char *X, size_t M, char *Y, size_t N, long *col, int seuil, long debut_seq, long fin_seq)
+void cache_oblivious_helper(const char *X, size_t M, const char *Y, long *col, int seuil, long debut_seq, long fin_seq,
+							long corner, const struct NW_Kernel *kernel, const struct NW_Profile *profile)
 {
 	//la taille du sous tableau 
 	long taille = fin_seq - debut_seq;
+	if (taille <= 0)
+		return;
 	if (taille > seuil)
 	{
 		/* notre taille supérieure au seuil 
@@ -359,52 +378,156 @@ void cache_oblivious_helper(char *X, size_t M, char *Y, size_t N, long *col, int
 		 */
 		long milieu = taille / 2;
 		milieu += debut_seq;
-		cache_oblivious_helper(X, M, Y, N, col, seuil, debut_seq, milieu);
-		cache_oblivious_helper(X, M, Y, N, col, seuil, milieu, fin_seq);
+		long corner_milieu = corner; // D[0][milieu]
+		for (long j = debut_seq; j < milieu; j++)
+			corner_milieu += INSERTION_COST * isBase(Y[j]);
+		cache_oblivious_helper(X, M, Y, col, seuil, debut_seq, milieu, corner, kernel, profile);
+		cache_oblivious_helper(X, M, Y, col, seuil, milieu, fin_seq, corner_milieu, kernel, profile);
 	}
 	/* notre taille est inférieure au seuil: 
-	* la suite revient aux étapes de la version itérative pour le sous tableau
+	* le noyau calcule la bande de colonnes [debut_seq, fin_seq( sur toutes les lignes
 	*/
 	else
 	{
-		long tab[taille + 1];
-		long prev_value;
-		tab[0] = col[0];
-		long min;
-		long delta;
-		// on initialise notre sous-tableau
-		for (int j = 1; j < taille + 1; j++)
+		long tab[taille];
+		// on initialise notre sous-tableau avec la première ligne
+		long first_row = corner;
+		for (long j = 0; j < taille; j++)
 		{
-			tab[j] = tab[j - 1] + (isBase(Y[N - j - debut_seq]) * 2);
+			first_row += INSERTION_COST * isBase(Y[debut_seq + j]);
+			tab[j] = first_row;
 		}
-		col[0] = tab[fin_seq];
-		for (int i = 1; i < M + 1; i++)
+		// mise à jour de col : colonne droite de la bande
+		kernel->tile(X, M, Y + debut_seq, (size_t)taille, corner, tab, col);
+		for (long j = 0; j < taille; j++) // dernière ligne : D[M][debut_seq+j+1]
+			NW_PROFILE_PUT(profile, row, (size_t)(debut_seq + j + 1), tab[j]);
+	}
+}
+
+
+/* Names of the engines, indexed by enum NW_Engine */
+static const char *_nw_engine_names[NW_ENGINE_COUNT] = {"rec", "iteratif", "cache_aware", "cache_oblivious", "multilevel"};
+
+/* EditDistance_NW : dispatches to the engine selected at run time.
+ * See .h file for documentation
+ */
+long EditDistance_NW(enum NW_Engine engine, char *A, size_t lengthA, char *B, size_t lengthB)
+{
+	long res;
+	const struct NW_Mask *mask = NW_DefaultMask();
+	NW_PROBE3(job_start, engine, lengthA, lengthB);
+	if (mask->policy != NW_MASK_ALIGN)
+		res = EditDistance_NW_masked(engine, A, lengthA, B, lengthB, mask);
+	else
+		res = EditDistance_NW_engine(engine, A, lengthA, B, lengthB);
+	NW_PROBE4(job_end, engine, lengthA, lengthB, res);
+	return res;
+}
+
+/* EditDistance_NW_engine : see .h file for documentation
+ */
+long EditDistance_NW_engine(enum NW_Engine engine, char *A, size_t lengthA, char *B, size_t lengthB)
+{
+	long res;
+	if (engine != NW_ENGINE_REC && NW_IS_SHORT(lengthA, lengthB))
+		res = EditDistance_NW_short(A, lengthA, B, lengthB);
+	else
+		switch (engine)
 		{
-			prev_value = tab[0];
-			tab[0] = col[i];
-			for (int j = 1; j < taille + 1; j++)
-			{
-				if (!isBase(Y[N - j - debut_seq]))
-				{
-					prev_value = tab[j];
-					tab[j] = tab[j - 1];
-				}
-				else if (!isBase(X[M - i]))
-				{
-					prev_value = tab[j];
-				}
-				else
-				{
-					min = (tab[j] < tab[j - 1]) ? tab[j] : tab[j - 1];
-					min += INSERTION_COST;
-					delta = (int)!isSameBase(X[M - i], Y[N - j - debut_seq]);
-					delta += prev_value;
-					prev_value = tab[j];
-					tab[j] = (min < delta) ? min : delta;
-				}
-			}
-			// mise à jour de col[i]
-			col[i] = tab[taille];
+		case NW_ENGINE_REC:
+			res = EditDistance_NW_Rec(A, lengthA, B, lengthB);
+			break;
+		case NW_ENGINE_ITERATIF:
+			res = EditDistance_NW_iteratif(A, lengthA, B, lengthB);
+			break;
+		case NW_ENGINE_CACHE_OBLIVIOUS:
+			res = EditDistance_NW_cache_oblivious(A, lengthA, B, lengthB, NW_DEFAULT_SEUIL);
+			break;
+		case NW_ENGINE_MULTILEVEL:
+			res = EditDistance_NW_cache_multilevel(A, lengthA, B, lengthB, NULL);
+			break;
+		case NW_ENGINE_CACHE_AWARE:
+		default:
+			res = EditDistance_NW_cache_aware(A, lengthA, B, lengthB, NW_DEFAULT_Z);
+			break;
+		}
+	return res;
+}
+
+/* NW_PeakBytes : see .h file for documentation
+ */
+size_t NW_PeakBytes(enum NW_Engine engine, size_t lengthA, size_t lengthB)
+{
+	size_t M = (lengthA < lengthB) ? lengthB : lengthA, N = (lengthA < lengthB) ? lengthA : lengthB;
+	size_t extra = (NW_DefaultMask()->policy != NW_MASK_ALIGN) // the sequences out of the masks, or the row of the band
+					   ? lengthA + lengthB + (M + 64) * sizeof(long)
+					   : 0;
+	if (engine != NW_ENGINE_REC && NW_IS_SHORT(lengthA, lengthB))
+		return 4096 + extra;
+	switch (engine)
+	{
+	case NW_ENGINE_REC: // memo[M + 1][N + 1], its row pointers and one frame per level of recursion
+		return (M + 1) * (N + 1) * sizeof(long) + (M + 1) * sizeof(long *) + (M + N + 1) * 64 + extra;
+	case NW_ENGINE_ITERATIF: // one row, of the shortest sequence
+		return (N + 64) * sizeof(long) + extra;
+	default: // one row and one column
+		return (lengthA + lengthB + 64) * sizeof(long) + extra;
+	}
+}
+
+/* EditDistance_NW_profile : dispatches to the linear space engine selected at run time.
+ * See .h file for documentation
+ */
+long EditDistance_NW_profile(enum NW_Engine engine, char *A, size_t lengthA, char *B, size_t lengthB, const struct NW_Profile *profile)
+{
+	switch (engine)
+	{
+	case NW_ENGINE_REC:
+	case NW_ENGINE_ITERATIF:
+		return EditDistance_NW_iteratif_profile(A, lengthA, B, lengthB, profile);
+	case NW_ENGINE_CACHE_OBLIVIOUS:
+		return EditDistance_NW_cache_oblivious_profile(A, lengthA, B, lengthB, NW_DEFAULT_SEUIL, profile);
+	case NW_ENGINE_MULTILEVEL:
+		return EditDistance_NW_cache_multilevel_profile(A, lengthA, B, lengthB, NULL, profile);
+	case NW_ENGINE_CACHE_AWARE:
+	default:
+		return EditDistance_NW_cache_aware_profile(A, lengthA, B, lengthB, NW_DEFAULT_Z, profile);
+	}
+}
+
+/* NW_ProfileOrient : see .h file for documentation
+ */
+void NW_ProfileOrient(const struct NW_Profile *profile, int swapped, struct NW_Profile *xy)
+{
+	xy->row = xy->col = NULL;
+	xy->step = 1;
+	if (profile == NULL)
+		return;
+	xy->row = swapped ? profile->col : profile->row;
+	xy->col = swapped ? profile->row : profile->col;
+	xy->step = (profile->step == 0) ? 1 : profile->step;
+}
+
+/* NW_EngineFromName : see .h file for documentation
+ */
+int NW_EngineFromName(const char *name, enum NW_Engine *engine)
+{
+	for (size_t e = 0; e < NW_ENGINE_COUNT; ++e)
+	{
+		if (strcmp(name, _nw_engine_names[e]) == 0)
+		{
+			*engine = (enum NW_Engine)e;
+			return 0;
 		}
 	}
+	return -1;
+}
+
+/* NW_EngineName : see .h file for documentation
+ */
+const char *NW_EngineName(enum NW_Engine engine)
+{
+	if ((size_t)engine >= NW_ENGINE_COUNT)
+		return "unknown";
+	return _nw_engine_names[engine];
 }
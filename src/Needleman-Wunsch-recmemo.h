@@ -6,6 +6,9 @@
  * \author Jean-Louis Roch (Ensimag, Grenoble-INP - University Grenoble-Alpes) jean-louis.roch@grenoble-inp.fr
  */
 
+#ifndef __NEEDLEMAN_WUNSCH_RECMEMO_H__
+#define __NEEDLEMAN_WUNSCH_RECMEMO_H__
+
 #include <stdlib.h> /* for size_t */
 
 /*
@@ -61,10 +64,12 @@ long EditDistance_NW_Rec(char *A, size_t lengthA, char *B, size_t lengthB);
  * \param lengthB :  number of elements in B 
  * \return :  edit distance between A and B }
  *
- * editDistance_iteratif : Using an array of (N+1) elements when traversed M times (with M the length of the largest sequence 
+ * editDistance_iteratif : Using an array of N elements when traversed M times (with M the length of the largest sequence 
  * and N that of the smallest). After each traversal, Bellman's equation is applied with a storage of the prev_value"which is
  * the old value of the neighbor to the left of our iterator before the last traversal.
- * Our array is renewed after each scan, until the end and the value of tab[N] is thus the value sought.
+ * Our array is renewed after each scan, until the end and the value of tab[N-1] is thus the value sought.
+ * The scans are done by the tile kernel NW_DefaultKernel() (cf Needleman-Wunsch-kernel.h), by groups of
+ * kernel->rows rows (one row for the scalar kernel).
  */
 long EditDistance_NW_iteratif(char *A, size_t lengthA, char *B, size_t lengthB);
 
@@ -80,8 +85,8 @@ long EditDistance_NW_iteratif(char *A, size_t lengthA, char *B, size_t lengthB);
  *
  * editDistance_cache_aware :the same principle as the iterative version, except that here we take the size
  * of the cache Z into consideration. The table is divides into mini tables of nbr_case elements.
- * Hence the usefulness of the col array of M+1 elements which makes it possible to store the ancient values needed for
- * Bellman's esquation.
+ * Hence the usefulness of the col array of M elements which makes it possible to store the ancient values needed for
+ * Bellman's esquation. Each band of nb_case columns is computed by the tile kernel NW_DefaultKernel().
  */
 long EditDistance_NW_cache_aware(char *A, size_t lengthA, char *B, size_t lengthB, int Z);
 
@@ -97,21 +102,328 @@ long EditDistance_NW_cache_aware(char *A, size_t lengthA, char *B, size_t length
  *
  * editDistance_cache_oblivious :From the iterative version, we take a threshold for the number of boxes
  * that we can calculate, we do a recursion: that is to say that we divide our N in two, and then we call
- * the function for half of the sequence and then the second half. and still using our col array of M+1
- * elements which allows us to store the values. this recursion is done using the fonction cache_oblivious_helper
+ * the function for half of the sequence and then the second half. and still using our col array of M
+ * elements which allows us to store the values. this recursion is done using the fonction cache_oblivious_helper,
+ * whose leaves are computed by the tile kernel NW_DefaultKernel().
  */
 long EditDistance_NW_cache_oblivious(char *A, size_t lengthA, char *B, size_t lengthB, int seuil);
 
 /**
- * \fn void cache_oblivious_helper(char *X, size_t M, char *Y, size_t N, long *col, int seuil, long debut_seq, long fin_seq);
+ * \fn void cache_oblivious_helper(const char *X, size_t M, const char *Y, long *col, int seuil, long debut_seq, long fin_seq, long corner, const struct NW_Kernel *kernel, const struct NW_Profile *profile);
  * \brief helps in findint the edit distance between A[0 .. lengthA-1] and B[0 .. lengthB-1]
  * \param X  : array of char represneting a genetic sequence X 
  * \param M :  number of elements in X 
  * \param Y  : array of char represneting a genetic sequence Y
- * \param N :  number of elements in Y
+ * \param col : on entry, the column of the distances before column debut_seq; on return, the column fin_seq-1
  * \param seuil : a threshold for the calculation
+ * \param debut_seq : first column of Y to compute
+ * \param fin_seq : end (excluded) of the columns of Y to compute
+ * \param corner : distance between the empty prefix of X and Y[0 .. debut_seq-1]
+ * \param kernel : the tile kernel that computes the columns [debut_seq, fin_seq( when there are at most seuil of them
+ * \param profile : receives the last row of the columns [debut_seq, fin_seq( (cf NW_ProfileOrient)
  * }
  *
  * cache_oblivious_helper : it helps in the recursion needed for the cache oblivious version
  */
-static void cache_oblivious_helper(char *X, size_t M, char *Y, size_t N, long *col, int seuil, long debut_seq, long fin_seq);
+struct NW_Kernel; /* cf Needleman-Wunsch-kernel.h */
+struct NW_Profile;
+void cache_oblivious_helper(const char *X, size_t M, const char *Y, long *col, int seuil, long debut_seq, long fin_seq,
+							 long corner, const struct NW_Kernel *kernel, const struct NW_Profile *profile);
+
+/********************************************************************************
+ * Specialized kernels for short sequences (Needleman-Wunsch-short.c)
+ */
+/** \def NW_SHORT_MAX_N
+ *  \brief maximal length of the shortest sequence handled by EditDistance_NW_short
+ */
+#define NW_SHORT_MAX_N 128
+
+/** \def NW_SHORT_MAX_M
+ *  \brief maximal length of the longest sequence handled by EditDistance_NW_short (distances fit on 16 bits)
+ */
+#define NW_SHORT_MAX_M 8192
+
+/** \def NW_IS_SHORT(lengthA, lengthB)
+ *  \brief true iff EditDistance_NW_short may be called on sequences of these lengths
+ */
+#define NW_IS_SHORT(lengthA, lengthB)                                                       \
+	((((lengthA) < (lengthB)) ? (lengthA) : (lengthB)) <= NW_SHORT_MAX_N && \
+	 (((lengthA) < (lengthB)) ? (lengthB) : (lengthA)) <= NW_SHORT_MAX_M)
+
+/**
+ * \fn long EditDistance_NW_short(char* A, size_t lengthA, char* B, size_t lengthB);
+ * \brief computes the edit distance between A[0 .. lengthA-1] and B[0 .. lengthB-1], for short sequences only
+ * \param A  : array of char represneting a genetic sequence A 
+ * \param lengthA :  number of elements in A 
+ * \param B  : array of char represneting a genetic sequence B
+ * \param lengthB :  number of elements in B 
+ * \return :  edit distance between A and B (same costs as EditDistance_NW_iteratif)
+ *
+ * Requires NW_IS_SHORT(lengthA, lengthB). The shortest sequence is first compacted into an array of bases 
+ * (skipping the chars that are not bases) and a query profile of substitution costs, then one kernel is chosen 
+ * among widths 16, 32, 64 and 128 (the smallest one not less than the number of bases). Each kernel is generated 
+ * by a macro with its width as a compile time constant, on rows of 16 bits cells stored in fixed size local arrays:
+ * for widths 16 and 32, the loop on a row is fully unrolled so that the row stays in registers; for widths 64 
+ * and 128, the dependency on the left neighbour is computed by a prefix-min scan in log2(width) vectorized steps. 
+ * There is no allocation and no variable length array.
+ */
+long EditDistance_NW_short(char *A, size_t lengthA, char *B, size_t lengthB);
+
+/********************************************************************************
+ * Hierarchical cache aware implementation (Needleman-Wunsch-tiled.c)
+ */
+/** \struct NW_CacheLevels
+ * \brief sizes in bytes of the cache levels used by EditDistance_NW_cache_multilevel
+ */
+struct NW_CacheLevels
+{
+	size_t l1;	/*!< size of the L1 data cache */
+	size_t l2;	/*!< size of the L2 cache */
+	size_t llc; /*!< share of the last level cache available to one core */
+};
+
+/** \def NW_TUNING_FILE_ENV
+ *  \brief name of the environment variable giving the pathname of a tuning file for NW_CacheLevelsDetect
+ */
+#define NW_TUNING_FILE_ENV "NW_TUNING_FILE"
+
+/**
+ * \fn void NW_CacheLevelsDetect(struct NW_CacheLevels *levels);
+ * \brief sets the cache sizes from the tuning file, else from the cache topology of the machine
+ * \param levels : the sizes found
+ *
+ * If the environment variable NW_TUNING_FILE names a readable file, each of its lines "l1 <size>", 
+ * "l2 <size>" or "llc <size>" (size in bytes, with an optional suffix K, M or G; '#' starts a comment) 
+ * overrides the detected value. Otherwise the sizes are read in /sys/devices/system/cpu/cpu0/cache 
+ * (the LLC size is divided by the number of cpus sharing it), then with sysconf, and default to 
+ * 32 KiB, 1 MiB and 2 MiB.
+ */
+void NW_CacheLevelsDetect(struct NW_CacheLevels *levels);
+
+/**
+ * \fn long EditDistance_NW_cache_multilevel(char* A, size_t lengthA, char* B, size_t lengthB, const struct NW_CacheLevels *levels);
+ * \brief computes the edit distance between A[0 .. lengthA-1] and B[0 .. lengthB-1]
+ * \param A  : array of char represneting a genetic sequence A 
+ * \param lengthA :  number of elements in A 
+ * \param B  : array of char represneting a genetic sequence B
+ * \param lengthB :  number of elements in B 
+ * \param levels : sizes of the cache levels (if NULL: NW_CacheLevelsDetect, done once per process)
+ * \return :  edit distance between A and B (same costs as EditDistance_NW_iteratif)
+ *
+ * editDistance_cache_multilevel : generalizes the cache aware version to three nested levels of tiles. 
+ * The table is divided into outer tiles sized for the LLC share of one core, each outer tile into middle 
+ * tiles sized for L2 and each middle tile into micro tiles sized for L1; a micro tile is computed by the tile 
+ * kernel NW_DefaultKernel() (cf Needleman-Wunsch-kernel.h). A tile of h rows and w columns 
+ * only reads and writes w values of the boundary row and h values of the boundary column, so its size is 
+ * chosen such that 9 (w + h) bytes (8 per long and 1 per base) fill half of the cache level.
+ * Only one row of N+1 and one column of M+1 longs are allocated.
+ */
+long EditDistance_NW_cache_multilevel(char *A, size_t lengthA, char *B, size_t lengthB, const struct NW_CacheLevels *levels);
+
+/********************************************************************************
+ * Alignment of block compressed sequences (Needleman-Wunsch-compressed.c)
+ */
+struct NWZ_Container; /* cf block_container.h */
+struct NWZ_Seq;
+
+/** \struct NW_BlockMemo
+ * \brief table of the tiles already computed, indexed by their blocks and their input boundaries
+ */
+struct NW_BlockMemo;
+
+/** \def NW_DEFAULT_MEMO_BYTES
+ *  \brief default size of the memory of a NW_BlockMemo
+ */
+#define NW_DEFAULT_MEMO_BYTES ((size_t)256 << 20)
+
+/**
+ * \fn struct NW_BlockMemo *NW_BlockMemoCreate(size_t bytes);
+ * \brief creates an empty table of tiles using at most about bytes bytes
+ */
+struct NW_BlockMemo *NW_BlockMemoCreate(size_t bytes);
+
+/**
+ * \fn void NW_BlockMemoFree(struct NW_BlockMemo *memo);
+ * \brief frees the table of tiles
+ */
+void NW_BlockMemoFree(struct NW_BlockMemo *memo);
+
+/**
+ * \fn void NW_BlockMemoStats(const struct NW_BlockMemo *memo, size_t *tiles, size_t *hits, size_t *cells);
+ * \brief returns the number of tiles met, of tiles found in the table and of cells computed since the creation
+ */
+void NW_BlockMemoStats(const struct NW_BlockMemo *memo, size_t *tiles, size_t *hits, size_t *cells);
+
+/**
+ * \fn long EditDistance_NW_compressed(const struct NWZ_Container *c, const struct NWZ_Seq *A, const struct NWZ_Seq *B, struct NW_BlockMemo *memo);
+ * \brief computes the edit distance between two sequences of a block compressed container
+ * \param c : the container (cf block_container.h)
+ * \param A : a sequence of c
+ * \param B : a sequence of c
+ * \param memo : the table of tiles, shared by all the calls on the same container (not thread safe)
+ * \return :  edit distance between A and B (same costs as EditDistance_NW_iteratif)
+ *
+ * editDistance_compressed : the table is divided into tiles, one per pair (block of A, block of B).
+ * The bottom and right boundaries of a tile only depend on its two blocks and on the differences between
+ * consecutive values of its top and left boundaries (in [-2, 2]), so the tile is looked up in memo with
+ * this key and only computed (by the tile kernel NW_DefaultKernel()) if it is not found. When many
+ * sequences are nearly identical, the same tiles occur in every pair and the cost of a tile is the one
+ * of hashing its boundaries: O(h + w) instead of O(h w). The total cost is thus O(M N / B) for blocks of
+ * average length B, not O(compressed size): boundaries still have to be propagated through every tile.
+ * When memo is full, it is emptied.
+ */
+long EditDistance_NW_compressed(const struct NWZ_Container *c, const struct NWZ_Seq *A, const struct NWZ_Seq *B,
+								struct NW_BlockMemo *memo);
+
+/********************************************************************************
+ * Selection of an implementation at run time (used by the batch mode)
+ */
+/**
+ * \enum NW_Engine
+ * \brief the implementations of Needleman-Wunsch that can be selected at run time
+ */
+enum NW_Engine
+{
+	NW_ENGINE_REC = 0,		   /*!< EditDistance_NW_Rec */
+	NW_ENGINE_ITERATIF,		   /*!< EditDistance_NW_iteratif */
+	NW_ENGINE_CACHE_AWARE,	   /*!< EditDistance_NW_cache_aware with Z = NW_DEFAULT_Z */
+	NW_ENGINE_CACHE_OBLIVIOUS, /*!< EditDistance_NW_cache_oblivious with seuil = NW_DEFAULT_SEUIL */
+	NW_ENGINE_MULTILEVEL,	   /*!< EditDistance_NW_cache_multilevel with the detected cache sizes */
+	NW_ENGINE_COUNT			   /*!< number of engines */
+};
+
+/** \def NW_DEFAULT_Z
+ *  \brief cache size Z given to EditDistance_NW_cache_aware by EditDistance_NW
+ */
+#define NW_DEFAULT_Z 4096
+
+/** \def NW_DEFAULT_SEUIL
+ *  \brief threshold given to EditDistance_NW_cache_oblivious by EditDistance_NW
+ */
+#define NW_DEFAULT_SEUIL 100
+
+/**
+ * \fn long EditDistance_NW(enum NW_Engine engine, char *A, size_t lengthA, char *B, size_t lengthB);
+ * \brief computes the edit distance between A[0 .. lengthA-1] and B[0 .. lengthB-1] with the given engine
+ * \param engine : the implementation to call
+ * \param A  : array of char represneting a genetic sequence A 
+ * \param lengthA :  number of elements in A 
+ * \param B  : array of char represneting a genetic sequence B
+ * \param lengthB :  number of elements in B 
+ * \return :  edit distance between A and B
+ *
+ * All the engines are reentrant and may be called concurrently from several threads.
+ * When NW_IS_SHORT(lengthA, lengthB), the linear space engines (all but NW_ENGINE_REC, whose cost of 
+ * substitution of N by N differs) are replaced by EditDistance_NW_short.
+ * The soft-masked intervals are aligned according to the policy NW_DefaultMask() (cf
+ * Needleman-Wunsch-masked.h): by default, as the other bases.
+ */
+long EditDistance_NW(enum NW_Engine engine, char *A, size_t lengthA, char *B, size_t lengthB);
+
+/**
+ * \fn long EditDistance_NW_engine(enum NW_Engine engine, char *A, size_t lengthA, char *B, size_t lengthB);
+ * \brief EditDistance_NW without the mask policy: the masked bases are aligned as the other ones
+ */
+long EditDistance_NW_engine(enum NW_Engine engine, char *A, size_t lengthA, char *B, size_t lengthB);
+
+/**
+ * \fn size_t NW_PeakBytes(enum NW_Engine engine, size_t lengthA, size_t lengthB);
+ * \brief returns the predicted peak memory (heap and stack, in bytes) of EditDistance_NW with these arguments
+ *
+ * NW_ENGINE_REC stores the whole table and recurses along its diagonal; the other engines store one row
+ * and (but NW_ENGINE_ITERATIF, the smallest) one column of the table.
+ */
+size_t NW_PeakBytes(enum NW_Engine engine, size_t lengthA, size_t lengthB);
+
+/**
+ * \fn int NW_EngineFromName(const char *name, enum NW_Engine *engine);
+ * \brief parses an engine name ("rec", "iteratif", "cache_aware", "cache_oblivious" or "multilevel")
+ * \param name : the name of the engine
+ * \param engine : set to the matching engine on success
+ * \return : 0 on success, -1 if the name is unknown
+ */
+int NW_EngineFromName(const char *name, enum NW_Engine *engine);
+
+/**
+ * \fn const char *NW_EngineName(enum NW_Engine engine);
+ * \brief returns the name of an engine, as accepted by NW_EngineFromName
+ */
+const char *NW_EngineName(enum NW_Engine engine);
+
+/********************************************************************************
+ * Distance profiles: last row and last column of the linear space engines
+ */
+/** \struct NW_Profile
+ * \brief buffers given by the caller to receive the last row and the last column of the table D
+ *
+ * D[i][j] is the distance between the prefixes A[0 .. i-1] and B[0 .. j-1]. With step >= 1:
+ *    row[k] = D[lengthA][k step] for 0 <= k <= lengthB / step : A against every prefix of B
+ *    col[k] = D[k step][lengthB] for 0 <= k <= lengthA / step : every prefix of A against B
+ * (the distances against the suffixes are the profiles of the reversed sequences).
+ */
+struct NW_Profile
+{
+	long *row;	 /*!< if not NULL, receives lengthB / step + 1 values */
+	long *col;	 /*!< if not NULL, receives lengthA / step + 1 values */
+	size_t step; /*!< decimation: one value out of step (0 is taken as 1) */
+};
+
+/** \def NW_PROFILE_PUT(profile, v, k, value)
+ *  \brief stores value as the k-th element of the vector v (row or col) of profile if v is given and k is a multiple of step
+ */
+#define NW_PROFILE_PUT(profile, v, k, value)                                        \
+	do                                                                              \
+	{                                                                               \
+		if ((profile)->v != NULL && (k) % (profile)->step == 0)                     \
+			(profile)->v[(k) / (profile)->step] = (value);                          \
+	} while (0)
+
+/**
+ * \fn void NW_ProfileOrient(const struct NW_Profile *profile, int swapped, struct NW_Profile *xy);
+ * \brief sets xy to the profile of the table of X (rows, the longest) and Y used inside the engines
+ * \param profile : the profile of the caller (may be NULL)
+ * \param swapped : 1 if X is B and Y is A
+ * \param xy : the profile where the engines write the rows and columns of their own table
+ *
+ * As the distance is symmetric, the last row of the table of X = B and Y = A is the last column of the
+ * table of A and B.
+ */
+void NW_ProfileOrient(const struct NW_Profile *profile, int swapped, struct NW_Profile *xy);
+
+/**
+ * \fn long EditDistance_NW_iteratif_profile(char *A, size_t lengthA, char *B, size_t lengthB, const struct NW_Profile *profile);
+ * \brief EditDistance_NW_iteratif, also writing the last row and column of D in profile
+ */
+long EditDistance_NW_iteratif_profile(char *A, size_t lengthA, char *B, size_t lengthB, const struct NW_Profile *profile);
+
+/**
+ * \fn long EditDistance_NW_cache_aware_profile(char *A, size_t lengthA, char *B, size_t lengthB, int Z, const struct NW_Profile *profile);
+ * \brief EditDistance_NW_cache_aware, also writing the last row and column of D in profile
+ */
+long EditDistance_NW_cache_aware_profile(char *A, size_t lengthA, char *B, size_t lengthB, int Z, const struct NW_Profile *profile);
+
+/**
+ * \fn long EditDistance_NW_cache_oblivious_profile(char *A, size_t lengthA, char *B, size_t lengthB, int seuil, const struct NW_Profile *profile);
+ * \brief EditDistance_NW_cache_oblivious, also writing the last row and column of D in profile
+ */
+long EditDistance_NW_cache_oblivious_profile(char *A, size_t lengthA, char *B, size_t lengthB, int seuil, const struct NW_Profile *profile);
+
+/**
+ * \fn long EditDistance_NW_cache_multilevel_profile(char *A, size_t lengthA, char *B, size_t lengthB, const struct NW_CacheLevels *levels, const struct NW_Profile *profile);
+ * \brief EditDistance_NW_cache_multilevel, also writing the last row and column of D in profile
+ */
+long EditDistance_NW_cache_multilevel_profile(char *A, size_t lengthA, char *B, size_t lengthB, const struct NW_CacheLevels *levels,
+											  const struct NW_Profile *profile);
+
+/**
+ * \fn long EditDistance_NW_profile(enum NW_Engine engine, char *A, size_t lengthA, char *B, size_t lengthB, const struct NW_Profile *profile);
+ * \brief computes the edit distance between A[0 .. lengthA-1] and B[0 .. lengthB-1] and its profiles with the given engine
+ * \return :  edit distance between A and B
+ *
+ * The last row and column are the boundaries that the linear space engines already keep, so the cost is
+ * the one of EditDistance_NW plus O(lengthA + lengthB). NW_ENGINE_REC (quadratic space, suffixes)
+ * is replaced by NW_ENGINE_ITERATIF, and EditDistance_NW_short is not used.
+ */
+long EditDistance_NW_profile(enum NW_Engine engine, char *A, size_t lengthA, char *B, size_t lengthB, const struct NW_Profile *profile);
+
+#endif /* __NEEDLEMAN_WUNSCH_RECMEMO_H__ */
@@ -0,0 +1,159 @@
+/**
+ * \file Needleman-Wunsch-short.c
+ * \brief kernels of Needleman-Wunsch specialized at compile time for short sequences (at most NW_SHORT_MAX_N bases)
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see Needleman-Wunsch-recmemo.h
+ *
+ * Let y[1..n] be the bases of the shortest sequence and row[0..W] the values of the current row
+ * (W >= n is the width of the kernel; columns n+1..W are padding that never influences row[0..n]).
+ * For each base x of the longest sequence, the new row is:
+ *    u[j]   = min( row[j] + INSERTION_COST, row[j-1] + (x != y[j]) * SUBSTITUTION_COST )   (up and diagonal)
+ *    row[j] = min_{k <= j} ( u[k] + INSERTION_COST * (j - k) )                                (left)
+ * For W = 16 and 32, the second line is computed directly from left to right (NW_SHORT_CHAIN_KERNEL).
+ * For W = 64 and 128, it is a prefix minimum of u[k] - INSERTION_COST * k, computed in log2(W) steps of
+ * independent min operations which, like the first line, are vectorized by the compiler (NW_SHORT_KERNEL).
+ */
+
+#include "Needleman-Wunsch-recmemo.h"
+#include <stdint.h> /* for int16_t */
+
+#include "characters_to_base.h" /* mapping from char to base */
+
+/*
+ * static inline void _nw_min_shift(int16_t *t, const int16_t *u, int s, int W)
+ * \brief one step of the prefix minimum : t[k] = min(u[k], u[k - s]) (t[k] = u[k] for k < s)
+ * Always inlined with constant s and W, so that both loops are vectorized with a constant trip count.
+ */
+static inline __attribute__((always_inline)) void _nw_min_shift(int16_t *restrict t, const int16_t *restrict u, int s, int W)
+{
+	for (int k = 0; k < s; ++k)
+		t[k] = u[k];
+	for (int k = s; k < W; ++k)
+		t[k] = (u[k - s] < u[k]) ? u[k - s] : u[k];
+}
+
+/** \def NW_SHORT_KERNEL(W)
+ * \brief defines static long _nw_short_W(const char *X, size_t M, const unsigned char *y, size_t n):
+ * the distance between X[0..M-1] and the n <= W bases y[1..n], computed on rows of W cells of 16 bits
+ *
+ * The cell of column j >= 1 is stored in r[j - 1]; column 0 is kept apart in r0.
+ * profile[b][k] is the cost of the substitution of base b by y[k + 1] (query profile, computed once).
+ */
+#define NW_SHORT_KERNEL(W)                                                                   \
+	static long _nw_short_##W(const char *X, size_t M, const unsigned char *y, size_t n)     \
+	{                                                                                        \
+		int16_t profile[UNKOWN_BASE + 1][(W)];                                               \
+		for (int b = 0; b <= UNKOWN_BASE; ++b)                                               \
+			for (int k = 0; k < (W); ++k)                                                    \
+				profile[b][k] = (int16_t)((b != y[k + 1]) * SUBSTITUTION_COST);              \
+		int16_t r[(W)], u[(W)], t[(W)];                                                      \
+		int16_t r0 = 0;                                                                      \
+		for (int k = 0; k < (W); ++k)                                                        \
+			r[k] = (int16_t)(INSERTION_COST * (k + 1));                                      \
+		for (size_t i = 0; i < M; ++i)                                                       \
+		{                                                                                    \
+			unsigned char x = (unsigned char)CharToBase((unsigned char)X[i]);                \
+			if (x == SKIP_BASE) /* une ligne qui n'est pas une base ne change rien */        \
+				continue;                                                                    \
+			const int16_t *cost = profile[x];                                                \
+			/* voisins haut et diagonal, décalés de -INSERTION_COST * colonne */             \
+			u[0] = (int16_t)(r0 + cost[0]);                                                  \
+			for (int k = 1; k < (W); ++k)                                                    \
+				u[k] = (int16_t)(r[k - 1] + cost[k]);                                        \
+			for (int k = 0; k < (W); ++k)                                                    \
+			{                                                                                \
+				int16_t up = (int16_t)(r[k] + INSERTION_COST);                               \
+				u[k] = (int16_t)(((up < u[k]) ? up : u[k]) - INSERTION_COST * (k + 1));      \
+			}                                                                                \
+			r0 = (int16_t)(r0 + INSERTION_COST);                                             \
+			if (r0 < u[0])                                                                   \
+				u[0] = r0;                                                                   \
+			/* voisin gauche : minimum préfixe en log2(W) étapes déroulées */                \
+			_Pragma("GCC unroll 8") for (int s = 1; s < (W); s <<= 2)                        \
+			{                                                                                \
+				_nw_min_shift(t, u, s, (W));                                                 \
+				if (2 * s < (W))                                                             \
+					_nw_min_shift(u, t, 2 * s, (W));                                         \
+				else                                                                         \
+					for (int k = 0; k < (W); ++k)                                            \
+						u[k] = t[k];                                                         \
+			}                                                                                \
+			for (int k = 0; k < (W); ++k)                                                    \
+				r[k] = (int16_t)(u[k] + INSERTION_COST * (k + 1));                           \
+		}                                                                                    \
+		return (n == 0) ? r0 : r[n - 1];                                                     \
+	}
+
+/** \def NW_SHORT_CHAIN_KERNEL(W)
+ * \brief same as NW_SHORT_KERNEL(W), for the narrowest widths: each row is computed from left to right,
+ * by a loop fully unrolled so that the W + 1 cells of the row stay in registers
+ */
+#define NW_SHORT_CHAIN_KERNEL(W)                                                             \
+	static long _nw_short_##W(const char *X, size_t M, const unsigned char *y, size_t n)     \
+	{                                                                                        \
+		int16_t profile[UNKOWN_BASE + 1][(W)];                                               \
+		for (int b = 0; b <= UNKOWN_BASE; ++b)                                               \
+			for (int k = 0; k < (W); ++k)                                                    \
+				profile[b][k] = (int16_t)((b != y[k + 1]) * SUBSTITUTION_COST);              \
+		int16_t row[(W) + 1];                                                                \
+		for (int j = 0; j <= (W); ++j)                                                       \
+			row[j] = (int16_t)(INSERTION_COST * j);                                          \
+		for (size_t i = 0; i < M; ++i)                                                       \
+		{                                                                                    \
+			unsigned char x = (unsigned char)CharToBase((unsigned char)X[i]);                \
+			if (x == SKIP_BASE) /* une ligne qui n'est pas une base ne change rien */        \
+				continue;                                                                    \
+			const int16_t *cost = profile[x];                                                \
+			int16_t diag = row[0];                                                           \
+			int16_t left = (int16_t)(row[0] + INSERTION_COST);                               \
+			row[0] = left;                                                                   \
+			_Pragma("GCC unroll 64") for (int j = 1; j <= (W); ++j)                          \
+			{                                                                                \
+				int16_t up = row[j];                                                         \
+				int16_t ins = (int16_t)(((up < left) ? up : left) + INSERTION_COST);         \
+				int16_t sub = (int16_t)(diag + cost[j - 1]);                                 \
+				diag = up;                                                                   \
+				left = (ins < sub) ? ins : sub;                                              \
+				row[j] = left;                                                               \
+			}                                                                                \
+		}                                                                                    \
+		return row[n];                                                                       \
+	}
+
+NW_SHORT_CHAIN_KERNEL(16)
+NW_SHORT_CHAIN_KERNEL(32)
+NW_SHORT_KERNEL(64)
+NW_SHORT_KERNEL(128)
+
+/* EditDistance_NW_short : dispatch on the length class of the shortest sequence.
+ * See .h file for documentation
+ */
+long EditDistance_NW_short(char *A, size_t lengthA, char *B, size_t lengthB)
+{
+	const char *X = A, *Y = B;
+	size_t M = lengthA, N = lengthB;
+	if (lengthA < lengthB) /* X is the longest sequence, Y the shortest */
+	{
+		X = B;
+		M = lengthB;
+		Y = A;
+		N = lengthA;
+	}
+	unsigned char y[NW_SHORT_MAX_N + 1] = {0}; /* y[1..n] : bases of Y, the padding is never read for row[n] */
+	size_t n = 0;
+	for (size_t j = 0; j < N; ++j)
+	{
+		unsigned char b = (unsigned char)CharToBase((unsigned char)Y[j]);
+		if (b != SKIP_BASE)
+			y[++n] = b;
+	}
+	if (n <= 16)
+		return _nw_short_16(X, M, y, n);
+	if (n <= 32)
+		return _nw_short_32(X, M, y, n);
+	if (n <= 64)
+		return _nw_short_64(X, M, y, n);
+	return _nw_short_128(X, M, y, n);
+}
@@ -0,0 +1,320 @@
+/**
+ * \file Needleman-Wunsch-tiled.c
+ * \brief hierarchical cache aware implementation of Needleman-Wunsch: nested tiles for L1, L2 and the LLC
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see Needleman-Wunsch-recmemo.h
+ *
+ * Notations: D[i][j] is the distance between the prefixes X[0..i-1] and Y[0..j-1] (0 <= i <= M, 0 <= j <= N).
+ * The boundaries are stored in two arrays shared by all the tiles:
+ *    row[j] (1 <= j <= N) : D[i][j] for the last row i computed above column j,
+ *    col[i] (1 <= i <= M) : D[i][j] for the last column j computed left of row i.
+ * A tile of rows i0+1..i0+h and columns j0+1..j0+w receives its corner D[i0][j0] as a parameter, reads its
+ * top boundary in row[j0+1..j0+w] and its left boundary in col[i0+1..i0+h], and replaces them by its bottom
+ * and right boundaries. Inside a tile, the sub-tiles are computed in row-major order; the corner of each
+ * sub-tile is read in row or col before the sub-tile on its left (resp. above) overwrites it.
+ */
+
+#include "Needleman-Wunsch-recmemo.h"
+#include "Needleman-Wunsch-kernel.h" /* tile kernels */
+#include "probes.h"					 /* USDT probes */
+#include "arena.h"					 /* row and col */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>	 /* for strncmp */
+#include <unistd.h>	 /* for sysconf */
+#include <pthread.h> /* for pthread_once */
+
+#include "characters_to_base.h" /* mapping from char to base */
+
+/*****************************************************************************/
+/* Cache sizes */
+
+/*
+ * static size_t _parse_size(const char *s)
+ * \brief parses a size in bytes with an optional suffix K, M or G (as in sysfs and tuning files)
+ */
+static size_t _parse_size(const char *s)
+{
+	char *end;
+	size_t v = strtoul(s, &end, 10);
+	switch (*end)
+	{
+	case 'k':
+	case 'K':
+		return v << 10;
+	case 'm':
+	case 'M':
+		return v << 20;
+	case 'g':
+	case 'G':
+		return v << 30;
+	default:
+		return v;
+	}
+}
+
+/*
+ * static int _read_line(const char *path, char *buf, size_t size)
+ * \brief reads the first line of file path in buf; returns 0 on success
+ */
+static int _read_line(const char *path, char *buf, size_t size)
+{
+	FILE *f = fopen(path, "r");
+	if (f == NULL)
+		return -1;
+	char *res = fgets(buf, (int)size, f);
+	fclose(f);
+	return (res == NULL) ? -1 : 0;
+}
+
+/*
+ * static int _count_cpus(const char *list)
+ * \brief returns the number of cpus in a sysfs cpu list such as "0-7,16-23"
+ */
+static int _count_cpus(const char *list)
+{
+	int n = 0;
+	while (*list != '\0' && *list != '\n')
+	{
+		char *end;
+		long first = strtol(list, &end, 10);
+		long last = first;
+		if (end == list)
+			break;
+		if (*end == '-')
+			last = strtol(end + 1, &end, 10);
+		n += (int)(last - first + 1);
+		list = (*end == ',') ? end + 1 : end;
+	}
+	return (n < 1) ? 1 : n;
+}
+
+/*
+ * static void _detect_sysfs(struct NW_CacheLevels *levels)
+ * \brief reads the data and unified caches of cpu0 in sysfs
+ */
+static void _detect_sysfs(struct NW_CacheLevels *levels)
+{
+	for (int index = 0; index < 8; ++index)
+	{
+		char path[128], buf[256];
+		int level;
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/level", index);
+		if (_read_line(path, buf, sizeof(buf)) != 0)
+			break;
+		level = atoi(buf);
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/type", index);
+		if (_read_line(path, buf, sizeof(buf)) != 0 || strncmp(buf, "Instruction", 11) == 0)
+			continue;
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", index);
+		if (_read_line(path, buf, sizeof(buf)) != 0)
+			continue;
+		size_t size = _parse_size(buf);
+		if (level == 1)
+			levels->l1 = size;
+		else if (level == 2)
+			levels->l2 = size;
+		else if (level >= 3)
+		{
+			snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/shared_cpu_list", index);
+			if (_read_line(path, buf, sizeof(buf)) == 0)
+				size /= (size_t)_count_cpus(buf);
+			levels->llc = size;
+		}
+	}
+}
+
+/*
+ * static void _read_tuning_file(const char *path, struct NW_CacheLevels *levels)
+ * \brief overrides the sizes given in the tuning file path (lines "l1 48K", "l2 2M", "llc 4M")
+ */
+static void _read_tuning_file(const char *path, struct NW_CacheLevels *levels)
+{
+	FILE *f = fopen(path, "r");
+	if (f == NULL)
+	{
+		fprintf(stderr, "Warning: tuning file %s cannot be read; cache sizes are detected.\n", path);
+		return;
+	}
+	char line[256], key[64], value[64];
+	while (fgets(line, sizeof(line), f) != NULL)
+	{
+		char *comment = strchr(line, '#');
+		if (comment != NULL)
+			*comment = '\0';
+		if (sscanf(line, "%63s %63s", key, value) != 2)
+			continue;
+		if (strcmp(key, "l1") == 0)
+			levels->l1 = _parse_size(value);
+		else if (strcmp(key, "l2") == 0)
+			levels->l2 = _parse_size(value);
+		else if (strcmp(key, "llc") == 0)
+			levels->llc = _parse_size(value);
+	}
+	fclose(f);
+}
+
+/* NW_CacheLevelsDetect : see .h file for documentation
+ */
+void NW_CacheLevelsDetect(struct NW_CacheLevels *levels)
+{
+	levels->l1 = levels->l2 = levels->llc = 0;
+	_detect_sysfs(levels);
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+	if (levels->l1 == 0 && sysconf(_SC_LEVEL1_DCACHE_SIZE) > 0)
+		levels->l1 = (size_t)sysconf(_SC_LEVEL1_DCACHE_SIZE);
+	if (levels->l2 == 0 && sysconf(_SC_LEVEL2_CACHE_SIZE) > 0)
+		levels->l2 = (size_t)sysconf(_SC_LEVEL2_CACHE_SIZE);
+	if (levels->llc == 0 && sysconf(_SC_LEVEL3_CACHE_SIZE) > 0)
+		levels->llc = (size_t)sysconf(_SC_LEVEL3_CACHE_SIZE) / (size_t)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if (levels->l1 == 0)
+		levels->l1 = 32 << 10;
+	if (levels->l2 == 0)
+		levels->l2 = 1 << 20;
+	if (levels->llc == 0)
+		levels->llc = 2 << 20;
+	const char *tuning = getenv(NW_TUNING_FILE_ENV);
+	if (tuning != NULL && *tuning != '\0')
+		_read_tuning_file(tuning, levels);
+}
+
+/* cache sizes detected once for all the calls with levels == NULL */
+static struct NW_CacheLevels _detected_levels;
+static pthread_once_t _detected_once = PTHREAD_ONCE_INIT;
+
+static void _detect_once(void)
+{
+	NW_CacheLevelsDetect(&_detected_levels);
+}
+
+/*****************************************************************************/
+/* Tiles */
+
+/** \struct NW_TiledContext
+ * \brief data shared by all the tiles of one computation
+ */
+struct NW_TiledContext
+{
+	const char *X; /*!< the longest genetic sequence, along the rows */
+	const char *Y; /*!< the shortest genetic sequence, along the columns */
+	long *row;	   /*!< row[1..N] : bottom boundary of the last tiles computed */
+	long *col;	   /*!< col[1..M] : right boundary of the last tiles computed */
+	size_t side[3]; /*!< side of the tiles of each level: side[0] for L1, side[1] for L2, side[2] for LLC */
+	const struct NW_Kernel *kernel; /*!< computes the micro tiles */
+};
+
+/*
+ * static void _tile(struct NW_TiledContext *c, int level, size_t i0, size_t h, size_t j0, size_t w, long corner)
+ * \brief computes the tile of rows i0+1..i0+h and columns j0+1..j0+w by sub-tiles of level level-1
+ */
+static void _tile(struct NW_TiledContext *c, int level, size_t i0, size_t h, size_t j0, size_t w, long corner)
+{
+	if (level < 0)
+	{
+		c->kernel->tile(c->X + i0, h, c->Y + j0, w, corner, c->row + j0 + 1, c->col + i0 + 1);
+		return;
+	}
+	size_t side = c->side[level];
+	NW_PROBE4(tile_start, level, i0, j0, h * w);
+	for (size_t i = 0; i < h; i += side)
+	{
+		size_t hs = (h - i < side) ? h - i : side;
+		long next_row_corner = c->col[i0 + i + hs]; // D[i0+i+hs][j0], overwritten by the first sub-tile
+		long sub_corner = corner;
+		for (size_t j = 0; j < w; j += side)
+		{
+			size_t ws = (w - j < side) ? w - j : side;
+			long next_corner = c->row[j0 + j + ws]; // D[i0+i][j0+j+ws], overwritten by this sub-tile
+			_tile(c, level - 1, i0 + i, hs, j0 + j, ws, sub_corner);
+			sub_corner = next_corner;
+		}
+		corner = next_row_corner;
+	}
+	NW_PROBE3(tile_end, level, i0, j0);
+}
+
+/*
+ * static size_t _tile_side(size_t cache, size_t inner)
+ * \brief side of a square tile using half of the cache (9 bytes per boundary cell), multiple of the inner side
+ */
+static size_t _tile_side(size_t cache, size_t inner)
+{
+	size_t side = cache / (2 * 2 * (sizeof(long) + sizeof(char)));
+	if (side < inner)
+		return inner;
+	return side - side % inner;
+}
+
+/* EditDistance_NW_cache_multilevel : three levels of tiles.
+ * See .h file for documentation
+ */
+long EditDistance_NW_cache_multilevel(char *A, size_t lengthA, char *B, size_t lengthB, const struct NW_CacheLevels *levels)
+{
+	return EditDistance_NW_cache_multilevel_profile(A, lengthA, B, lengthB, levels, NULL);
+}
+
+/* EditDistance_NW_cache_multilevel_profile : row and col are the last row and column at the end.
+ * See .h file for documentation
+ */
+long EditDistance_NW_cache_multilevel_profile(char *A, size_t lengthA, char *B, size_t lengthB, const struct NW_CacheLevels *levels,
+											  const struct NW_Profile *profile)
+{
+	struct NW_TiledContext ctx;
+	struct NW_Profile xy;
+	size_t M, N;
+	NW_ProfileOrient(profile, lengthA < lengthB, &xy);
+	ctx.kernel = NW_DefaultKernel();
+	if (lengthA >= lengthB) /* X is the longest sequence, Y the shortest */
+	{
+		ctx.X = A;
+		M = lengthA;
+		ctx.Y = B;
+		N = lengthB;
+	}
+	else
+	{
+		ctx.X = B;
+		M = lengthB;
+		ctx.Y = A;
+		N = lengthA;
+	}
+	if (levels == NULL)
+	{
+		pthread_once(&_detected_once, _detect_once);
+		levels = &_detected_levels;
+	}
+	ctx.side[0] = _tile_side(levels->l1, 16);
+	ctx.side[1] = _tile_side(levels->l2, ctx.side[0]);
+	ctx.side[2] = _tile_side(levels->llc, ctx.side[1]);
+
+	struct NW_ArenaMark mark = NW_ArenaGet();
+	ctx.row = (long *)NW_ArenaAlloc((N + 1) * sizeof(long));
+	ctx.col = (long *)NW_ArenaAlloc((M + 1) * sizeof(long));
+	// bordures : première ligne et première colonne
+	ctx.row[0] = ctx.col[0] = 0;
+	for (size_t j = 1; j <= N; ++j)
+		ctx.row[j] = ctx.row[j - 1] + (isBase(ctx.Y[j - 1]) ? INSERTION_COST : 0);
+	for (size_t i = 1; i <= M; ++i)
+		ctx.col[i] = ctx.col[i - 1] + (isBase(ctx.X[i - 1]) ? INSERTION_COST : 0);
+	long first_col = ctx.col[M], first_row = ctx.row[N]; // D[M][0] et D[0][N]
+
+	long res;
+	if (N == 0)
+		res = ctx.col[M];
+	else
+	{
+		_tile(&ctx, 2, 0, M, 0, N, 0);
+		res = ctx.row[N]; // D[M][N]
+	}
+	ctx.row[0] = first_col; // dernière ligne D[M][0..N] et dernière colonne D[0..M][N]
+	ctx.col[0] = first_row;
+	for (size_t j = 0; j <= N; ++j)
+		NW_PROFILE_PUT(&xy, row, j, ctx.row[j]);
+	for (size_t i = 0; i <= M; ++i)
+		NW_PROFILE_PUT(&xy, col, i, ctx.col[i]);
+	NW_ArenaRelease(mark);
+	return res;
+}
@@ -0,0 +1,161 @@
+/**
+ * \file Needleman-Wunsch-traceback.c
+ * \brief optimal alignment from a table of 2 bit moves laid out by anti-diagonals
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see Needleman-Wunsch-traceback.h
+ * Costs are the ones of the tile kernels: INSERTION_COST for an insertion, SUBSTITUTION_COST between two
+ * different bases (the unknown base N matches N); a char that is not a base is skipped.
+ */
+
+#include "Needleman-Wunsch-traceback.h"
+#include "Needleman-Wunsch-recmemo.h" /* for the costs */
+#include "arena.h"					  /* table of moves and anti-diagonals */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h> /* for int32_t */
+
+#include "characters_to_base.h" /* mapping from char to base */
+
+/*
+ * static size_t _diagonal_bytes(size_t M, size_t N, size_t d)
+ * \brief bytes of the moves of the anti-diagonal d of the table of (M + 1) x (N + 1) cells
+ */
+static size_t _diagonal_bytes(size_t M, size_t N, size_t d)
+{
+	size_t ilo = (d > N) ? d - N : 0, ihi = (d < M) ? d : M;
+	return (ihi - ilo + 1 + 3) / 4;
+}
+
+/* NW_TracebackBytes : see .h file for documentation
+ */
+size_t NW_TracebackBytes(size_t lengthA, size_t lengthB)
+{
+	size_t bytes = 0;
+	for (size_t d = 0; d <= lengthA + lengthB; ++d)
+		bytes += _diagonal_bytes(lengthA, lengthB, d);
+	return bytes + (lengthA + lengthB + 2) * sizeof(size_t) + 3 * (lengthA + 1) * sizeof(int32_t) + 2 * lengthA +
+		   lengthB + 6;
+}
+
+/* EditDistance_NW_traceback : see .h file for documentation
+ */
+long EditDistance_NW_traceback(const char *A, size_t lengthA, const char *B, size_t lengthB, unsigned char *moves,
+							   size_t *nmoves)
+{
+	size_t M = lengthA, N = lengthB;
+	struct NW_ArenaMark mark = NW_ArenaGet();
+	// off[d] = position of the anti-diagonal d in the table of moves
+	size_t *off = (size_t *)NW_ArenaAlloc((M + N + 2) * sizeof(size_t));
+	off[0] = 0;
+	for (size_t d = 0; d <= M + N; ++d)
+		off[d + 1] = off[d] + _diagonal_bytes(M, N, d);
+	unsigned char *table = (unsigned char *)NW_ArenaAlloc(off[M + N + 1]);
+	unsigned char *xb = (unsigned char *)NW_ArenaAlloc(M + 1), *yr = (unsigned char *)NW_ArenaAlloc(N + 1);
+	unsigned char *cell = (unsigned char *)NW_ArenaAlloc(M + 4); // moves of an anti-diagonal, 1 per byte
+	// the values of 3 anti-diagonals: int32_t (less than 2 (M + N), the table of M N / 4 bytes being smaller
+	// than the memory), so that the vectors of SSE2 hold 4 cells
+	int32_t *pp = (int32_t *)NW_ArenaAlloc(3 * (M + 1) * sizeof(int32_t)), *p = pp + (M + 1), *c = p + (M + 1);
+	for (size_t i = 0; i < M; ++i)
+		xb[i] = (unsigned char)CharToBase((unsigned char)A[i]);
+	for (size_t k = 0; k < N; ++k) // B reversed, so that the chars B[d - i - 1] of an anti-diagonal are contiguous
+		yr[N - 1 - k] = (unsigned char)CharToBase((unsigned char)B[k]);
+
+	// the anti-diagonals are indexed by row: c[i] = D[i][d - i], p and pp the anti-diagonals d-1 and d-2
+	for (size_t d = 0; d <= M + N; ++d)
+	{
+		size_t ilo = (d > N) ? d - N : 0, ihi = (d < M) ? d : M;
+		if (ilo == 0) // first row
+		{
+			c[0] = (d == 0) ? 0 : p[0] + ((yr[N - d] == SKIP_BASE) ? 0 : INSERTION_COST);
+			cell[0] = NW_MOVE_LEFT;
+		}
+		if (ihi == d && d > 0) // first column
+		{
+			c[d] = p[d - 1] + ((xb[d - 1] == SKIP_BASE) ? 0 : INSERTION_COST);
+			cell[d - ilo] = NW_MOVE_UP;
+		}
+		size_t rlo = (ilo > 0) ? ilo : 1, rhi = (ihi < d) ? ihi + 1 : d;
+		for (size_t i = rlo; i < rhi; ++i) // no dependency and no branch: vectorized
+		{
+			unsigned char x = xb[i - 1], b = yr[N - d + i]; // A[i-1] and B[j-1]
+			int32_t up = p[i - 1], lf = p[i];
+			int32_t v = pp[i - 1] + ((x == b) ? 0 : SUBSTITUTION_COST);
+			int32_t m = NW_MOVE_DIAGONAL;
+			int32_t u = up + INSERTION_COST, l = lf + INSERTION_COST;
+			m = (u < v) ? NW_MOVE_UP : m;
+			v = (u < v) ? u : v;
+			m = (l < v) ? NW_MOVE_LEFT : m;
+			v = (l < v) ? l : v;
+			m = (b == SKIP_BASE) ? NW_MOVE_LEFT : m; /* une colonne qui n'est pas une base recopie son voisin gauche */
+			v = (b == SKIP_BASE) ? lf : v;
+			m = (x == SKIP_BASE) ? NW_MOVE_UP : m; /* une ligne qui n'est pas une base recopie la ligne du dessus */
+			v = (x == SKIP_BASE) ? up : v;
+			c[i] = v;
+			cell[i - ilo] = (unsigned char)m;
+		}
+		size_t n = ihi - ilo + 1;
+		cell[n] = cell[n + 1] = cell[n + 2] = 0;
+		unsigned char *moves_d = table + off[d];
+		for (size_t k = 0; k < n; k += 4)
+			moves_d[k / 4] = (unsigned char)(cell[k] | (cell[k + 1] << 2) | (cell[k + 2] << 4) | (cell[k + 3] << 6));
+
+		int32_t *t = pp;
+		pp = p;
+		p = c;
+		c = t;
+	}
+	long res = p[M];
+
+	size_t i = M, j = N, n = 0;
+	while (i > 0 || j > 0)
+	{
+		size_t d = i + j, k = i - ((d > N) ? d - N : 0);
+		unsigned char m = (table[off[d] + k / 4] >> (2 * (k % 4))) & 3;
+		moves[n++] = m;
+		if (m != NW_MOVE_LEFT)
+			--i;
+		if (m != NW_MOVE_UP)
+			--j;
+	}
+	for (size_t k = 0; k < n / 2; ++k) // from the first move
+	{
+		unsigned char t = moves[k];
+		moves[k] = moves[n - 1 - k];
+		moves[n - 1 - k] = t;
+	}
+	*nmoves = n;
+	NW_ArenaRelease(mark);
+	return res;
+}
+
+/* NW_WriteCigar : see .h file for documentation
+ */
+void NW_WriteCigar(FILE *out, const char *A, const char *B, const unsigned char *moves, size_t nmoves)
+{
+	size_t i = 0, j = 0, run = 0;
+	char last = '\0';
+	for (size_t k = 0; k < nmoves; ++k)
+	{
+		char op;
+		if (moves[k] == NW_MOVE_DIAGONAL)
+			op = isSameBase(A[i++], B[j++]) ? '=' : 'X';
+		else if (moves[k] == NW_MOVE_UP)
+			op = isBase(A[i++]) ? 'D' : '\0';
+		else
+			op = isBase(B[j++]) ? 'I' : '\0';
+		if (op == '\0' || op == last)
+		{
+			run += (op != '\0');
+			continue;
+		}
+		if (run > 0)
+			fprintf(out, "%zu%c", run, last);
+		last = op;
+		run = 1;
+	}
+	if (run > 0)
+		fprintf(out, "%zu%c", run, last);
+	fputc('\n', out);
+}
@@ -0,0 +1,60 @@
+/**
+ * \file Needleman-Wunsch-traceback.h
+ * \brief optimal alignment from a table of 2 bit moves laid out by anti-diagonals
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Notations: D[i][j] is the distance between the prefixes A[0..i-1] and B[0..j-1].
+ * The traceback does not need the values of D but only the move giving each cell: from the diagonal,
+ * from the cell above (A[i-1] is deleted) or from the cell on the left (B[j-1] is inserted). The cells
+ * are computed anti-diagonal by anti-diagonal as by the antidiag kernel (cf Needleman-Wunsch-kernel.h),
+ * with three anti-diagonals of values, and the move of each cell is stored on 2 bits: anti-diagonal d,
+ * the cells (i, d - i) by increasing i, starts on a byte, so that the moves of an anti-diagonal are
+ * written in a row. The table takes (lengthA + 1) (lengthB + 1) / 4 bytes instead of 8 bytes per cell
+ * for a table of long (EditDistance_NW_Rec): about 10 GB for two sequences of 200 kbp.
+ *
+ * The path is returned as its moves from (0, 0) to (lengthA, lengthB). The chars that are not bases are
+ * skipped (a move up or left at no cost); a tie is broken as in the traceback of divergence.c: the
+ * diagonal first, then up, then left.
+ */
+
+#ifndef __NEEDLEMAN_WUNSCH_TRACEBACK_H__
+#define __NEEDLEMAN_WUNSCH_TRACEBACK_H__
+
+#include <stdio.h>	/* for FILE */
+#include <stdlib.h> /* for size_t */
+
+/** \enum NW_Move
+ * \brief move of the path to a cell, as stored on 2 bits
+ */
+enum NW_Move
+{
+	NW_MOVE_DIAGONAL = 0, /*!< A[i-1] aligned with B[j-1]: match or substitution */
+	NW_MOVE_UP = 1,		  /*!< A[i-1] deleted (or skipped if it is not a base) */
+	NW_MOVE_LEFT = 2,	  /*!< B[j-1] inserted (or skipped if it is not a base) */
+};
+
+/**
+ * \fn size_t NW_TracebackBytes(size_t lengthA, size_t lengthB);
+ * \brief returns the memory (in bytes) used by EditDistance_NW_traceback with these lengths
+ */
+size_t NW_TracebackBytes(size_t lengthA, size_t lengthB);
+
+/**
+ * \fn long EditDistance_NW_traceback(const char *A, size_t lengthA, const char *B, size_t lengthB, unsigned char *moves, size_t *nmoves);
+ * \brief computes the edit distance between A[0 .. lengthA-1] and B[0 .. lengthB-1] and an optimal path
+ * \param moves : receives the moves (enum NW_Move) of the path, from the first one; at most lengthA + lengthB
+ * \param nmoves : receives the number of moves
+ * \return : the edit distance, as EditDistance_NW
+ */
+long EditDistance_NW_traceback(const char *A, size_t lengthA, const char *B, size_t lengthB, unsigned char *moves,
+							   size_t *nmoves);
+
+/**
+ * \fn void NW_WriteCigar(FILE *out, const char *A, const char *B, const unsigned char *moves, size_t nmoves);
+ * \brief writes the path as an extended CIGAR string of the bases, A being the reference: runs of = (match),
+ * X (substitution), D (base of A deleted) and I (base of B inserted); the skipped chars are not written
+ */
+void NW_WriteCigar(FILE *out, const char *A, const char *B, const unsigned char *moves, size_t nmoves);
+
+#endif /* __NEEDLEMAN_WUNSCH_TRACEBACK_H__ */
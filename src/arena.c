@@ -0,0 +1,177 @@
+/**
+ * \file arena.c
+ * \brief per thread arena (bump allocator) of the temporary memory of the engines
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see arena.h
+ */
+
+#include "arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+/** \struct _chunk
+ * \brief a chunk of an arena, followed by its size bytes
+ */
+struct _chunk
+{
+	struct _chunk *next; /*!< following chunk (in use after this one, or free) */
+	size_t size;		 /*!< bytes of the chunk */
+	size_t used;		 /*!< bytes allocated */
+	char pad[40];		 /*!< the data start on a cache line */
+};
+
+/** \struct _arena
+ * \brief chunks of a thread: first .. current are in use, the ones after current are free
+ */
+struct _arena
+{
+	struct _chunk *first;
+	struct _chunk *current; /*!< NULL if nothing is allocated */
+	size_t mallocs;			/*!< chunks allocated since the thread started */
+	int registered;			/*!< 1 once the destructor is registered */
+};
+
+static __thread struct _arena _arena;
+static pthread_key_t _key;
+static pthread_once_t _key_once = PTHREAD_ONCE_INIT;
+
+/*
+ * static void _free_chunks(void *arg)
+ * \brief frees the chunks of an arena (destructor of the thread)
+ */
+static void _free_chunks(void *arg)
+{
+	struct _arena *a = (struct _arena *)arg;
+	for (struct _chunk *c = a->first, *next; c != NULL; c = next)
+	{
+		next = c->next;
+		free(c);
+	}
+	a->first = a->current = NULL;
+}
+
+/*
+ * static void _create_key(void)
+ * \brief creates the key whose destructor frees the chunks of the exiting threads
+ */
+static void _create_key(void)
+{
+	pthread_key_create(&_key, _free_chunks);
+}
+
+/* NW_ArenaGet : see .h file for documentation
+ */
+struct NW_ArenaMark NW_ArenaGet(void)
+{
+	struct NW_ArenaMark mark = {_arena.current, (_arena.current == NULL) ? 0 : _arena.current->used};
+	return mark;
+}
+
+/* NW_ArenaAlloc : see .h file for documentation
+ */
+void *NW_ArenaAlloc(size_t size)
+{
+	struct _arena *a = &_arena;
+	size = (size + 63) & ~(size_t)63;
+	struct _chunk *c = a->current;
+	if (c != NULL && c->size - c->used >= size)
+	{
+		void *p = (char *)(c + 1) + c->used;
+		c->used += size;
+		return p;
+	}
+
+	// the next free chunk, if it is large enough, else a new chunk in its place
+	struct _chunk **link = (c == NULL) ? &a->first : &c->next;
+	struct _chunk *next = *link;
+	if (next == NULL || next->size < size)
+	{
+		size_t bytes = (c == NULL) ? NW_ARENA_CHUNK : 2 * c->size;
+		if (bytes < size)
+			bytes = size;
+		struct _chunk *fresh = NULL;
+		if (posix_memalign((void **)&fresh, 64, sizeof(struct _chunk) + bytes) != 0)
+		{
+			perror("NW_ArenaAlloc: malloc of a chunk");
+			exit(EXIT_FAILURE);
+		}
+		fresh->size = bytes;
+		fresh->next = NULL;
+		for (struct _chunk *f = next, *n; f != NULL; f = n) // the free chunks too small are given back
+		{
+			n = f->next;
+			free(f);
+		}
+		*link = next = fresh;
+		a->mallocs++;
+		if (!a->registered)
+		{
+			pthread_once(&_key_once, _create_key);
+			pthread_setspecific(_key, a);
+			a->registered = 1;
+		}
+	}
+	next->used = size;
+	a->current = next;
+	return next + 1;
+}
+
+/* NW_ArenaRelease : see .h file for documentation
+ */
+void NW_ArenaRelease(struct NW_ArenaMark mark)
+{
+	struct _arena *a = &_arena;
+	if (mark.chunk == NULL)
+	{
+		if (a->first != NULL)
+			a->first->used = 0;
+		a->current = NULL;
+		return;
+	}
+	a->current = (struct _chunk *)mark.chunk;
+	a->current->used = mark.used;
+}
+
+/* NW_ArenaReset : see .h file for documentation
+ */
+void NW_ArenaReset(size_t keep)
+{
+	struct _arena *a = &_arena;
+	if (keep == 0)
+		keep = NW_ARENA_KEEP;
+	a->current = NULL;
+	size_t total = 0;
+	struct _chunk **link = &a->first;
+	while (*link != NULL)
+	{
+		struct _chunk *c = *link;
+		if (total + c->size > keep)
+		{
+			*link = c->next;
+			free(c);
+		}
+		else
+		{
+			total += c->size;
+			c->used = 0;
+			link = &c->next;
+		}
+	}
+}
+
+/* NW_ArenaStats : see .h file for documentation
+ */
+void NW_ArenaStats(size_t *chunks, size_t *bytes, size_t *mallocs)
+{
+	*chunks = *bytes = 0;
+	for (struct _chunk *c = _arena.first; c != NULL; c = c->next)
+	{
+		++*chunks;
+		*bytes += c->size;
+	}
+	*mallocs = _arena.mallocs;
+}
@@ -0,0 +1,77 @@
+/**
+ * \file arena.h
+ * \brief per thread arena (bump allocator) of the temporary memory of the engines
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Each thread allocates its work buffers (tables, rows and columns, reversed sequences) by bumping a
+ * pointer in its own chunks of memory, which are kept from one job to the next: once the chunks are large
+ * enough for the jobs of a batch, computing a pair performs no call to malloc, hence no contention on the
+ * locks of the heap between the workers. The buffers are freed in LIFO order, by going back to a mark:
+ *
+ *     struct NW_ArenaMark mark = NW_ArenaGet();
+ *     long *row = (long *)NW_ArenaAlloc((N + 1) * sizeof(long));
+ *     ...
+ *     NW_ArenaRelease(mark);
+ *
+ * The workers of the scheduler call NW_ArenaReset between their jobs, so that a thread keeps at most
+ * NW_ARENA_KEEP bytes after a large job. The chunks of a thread are freed when it exits.
+ */
+
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stdlib.h> /* for size_t */
+
+/** \def NW_ARENA_CHUNK
+ *  \brief minimal size of a chunk
+ */
+#define NW_ARENA_CHUNK (1 << 20)
+
+/** \def NW_ARENA_KEEP
+ *  \brief bytes of chunks kept by NW_ArenaReset(0)
+ */
+#define NW_ARENA_KEEP (64 << 20)
+
+/** \struct NW_ArenaMark
+ * \brief state of the arena of the calling thread, to go back to
+ */
+struct NW_ArenaMark
+{
+	void *chunk; /*!< chunk in use (NULL: none) */
+	size_t used; /*!< bytes used in it */
+};
+
+/**
+ * \fn struct NW_ArenaMark NW_ArenaGet(void);
+ * \brief returns the current state of the arena of the calling thread
+ */
+struct NW_ArenaMark NW_ArenaGet(void);
+
+/**
+ * \fn void *NW_ArenaAlloc(size_t size);
+ * \brief returns size bytes aligned on 64 bytes (a cache line) from the arena of the calling thread
+ *
+ * Exits (with a message on stderr) if a new chunk cannot be allocated, as the engines on malloc failures.
+ */
+void *NW_ArenaAlloc(size_t size);
+
+/**
+ * \fn void NW_ArenaRelease(struct NW_ArenaMark mark);
+ * \brief frees all the buffers allocated by the calling thread since mark was got (the chunks are kept)
+ */
+void NW_ArenaRelease(struct NW_ArenaMark mark);
+
+/**
+ * \fn void NW_ArenaReset(size_t keep);
+ * \brief frees all the buffers of the calling thread, and its chunks beyond keep bytes (0 for NW_ARENA_KEEP)
+ */
+void NW_ArenaReset(size_t keep);
+
+/**
+ * \fn void NW_ArenaStats(size_t *chunks, size_t *bytes, size_t *mallocs);
+ * \brief returns the chunks of the calling thread, their bytes and the chunks it allocated since it started
+ */
+void NW_ArenaStats(size_t *chunks, size_t *bytes, size_t *mallocs);
+
+#endif /* __ARENA_H__ */
@@ -0,0 +1,983 @@
+/**
+ * \file arrow_ipc.c
+ * \brief Apache Arrow IPC files and streams: columns of sequences and of indexes, column of distances
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see arrow_ipc.h
+ */
+
+#include "arrow_ipc.h"
+#include "batch.h" /* for NW_RunPairs */
+
+#include <stdio.h>
+#include <string.h> /* for memcpy, memcmp and strerror */
+#include <errno.h>
+#include <fcntl.h>	  /* for open */
+#include <unistd.h>	  /* for close */
+#include <sys/mman.h> /* for mmap */
+#include <sys/stat.h> /* for fstat */
+
+/** \enum _MessageHeader
+ * \brief union MessageHeader of Message.fbs
+ */
+enum _MessageHeader
+{
+	_SCHEMA = 1,
+	_DICTIONARY_BATCH = 2,
+	_RECORD_BATCH = 3,
+};
+
+/** \enum _Type
+ * \brief union Type of Schema.fbs (the ones whose buffers are counted)
+ */
+enum _Type
+{
+	_NULL = 1,
+	_INT = 2,
+	_BINARY = 4,
+	_UTF8 = 5,
+	_LIST = 12,
+	_STRUCT = 13,
+	_UNION = 14,
+	_FIXED_SIZE_LIST = 16,
+	_MAP = 17,
+	_LARGE_BINARY = 19,
+	_LARGE_UTF8 = 20,
+	_LARGE_LIST = 21,
+	_RUN_END_ENCODED = 22,
+	_BINARY_VIEW = 23,
+};
+
+/** \def _METADATA_V4
+ *  \brief MetadataVersion V4 of Schema.fbs (the oldest one read)
+ */
+#define _METADATA_V4 3
+
+/** \def _METADATA_V5
+ *  \brief MetadataVersion V5 of Schema.fbs (written)
+ */
+#define _METADATA_V5 4
+
+/*****************************************************************************
+ * Reading of flatbuffers, with bounds checking: positions are offsets in the whole file
+ */
+
+/** \struct _fb
+ * \brief the file; bad is set by any read out of it
+ */
+struct _fb
+{
+	const unsigned char *b;
+	size_t size;
+	int bad;
+};
+
+/*
+ * static uint64_t _rd(struct _fb *r, size_t pos, int bytes)
+ * \brief little endian unsigned integer of bytes bytes at pos (0 and r->bad set if out of the file)
+ */
+static uint64_t _rd(struct _fb *r, size_t pos, int bytes)
+{
+	if (pos > r->size || r->size - pos < (size_t)bytes)
+	{
+		r->bad = 1;
+		return 0;
+	}
+	uint64_t v = 0;
+	for (int k = bytes - 1; k >= 0; --k)
+		v = (v << 8) | r->b[pos + k];
+	return v;
+}
+
+/*
+ * static size_t _field(struct _fb *r, size_t table, int id)
+ * \brief position of the field id of the table at position table, 0 if it is absent
+ */
+static size_t _field(struct _fb *r, size_t table, int id)
+{
+	size_t vtable = table - (size_t)(int64_t)(int32_t)_rd(r, table, 4);
+	size_t vsize = (size_t)_rd(r, vtable, 2);
+	if (r->bad || 4 + 2 * (size_t)id + 2 > vsize)
+		return 0;
+	size_t offset = (size_t)_rd(r, vtable + 4 + 2 * id, 2);
+	return (offset == 0) ? 0 : table + offset;
+}
+
+/*
+ * static uint64_t _scalar(struct _fb *r, size_t table, int id, int bytes, uint64_t def)
+ * \brief value of the scalar field id (of bytes bytes) of table, def if it is absent
+ */
+static uint64_t _scalar(struct _fb *r, size_t table, int id, int bytes, uint64_t def)
+{
+	size_t f = _field(r, table, id);
+	return (f == 0) ? def : _rd(r, f, bytes);
+}
+
+/*
+ * static size_t _ref(struct _fb *r, size_t table, int id)
+ * \brief position of the object (table, vector, string) referenced by the field id of table, 0 if absent
+ */
+static size_t _ref(struct _fb *r, size_t table, int id)
+{
+	size_t f = _field(r, table, id);
+	return (f == 0) ? 0 : f + (size_t)_rd(r, f, 4);
+}
+
+/*
+ * static size_t _vector(struct _fb *r, size_t table, int id, size_t element, size_t *n)
+ * \brief position of the first element of the vector field id of table (of n elements of element bytes),
+ * 0 with n = 0 if it is absent
+ */
+static size_t _vector(struct _fb *r, size_t table, int id, size_t element, size_t *n)
+{
+	size_t v = _ref(r, table, id);
+	*n = 0;
+	if (v == 0)
+		return 0;
+	*n = (size_t)_rd(r, v, 4);
+	if (r->bad || *n > r->size / element || v + 4 > r->size || *n * element > r->size - v - 4)
+	{
+		r->bad = 1;
+		*n = 0;
+		return 0;
+	}
+	return v + 4;
+}
+
+/*
+ * static size_t _element(struct _fb *r, size_t vector, size_t k)
+ * \brief position of the table number k of a vector of tables
+ */
+static size_t _element(struct _fb *r, size_t vector, size_t k)
+{
+	size_t e = vector + 4 * k;
+	return e + (size_t)_rd(r, e, 4);
+}
+
+/*****************************************************************************
+ * Schema and record batches
+ */
+
+/*
+ * static int _buffers(struct _fb *r, size_t field, size_t *nodes, size_t *buffers, int depth)
+ * \brief adds to nodes and buffers the numbers of field nodes and of buffers of a field and its children
+ * \return : 0, or 1 if its type has a number of buffers depending on the record batch (view types) or is
+ * unknown, or if the fields are nested more than 64 levels deep
+ */
+static int _buffers(struct _fb *r, size_t field, size_t *nodes, size_t *buffers, int depth)
+{
+	unsigned type = (unsigned)_scalar(r, field, 2, 1, 0);
+	size_t type_table = _ref(r, field, 3);
+	*nodes += 1;
+	if (depth > 64 || type >= _BINARY_VIEW)
+		return 1;
+	if (_ref(r, field, 4) != 0) // dictionary encoded: the indexes
+	{
+		*buffers += 2;
+		return 0;
+	}
+	switch (type)
+	{
+	case _NULL:
+	case _RUN_END_ENCODED:
+		break;
+	case _BINARY:
+	case _UTF8:
+	case _LARGE_BINARY:
+	case _LARGE_UTF8:
+		*buffers += 3;
+		break;
+	case _STRUCT:
+	case _FIXED_SIZE_LIST:
+		*buffers += 1;
+		break;
+	case _UNION: // sparse: type ids, dense: type ids and offsets
+		*buffers += (type_table != 0 && _scalar(r, type_table, 0, 2, 0) == 1) ? 2 : 1;
+		break;
+	default: // validity and values (or offsets for the lists and maps)
+		*buffers += 2;
+		break;
+	}
+	size_t n, children = _vector(r, field, 5, 4, &n);
+	for (size_t k = 0; k < n; ++k)
+		if (_buffers(r, _element(r, children, k), nodes, buffers, depth + 1) != 0)
+			return 1;
+	return 0;
+}
+
+/*
+ * static int _schema(struct NW_Arrow *a, struct _fb *r, size_t schema)
+ * \brief reads the top level fields of the Schema table at position schema
+ */
+static int _schema(struct NW_Arrow *a, struct _fb *r, size_t schema)
+{
+	if (_scalar(r, schema, 0, 2, 0) != 0)
+	{
+		fprintf(stderr, "Error: Arrow data in big endian are not supported.\n");
+		return EXIT_FAILURE;
+	}
+	size_t n, fields = _vector(r, schema, 1, 4, &n);
+	a->fields = (struct NW_ArrowField *)calloc(n + 1, sizeof(struct NW_ArrowField));
+	if (a->fields == NULL)
+	{
+		perror("NW_ArrowOpen: malloc of the fields");
+		exit(EXIT_FAILURE);
+	}
+	a->nfields = n;
+	size_t nodes = 0, buffers = 0;
+	for (size_t k = 0; k < n; ++k)
+	{
+		struct NW_ArrowField *f = &a->fields[k];
+		size_t field = _element(r, fields, k);
+		size_t name = _ref(r, field, 0);
+		if (name != 0)
+		{
+			f->name_length = (size_t)_rd(r, name, 4);
+			f->name = (const char *)a->data + name + 4;
+			if (name + 4 + f->name_length > r->size)
+				r->bad = 1;
+		}
+		unsigned type = (unsigned)_scalar(r, field, 2, 1, 0);
+		size_t type_table = _ref(r, field, 3);
+		f->type = NW_ARROW_OTHER;
+		if (_ref(r, field, 4) == 0) // not dictionary encoded
+			switch (type)
+			{
+			case _INT:
+				if (type_table == 0)
+					break;
+				f->bits = (int)_scalar(r, type_table, 0, 4, 0);
+				f->is_signed = (int)_scalar(r, type_table, 1, 1, 0);
+				if (f->bits == 8 || f->bits == 16 || f->bits == 32 || f->bits == 64)
+					f->type = NW_ARROW_INT;
+				break;
+			case _BINARY:
+				f->type = NW_ARROW_BINARY;
+				break;
+			case _UTF8:
+				f->type = NW_ARROW_UTF8;
+				break;
+			case _LARGE_BINARY:
+				f->type = NW_ARROW_LARGE_BINARY;
+				break;
+			case _LARGE_UTF8:
+				f->type = NW_ARROW_LARGE_UTF8;
+				break;
+			}
+		f->node = nodes;
+		f->buffer = buffers;
+		if (_buffers(r, field, &nodes, &buffers, 0) != 0)
+		{
+			fprintf(stderr, "Error: the type of the Arrow field %zu (or of a child) is not supported.\n", k);
+			return EXIT_FAILURE;
+		}
+	}
+	return 0;
+}
+
+/*
+ * static int _batch(struct NW_Arrow *a, struct _fb *r, size_t batch, size_t body, size_t body_size)
+ * \brief appends the RecordBatch table at position batch, of body at position body
+ */
+static int _batch(struct NW_Arrow *a, struct _fb *r, size_t batch, size_t body, size_t body_size)
+{
+	if (_ref(r, batch, 3) != 0)
+	{
+		fprintf(stderr, "Error: compressed Arrow record batches are not supported.\n");
+		return EXIT_FAILURE;
+	}
+	if (body > a->size || a->size - body < body_size)
+	{
+		fprintf(stderr, "Error: Arrow record batch %zu exceeds the end of the data.\n", a->nbatches);
+		return EXIT_FAILURE;
+	}
+	if ((a->nbatches & (a->nbatches + 1)) == 0) // 0, 1, 3, 7...: doubles the arrays
+	{
+		size_t capacity = 2 * (a->nbatches + 1);
+		a->batches = (size_t *)realloc(a->batches, capacity * sizeof(size_t));
+		a->bodies = (size_t *)realloc(a->bodies, capacity * sizeof(size_t));
+		a->body_sizes = (size_t *)realloc(a->body_sizes, capacity * sizeof(size_t));
+		if (a->batches == NULL || a->bodies == NULL || a->body_sizes == NULL)
+		{
+			perror("NW_ArrowOpen: malloc of the record batches");
+			exit(EXIT_FAILURE);
+		}
+	}
+	a->batches[a->nbatches] = batch;
+	a->bodies[a->nbatches] = body;
+	a->body_sizes[a->nbatches++] = body_size;
+	a->rows += (size_t)_scalar(r, batch, 0, 8, 0);
+	return 0;
+}
+
+/*
+ * static size_t _message(struct _fb *r, size_t pos, size_t *message, size_t *end)
+ * \brief reads the encapsulated message at pos: sets message to the position of its Message table and end
+ * to the position of its body; returns the size of its metadata, 0 at the end of the stream
+ */
+static size_t _message(struct _fb *r, size_t pos, size_t *message, size_t *end)
+{
+	if (pos + 4 > r->size)
+		return 0;
+	size_t length = (size_t)_rd(r, pos, 4);
+	size_t prefix = 4;
+	if (length == 0xFFFFFFFF) // continuation marker (else format before 0.15)
+	{
+		length = (size_t)_rd(r, pos + 4, 4);
+		prefix = 8;
+	}
+	if (length == 0 || r->bad || length > r->size - pos - prefix)
+		return 0;
+	*message = pos + prefix + (size_t)_rd(r, pos + prefix, 4);
+	*end = pos + prefix + length;
+	return prefix + length;
+}
+
+/*
+ * static int _read_stream(struct NW_Arrow *a, struct _fb *r, size_t pos)
+ * \brief reads the messages from pos to the end of the stream
+ */
+static int _read_stream(struct NW_Arrow *a, struct _fb *r, size_t pos)
+{
+	size_t message, body;
+	int schema = 0;
+	while (_message(r, pos, &message, &body) != 0)
+	{
+		unsigned header = (unsigned)_scalar(r, message, 1, 1, 0);
+		size_t table = _ref(r, message, 2);
+		size_t body_size = (size_t)_scalar(r, message, 3, 8, 0);
+		if (r->bad || table == 0)
+			break;
+		if (_scalar(r, message, 0, 2, 0) < _METADATA_V4)
+		{
+			fprintf(stderr, "Error: Arrow metadata versions before V4 are not supported.\n");
+			return EXIT_FAILURE;
+		}
+		if (header == _SCHEMA && !schema)
+		{
+			if (_schema(a, r, table) != 0)
+				return EXIT_FAILURE;
+			schema = 1;
+		}
+		else if (header == _RECORD_BATCH && schema && _batch(a, r, table, body, body_size) != 0)
+			return EXIT_FAILURE;
+		if (body_size > r->size - body)
+			break;
+		pos = body + body_size;
+	}
+	if (!schema)
+	{
+		fprintf(stderr, "Error: no Arrow schema.\n");
+		return EXIT_FAILURE;
+	}
+	return 0;
+}
+
+/*
+ * static int _read_file(struct NW_Arrow *a, struct _fb *r)
+ * \brief reads the footer of a file and the record batches listed in it
+ */
+static int _read_file(struct NW_Arrow *a, struct _fb *r)
+{
+	size_t footer_size = (size_t)_rd(r, r->size - 10, 4);
+	if (footer_size > r->size - 18)
+	{
+		fprintf(stderr, "Error: bad Arrow footer size.\n");
+		return EXIT_FAILURE;
+	}
+	size_t start = r->size - 10 - footer_size;
+	size_t footer = start + (size_t)_rd(r, start, 4);
+	size_t schema = _ref(r, footer, 1);
+	if (r->bad || schema == 0 || _schema(a, r, schema) != 0)
+	{
+		if (r->bad || schema == 0)
+			fprintf(stderr, "Error: no Arrow schema in the footer.\n");
+		return EXIT_FAILURE;
+	}
+	size_t n, blocks = _vector(r, footer, 3, 24, &n);
+	for (size_t k = 0; k < n && !r->bad; ++k) // Block: offset, metaDataLength (int32, padded), bodyLength
+	{
+		size_t offset = (size_t)_rd(r, blocks + 24 * k, 8);
+		size_t metadata = (size_t)_rd(r, blocks + 24 * k + 8, 4);
+		size_t body_size = (size_t)_rd(r, blocks + 24 * k + 16, 8);
+		size_t message, end;
+		if (_message(r, offset, &message, &end) == 0 || _scalar(r, message, 1, 1, 0) != _RECORD_BATCH ||
+			_batch(a, r, _ref(r, message, 2), offset + metadata, body_size) != 0)
+		{
+			fprintf(stderr, "Error: bad Arrow record batch %zu.\n", k);
+			return EXIT_FAILURE;
+		}
+	}
+	return 0;
+}
+
+/* NW_ArrowOpen : see .h file for documentation
+ */
+int NW_ArrowOpen(struct NW_Arrow *a, const char *path)
+{
+	memset(a, 0, sizeof(*a));
+	if (strcmp(path, "-") == 0) // a stream: in memory
+	{
+		size_t capacity = 1 << 20;
+		unsigned char *data = (unsigned char *)malloc(capacity);
+		size_t got;
+		while (data != NULL && (got = fread(data + a->size, 1, capacity - a->size, stdin)) > 0)
+			if ((a->size += got) == capacity)
+				data = (unsigned char *)realloc(data, capacity *= 2);
+		if (data == NULL)
+		{
+			perror("NW_ArrowOpen: malloc of the stream");
+			exit(EXIT_FAILURE);
+		}
+		a->data = data;
+	}
+	else
+	{
+		int fd = open(path, O_RDONLY);
+		struct stat s;
+		if (fd < 0 || fstat(fd, &s) != 0)
+		{
+			perror(path);
+			if (fd >= 0)
+				close(fd);
+			return EXIT_FAILURE;
+		}
+		a->size = (size_t)s.st_size;
+		void *map = (a->size == 0) ? MAP_FAILED : mmap(NULL, a->size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (map == MAP_FAILED)
+		{
+			fprintf(stderr, "Error: mapping %s: %s.\n", path, (a->size == 0) ? "empty file" : strerror(errno));
+			return EXIT_FAILURE;
+		}
+		a->data = (const unsigned char *)map;
+		a->mapped = 1;
+	}
+
+	struct _fb r = {a->data, a->size, 0};
+	int status;
+	if (a->size >= 18 && memcmp(a->data, NW_ARROW_MAGIC, 6) == 0 && memcmp(a->data + a->size - 6, NW_ARROW_MAGIC, 6) == 0)
+		status = _read_file(a, &r);
+	else
+		status = _read_stream(a, &r, 0);
+	if (status == 0 && r.bad)
+	{
+		fprintf(stderr, "Error: %s: bad Arrow metadata.\n", path);
+		status = EXIT_FAILURE;
+	}
+	if (status != 0)
+	{
+		fprintf(stderr, "Error: %s is not a supported Arrow IPC file or stream.\n", path);
+		NW_ArrowClose(a);
+	}
+	return status;
+}
+
+/* NW_ArrowClose : see .h file for documentation
+ */
+void NW_ArrowClose(struct NW_Arrow *a)
+{
+	if (a->mapped)
+		munmap((void *)a->data, a->size);
+	else
+		free((void *)a->data);
+	free(a->fields);
+	free(a->batches);
+	free(a->bodies);
+	free(a->body_sizes);
+	memset(a, 0, sizeof(*a));
+}
+
+/* NW_ArrowColumn : see .h file for documentation
+ */
+long NW_ArrowColumn(const struct NW_Arrow *a, const char *name, int types, size_t skip)
+{
+	size_t wanted = skip;
+	for (size_t k = 0; k < a->nfields; ++k)
+	{
+		const struct NW_ArrowField *f = &a->fields[k];
+		if (name != NULL ? (f->name_length == strlen(name) && memcmp(f->name, name, f->name_length) == 0)
+						 : ((f->type & types) != 0 && skip-- == 0))
+		{
+			if ((f->type & types) != 0)
+				return (long)k;
+			fprintf(stderr, "Error: Arrow column %s is not of a supported type.\n", name);
+			return -1;
+		}
+	}
+	if (name != NULL)
+		fprintf(stderr, "Error: no Arrow column %s.\n", name);
+	else
+		fprintf(stderr, "Error: less than %zu Arrow columns of %s.\n", wanted + 1,
+				(types == NW_ARROW_INT) ? "integers" : "strings");
+	return -1;
+}
+
+/*
+ * static const unsigned char *_buffer(const struct NW_Arrow *a, size_t batch, size_t k, size_t *length)
+ * \brief address and length of the buffer k of a record batch, NULL if it exceeds the body
+ */
+static const unsigned char *_buffer(const struct NW_Arrow *a, size_t batch, size_t k, size_t *length)
+{
+	struct _fb r = {a->data, a->size, 0};
+	size_t n, buffers = _vector(&r, a->batches[batch], 2, 16, &n);
+	size_t offset = (size_t)_rd(&r, buffers + 16 * k, 8);
+	*length = (size_t)_rd(&r, buffers + 16 * k + 8, 8);
+	if (r.bad || k >= n || offset > a->body_sizes[batch] || *length > a->body_sizes[batch] - offset)
+		return NULL;
+	return a->data + a->bodies[batch] + offset;
+}
+
+/*
+ * static int _node(const struct NW_Arrow *a, size_t batch, const struct NW_ArrowField *f, size_t *rows, const unsigned char **validity)
+ * \brief rows of the column f in a record batch, and its validity bitmap (NULL if it has no null); the node
+ * has the length of the batch, so that the columns fill every row of the table
+ */
+static int _node(const struct NW_Arrow *a, size_t batch, const struct NW_ArrowField *f, size_t *rows,
+				 const unsigned char **validity)
+{
+	struct _fb r = {a->data, a->size, 0};
+	size_t n, nodes = _vector(&r, a->batches[batch], 1, 16, &n);
+	*rows = (size_t)_rd(&r, nodes + 16 * f->node, 8);
+	size_t nulls = (size_t)_rd(&r, nodes + 16 * f->node + 8, 8);
+	size_t length;
+	*validity = _buffer(a, batch, f->buffer, &length);
+	if (nulls == 0 || length == 0)
+		*validity = NULL;
+	if (r.bad || f->node >= n || *rows != (size_t)_scalar(&r, a->batches[batch], 0, 8, 0) ||
+		(*validity != NULL && length < (*rows + 7) / 8))
+	{
+		fprintf(stderr, "Error: bad field node %zu in Arrow record batch %zu.\n", f->node, batch);
+		return EXIT_FAILURE;
+	}
+	return 0;
+}
+
+/* NW_ArrowStrings : see .h file for documentation
+ */
+int NW_ArrowStrings(const struct NW_Arrow *a, size_t field, const char **values, size_t *lengths)
+{
+	const struct NW_ArrowField *f = &a->fields[field];
+	int width = (f->type == NW_ARROW_LARGE_BINARY || f->type == NW_ARROW_LARGE_UTF8) ? 8 : 4;
+	size_t row = 0;
+	for (size_t b = 0; b < a->nbatches; ++b)
+	{
+		size_t rows, offsets_length, data_length;
+		const unsigned char *validity;
+		if (_node(a, b, f, &rows, &validity) != 0)
+			return EXIT_FAILURE;
+		const unsigned char *offsets = _buffer(a, b, f->buffer + 1, &offsets_length);
+		const unsigned char *data = _buffer(a, b, f->buffer + 2, &data_length);
+		if (rows > a->rows - row || (rows > 0 && (offsets == NULL || data == NULL || offsets_length / width < rows + 1)))
+		{
+			fprintf(stderr, "Error: bad buffers of the column %zu in Arrow record batch %zu.\n", field, b);
+			return EXIT_FAILURE;
+		}
+		struct _fb r = {offsets, offsets_length, 0};
+		for (size_t k = 0; k < rows; ++k, ++row)
+		{
+			uint64_t begin = _rd(&r, k * width, width), end = _rd(&r, (k + 1) * width, width);
+			if (begin > end || end > data_length)
+			{
+				fprintf(stderr, "Error: bad offsets of the column %zu in Arrow record batch %zu.\n", field, b);
+				return EXIT_FAILURE;
+			}
+			int valid = (validity == NULL) || ((validity[k / 8] >> (k % 8)) & 1);
+			values[row] = valid ? (const char *)data + begin : NULL;
+			lengths[row] = valid ? (size_t)(end - begin) : 0;
+		}
+	}
+	if (row != a->rows)
+	{
+		fprintf(stderr, "Error: the column %zu of the Arrow record batches has %zu rows instead of %zu.\n", field, row,
+				a->rows);
+		return EXIT_FAILURE;
+	}
+	return 0;
+}
+
+/* NW_ArrowIntegers : see .h file for documentation
+ */
+int NW_ArrowIntegers(const struct NW_Arrow *a, size_t field, int64_t *values, unsigned char *valid)
+{
+	const struct NW_ArrowField *f = &a->fields[field];
+	int width = f->bits / 8;
+	size_t row = 0;
+	for (size_t b = 0; b < a->nbatches; ++b)
+	{
+		size_t rows, length;
+		const unsigned char *validity;
+		if (_node(a, b, f, &rows, &validity) != 0)
+			return EXIT_FAILURE;
+		const unsigned char *data = _buffer(a, b, f->buffer + 1, &length);
+		if (rows > a->rows - row || (rows > 0 && (data == NULL || length / width < rows)))
+		{
+			fprintf(stderr, "Error: bad buffers of the column %zu in Arrow record batch %zu.\n", field, b);
+			return EXIT_FAILURE;
+		}
+		struct _fb r = {data, length, 0};
+		for (size_t k = 0; k < rows; ++k, ++row)
+		{
+			uint64_t v = _rd(&r, k * width, width);
+			if (f->is_signed && width < 8 && (v >> (8 * width - 1)) != 0) // sign extension
+				v |= ~(uint64_t)0 << (8 * width);
+			values[row] = (int64_t)v;
+			valid[row] = (validity == NULL) || ((validity[k / 8] >> (k % 8)) & 1);
+		}
+	}
+	if (row != a->rows)
+	{
+		fprintf(stderr, "Error: the column %zu of the Arrow record batches has %zu rows instead of %zu.\n", field, row,
+				a->rows);
+		return EXIT_FAILURE;
+	}
+	return 0;
+}
+
+/*****************************************************************************
+ * Writing: the flatbuffers are built forwards (each object before the ones it references, whose offsets
+ * are patched once they are written), aligned from the beginning of the metadata
+ */
+
+/** \struct _fbw
+ * \brief a flatbuffer being built
+ */
+struct _fbw
+{
+	unsigned char *b;
+	size_t len;
+	size_t cap;
+};
+
+/*
+ * static size_t _put(struct _fbw *w, const void *p, size_t n)
+ * \brief appends n bytes (zeros if p is NULL), returns their position
+ */
+static size_t _put(struct _fbw *w, const void *p, size_t n)
+{
+	if (w->len + n > w->cap)
+	{
+		w->cap = 2 * (w->len + n) + 256;
+		w->b = (unsigned char *)realloc(w->b, w->cap);
+		if (w->b == NULL)
+		{
+			perror("NW_ArrowWriteInt64: malloc of the metadata");
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (p == NULL)
+		memset(w->b + w->len, 0, n);
+	else
+		memcpy(w->b + w->len, p, n);
+	w->len += n;
+	return w->len - n;
+}
+
+/*
+ * static void _wr(struct _fbw *w, size_t pos, uint64_t v, int bytes)
+ * \brief writes the little endian integer v of bytes bytes at pos
+ */
+static void _wr(struct _fbw *w, size_t pos, uint64_t v, int bytes)
+{
+	for (int k = 0; k < bytes; ++k, v >>= 8)
+		w->b[pos + k] = (unsigned char)v;
+}
+
+/*
+ * static void _pad(struct _fbw *w, size_t align, size_t rest)
+ * \brief appends zeros until the length is rest modulo align
+ */
+static void _pad(struct _fbw *w, size_t align, size_t rest)
+{
+	while (w->len % align != rest)
+		_put(w, NULL, 1);
+}
+
+/*
+ * static void _link(struct _fbw *w, size_t at, size_t target)
+ * \brief sets the offset at position at to reference the object at position target
+ */
+static void _link(struct _fbw *w, size_t at, size_t target)
+{
+	_wr(w, at, target - at, 4);
+}
+
+/** \struct _slot
+ * \brief a field of a table being written: bytes 0 if absent, 4 with ref for an offset
+ */
+struct _slot
+{
+	int bytes;
+	uint64_t value;
+	int ref;
+};
+
+/*
+ * static size_t _table(struct _fbw *w, int n, const struct _slot *slots, size_t *at)
+ * \brief writes a vtable and its table of n fields; at[k] is the position of the field k (to link the
+ * offsets); returns the position of the table
+ */
+static size_t _table(struct _fbw *w, int n, const struct _slot *slots, size_t *at)
+{
+	size_t offsets[16], size = 4;
+	for (int k = 0; k < n; ++k)
+		if (slots[k].bytes > 0)
+		{
+			size = (size + slots[k].bytes - 1) / slots[k].bytes * slots[k].bytes;
+			offsets[k] = size;
+			size += slots[k].bytes;
+		}
+	_pad(w, 2, 0);
+	size_t vtable = _put(w, NULL, 4 + 2 * n);
+	_wr(w, vtable, 4 + 2 * n, 2);
+	_wr(w, vtable + 2, size, 2);
+	for (int k = 0; k < n; ++k)
+		_wr(w, vtable + 4 + 2 * k, (slots[k].bytes > 0) ? offsets[k] : 0, 2);
+	_pad(w, 8, 0);
+	size_t table = _put(w, NULL, size);
+	_wr(w, table, table - vtable, 4);
+	for (int k = 0; k < n; ++k)
+	{
+		at[k] = (slots[k].bytes > 0) ? table + offsets[k] : 0;
+		if (slots[k].bytes > 0 && !slots[k].ref)
+			_wr(w, at[k], slots[k].value, slots[k].bytes);
+	}
+	return table;
+}
+
+/*
+ * static size_t _vector_of(struct _fbw *w, size_t n, size_t element, size_t align)
+ * \brief writes a vector of n elements of element bytes (zeros), aligned on align, returns its first element
+ */
+static size_t _vector_of(struct _fbw *w, size_t n, size_t element, size_t align)
+{
+	_pad(w, align, align - 4);
+	size_t v = _put(w, NULL, 4);
+	_wr(w, v, n, 4);
+	_put(w, NULL, n * element);
+	return v + 4;
+}
+
+/*
+ * static size_t _schema_table(struct _fbw *w, const char *name)
+ * \brief writes the Schema table of one nullable Int64 field name
+ */
+static size_t _schema_table(struct _fbw *w, const char *name)
+{
+	size_t at[6];
+	const struct _slot schema[2] = {{0, 0, 0}, {4, 0, 1}}; // endianness (little), fields
+	size_t table = _table(w, 2, schema, at);
+	size_t fields = _vector_of(w, 1, 4, 4);
+	_link(w, at[1], fields - 4);
+	const struct _slot field[6] = {{4, 0, 1}, {1, 1, 0}, {1, _INT, 0}, {4, 0, 1}, {0, 0, 0}, {4, 0, 1}};
+	size_t f = _table(w, 6, field, at); // name, nullable, type_type, type, dictionary, children
+	_link(w, fields, f);
+	size_t string = _vector_of(w, strlen(name) + 1, 1, 4);
+	memcpy(w->b + string, name, strlen(name));
+	_wr(w, string - 4, strlen(name), 4);
+	_link(w, at[0], string - 4);
+	size_t children = _vector_of(w, 0, 4, 4);
+	_link(w, at[5], children - 4);
+	size_t type_at[2];
+	const struct _slot type[2] = {{4, 64, 0}, {1, 1, 0}}; // bitWidth, is_signed
+	_link(w, at[3], _table(w, 2, type, type_at));
+	return table;
+}
+
+/*
+ * static void _message_table(struct _fbw *w, int header, size_t body_size, size_t *header_at)
+ * \brief writes the root offset and the Message table; header_at is the offset to link to the header
+ */
+static void _message_table(struct _fbw *w, int header, size_t body_size, size_t *header_at)
+{
+	size_t at[4];
+	_put(w, NULL, 4);
+	const struct _slot message[4] = {{2, _METADATA_V5, 0}, {1, (uint64_t)header, 0}, {4, 0, 1}, {8, body_size, 0}};
+	_link(w, 0, _table(w, 4, message, at));
+	*header_at = at[2];
+}
+
+/*
+ * static int _write_message(FILE *out, struct _fbw *w, size_t *written)
+ * \brief writes the continuation marker, the size and the flatbuffer padded to 8 bytes
+ */
+static int _write_message(FILE *out, struct _fbw *w, size_t *written)
+{
+	_pad(w, 8, 0);
+	unsigned char prefix[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0};
+	for (int k = 0; k < 4; ++k)
+		prefix[4 + k] = (unsigned char)(w->len >> (8 * k));
+	*written += 8 + w->len;
+	return fwrite(prefix, 1, 8, out) != 8 || fwrite(w->b, 1, w->len, out) != w->len;
+}
+
+/* NW_ArrowWriteInt64 : see .h file for documentation
+ */
+int NW_ArrowWriteInt64(const char *path, const char *name, const int64_t *values, const unsigned char *valid, size_t n)
+{
+	int stream = (strcmp(path, "-") == 0);
+	FILE *out = stream ? stdout : fopen(path, "wb");
+	if (out == NULL)
+	{
+		perror(path);
+		return EXIT_FAILURE;
+	}
+	size_t nulls = 0;
+	for (size_t k = 0; valid != NULL && k < n; ++k)
+		nulls += !valid[k];
+	size_t bitmap = (nulls == 0) ? 0 : (n + 7) / 8, padded = (bitmap + 7) & ~(size_t)7;
+	size_t body_size = padded + 8 * n;
+	size_t written = 0;
+	int error = 0;
+	if (!stream)
+	{
+		error |= fwrite(NW_ARROW_MAGIC "\0\0", 1, 8, out) != 8;
+		written = 8;
+	}
+
+	struct _fbw w = {NULL, 0, 0};
+	size_t header_at;
+	_message_table(&w, _SCHEMA, 0, &header_at);
+	_link(&w, header_at, _schema_table(&w, name));
+	error |= _write_message(out, &w, &written);
+
+	size_t batch_offset = written;
+	w.len = 0;
+	_message_table(&w, _RECORD_BATCH, body_size, &header_at);
+	size_t at[3];
+	const struct _slot batch[3] = {{8, n, 0}, {4, 0, 1}, {4, 0, 1}}; // length, nodes, buffers
+	_link(&w, header_at, _table(&w, 3, batch, at));
+	size_t nodes = _vector_of(&w, 1, 16, 8);
+	_wr(&w, nodes, n, 8);
+	_wr(&w, nodes + 8, nulls, 8);
+	_link(&w, at[1], nodes - 4);
+	size_t buffers = _vector_of(&w, 2, 16, 8);
+	_wr(&w, buffers + 8, bitmap, 8); // validity: offset 0
+	_wr(&w, buffers + 16, padded, 8);
+	_wr(&w, buffers + 24, 8 * n, 8);
+	_link(&w, at[2], buffers - 4);
+	error |= _write_message(out, &w, &written);
+	size_t metadata = written - batch_offset;
+	for (size_t k = 0; k < bitmap; k += 8)
+	{
+		unsigned char bits[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		for (size_t r = 8 * k; r < n && r < 8 * (k + 8); ++r)
+			bits[r / 8 - k] |= (unsigned char)(valid[r] != 0) << (r % 8);
+		error |= fwrite(bits, 1, 8, out) != 8;
+	}
+	for (size_t k = 0; k < n; ++k)
+	{
+		unsigned char v[8];
+		for (int b = 0; b < 8; ++b)
+			v[b] = (unsigned char)((uint64_t)((valid == NULL || valid[k]) ? values[k] : 0) >> (8 * b));
+		error |= fwrite(v, 1, 8, out) != 8;
+	}
+	written += body_size;
+	static const unsigned char eos[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0};
+	error |= fwrite(eos, 1, 8, out) != 8;
+
+	if (!stream) // footer: version, schema, dictionaries, recordBatches
+	{
+		w.len = 0;
+		_put(&w, NULL, 4);
+		const struct _slot footer[4] = {{2, _METADATA_V5, 0}, {4, 0, 1}, {4, 0, 1}, {4, 0, 1}};
+		size_t f_at[4];
+		_link(&w, 0, _table(&w, 4, footer, f_at));
+		_link(&w, f_at[1], _schema_table(&w, name));
+		_link(&w, f_at[2], _vector_of(&w, 0, 24, 8) - 4);
+		size_t blocks = _vector_of(&w, 1, 24, 8);
+		_wr(&w, blocks, batch_offset, 8);
+		_wr(&w, blocks + 8, metadata, 4);
+		_wr(&w, blocks + 16, body_size, 8);
+		_link(&w, f_at[3], blocks - 4);
+		unsigned char size[4];
+		for (int k = 0; k < 4; ++k)
+			size[k] = (unsigned char)(w.len >> (8 * k));
+		error |= fwrite(w.b, 1, w.len, out) != w.len;
+		error |= fwrite(size, 1, 4, out) != 4;
+		error |= fwrite(NW_ARROW_MAGIC, 1, 6, out) != 6;
+	}
+	free(w.b);
+	if ((stream ? fflush(out) : fclose(out)) != 0 || error)
+	{
+		fprintf(stderr, "Error: writing %s: %s.\n", path, strerror(errno));
+		return EXIT_FAILURE;
+	}
+	return 0;
+}
+
+/*****************************************************************************
+ * Batch mode on Arrow columns
+ */
+
+/* NW_RunArrow : see .h file for documentation
+ */
+int NW_RunArrow(const char *sequences, const char *column, const char *pairs, const char *first, const char *second,
+				const char *output, enum NW_Engine engine, int nthreads)
+{
+	struct NW_Arrow s, p;
+	int same = (strcmp(sequences, pairs) == 0);
+	if (NW_ArrowOpen(&s, sequences) != 0)
+		return EXIT_FAILURE;
+	if (!same && NW_ArrowOpen(&p, pairs) != 0)
+	{
+		NW_ArrowClose(&s);
+		return EXIT_FAILURE;
+	}
+	struct NW_Arrow *t = same ? &s : &p;
+	long seq = NW_ArrowColumn(&s, column, NW_ARROW_STRINGS, 0);
+	long ia = NW_ArrowColumn(t, first, NW_ARROW_INT, 0);
+	long ib = NW_ArrowColumn(t, second, NW_ARROW_INT, (first == NULL && second == NULL) ? 1 : 0);
+	const char **values = (const char **)malloc((s.rows + 1) * sizeof(char *));
+	size_t *lengths = (size_t *)malloc((s.rows + 1) * sizeof(size_t));
+	int64_t *index = (int64_t *)malloc((2 * t->rows + 1) * sizeof(int64_t));
+	unsigned char *valid = (unsigned char *)malloc(2 * t->rows + 1);
+	struct NW_Pair *work = (struct NW_Pair *)malloc((t->rows + 1) * sizeof(struct NW_Pair));
+	int64_t *distances = (int64_t *)calloc(t->rows + 1, sizeof(int64_t));
+	if (values == NULL || lengths == NULL || index == NULL || valid == NULL || work == NULL || distances == NULL)
+	{
+		perror("NW_RunArrow: malloc of the columns");
+		exit(EXIT_FAILURE);
+	}
+	int status = (seq < 0 || ia < 0 || ib < 0 || NW_ArrowStrings(&s, (size_t)seq, values, lengths) != 0 ||
+				  NW_ArrowIntegers(t, (size_t)ia, index, valid) != 0 ||
+				  NW_ArrowIntegers(t, (size_t)ib, index + t->rows, valid + t->rows) != 0)
+					 ? EXIT_FAILURE
+					 : 0;
+	size_t n = 0;
+	for (size_t r = 0; r < t->rows && status == 0; ++r)
+	{
+		int64_t a = index[r], b = index[t->rows + r];
+		if ((valid[r] && (a < 0 || (uint64_t)a >= s.rows)) || (valid[t->rows + r] && (b < 0 || (uint64_t)b >= s.rows)))
+		{
+			fprintf(stderr, "Error: pair %zu: index of sequence out of 0 .. %zu.\n", r, s.rows - 1);
+			status = EXIT_FAILURE;
+		}
+		else if ((valid[r] = valid[r] && valid[t->rows + r] && values[a] != NULL && values[b] != NULL))
+		{
+			work[n].A = (char *)values[a];
+			work[n].lengthA = lengths[a];
+			work[n].B = (char *)values[b];
+			work[n++].lengthB = lengths[b];
+		}
+	}
+	if (status == 0)
+	{
+		NW_RunPairs(work, n, engine, nthreads);
+		for (size_t r = 0, k = 0; r < t->rows; ++r)
+			if (valid[r])
+				distances[r] = work[k++].distance;
+		status = NW_ArrowWriteInt64(output, "distance", distances, valid, t->rows);
+	}
+	free(values);
+	free(lengths);
+	free(index);
+	free(valid);
+	free(work);
+	free(distances);
+	if (!same)
+		NW_ArrowClose(&p);
+	NW_ArrowClose(&s);
+	return status;
+}
@@ -0,0 +1,145 @@
+/**
+ * \file arrow_ipc.h
+ * \brief Apache Arrow IPC files and streams: reading of the columns of sequences and of pairs of indexes
+ * (without copy of the sequences), writing of the distances as an Arrow column
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * The Arrow IPC format is read and written directly (no Arrow library): a stream is a sequence of
+ * messages, each a flatbuffer (Message of Message.fbs: a Schema, then RecordBatch ones) followed by its
+ * body; a file is "ARROW1\0\0", a stream, a Footer (File.fbs) giving the position of the record batches,
+ * its size and "ARROW1". A file is mapped (a stream read on stdin is loaded in memory), and the values
+ * of a column of strings are pointers in the bodies of its record batches.
+ *
+ * Supported: little endian data, metadata version 4 or 5, uncompressed record batches. The columns read
+ * are the top level fields of types Binary, Utf8, LargeBinary, LargeUtf8 (sequences) and Int of 8 to 64
+ * bits (indexes), not dictionary encoded; the other fields, nested or not, are skipped. The dictionary
+ * batches are ignored.
+ */
+
+#ifndef __ARROW_IPC_H__
+#define __ARROW_IPC_H__
+
+#include <stdint.h> /* for int64_t */
+#include <stdlib.h> /* for size_t */
+
+#include "Needleman-Wunsch-recmemo.h" /* for enum NW_Engine */
+
+/** \def NW_ARROW_MAGIC
+ *  \brief first 6 bytes (padded to 8) and last 6 bytes of an Arrow IPC file
+ */
+#define NW_ARROW_MAGIC "ARROW1"
+
+/** \enum NW_ArrowType
+ * \brief type of a field, as a bit to select the columns of several types
+ */
+enum NW_ArrowType
+{
+	NW_ARROW_OTHER = 0,		   /*!< not supported */
+	NW_ARROW_INT = 1,		   /*!< Int (bits, is_signed) */
+	NW_ARROW_BINARY = 2,	   /*!< Binary: 32 bit offsets */
+	NW_ARROW_UTF8 = 4,		   /*!< Utf8: 32 bit offsets */
+	NW_ARROW_LARGE_BINARY = 8, /*!< LargeBinary: 64 bit offsets */
+	NW_ARROW_LARGE_UTF8 = 16,  /*!< LargeUtf8: 64 bit offsets */
+};
+
+/** \def NW_ARROW_STRINGS
+ *  \brief types of the columns of sequences
+ */
+#define NW_ARROW_STRINGS (NW_ARROW_BINARY | NW_ARROW_UTF8 | NW_ARROW_LARGE_BINARY | NW_ARROW_LARGE_UTF8)
+
+/** \struct NW_ArrowField
+ * \brief a top level field of the schema
+ */
+struct NW_ArrowField
+{
+	const char *name;	 /*!< name, in the metadata (not terminated by '\0') */
+	size_t name_length;	 /*!< its length */
+	enum NW_ArrowType type;
+	int bits;			 /*!< Int: 8, 16, 32 or 64 */
+	int is_signed;		 /*!< Int: 1 if signed */
+	size_t node;		 /*!< index of its field node in the record batches */
+	size_t buffer;		 /*!< index of its first buffer in the record batches */
+};
+
+/** \struct NW_Arrow
+ * \brief an Arrow IPC file or stream
+ */
+struct NW_Arrow
+{
+	const unsigned char *data; /*!< the mapping of the file, or the stream in memory */
+	size_t size;			   /*!< its size */
+	int mapped;				   /*!< 1 if data is a mapping, 0 if it is allocated */
+	size_t nfields;			   /*!< top level fields of the schema */
+	struct NW_ArrowField *fields;
+	size_t nbatches;		   /*!< record batches */
+	size_t *batches;		   /*!< position of their RecordBatch tables in data */
+	size_t *bodies;			   /*!< position of their bodies */
+	size_t *body_sizes;		   /*!< size of their bodies */
+	size_t rows;			   /*!< total number of rows */
+};
+
+/**
+ * \fn int NW_ArrowOpen(struct NW_Arrow *a, const char *path);
+ * \brief maps the Arrow IPC file, or stream, path ("-" for a stream on stdin) and reads its schema and the
+ * positions of its record batches
+ * \return : 0 on success, >0 (with a message on stderr) if it cannot be read or is not supported
+ */
+int NW_ArrowOpen(struct NW_Arrow *a, const char *path);
+
+/**
+ * \fn void NW_ArrowClose(struct NW_Arrow *a);
+ * \brief unmaps (or frees) a
+ */
+void NW_ArrowClose(struct NW_Arrow *a);
+
+/**
+ * \fn long NW_ArrowColumn(const struct NW_Arrow *a, const char *name, int types, size_t skip);
+ * \brief returns the index of the field name of a (if name is NULL: of the top level field number skip
+ * among the ones of types), or -1 with a message on stderr if there is none of these types
+ * \param types : bits of enum NW_ArrowType
+ */
+long NW_ArrowColumn(const struct NW_Arrow *a, const char *name, int types, size_t skip);
+
+/**
+ * \fn int NW_ArrowStrings(const struct NW_Arrow *a, size_t field, const char **values, size_t *lengths);
+ * \brief sets values[r] to the address (in the mapping) of the string of the row r of the column field, of
+ * lengths[r] bytes, for r = 0 .. a->rows-1; values[r] is NULL if the row is null
+ * \return : 0 on success, >0 (with a message on stderr) if a buffer exceeds its body
+ */
+int NW_ArrowStrings(const struct NW_Arrow *a, size_t field, const char **values, size_t *lengths);
+
+/**
+ * \fn int NW_ArrowIntegers(const struct NW_Arrow *a, size_t field, int64_t *values, unsigned char *valid);
+ * \brief sets values[r] to the integer of the row r of the column field and valid[r] to 0 if it is null,
+ * else to 1, for r = 0 .. a->rows-1 (unsigned 64 bit values above INT64_MAX are converted to negative ones)
+ * \return : 0 on success, >0 (with a message on stderr) if a buffer exceeds its body
+ */
+int NW_ArrowIntegers(const struct NW_Arrow *a, size_t field, int64_t *values, unsigned char *valid);
+
+/**
+ * \fn int NW_ArrowWriteInt64(const char *path, const char *name, const int64_t *values, const unsigned char *valid, size_t n);
+ * \brief writes the Arrow IPC file path (a stream on stdout if path is "-") of one record batch of the
+ * nullable Int64 column name: values[0 .. n-1], where the rows of valid[r] == 0 are null (none if valid
+ * is NULL)
+ * \return : 0 on success, >0 (with a message on stderr) on an error of writing
+ */
+int NW_ArrowWriteInt64(const char *path, const char *name, const int64_t *values, const unsigned char *valid, size_t n);
+
+/**
+ * \fn int NW_RunArrow(const char *sequences, const char *column, const char *pairs, const char *first, const char *second, const char *output, enum NW_Engine engine, int nthreads);
+ * \brief computes the distances of the pairs of rows of an Arrow table of sequences and writes them as an
+ * Arrow column "distance"
+ * \param sequences : Arrow IPC file (or "-" for a stream on stdin) of the sequences
+ * \param column : column of the sequences (NULL: the first column of strings)
+ * \param pairs : Arrow IPC file of the pairs (may be the same as sequences, read once)
+ * \param first, second : columns of the indexes of the rows of the pairs (NULL: the first two integer ones)
+ * \param output : Arrow IPC file written ("-" for a stream on stdout); row r is the distance of the pair of
+ * row r, null if an index or a sequence of the pair is null
+ * \param engine, nthreads : cf NW_RunPairs in batch.h
+ * \return : 0 on success, >0 (with a message on stderr) on an error of the inputs or of the output
+ */
+int NW_RunArrow(const char *sequences, const char *column, const char *pairs, const char *first, const char *second,
+				const char *output, enum NW_Engine engine, int nthreads);
+
+#endif /* __ARROW_IPC_H__ */
@@ -0,0 +1,444 @@
+/**
+ * \file async_read.c
+ * \brief sequential reading of a file by large blocks, several reads being in flight (io_uring, or a pool of
+ * threads calling pread)
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see async_read.h
+ *
+ * The block b is read in the buffer (slot) b % depth. The blocks 0 .. depth-1 are submitted when the
+ * reader is opened, and the block b + depth when the caller gives back the block b. The io_uring is used
+ * without liburing: its submission and completion rings are mapped and updated with the memory orders of
+ * the kernel documentation (io_uring(7)); the reads are IORING_OP_READV (kernel 5.1).
+ */
+
+#include "async_read.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h> /* for uintptr_t */
+#include <string.h> /* for memset and strcmp */
+#include <errno.h>
+#include <err.h>
+#include <unistd.h>		 /* for pread, syscall and close */
+#include <pthread.h>	 /* pool of the pread backend */
+#include <sys/mman.h>	 /* for the mapping of the rings */
+#include <sys/uio.h>	 /* for struct iovec */
+#include <sys/syscall.h> /* for __NR_io_uring_setup and __NR_io_uring_enter */
+#include <linux/io_uring.h>
+
+/** \struct _slot
+ * \brief a buffer and the read of its block
+ */
+struct _slot
+{
+	char *buf;
+	size_t size;	  /*!< bytes requested */
+	off_t offset;	  /*!< position in the file */
+	ssize_t done;	  /*!< bytes read, -1 while the read is in flight */
+	int error;		  /*!< errno of the read, 0 on success */
+	struct iovec iov; /*!< the buffer, for IORING_OP_READV */
+};
+
+/** \struct _uring
+ * \brief an io_uring and its mapped rings
+ */
+struct _uring
+{
+	int fd;
+	void *sq_ring, *cq_ring;
+	size_t sq_size, cq_size;
+	struct io_uring_sqe *sqes;
+	size_t sqes_size;
+	unsigned *sq_tail, *sq_mask, *sq_array;
+	unsigned *cq_head, *cq_tail, *cq_mask;
+	struct io_uring_cqe *cqes;
+	unsigned unsubmitted; /*!< entries of the submission ring not yet given to the kernel */
+};
+
+/** \struct NW_Reader
+ * \brief a file being read
+ */
+struct NW_Reader
+{
+	int fd;
+	off_t offset, length;		   /*!< the range read */
+	size_t block;				   /*!< bytes of a block */
+	unsigned depth;				   /*!< number of slots */
+	enum NW_ReaderBackend backend; /*!< NW_READER_URING or NW_READER_PREAD */
+	struct _slot *slots;
+	size_t nblocks;	  /*!< blocks of the range */
+	size_t submitted; /*!< blocks 0 .. submitted-1 are submitted */
+	size_t next;	  /*!< next block given to the caller */
+	unsigned inflight;
+	struct _uring ring; /*!< NW_READER_URING */
+	pthread_t *threads; /*!< NW_READER_PREAD: the pool and its queue (blocks started .. submitted-1) */
+	unsigned nthreads;
+	pthread_mutex_t lock;
+	pthread_cond_t work, ready;
+	size_t started;
+	int stop;
+};
+
+/*
+ * static int _uring_init(struct _uring *u, unsigned entries)
+ * \brief sets up an io_uring of at least entries entries and maps its rings
+ * \return : 0 on success, -1 if io_uring is not available
+ */
+static int _uring_init(struct _uring *u, unsigned entries)
+{
+	struct io_uring_params p;
+	memset(&p, 0, sizeof(p));
+	memset(u, 0, sizeof(struct _uring));
+	u->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+	if (u->fd < 0)
+		return -1;
+	u->sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	u->cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	if (p.features & IORING_FEAT_SINGLE_MMAP) // one mapping for both rings
+		u->sq_size = u->cq_size = (u->sq_size > u->cq_size) ? u->sq_size : u->cq_size;
+	u->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+	u->sq_ring = mmap(NULL, u->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_SQ_RING);
+	u->cq_ring = (p.features & IORING_FEAT_SINGLE_MMAP)
+					 ? u->sq_ring
+					 : mmap(NULL, u->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->fd,
+							IORING_OFF_CQ_RING);
+	u->sqes = (struct io_uring_sqe *)mmap(NULL, u->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+										  u->fd, IORING_OFF_SQES);
+	if (u->sq_ring == MAP_FAILED || u->cq_ring == MAP_FAILED || u->sqes == MAP_FAILED)
+	{
+		if (u->sqes != MAP_FAILED)
+			munmap(u->sqes, u->sqes_size);
+		if (u->cq_ring != MAP_FAILED && u->cq_ring != u->sq_ring)
+			munmap(u->cq_ring, u->cq_size);
+		if (u->sq_ring != MAP_FAILED)
+			munmap(u->sq_ring, u->sq_size);
+		close(u->fd);
+		return -1;
+	}
+	unsigned char *sq = (unsigned char *)u->sq_ring, *cq = (unsigned char *)u->cq_ring;
+	u->sq_tail = (unsigned *)(sq + p.sq_off.tail);
+	u->sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+	u->sq_array = (unsigned *)(sq + p.sq_off.array);
+	u->cq_head = (unsigned *)(cq + p.cq_off.head);
+	u->cq_tail = (unsigned *)(cq + p.cq_off.tail);
+	u->cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+	u->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+	return 0;
+}
+
+/*
+ * static void _uring_free(struct _uring *u)
+ * \brief unmaps the rings and closes the io_uring
+ */
+static void _uring_free(struct _uring *u)
+{
+	munmap(u->sqes, u->sqes_size);
+	if (u->cq_ring != u->sq_ring)
+		munmap(u->cq_ring, u->cq_size);
+	munmap(u->sq_ring, u->sq_size);
+	close(u->fd);
+}
+
+/*
+ * static void _uring_flush(struct _uring *u)
+ * \brief gives the new entries of the submission ring to the kernel
+ */
+static void _uring_flush(struct _uring *u)
+{
+	while (u->unsubmitted > 0)
+	{
+		int n = (int)syscall(__NR_io_uring_enter, u->fd, u->unsubmitted, 0, 0, NULL, 0);
+		if (n < 0 && errno != EINTR && errno != EAGAIN)
+			err(1, "NW_Reader: io_uring_enter");
+		if (n > 0)
+			u->unsubmitted -= (unsigned)n;
+	}
+}
+
+/*
+ * static void _uring_reap(struct NW_Reader *r)
+ * \brief waits for one completion and sets the result of its slot
+ */
+static void _uring_reap(struct NW_Reader *r)
+{
+	struct _uring *u = &r->ring;
+	for (;;)
+	{
+		unsigned head = *u->cq_head, tail = __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE);
+		if (head != tail)
+		{
+			const struct io_uring_cqe *cqe = &u->cqes[head & *u->cq_mask];
+			struct _slot *slot = &r->slots[cqe->user_data];
+			slot->error = (cqe->res < 0) ? -cqe->res : 0;
+			slot->done = (cqe->res < 0) ? 0 : cqe->res;
+			__atomic_store_n(u->cq_head, head + 1, __ATOMIC_RELEASE);
+			--r->inflight;
+			return;
+		}
+		if (syscall(__NR_io_uring_enter, u->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR)
+			err(1, "NW_Reader: io_uring_enter");
+	}
+}
+
+/*
+ * static void *_worker(void *arg)
+ * \brief a thread of the pread backend: reads the blocks of the queue
+ */
+static void *_worker(void *arg)
+{
+	struct NW_Reader *r = (struct NW_Reader *)arg;
+	pthread_mutex_lock(&r->lock);
+	for (;;)
+	{
+		while (!r->stop && r->started == r->submitted)
+			pthread_cond_wait(&r->work, &r->lock);
+		if (r->started == r->submitted) // stopped, and no read left
+			break;
+		struct _slot *slot = &r->slots[r->started++ % r->depth];
+		pthread_mutex_unlock(&r->lock);
+		size_t got = 0;
+		int error = 0;
+		while (got < slot->size)
+		{
+			ssize_t n = pread(r->fd, slot->buf + got, slot->size - got, slot->offset + (off_t)got);
+			if (n < 0 && errno == EINTR)
+				continue;
+			if (n < 0)
+				error = errno;
+			if (n <= 0)
+				break;
+			got += (size_t)n;
+		}
+		pthread_mutex_lock(&r->lock);
+		slot->done = (ssize_t)got;
+		slot->error = error;
+		--r->inflight;
+		pthread_cond_broadcast(&r->ready);
+	}
+	pthread_mutex_unlock(&r->lock);
+	return NULL;
+}
+
+/*
+ * static void _submit(struct NW_Reader *r)
+ * \brief submits the read of the next block (in its slot, given back)
+ */
+static void _submit(struct NW_Reader *r)
+{
+	size_t b = r->submitted;
+	struct _slot *slot = &r->slots[b % r->depth];
+	slot->offset = r->offset + (off_t)(b * r->block);
+	slot->size = ((off_t)((b + 1) * r->block) <= r->length) ? r->block : (size_t)(r->length - (off_t)(b * r->block));
+	slot->done = -1;
+	slot->error = 0;
+	slot->iov.iov_base = slot->buf;
+	slot->iov.iov_len = slot->size;
+	if (r->backend == NW_READER_URING)
+	{
+		struct _uring *u = &r->ring;
+		unsigned tail = *u->sq_tail, index = tail & *u->sq_mask;
+		struct io_uring_sqe *sqe = &u->sqes[index];
+		memset(sqe, 0, sizeof(struct io_uring_sqe));
+		sqe->opcode = IORING_OP_READV;
+		sqe->fd = r->fd;
+		sqe->off = (uint64_t)slot->offset;
+		sqe->addr = (uint64_t)(uintptr_t)&slot->iov;
+		sqe->len = 1;
+		sqe->user_data = b % r->depth;
+		u->sq_array[index] = index;
+		__atomic_store_n(u->sq_tail, tail + 1, __ATOMIC_RELEASE);
+		++u->unsubmitted;
+		++r->inflight;
+		++r->submitted;
+	}
+	else
+	{
+		pthread_mutex_lock(&r->lock);
+		++r->inflight;
+		++r->submitted;
+		pthread_cond_signal(&r->work);
+		pthread_mutex_unlock(&r->lock);
+	}
+}
+
+/*
+ * static enum NW_ReaderBackend _backend_from_env(void)
+ * \brief backend named by NW_READER (NW_READER_AUTO if it is not set)
+ */
+static enum NW_ReaderBackend _backend_from_env(void)
+{
+	const char *name = getenv(NW_READER_ENV);
+	if (name == NULL || strcmp(name, "auto") == 0)
+		return NW_READER_AUTO;
+	if (strcmp(name, "uring") == 0)
+		return NW_READER_URING;
+	if (strcmp(name, "pread") == 0)
+		return NW_READER_PREAD;
+	fprintf(stderr, "Warning: unknown reader %s=%s; io_uring is used if available.\n", NW_READER_ENV, name);
+	return NW_READER_AUTO;
+}
+
+/* NW_ReaderOpen : see .h file for documentation
+ */
+struct NW_Reader *NW_ReaderOpen(int fd, off_t offset, off_t length, const struct NW_ReaderParams *params)
+{
+	struct NW_Reader *r = (struct NW_Reader *)calloc(1, sizeof(struct NW_Reader));
+	if (r == NULL)
+	{
+		perror("NW_ReaderOpen: calloc");
+		exit(EXIT_FAILURE);
+	}
+	r->fd = fd;
+	r->offset = offset;
+	r->length = (length > 0) ? length : 0;
+	r->block = (params == NULL || params->block == 0) ? NW_READER_BLOCK : params->block;
+	r->depth = (params == NULL || params->depth == 0) ? NW_READER_DEPTH : params->depth;
+	r->nblocks = ((size_t)r->length + r->block - 1) / r->block;
+	r->slots = (struct _slot *)calloc(r->depth, sizeof(struct _slot));
+	if (r->slots == NULL)
+	{
+		perror("NW_ReaderOpen: calloc of the slots");
+		exit(EXIT_FAILURE);
+	}
+	for (unsigned k = 0; k < r->depth; ++k)
+	{
+		r->slots[k].buf = (char *)malloc(r->block);
+		if (r->slots[k].buf == NULL)
+		{
+			perror("NW_ReaderOpen: malloc of the buffers");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	enum NW_ReaderBackend backend = (params == NULL || params->backend == NW_READER_AUTO) ? _backend_from_env()
+																						 : params->backend;
+	r->backend = NW_READER_PREAD;
+	if (backend != NW_READER_PREAD && _uring_init(&r->ring, r->depth) == 0)
+		r->backend = NW_READER_URING;
+	else if (backend == NW_READER_URING)
+		fprintf(stderr, "Warning: io_uring is not available (%s); the files are read by pread.\n", strerror(errno));
+	if (r->backend == NW_READER_PREAD)
+	{
+		r->nthreads = (r->depth > 1) ? r->depth - 1 : 1;
+		r->threads = (pthread_t *)malloc(r->nthreads * sizeof(pthread_t));
+		if (r->threads == NULL)
+		{
+			perror("NW_ReaderOpen: malloc of the threads");
+			exit(EXIT_FAILURE);
+		}
+		pthread_mutex_init(&r->lock, NULL);
+		pthread_cond_init(&r->work, NULL);
+		pthread_cond_init(&r->ready, NULL);
+		for (unsigned t = 0; t < r->nthreads; ++t)
+			if (pthread_create(&r->threads[t], NULL, _worker, r) != 0)
+				errx(1, "NW_ReaderOpen: pthread_create");
+	}
+
+	while (r->submitted < r->nblocks && r->submitted < r->depth)
+		_submit(r);
+	if (r->backend == NW_READER_URING)
+		_uring_flush(&r->ring);
+	return r;
+}
+
+/* NW_ReaderNext : see .h file for documentation
+ */
+size_t NW_ReaderNext(struct NW_Reader *r, const char **data)
+{
+	if (r->next > 0 && r->submitted < r->nblocks) // the slot of the previous block reads the next one
+	{
+		_submit(r);
+		if (r->backend == NW_READER_URING)
+			_uring_flush(&r->ring);
+	}
+	if (r->next >= r->nblocks)
+		return 0;
+
+	struct _slot *slot = &r->slots[r->next % r->depth];
+	if (r->backend == NW_READER_URING)
+		while (slot->done < 0)
+			_uring_reap(r);
+	else
+	{
+		pthread_mutex_lock(&r->lock);
+		while (slot->done < 0)
+			pthread_cond_wait(&r->ready, &r->lock);
+		pthread_mutex_unlock(&r->lock);
+	}
+	while (slot->error == 0 && slot->done > 0 && (size_t)slot->done < slot->size) // short read: the rest
+	{
+		ssize_t n = pread(r->fd, slot->buf + slot->done, slot->size - (size_t)slot->done, slot->offset + slot->done);
+		if (n < 0 && errno != EINTR)
+			slot->error = errno;
+		if (n == 0)
+			break;
+		if (n > 0)
+			slot->done += n;
+	}
+	if (slot->error != 0)
+	{
+		errno = slot->error;
+		err(1, "NW_ReaderNext: read");
+	}
+	if ((size_t)slot->done < slot->size) // the file is shorter than the range
+		r->nblocks = r->next + (slot->done > 0);
+	if (slot->done == 0)
+		return 0;
+	++r->next;
+	*data = slot->buf;
+	return (size_t)slot->done;
+}
+
+/* NW_ReaderClose : see .h file for documentation
+ */
+void NW_ReaderClose(struct NW_Reader *r)
+{
+	if (r->backend == NW_READER_URING)
+	{
+		while (r->inflight > 0)
+			_uring_reap(r);
+		_uring_free(&r->ring);
+	}
+	else
+	{
+		pthread_mutex_lock(&r->lock);
+		r->stop = 1;
+		pthread_cond_broadcast(&r->work);
+		pthread_mutex_unlock(&r->lock);
+		for (unsigned t = 0; t < r->nthreads; ++t)
+			pthread_join(r->threads[t], NULL);
+		pthread_mutex_destroy(&r->lock);
+		pthread_cond_destroy(&r->work);
+		pthread_cond_destroy(&r->ready);
+		free(r->threads);
+	}
+	for (unsigned k = 0; k < r->depth; ++k)
+		free(r->slots[k].buf);
+	free(r->slots);
+	free(r);
+}
+
+/* NW_ReaderBackendName : see .h file for documentation
+ */
+const char *NW_ReaderBackendName(const struct NW_Reader *r)
+{
+	return (r->backend == NW_READER_URING) ? "uring" : "pread";
+}
+
+/* NW_ReadAll : see .h file for documentation
+ */
+int NW_ReadAll(int fd, char *dest, size_t length)
+{
+	struct NW_Reader *r = NW_ReaderOpen(fd, 0, (off_t)length, NULL);
+	const char *data;
+	size_t copied = 0, n;
+	while ((n = NW_ReaderNext(r, &data)) > 0)
+	{
+		memcpy(dest + copied, data, n);
+		copied += n;
+	}
+	NW_ReaderClose(r);
+	return (copied == length) ? 0 : -1;
+}
@@ -0,0 +1,98 @@
+/**
+ * \file async_read.h
+ * \brief sequential reading of a file by large blocks, several reads being in flight (io_uring, or a pool of
+ * threads calling pread)
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * When the inputs are on a network filesystem, the page faults of a mapping (or the reads of a FILE) are
+ * served one at a time, by the thread computing the alignment: it waits for each round trip. A NW_Reader
+ * reads the range of a file by blocks of <block> bytes into a ring of <depth> buffers: the reads of the
+ * next depth - 1 blocks are in flight while the caller decodes and aligns the current one. A buffer is
+ * read again (with the block depth places further) as soon as the caller asks for the next block.
+ *
+ * The reads are submitted to an io_uring (called through the system calls: liburing is not required); if
+ * io_uring is not available (kernel before 5.1, disabled by a seccomp filter or by the administrator), they
+ * are done by a pool of threads calling pread. The environment variable NW_READER selects the backend:
+ * "uring", "pread" or "auto" (default: io_uring if it can be set up).
+ */
+
+#ifndef __ASYNC_READ_H__
+#define __ASYNC_READ_H__
+
+#include <stdlib.h>	   /* for size_t */
+#include <sys/types.h> /* for off_t */
+
+/** \def NW_READER_ENV
+ *  \brief name of the environment variable that selects the backend ("uring", "pread" or "auto")
+ */
+#define NW_READER_ENV "NW_READER"
+
+/** \def NW_READER_BLOCK
+ *  \brief default size of a read
+ */
+#define NW_READER_BLOCK (4 << 20)
+
+/** \def NW_READER_DEPTH
+ *  \brief default number of buffers (reads in flight plus the block of the caller)
+ */
+#define NW_READER_DEPTH 8
+
+/** \enum NW_ReaderBackend
+ * \brief implementation of the reads
+ */
+enum NW_ReaderBackend
+{
+	NW_READER_AUTO = 0, /*!< io_uring if it can be set up, else pread */
+	NW_READER_URING,	/*!< io_uring */
+	NW_READER_PREAD,	/*!< pool of threads calling pread */
+};
+
+/** \struct NW_ReaderParams
+ * \brief parameters of NW_ReaderOpen
+ */
+struct NW_ReaderParams
+{
+	size_t block;				   /*!< bytes of a read (0 for NW_READER_BLOCK) */
+	unsigned depth;				   /*!< buffers (0 for NW_READER_DEPTH) */
+	enum NW_ReaderBackend backend; /*!< NW_READER_AUTO: from NW_READER, else io_uring if available */
+};
+
+struct NW_Reader;
+
+/**
+ * \fn struct NW_Reader *NW_ReaderOpen(int fd, off_t offset, off_t length, const struct NW_ReaderParams *params);
+ * \brief starts reading the bytes [offset, offset + length( of the file fd (not closed by the reader)
+ * \param params : may be NULL for the defaults
+ * \return : the reader; exits with an error message if the buffers cannot be allocated
+ */
+struct NW_Reader *NW_ReaderOpen(int fd, off_t offset, off_t length, const struct NW_ReaderParams *params);
+
+/**
+ * \fn size_t NW_ReaderNext(struct NW_Reader *r, const char **data);
+ * \brief gives back the previous block and sets *data to the next one, valid until the next call
+ * \return : the size of the block, 0 at the end of the range (or of the file if it is shorter); exits with an
+ * error message on an error of reading
+ */
+size_t NW_ReaderNext(struct NW_Reader *r, const char **data);
+
+/**
+ * \fn void NW_ReaderClose(struct NW_Reader *r);
+ * \brief waits for the reads in flight and frees r
+ */
+void NW_ReaderClose(struct NW_Reader *r);
+
+/**
+ * \fn const char *NW_ReaderBackendName(const struct NW_Reader *r);
+ * \brief returns "uring" or "pread"
+ */
+const char *NW_ReaderBackendName(const struct NW_Reader *r);
+
+/**
+ * \fn int NW_ReadAll(int fd, char *dest, size_t length);
+ * \brief reads the first length bytes of fd into dest with a reader of the default parameters
+ * \return : 0 on success, -1 if the file is shorter
+ */
+int NW_ReadAll(int fd, char *dest, size_t length);
+
+#endif /* __ASYNC_READ_H__ */
@@ -0,0 +1,347 @@
+/**
+ * \file batch.c
+ * \brief batch mode: computes the edit distance of many pairs of sequences in one process
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see batch.h
+ */
+
+#include "batch.h"
+#include "sequence_map.h"
+#include "thread_pool.h"
+#include "metrics.h"
+#include "scheduler.h"
+#include "capture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> /* for strtok_r */
+#include <errno.h>	/* for ETIMEDOUT and ENOMEM */
+#include <time.h>	/* for clock_gettime */
+#include <pthread.h>
+
+/* NW_Now : see .h file for documentation
+ */
+double NW_Now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+}
+
+/* NW_StackSize : see .h file for documentation
+ */
+size_t NW_StackSize(size_t lengthA, size_t lengthB)
+{
+	return 16 * sizeof(long) * (lengthA + lengthB + 2) + (1UL << 20);
+}
+
+/* cost array used by _compare_cost (qsort has no argument for the comparison function) */
+static __thread const double *_sort_cost;
+
+/*
+ * static int _compare_cost(const void *a, const void *b)
+ * \brief orders tasks by decreasing cost, then by increasing index
+ */
+static int _compare_cost(const void *a, const void *b)
+{
+	size_t i = *(const size_t *)a;
+	size_t j = *(const size_t *)b;
+	if (_sort_cost[i] != _sort_cost[j])
+		return (_sort_cost[i] > _sort_cost[j]) ? -1 : 1;
+	return (i < j) ? -1 : (i > j);
+}
+
+/* NW_LongestFirst : see .h file for documentation
+ */
+size_t *NW_LongestFirst(const double *cost, size_t n)
+{
+	size_t *order = (size_t *)malloc((n + 1) * sizeof(size_t));
+	if (order == NULL)
+	{
+		perror("NW_LongestFirst: malloc of order");
+		exit(EXIT_FAILURE);
+	}
+	for (size_t k = 0; k < n; ++k)
+		order[k] = k;
+	_sort_cost = cost;
+	qsort(order, n, sizeof(size_t), _compare_cost);
+	return order;
+}
+
+/********************************************************************************
+ * Pairs already in memory
+ */
+
+/** \struct NW_PairsContext
+ * \brief argument of _pair_task
+ */
+struct NW_PairsContext
+{
+	struct NW_Pair *pairs; /*!< the pairs */
+	enum NW_Engine engine; /*!< implementation used for all the pairs */
+};
+
+/*
+ * static void _pair_task(size_t index, int worker, void *arg)
+ * \brief computes pair number index of a NW_PairsContext
+ */
+static void _pair_task(size_t index, int worker, void *arg)
+{
+	struct NW_PairsContext *ctx = (struct NW_PairsContext *)arg;
+	struct NW_Pair *p = &ctx->pairs[index];
+	double start = NW_Now();
+	p->distance = EditDistance_NW(ctx->engine, p->A, p->lengthA, p->B, p->lengthB);
+	p->seconds = NW_Now() - start;
+	NW_MetricsJob(ctx->engine, p->lengthA, p->lengthB, p->seconds);
+}
+
+/* NW_RunPairs : see .h file for documentation
+ */
+void NW_RunPairs(struct NW_Pair *pairs, size_t n, enum NW_Engine engine, int nthreads)
+{
+	double *cost = (double *)malloc((n + 1) * sizeof(double));
+	if (cost == NULL)
+	{
+		perror("NW_RunPairs: malloc of cost");
+		exit(EXIT_FAILURE);
+	}
+	size_t stack_size = 0;
+	for (size_t k = 0; k < n; ++k)
+	{
+		cost[k] = (double)pairs[k].lengthA * (double)pairs[k].lengthB;
+		size_t s = NW_StackSize(pairs[k].lengthA, pairs[k].lengthB);
+		if (s > stack_size)
+			stack_size = s;
+	}
+	size_t *order = NW_LongestFirst(cost, n);
+	struct NW_PairsContext ctx = {pairs, engine};
+	NW_ParallelFor(n, order, nthreads, stack_size, _pair_task, &ctx);
+	free(order);
+	free(cost);
+}
+
+/********************************************************************************
+ * Manifest of pairs of regions
+ */
+
+/** \struct NW_ManifestEntry
+ * \brief one line of the manifest
+ */
+struct NW_ManifestEntry
+{
+	struct SeqFile *file[2]; /*!< the files containing both regions */
+	long begin[2];			 /*!< position of the regions in the files */
+	long length[2];			 /*!< length of the regions */
+	char *name;				 /*!< name of the pair printed in the result */
+	int priority;			 /*!< priority of the pair (cf struct NW_Job) */
+	double deadline;		 /*!< seconds after the start of the batch (0: none) */
+};
+
+/** \struct NW_ManifestContext
+ * \brief argument of the jobs of the manifest
+ */
+struct NW_ManifestContext
+{
+	struct NW_ManifestEntry *entries; /*!< the pairs of the manifest */
+	struct NW_Job *jobs;			  /*!< the job of each pair */
+	FILE *out;						  /*!< stream of the results */
+	struct NW_Capture *capture;		  /*!< log of the jobs, or NULL */
+	pthread_mutex_t out_lock;		  /*!< serializes the result lines */
+};
+
+/*
+ * static void _manifest_done(struct NW_Job *job)
+ * \brief prints the result of the job of a pair
+ */
+static void _manifest_done(struct NW_Job *job)
+{
+	struct NW_ManifestContext *ctx = (struct NW_ManifestContext *)job->arg;
+	struct NW_ManifestEntry *e = &ctx->entries[job - ctx->jobs];
+	pthread_mutex_lock(&ctx->out_lock);
+	if (job->status == ETIMEDOUT)
+		fprintf(stderr, "Warning: pair %s: deadline of %g s passed before it started.\n", e->name, e->deadline);
+	else if (job->status == ENOMEM)
+		fprintf(stderr, "Warning: pair %s: %zu bytes exceed the memory budget.\n", e->name, job->peak);
+	else if (job->downgraded)
+		fprintf(stderr, "Warning: pair %s: computed by engine %s for lack of memory.\n", e->name,
+				NW_EngineName(job->engine));
+	if (job->status != 0)
+		fprintf(ctx->out, "%s\tNA\t%zu\t%zu\t0\n", e->name, job->lengthA, job->lengthB);
+	else
+		fprintf(ctx->out, "%s\t%ld\t%zu\t%zu\t%.6f\n", e->name, job->distance, job->lengthA, job->lengthB, job->seconds);
+	fflush(ctx->out);
+	pthread_mutex_unlock(&ctx->out_lock);
+	if (ctx->capture != NULL)
+		NW_CaptureJob(ctx->capture, job, 0, 0);
+}
+
+/*
+ * static int _ends_with(const char *s, const char *suffix)
+ * \brief returns 1 iff s ends with suffix
+ */
+static int _ends_with(const char *s, const char *suffix)
+{
+	size_t ls = strlen(s), lsuffix = strlen(suffix);
+	return (ls >= lsuffix) && (strcmp(s + ls - lsuffix, suffix) == 0);
+}
+
+/* NW_RunManifest : see .h file for documentation
+ */
+int NW_RunManifest(const char *manifest, enum NW_Engine engine, const struct NW_SchedParams *sched,
+				   struct NW_Capture *capture, FILE *out)
+{
+	FILE *in = (strcmp(manifest, "-") == 0) ? stdin : fopen(manifest, "r");
+	if (in == NULL)
+	{
+		perror(manifest);
+		return 1;
+	}
+	int bedpe = _ends_with(manifest, ".bedpe");
+
+	struct SeqFileSet files;
+	SeqFileSet_init(&files);
+	struct NW_ManifestEntry *entries = NULL;
+	size_t n = 0, capacity = 0;
+	char *line = NULL;
+	size_t line_size = 0;
+	long lineno = 0;
+	int status = 0;
+	while (getline(&line, &line_size, in) != -1)
+	{
+		++lineno;
+		char *saveptr;
+		char *field[9];
+		int nfields = 0;
+		for (char *tok = strtok_r(line, " \t\r\n", &saveptr); tok != NULL && nfields < 9;
+			 tok = strtok_r(NULL, " \t\r\n", &saveptr))
+			field[nfields++] = tok;
+		if (nfields == 0 || field[0][0] == '#')
+			continue;
+		if (n == capacity)
+		{
+			capacity = (capacity == 0) ? 1024 : 2 * capacity;
+			entries = (struct NW_ManifestEntry *)realloc(entries, capacity * sizeof(struct NW_ManifestEntry));
+			if (entries == NULL)
+			{
+				perror("NW_RunManifest: realloc of entries");
+				exit(EXIT_FAILURE);
+			}
+		}
+		struct NW_ManifestEntry *e = &entries[n++];
+		for (int i = 0; i < 2; ++i)
+		{
+			e->file[i] = NULL; // a malformed line: the pair gets NA
+			e->begin[i] = e->length[i] = 0;
+			if (nfields < 6)
+				continue;
+			e->file[i] = SeqFileSet_open(&files, field[3 * i]);
+			e->begin[i] = strtol(field[3 * i + 1], NULL, 10);
+			e->length[i] = strtol(field[3 * i + 2], NULL, 10);
+			if (bedpe)
+				e->length[i] -= e->begin[i];
+		}
+		e->priority = (nfields >= 8) ? atoi(field[7]) : 0;
+		e->deadline = (nfields >= 9) ? atof(field[8]) : 0;
+		if (nfields >= 7)
+			e->name = strdup(field[6]);
+		else
+		{
+			char buf[32];
+			snprintf(buf, sizeof(buf), "%ld", lineno);
+			e->name = strdup(buf);
+		}
+	}
+	free(line);
+	if (in != stdin)
+		fclose(in);
+
+	// the pairs (a malformed line gets NA)
+	{
+		struct NW_SchedParams params = *sched;
+		double split = (params.split > 0) ? params.split : NW_SCHED_SPLIT;
+		double *cost = (double *)malloc((n + 1) * sizeof(double));
+		struct NW_Job *jobs = (struct NW_Job *)calloc(n + 1, sizeof(struct NW_Job));
+		if (cost == NULL || jobs == NULL)
+		{
+			perror("NW_RunManifest: malloc of the jobs");
+			exit(EXIT_FAILURE);
+		}
+		for (size_t k = 0; k < n; ++k)
+		{
+			long l0 = (entries[k].length[0] > 0) ? entries[k].length[0] : 0;
+			long l1 = (entries[k].length[1] > 0) ? entries[k].length[1] : 0;
+			cost[k] = (double)l0 * (double)l1;
+			size_t s = NW_StackSize((size_t)l0, (size_t)l1); // the split jobs do not use the engines
+			if (cost[k] < split && s > params.stack_size)
+				params.stack_size = s;
+		}
+		size_t *order = NW_LongestFirst(cost, n); // longest first within each size class
+
+		struct NW_ManifestContext ctx;
+		ctx.entries = entries;
+		ctx.jobs = jobs;
+		ctx.out = out;
+		ctx.capture = capture;
+		pthread_mutex_init(&ctx.out_lock, NULL);
+		fprintf(out, "#name\tdistance\tlength_1\tlength_2\tseconds\n");
+		struct NW_Scheduler *scheduler = NW_SchedulerCreate(&params);
+		double start = NW_Now();
+		for (size_t k = 0; k < n; ++k)
+		{
+			struct NW_ManifestEntry *e = &entries[order[k]];
+			struct NW_Job *job = &jobs[order[k]];
+			char *seq[2];
+			long length[2];
+			int i = 0;
+			while (i < 2 && e->file[i] != NULL &&
+				   SeqRegion(e->file[i], e->begin[i], e->length[i], &seq[i], &length[i], NULL) != SEQ_REGION_ERROR)
+				++i;
+			if (i < 2)
+			{
+				pthread_mutex_lock(&ctx.out_lock);
+				if (e->file[i] == NULL)
+					fprintf(stderr, "Warning: pair %s: 6 fields are required: file_1 begin_1 length_1 file_2 begin_2 "
+									"length_2 [name]\n", e->name);
+				else
+					fprintf(stderr, "Warning: pair %s: region %ld %ld out of file %s of %ld bytes.\n", e->name,
+							e->begin[i], e->length[i], e->file[i]->path, e->file[i]->length);
+				fprintf(out, "%s\tNA\t0\t0\t0\n", e->name);
+				fflush(out);
+				pthread_mutex_unlock(&ctx.out_lock);
+				status = 1;
+				continue;
+			}
+			job->A = seq[0];
+			job->lengthA = (size_t)length[0];
+			job->B = seq[1];
+			job->lengthB = (size_t)length[1];
+			job->engine = engine;
+			job->priority = e->priority;
+			job->deadline = (e->deadline > 0) ? start + e->deadline : 0;
+			job->done = _manifest_done;
+			job->arg = &ctx;
+			NW_SchedulerSubmit(scheduler, job);
+		}
+		if (params.adapt > 0)
+		{
+			double rate;
+			NW_SchedulerWait(scheduler);
+			int chosen = NW_SchedulerConcurrency(scheduler, NULL, &rate);
+			fprintf(stderr, "concurrency: %d of %d workers (%.3g cells/s)\n", chosen,
+					(params.nthreads <= 0) ? NW_DefaultThreads() : params.nthreads, rate);
+		}
+		NW_SchedulerDestroy(scheduler);
+		pthread_mutex_destroy(&ctx.out_lock);
+		free(order);
+		free(jobs);
+		free(cost);
+	}
+
+	for (size_t k = 0; k < n; ++k)
+		free(entries[k].name);
+	free(entries);
+	SeqFileSet_close(&files);
+	return status;
+}
@@ -0,0 +1,96 @@
+/**
+ * \file batch.h
+ * \brief batch mode: computes the edit distance of many pairs of sequences in one process
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * A manifest lists one pair of regions per line. Each distinct file is mapped once (cf sequence_map.h),
+ * the pairs of a manifest are scheduled by size class (cf scheduler.h) and one result line is printed as
+ * soon as a pair completes; the pairs given in memory (NW_RunPairs) are scheduled longest-first on a pool of threads (cf thread_pool.h).
+ */
+
+#ifndef __BATCH_H__
+#define __BATCH_H__
+
+#include <stdio.h>	/* for FILE */
+#include <stdlib.h> /* for size_t */
+
+#include "Needleman-Wunsch-recmemo.h" /* for enum NW_Engine */
+#include "scheduler.h"				  /* for struct NW_SchedParams */
+
+struct NW_Capture; /* cf capture.h */
+
+/** \struct NW_Pair
+ * \brief one pair of sequences and the result of its computation
+ */
+struct NW_Pair
+{
+	char *A;		 /*!< first sequence */
+	size_t lengthA;	 /*!< number of elements in A */
+	char *B;		 /*!< second sequence */
+	size_t lengthB;	 /*!< number of elements in B */
+	long distance;	 /*!< output: edit distance between A and B */
+	double seconds;	 /*!< output: wall clock time of the computation */
+};
+
+/**
+ * \fn double NW_Now(void);
+ * \brief returns a monotonic wall clock time in seconds
+ */
+double NW_Now(void);
+
+/**
+ * \fn size_t NW_StackSize(size_t lengthA, size_t lengthB);
+ * \brief returns a stack size large enough for any engine to run on sequences of the given lengths
+ *
+ * The linear space engines store O(lengthA + lengthB) longs in variable length arrays and
+ * EditDistance_NW_Rec recurses lengthA + lengthB times.
+ */
+size_t NW_StackSize(size_t lengthA, size_t lengthB);
+
+/**
+ * \fn size_t *NW_LongestFirst(const double *cost, size_t n);
+ * \brief returns the permutation of 0..n-1 sorting the tasks by decreasing cost (to be freed by the caller)
+ *
+ * Starting the longest tasks first avoids a long pair started last that would leave the other workers idle.
+ */
+size_t *NW_LongestFirst(const double *cost, size_t n);
+
+/**
+ * \fn void NW_RunPairs(struct NW_Pair *pairs, size_t n, enum NW_Engine engine, int nthreads);
+ * \brief computes the distance of all pairs, longest first, on nthreads threads
+ * \param pairs : the pairs; fields distance and seconds are set on return
+ * \param n : number of pairs
+ * \param engine : implementation used for all the pairs
+ * \param nthreads : number of threads (if <= 0: the number of online processors)
+ */
+void NW_RunPairs(struct NW_Pair *pairs, size_t n, enum NW_Engine engine, int nthreads);
+
+/**
+ * \fn int NW_RunManifest(const char *manifest, enum NW_Engine engine, const struct NW_SchedParams *sched, struct NW_Capture *capture, FILE *out);
+ * \brief computes the distance of all the pairs of regions listed in file manifest
+ * \param manifest : pathname of the manifest ("-" for stdin)
+ * \param engine : implementation used for all the pairs (but the ones split into tiles)
+ * \param sched : parameters of the scheduler (threads, reserved workers, split, cf scheduler.h); with a
+ *        concurrency controller, the number of workers chosen is printed on stderr at the end
+ * \param capture : if not NULL, log in which the jobs are captured (cf capture.h)
+ * \param out : stream on which one line is printed per pair, in completion order
+ * \return : 0 on success, >0 if a line of the manifest is malformed or out of its files
+ *
+ * Each non empty line of the manifest not starting by '#' describes a pair with the same
+ * fields as the arguments of the single pair mode, separated by spaces or tabs:
+ *     file_1 begin_1 length_1 file_2 begin_2 length_2 [name [priority [deadline]]]
+ * where deadline is in seconds after the start of the batch (a pair not started by then is not computed).
+ * If the manifest pathname ends with ".bedpe", the third and sixth fields are end positions
+ * (BEDPE convention, half-open intervals) instead of lengths.
+ * The name defaults to the line number in the manifest. The result lines are:
+ *     name distance length_1 length_2 seconds
+ * where the lengths are the ones actually used (after truncation to the end of file), and the distance
+ * is NA if the deadline of the pair passed, if the pair cannot fit in the memory budget, or if its line
+ * is malformed (less than 6 fields, a beginning beyond the end of file or a negative length; with a
+ * warning on stderr, the other pairs being computed).
+ */
+int NW_RunManifest(const char *manifest, enum NW_Engine engine, const struct NW_SchedParams *sched,
+				   struct NW_Capture *capture, FILE *out);
+
+#endif /* __BATCH_H__ */
@@ -0,0 +1,316 @@
+/**
+ * \file block_container.c
+ * \brief block compressed container of a collection of repetitive genetic sequences (written by nwpack)
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see block_container.h
+ */
+
+#include "block_container.h"
+#include "probes.h" /* USDT probes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <err.h>
+#include <string.h>	  /* for memcmp and memcpy */
+#include <fcntl.h>	  /* for open */
+#include <unistd.h>	  /* for close */
+#include <sys/mman.h> /* for mmap and munmap */
+#include <sys/stat.h> /* for file length */
+
+/* rounds n up to a multiple of 8 */
+#define _ALIGN8(n) (((n) + 7) & ~(size_t)7)
+
+/*****************************************************************************/
+/* Reading */
+
+/* NWZ_Open : see .h file for documentation
+ */
+int NWZ_Open(struct NWZ_Container *c, const char *path)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd == -1)
+		err(1, "open %s", path);
+	struct stat s;
+	if (fstat(fd, &s) == -1)
+		err(1, "fstat %s", path);
+	c->size = (size_t)s.st_size;
+	if (c->size < sizeof(struct NWZ_Header))
+	{
+		fprintf(stderr, "Error: %s is not a container (too short).\n", path);
+		close(fd);
+		return -1;
+	}
+	NW_PROBE1(map_start, path);
+	c->data = (const char *)mmap(NULL, c->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (c->data == MAP_FAILED)
+		err(1, "mmap %s", path);
+	NW_PROBE2(map_end, path, c->size);
+	close(fd);
+
+	c->header = (const struct NWZ_Header *)c->data;
+	c->seqs = NULL;
+	size_t pos = sizeof(struct NWZ_Header);
+	if (memcmp(c->header->magic, NWZ_MAGIC, sizeof(NWZ_MAGIC)) != 0 ||
+		c->header->nblocks > (c->size - pos) / sizeof(struct NWZ_Block))
+		goto invalid;
+	c->blocks = (const struct NWZ_Block *)(c->data + pos);
+	pos += c->header->nblocks * sizeof(struct NWZ_Block);
+	if (c->header->text_size > c->size - pos)
+		goto invalid;
+	c->text = c->data + pos;
+	for (uint64_t b = 0; b < c->header->nblocks; ++b) // a block is not empty (the engine reads its last char)
+		if (c->blocks[b].length == 0 || c->blocks[b].offset > c->header->text_size ||
+			c->blocks[b].length > c->header->text_size - c->blocks[b].offset)
+			goto invalid;
+	pos += c->header->text_size;
+	if (c->header->nseqs > (c->size - pos) / sizeof(struct NWZ_SeqHeader)) // before the malloc of seqs
+		goto invalid;
+
+	c->seqs = (struct NWZ_Seq *)malloc((c->header->nseqs + 1) * sizeof(struct NWZ_Seq));
+	if (c->seqs == NULL)
+	{
+		perror("NWZ_Open: malloc of seqs");
+		exit(EXIT_FAILURE);
+	}
+	for (uint64_t k = 0; k < c->header->nseqs; ++k)
+	{
+		if (c->size - pos < sizeof(struct NWZ_SeqHeader))
+			goto invalid;
+		const struct NWZ_SeqHeader *h = (const struct NWZ_SeqHeader *)(c->data + pos);
+		pos += sizeof(struct NWZ_SeqHeader);
+		if (h->name_length > c->size - pos)
+			goto invalid;
+		c->seqs[k].name = c->data + pos;
+		c->seqs[k].name_length = h->name_length;
+		pos += _ALIGN8(h->name_length);
+		if (pos > c->size || h->nb > (c->size - pos) / sizeof(uint32_t))
+			goto invalid;
+		c->seqs[k].ids = (const uint32_t *)(c->data + pos);
+		c->seqs[k].nb = h->nb;
+		c->seqs[k].length = h->length;
+		pos += _ALIGN8(h->nb * sizeof(uint32_t));
+		uint64_t length = 0; // the engine sizes its rows by the length of the sequence
+		for (uint64_t b = 0; b < h->nb; ++b)
+		{
+			if (c->seqs[k].ids[b] >= c->header->nblocks)
+				goto invalid;
+			length += c->blocks[c->seqs[k].ids[b]].length;
+		}
+		if (length != h->length)
+			goto invalid;
+	}
+	return 0;
+
+invalid:
+	fprintf(stderr, "Error: %s is not a valid container.\n", path);
+	free(c->seqs);
+	munmap((void *)c->data, c->size);
+	return -1;
+}
+
+/* NWZ_Close : see .h file for documentation
+ */
+void NWZ_Close(struct NWZ_Container *c)
+{
+	free(c->seqs);
+	munmap((void *)c->data, c->size);
+}
+
+/* NWZ_Find : see .h file for documentation
+ */
+const struct NWZ_Seq *NWZ_Find(const struct NWZ_Container *c, const char *name)
+{
+	size_t length = strlen(name);
+	for (uint64_t k = 0; k < c->header->nseqs; ++k)
+		if (c->seqs[k].name_length == length && memcmp(c->seqs[k].name, name, length) == 0)
+			return &c->seqs[k];
+	char *end;
+	unsigned long k = strtoul(name, &end, 10);
+	if (*name != '\0' && *end == '\0' && k < c->header->nseqs)
+		return &c->seqs[k];
+	return NULL;
+}
+
+/* NWZ_BlockText : see .h file for documentation
+ */
+const char *NWZ_BlockText(const struct NWZ_Container *c, uint32_t id, size_t *length)
+{
+	*length = c->blocks[id].length;
+	return c->text + c->blocks[id].offset;
+}
+
+/*****************************************************************************/
+/* Writing */
+
+/*
+ * static void *_grow(void *array, size_t *capacity, size_t needed, size_t element)
+ * \brief reallocates array so that it contains at least needed elements
+ */
+static void *_grow(void *array, size_t *capacity, size_t needed, size_t element)
+{
+	if (needed <= *capacity)
+		return array;
+	size_t capacity2 = (*capacity == 0) ? 1024 : *capacity;
+	while (capacity2 < needed)
+		capacity2 *= 2;
+	array = realloc(array, capacity2 * element);
+	if (array == NULL)
+	{
+		perror("NWZ_Writer: realloc");
+		exit(EXIT_FAILURE);
+	}
+	*capacity = capacity2;
+	return array;
+}
+
+/*
+ * static uint32_t _hash(const char *s, size_t length)
+ * \brief FNV-1a hash of the block s
+ */
+static uint32_t _hash(const char *s, size_t length)
+{
+	uint32_t h = 2166136261u;
+	for (size_t k = 0; k < length; ++k)
+		h = (h ^ (unsigned char)s[k]) * 16777619u;
+	return h;
+}
+
+/* NWZ_WriterInit : see .h file for documentation
+ */
+void NWZ_WriterInit(struct NWZ_Writer *w, size_t average)
+{
+	memset(w, 0, sizeof(*w));
+	w->average = (average < 4) ? 4 : average;
+	w->table_size = 1 << 16;
+	w->table = (uint32_t *)calloc(w->table_size, sizeof(uint32_t));
+	if (w->table == NULL)
+	{
+		perror("NWZ_WriterInit: calloc of table");
+		exit(EXIT_FAILURE);
+	}
+}
+
+/*
+ * static uint32_t _block_id(struct NWZ_Writer *w, const char *s, size_t length)
+ * \brief returns the identifier of block s, adding it if it is new
+ */
+static uint32_t _block_id(struct NWZ_Writer *w, const char *s, size_t length)
+{
+	uint32_t h = _hash(s, length);
+	size_t mask = w->table_size - 1;
+	size_t k;
+	for (k = h & mask; w->table[k] != 0; k = (k + 1) & mask)
+	{
+		const struct NWZ_Block *b = &w->blocks[w->table[k] - 1];
+		if (b->hash == h && b->length == length && memcmp(w->text + b->offset, s, length) == 0)
+			return w->table[k] - 1;
+	}
+	w->blocks = (struct NWZ_Block *)_grow(w->blocks, &w->blocks_capacity, w->nblocks + 1, sizeof(struct NWZ_Block));
+	w->text = (char *)_grow(w->text, &w->text_capacity, w->text_size + length, 1);
+	memcpy(w->text + w->text_size, s, length);
+	w->blocks[w->nblocks].offset = w->text_size;
+	w->blocks[w->nblocks].length = (uint32_t)length;
+	w->blocks[w->nblocks].hash = h;
+	w->text_size += length;
+	w->table[k] = (uint32_t)++w->nblocks;
+
+	if (2 * w->nblocks > w->table_size) // rehash in a table twice larger
+	{
+		free(w->table);
+		w->table_size *= 2;
+		w->table = (uint32_t *)calloc(w->table_size, sizeof(uint32_t));
+		if (w->table == NULL)
+		{
+			perror("NWZ_Writer: calloc of table");
+			exit(EXIT_FAILURE);
+		}
+		mask = w->table_size - 1;
+		for (size_t b = 0; b < w->nblocks; ++b)
+		{
+			for (k = w->blocks[b].hash & mask; w->table[k] != 0; k = (k + 1) & mask)
+				;
+			w->table[k] = (uint32_t)(b + 1);
+		}
+	}
+	return (uint32_t)(w->nblocks - 1);
+}
+
+/*
+ * static void _append(struct NWZ_Writer *w, const void *data, size_t size)
+ * \brief appends size bytes to the sequences section, padded to 8 bytes
+ */
+static void _append(struct NWZ_Writer *w, const void *data, size_t size)
+{
+	w->seqs = (char *)_grow(w->seqs, &w->seqs_capacity, w->seqs_size + _ALIGN8(size), 1);
+	memcpy(w->seqs + w->seqs_size, data, size);
+	memset(w->seqs + w->seqs_size + size, 0, _ALIGN8(size) - size);
+	w->seqs_size += _ALIGN8(size);
+}
+
+/* NWZ_WriterAdd : see .h file for documentation
+ * The boundaries are the positions where the rolling hash of the last NWZ_WINDOW characters is 0 modulo
+ * the average length, within [average/4, 4 average] characters from the previous boundary.
+ */
+void NWZ_WriterAdd(struct NWZ_Writer *w, const char *name, size_t name_length, const char *seq, size_t length)
+{
+	const uint64_t base = 0x100000001b3ull;
+	uint64_t out = 1; // base^NWZ_WINDOW: weight of the character leaving the window
+	for (int k = 0; k < NWZ_WINDOW; ++k)
+		out *= base;
+	size_t min = w->average / 4, max = 4 * w->average;
+
+	uint32_t *ids = NULL;
+	size_t nb = 0, capacity = 0;
+	size_t start = 0;
+	uint64_t h = 0;
+	for (size_t k = 0; k < length; ++k)
+	{
+		h = h * base + (unsigned char)seq[k] + 1;
+		if (k >= NWZ_WINDOW)
+			h -= out * ((unsigned char)seq[k - NWZ_WINDOW] + 1);
+		size_t size = k + 1 - start;
+		if (k + 1 == length || size >= max || (size >= min && (h >> 32) % w->average == 0))
+		{
+			ids = (uint32_t *)_grow(ids, &capacity, nb + 1, sizeof(uint32_t));
+			ids[nb++] = _block_id(w, seq + start, size);
+			start = k + 1;
+		}
+	}
+
+	struct NWZ_SeqHeader header = {length, nb, name_length};
+	_append(w, &header, sizeof(header));
+	_append(w, name, name_length);
+	_append(w, ids, nb * sizeof(uint32_t));
+	free(ids);
+	w->nseqs++;
+	w->total += length;
+}
+
+/* NWZ_WriterSave : see .h file for documentation
+ */
+int NWZ_WriterSave(struct NWZ_Writer *w, FILE *out)
+{
+	struct NWZ_Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, NWZ_MAGIC, sizeof(NWZ_MAGIC));
+	header.nblocks = w->nblocks;
+	header.nseqs = w->nseqs;
+	header.text_size = _ALIGN8(w->text_size);
+	header.total = w->total;
+
+	static const char zeros[8] = {0};
+	int res = (fwrite(&header, sizeof(header), 1, out) == 1 &&
+			   fwrite(w->blocks, sizeof(struct NWZ_Block), w->nblocks, out) == w->nblocks &&
+			   fwrite(w->text, 1, w->text_size, out) == w->text_size &&
+			   fwrite(zeros, 1, header.text_size - w->text_size, out) == header.text_size - w->text_size &&
+			   fwrite(w->seqs, 1, w->seqs_size, out) == w->seqs_size)
+				  ? 0
+				  : -1;
+	free(w->text);
+	free(w->blocks);
+	free(w->table);
+	free(w->seqs);
+	return res;
+}
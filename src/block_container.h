@@ -0,0 +1,165 @@
+/**
+ * \file block_container.h
+ * \brief block compressed container of a collection of repetitive genetic sequences (written by nwpack)
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Each sequence is cut into blocks at content defined positions (a rolling hash of the last
+ * NWZ_WINDOW characters), so that two sequences which only differ by a few substitutions or indels
+ * share all their blocks except the ones around the differences. Each distinct block is stored once;
+ * a sequence is the list of the identifiers of its blocks.
+ *
+ * File layout (integers in the byte order of the machine, every section aligned on 8 bytes):
+ *    header       : struct NWZ_Header
+ *    block table  : nblocks x struct NWZ_Block, offsets relative to the beginning of the text section
+ *    text         : the characters of the distinct blocks, concatenated
+ *    sequences    : nseqs x { struct NWZ_SeqHeader, name (name_length bytes, padded to 8),
+ *                             nb x uint32_t block identifiers (padded to 8) }
+ * The file is mapped read-only; the sequences are indexed when it is opened.
+ */
+
+#ifndef __BLOCK_CONTAINER_H__
+#define __BLOCK_CONTAINER_H__
+
+#include <stdlib.h> /* for size_t */
+#include <stdint.h> /* for uint64_t and uint32_t */
+#include <stdio.h>	/* for FILE */
+
+/** \def NWZ_MAGIC
+ *  \brief first 8 bytes of a container
+ */
+#define NWZ_MAGIC "NWZBLK1"
+
+/** \def NWZ_WINDOW
+ *  \brief number of characters of the rolling hash that chooses the block boundaries
+ */
+#define NWZ_WINDOW 16
+
+/** \def NWZ_DEFAULT_BLOCK
+ *  \brief default average length of a block (nwpack -b)
+ */
+#define NWZ_DEFAULT_BLOCK 128
+
+/** \struct NWZ_Header
+ * \brief header of a container file
+ */
+struct NWZ_Header
+{
+	char magic[8];		/*!< NWZ_MAGIC */
+	uint64_t nblocks;	/*!< number of distinct blocks */
+	uint64_t nseqs;		/*!< number of sequences */
+	uint64_t text_size; /*!< size of the text section (padded to 8) */
+	uint64_t total;		/*!< total length of the uncompressed sequences */
+};
+
+/** \struct NWZ_Block
+ * \brief a distinct block: its characters are text[offset .. offset+length-1]
+ */
+struct NWZ_Block
+{
+	uint64_t offset; /*!< position of the block in the text section */
+	uint32_t length; /*!< number of characters of the block */
+	uint32_t hash;	 /*!< hash of the characters (used by nwpack to find the duplicates) */
+};
+
+/** \struct NWZ_SeqHeader
+ * \brief header of a sequence in the sequences section
+ */
+struct NWZ_SeqHeader
+{
+	uint64_t length;	  /*!< number of characters of the uncompressed sequence */
+	uint64_t nb;		  /*!< number of blocks of the sequence */
+	uint64_t name_length; /*!< number of characters of the name (without '\0') */
+};
+
+/** \struct NWZ_Seq
+ * \brief a sequence of an opened container
+ */
+struct NWZ_Seq
+{
+	const char *name;	   /*!< name of the sequence (not '\0' terminated) */
+	size_t name_length;	   /*!< number of characters of name */
+	size_t length;		   /*!< number of characters of the uncompressed sequence */
+	size_t nb;			   /*!< number of blocks */
+	const uint32_t *ids;   /*!< identifiers of the blocks, in the order of the sequence */
+};
+
+/** \struct NWZ_Container
+ * \brief an opened container, mapped read-only
+ */
+struct NWZ_Container
+{
+	const char *data;			   /*!< address of the mapping */
+	size_t size;				   /*!< size of the mapping */
+	const struct NWZ_Header *header; /*!< header of the file */
+	const struct NWZ_Block *blocks; /*!< the block table */
+	const char *text;			   /*!< the text section */
+	struct NWZ_Seq *seqs;		   /*!< the nseqs sequences, allocated */
+};
+
+/**
+ * \fn int NWZ_Open(struct NWZ_Container *c, const char *path);
+ * \brief maps the container path and indexes its sequences
+ * \return : 0 on success, -1 (with a message on stderr) if the file is not a valid container
+ */
+int NWZ_Open(struct NWZ_Container *c, const char *path);
+
+/**
+ * \fn void NWZ_Close(struct NWZ_Container *c);
+ * \brief unmaps the container
+ */
+void NWZ_Close(struct NWZ_Container *c);
+
+/**
+ * \fn const struct NWZ_Seq *NWZ_Find(const struct NWZ_Container *c, const char *name);
+ * \brief returns the sequence named name, or the sequence of index name if name is a number, or NULL
+ */
+const struct NWZ_Seq *NWZ_Find(const struct NWZ_Container *c, const char *name);
+
+/**
+ * \fn const char *NWZ_BlockText(const struct NWZ_Container *c, uint32_t id, size_t *length);
+ * \brief returns the characters of block id and sets *length to its number of characters
+ */
+const char *NWZ_BlockText(const struct NWZ_Container *c, uint32_t id, size_t *length);
+
+/********************************************************************************
+ * Writing a container (nwpack)
+ */
+
+/** \struct NWZ_Writer
+ * \brief a container being built: the distinct blocks and the sequences are kept in memory
+ */
+struct NWZ_Writer
+{
+	size_t average;			 /*!< average length of a block */
+	char *text;				 /*!< characters of the distinct blocks */
+	size_t text_size, text_capacity;
+	struct NWZ_Block *blocks; /*!< the distinct blocks */
+	size_t nblocks, blocks_capacity;
+	uint32_t *table;		 /*!< hash table of the blocks: id+1, 0 if empty */
+	size_t table_size;		 /*!< size of table, a power of 2 */
+	char *seqs;				 /*!< the sequences section */
+	size_t seqs_size, seqs_capacity;
+	uint64_t nseqs;			 /*!< number of sequences added */
+	uint64_t total;			 /*!< total length of the sequences added */
+};
+
+/**
+ * \fn void NWZ_WriterInit(struct NWZ_Writer *w, size_t average);
+ * \brief initializes an empty container whose blocks have average characters on average
+ */
+void NWZ_WriterInit(struct NWZ_Writer *w, size_t average);
+
+/**
+ * \fn void NWZ_WriterAdd(struct NWZ_Writer *w, const char *name, size_t name_length, const char *seq, size_t length);
+ * \brief cuts seq into blocks and adds it to the container
+ */
+void NWZ_WriterAdd(struct NWZ_Writer *w, const char *name, size_t name_length, const char *seq, size_t length);
+
+/**
+ * \fn int NWZ_WriterSave(struct NWZ_Writer *w, FILE *out);
+ * \brief writes the container to out and frees it; returns 0 on success
+ */
+int NWZ_WriterSave(struct NWZ_Writer *w, FILE *out);
+
+#endif /* __BLOCK_CONTAINER_H__ */
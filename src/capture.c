@@ -0,0 +1,198 @@
+/**
+ * \file capture.c
+ * \brief capture of the jobs of the batch and service modes in a binary log, replayed by nwreplay
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see capture.h
+ */
+
+#include "capture.h"
+#include "batch.h" /* for NW_Now */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> /* for memcpy and strerror */
+#include <errno.h>
+#include <time.h>	  /* for clock_gettime */
+#include <fcntl.h>	  /* for O_EXCL */
+#include <unistd.h>	  /* for write */
+#include <sys/stat.h> /* for mkdir */
+#include <pthread.h>
+
+/** \struct NW_Capture
+ * \brief a log being written
+ */
+struct NW_Capture
+{
+	FILE *log;
+	double start;		  /*!< NW_Now() at the start of the capture */
+	char *cache;		  /*!< directory of the sequences, or NULL */
+	uint64_t *seen;		  /*!< open addressing set of the fingerprints written in the cache (0: empty) */
+	size_t seen_size;	  /*!< a power of 2 */
+	size_t seen_count;
+	pthread_mutex_t lock; /*!< serializes the records and the cache */
+};
+
+/* NW_Fingerprint : see .h file for documentation
+ */
+uint64_t NW_Fingerprint(const char *s, size_t length)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (size_t k = 0; k < length; ++k)
+		h = (h ^ (unsigned char)s[k]) * 0x100000001b3ULL;
+	return h;
+}
+
+/* NW_CaptureOpen : see .h file for documentation
+ */
+struct NW_Capture *NW_CaptureOpen(const char *path, const char *cache)
+{
+	FILE *log = fopen(path, "wb");
+	if (log == NULL)
+	{
+		fprintf(stderr, "Error: capture log %s: %s.\n", path, strerror(errno));
+		return NULL;
+	}
+	if (cache != NULL && mkdir(cache, 0755) != 0 && errno != EEXIST)
+	{
+		fprintf(stderr, "Error: capture cache %s: %s.\n", cache, strerror(errno));
+		fclose(log);
+		return NULL;
+	}
+	struct NW_Capture *c = (struct NW_Capture *)calloc(1, sizeof(struct NW_Capture));
+	if (c == NULL)
+	{
+		perror("NW_CaptureOpen: malloc of the capture");
+		exit(EXIT_FAILURE);
+	}
+	c->log = log;
+	c->start = NW_Now();
+	c->cache = (cache == NULL) ? NULL : strdup(cache);
+	pthread_mutex_init(&c->lock, NULL);
+
+	struct NW_CaptureHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, NW_CAPTURE_MAGIC, 8);
+	h.version = NW_CAPTURE_VERSION;
+	h.record_size = sizeof(struct NW_CaptureRecord);
+	struct timespec t;
+	clock_gettime(CLOCK_REALTIME, &t);
+	h.epoch_ns = (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+	fwrite(&h, sizeof(h), 1, log);
+	return c;
+}
+
+/*
+ * static int _first_time(struct NW_Capture *c, uint64_t fingerprint)
+ * \brief adds fingerprint to the set of the sequences of the cache, the lock held; returns 1 iff it was not in it
+ */
+static int _first_time(struct NW_Capture *c, uint64_t fingerprint)
+{
+	if (fingerprint == 0) // the empty value of the set
+		fingerprint = 1;
+	if (2 * (c->seen_count + 1) > c->seen_size)
+	{
+		size_t size = (c->seen_size == 0) ? 1024 : 2 * c->seen_size;
+		uint64_t *seen = (uint64_t *)calloc(size, sizeof(uint64_t));
+		if (seen == NULL)
+		{
+			perror("NW_CaptureJob: malloc of the set of the sequences");
+			exit(EXIT_FAILURE);
+		}
+		for (size_t k = 0; k < c->seen_size; ++k)
+			if (c->seen[k] != 0)
+			{
+				size_t i = c->seen[k] & (size - 1);
+				while (seen[i] != 0)
+					i = (i + 1) & (size - 1);
+				seen[i] = c->seen[k];
+			}
+		free(c->seen);
+		c->seen = seen;
+		c->seen_size = size;
+	}
+	size_t i = fingerprint & (c->seen_size - 1);
+	for (; c->seen[i] != 0; i = (i + 1) & (c->seen_size - 1))
+		if (c->seen[i] == fingerprint)
+			return 0;
+	c->seen[i] = fingerprint;
+	c->seen_count++;
+	return 1;
+}
+
+/*
+ * static void _cache(struct NW_Capture *c, uint64_t fingerprint, const char *s, size_t length)
+ * \brief writes a sequence in the cache if it is not already there, the lock held
+ */
+static void _cache(struct NW_Capture *c, uint64_t fingerprint, const char *s, size_t length)
+{
+	if (!_first_time(c, fingerprint))
+		return;
+	char path[4096];
+	snprintf(path, sizeof(path), "%s/%016llx.seq", c->cache, (unsigned long long)fingerprint);
+	int fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644); // kept from a previous capture if it exists
+	if (fd < 0)
+		return;
+	for (size_t done = 0; done < length;)
+	{
+		ssize_t n = write(fd, s + done, length - done);
+		if (n <= 0)
+		{
+			fprintf(stderr, "Warning: capture cache %s: %s.\n", path, strerror(errno));
+			unlink(path);
+			break;
+		}
+		done += (size_t)n;
+	}
+	close(fd);
+}
+
+/* NW_CaptureJob : see .h file for documentation
+ */
+void NW_CaptureJob(struct NW_Capture *c, const struct NW_Job *job, int mode, double precision)
+{
+	struct NW_CaptureRecord r;
+	memset(&r, 0, sizeof(r));
+	double submit = job->submitted - c->start, queue = (job->start > 0) ? job->start - job->submitted : 0;
+	r.submit_ns = (submit > 0) ? (uint64_t)(submit * 1e9) : 0;
+	r.queue_ns = (queue > 0) ? (uint64_t)(queue * 1e9) : 0;
+	r.run_ns = (uint64_t)(job->seconds * 1e9);
+	r.fingerprintA = NW_Fingerprint(job->A, job->lengthA);
+	r.fingerprintB = NW_Fingerprint(job->B, job->lengthB);
+	r.lengthA = job->lengthA;
+	r.lengthB = job->lengthB;
+	r.distance = (job->status == 0) ? job->distance : -1;
+	r.precision = precision;
+	r.priority = job->priority;
+	if (job->deadline != 0)
+	{
+		double deadline = 1e3 * (job->deadline - job->submitted);
+		r.deadline_ms = (deadline < 1) ? 1 : (deadline > UINT32_MAX) ? UINT32_MAX : (uint32_t)deadline;
+	}
+	r.engine = (uint8_t)(job->downgraded ? job->requested : job->engine);
+	r.mode = (uint8_t)mode;
+	r.status = (uint8_t)job->status;
+	r.flags = (job->tiled ? NW_CAPTURE_TILED : 0) | (job->downgraded ? NW_CAPTURE_DOWNGRADED : 0);
+
+	pthread_mutex_lock(&c->lock);
+	fwrite(&r, sizeof(r), 1, c->log);
+	if (c->cache != NULL)
+	{
+		_cache(c, r.fingerprintA, job->A, job->lengthA);
+		_cache(c, r.fingerprintB, job->B, job->lengthB);
+	}
+	pthread_mutex_unlock(&c->lock);
+}
+
+/* NW_CaptureClose : see .h file for documentation
+ */
+void NW_CaptureClose(struct NW_Capture *c)
+{
+	if (fclose(c->log) != 0)
+		perror("NW_CaptureClose");
+	pthread_mutex_destroy(&c->lock);
+	free(c->cache);
+	free(c->seen);
+	free(c);
+}
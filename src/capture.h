@@ -0,0 +1,107 @@
+/**
+ * \file capture.h
+ * \brief capture of the jobs of the batch and service modes in a binary log, replayed by nwreplay
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * The log is a header followed by one fixed size record per completed job (in completion order), in the
+ * byte order of the machine: the fingerprints and lengths of both sequences, the engine, the mode and the
+ * parameters of the request, the time of its submission since the start of the capture, its time in the
+ * queues and its computation time, and its result. The sequences themselves are not logged; with a cache
+ * directory, each distinct sequence is also written once in <cache>/<fingerprint>.seq, so that the replay
+ * can run on the real inputs (else it generates synthetic sequences of the same lengths and distance).
+ */
+
+#ifndef __CAPTURE_H__
+#define __CAPTURE_H__
+
+#include <stdio.h>	/* for FILE */
+#include <stdint.h> /* for uint64_t */
+#include <stdlib.h> /* for size_t */
+
+#include "scheduler.h" /* for struct NW_Job */
+
+/** \def NW_CAPTURE_MAGIC
+ *  \brief first 8 bytes of a log
+ */
+#define NW_CAPTURE_MAGIC "NWCAPLOG"
+
+/** \def NW_CAPTURE_VERSION
+ *  \brief version of the layout of the records
+ */
+#define NW_CAPTURE_VERSION 1
+
+/** \struct NW_CaptureHeader
+ * \brief beginning of a log
+ */
+struct NW_CaptureHeader
+{
+	char magic[8];		  /*!< NW_CAPTURE_MAGIC */
+	uint32_t version;	  /*!< NW_CAPTURE_VERSION */
+	uint32_t record_size; /*!< sizeof(struct NW_CaptureRecord) */
+	uint64_t epoch_ns;	  /*!< CLOCK_REALTIME of the start of the capture, in nanoseconds */
+};
+
+/** \struct NW_CaptureRecord
+ * \brief one job
+ */
+struct NW_CaptureRecord
+{
+	uint64_t submit_ns;			/*!< submission, since the start of the capture */
+	uint64_t queue_ns;			/*!< from the submission to the start of the computation */
+	uint64_t run_ns;			/*!< computation */
+	uint64_t fingerprintA;		/*!< NW_Fingerprint of the first sequence */
+	uint64_t fingerprintB;		/*!< NW_Fingerprint of the second sequence */
+	uint64_t lengthA, lengthB;	/*!< lengths of the sequences */
+	int64_t distance;			/*!< result (-1 if the job failed) */
+	double precision;			/*!< estimate mode: precision requested */
+	int32_t priority;			/*!< cf struct NW_Job */
+	uint32_t deadline_ms;		/*!< deadline after the submission (0 if none) */
+	uint8_t engine;				/*!< enum NW_Engine requested */
+	uint8_t mode;				/*!< 0: distance, 1: estimate (as enum NW_ShmMode) */
+	uint8_t status;				/*!< errno of the job (0, ETIMEDOUT or ENOMEM) */
+	uint8_t flags;				/*!< NW_CAPTURE_TILED | NW_CAPTURE_DOWNGRADED */
+	uint32_t reserved;			/*!< 0 */
+};
+
+/** \def NW_CAPTURE_TILED
+ *  \brief flag of a job split into tiles
+ */
+#define NW_CAPTURE_TILED 1
+
+/** \def NW_CAPTURE_DOWNGRADED
+ *  \brief flag of a job computed by NW_ENGINE_ITERATIF for lack of memory
+ */
+#define NW_CAPTURE_DOWNGRADED 2
+
+/** \struct NW_Capture
+ * \brief a log being written
+ */
+struct NW_Capture;
+
+/**
+ * \fn uint64_t NW_Fingerprint(const char *s, size_t length);
+ * \brief returns the 64 bits FNV-1a hash of s[0 .. length-1]
+ */
+uint64_t NW_Fingerprint(const char *s, size_t length);
+
+/**
+ * \fn struct NW_Capture *NW_CaptureOpen(const char *path, const char *cache);
+ * \brief creates the log path, and the cache directory cache if not NULL
+ * \return : the log, or NULL (with a message on stderr) if it cannot be created
+ */
+struct NW_Capture *NW_CaptureOpen(const char *path, const char *cache);
+
+/**
+ * \fn void NW_CaptureJob(struct NW_Capture *c, const struct NW_Job *job, int mode, double precision);
+ * \brief logs a completed job (thread safe); called by its done function, while its sequences are valid
+ */
+void NW_CaptureJob(struct NW_Capture *c, const struct NW_Job *job, int mode, double precision);
+
+/**
+ * \fn void NW_CaptureClose(struct NW_Capture *c);
+ * \brief flushes and closes the log
+ */
+void NW_CaptureClose(struct NW_Capture *c);
+
+#endif /* __CAPTURE_H__ */
@@ -38,58 +38,44 @@ enum Base
 /** \var static enum Base  _base_match[256]
  * 
  * \brief _base_match maps directly a char to its corresponding base 
- */ 
-static enum Base  _base_match[256] = { SKIP_BASE }; /* initially all chars are ignored */
-
-/**
- * \fn static void _init_base_match()
- * \brief definition of the  mapping from char to base
  *
- * Has to be called once before any computation for identification of a char as a base
- */
-static void  _init_base_match() /* initialisation of _base_match array for correspondence from char to base */
-{ 
-   for (int c = 0; c < 256; ++c) _base_match[c] = SKIP_BASE ;
-   _base_match['a'] = ADENINE ;
-   _base_match['A'] = ADENINE ;
-   _base_match['c'] = CYTOSINE ;
-   _base_match['C'] = CYTOSINE ;
-   _base_match['g'] = GUANINE ;
-   _base_match['G'] = GUANINE ;
-   _base_match['t'] = THYMINE ;
-   _base_match['T'] = THYMINE ;
-   _base_match['u'] = URACILE ;
-   _base_match['U'] = URACILE ;
-   _base_match['n'] = UNKOWN_BASE ;
-   _base_match['N'] = UNKOWN_BASE ;
-}
-
+ * The table is initialized statically (designated initializers) so that it is never written 
+ * at run time: engines may run concurrently in several threads (batch mode).
+ */ 
+static enum Base  _base_match[256] = { /* all other chars are ignored (SKIP_BASE) */
+   ['a'] = ADENINE,  ['A'] = ADENINE,
+   ['c'] = CYTOSINE, ['C'] = CYTOSINE,
+   ['g'] = GUANINE,  ['G'] = GUANINE,
+   ['t'] = THYMINE,  ['T'] = THYMINE,
+   ['u'] = URACILE,  ['U'] = URACILE,
+   ['n'] = UNKOWN_BASE, ['N'] = UNKOWN_BASE
+};
 
 /**
  * \def CharToBase(c)
  * \brief retuns the Base (among enum Base} that matches character c 
  */
-#define CharToBase(c)	( _base_match[c] )
+#define CharToBase(c)	( _base_match[(unsigned char)(c)] )
 
 /**
  * \def isBase(c)
  * \brief retuns 0 iff char c match does not match a base 
  * i.e. c matches a base which is either known (A,C,G,T,U) or unknown (N)
  */
-#define isBase(c)	( _base_match[c] != SKIP_BASE )
+#define isBase(c)	( _base_match[(unsigned char)(c)] != SKIP_BASE )
 
 /**
  * \def isUnknownBase(c)
  * \brief retuns 0 iff char c match does not match an unknown  base ('n' or 'N')
  * i.e. c matches a base which is A,C,G,T,U
  */
-#define isUnknownBase(c)	( _base_match[c] == UNKOWN_BASE )
+#define isUnknownBase(c)	( _base_match[(unsigned char)(c)] == UNKOWN_BASE )
 
 /**
  * \def isSameBase(a,b)
  * \brief retuns 0 iff chars a and b are mapped to two different bases 
  */
-#define isSameBase(a,b)	( _base_match[a] == _base_match[b] )
+#define isSameBase(a,b)	( _base_match[(unsigned char)(a)] == _base_match[(unsigned char)(b)] )
 
 /** \enum BASE_ERROR_TREATMENT_MODE
  * \brief  BASE_ERROR_TREATMENT defines way a char not in AaCcGgTtUuNn is processed; either IGNORED (default), or WARNING (prints a message on stderr), or EROOR (stops execution). 
@@ -97,7 +83,7 @@ static void  _init_base_match() /* initialisation of _base_match array for corre
 enum BASE_ERROR_TREATMENT_MODE { IGNORED = 0, WARNING = 1, ERROR=2  } ;
 
 /** 
- * \fn void ManageBaseError(char c)
+ * \fn static inline void ManageBaseError(char c)
  * \brief according to BASE_ERROR_TREATMENT prints on stderr either nothing, or a warning or an error if the char passed as argument is not a base (known or unknown) nor a space char
  * \param c the character 
  *
@@ -107,7 +93,7 @@ enum BASE_ERROR_TREATMENT_MODE { IGNORED = 0, WARNING = 1, ERROR=2  } ;
  *   BASE_ERROR   : if c is neither a base nor a space, then prints an error with c on stderr and exit
  *   default : does nothing (just return)
 */
-void ManageBaseError(char c)
+static inline void ManageBaseError(char c)
 { 
    #ifdef BASE_ERROR_TREATMENT
    {  if (isBase(c)) return ; // no error
@@ -45,6 +45,23 @@ EXAMPLE
  */
 
 #include "Needleman-Wunsch-recmemo.h" // Recursive implementation of NeedlemanWunsch with memoization
+#include "sequence_map.h"			  // shared mapping of the files
+#include "batch.h"					  // batch mode (-m manifest)
+#include "Needleman-Wunsch-kernel.h"	  // tile kernels (-k kernel)
+#include "Needleman-Wunsch-masked.h"	  // soft-mask policy (-P policy)
+#include "block_container.h"		  // compressed sequences (-z container)
+#include "estimate.h"				  // estimate mode (-s precision)
+#include "dotplot.h"				  // dot plot mode (-d output)
+#include "divergence.h"				  // divergence track (-b output)
+#include "Needleman-Wunsch-traceback.h" // alignment (-A output)
+#include "Needleman-Wunsch-graph.h"	  // alignment to a graph (-G graph)
+#include "stream_banded.h"			  // streaming mode (-f band)
+#include "shm_service.h"			  // shared memory service (--serve-shm /name)
+#include "capture.h"				  // capture of the jobs (-L log)
+#include "probes.h"				  // USDT probes (job_start, decode_start, ...)
+#include "tree.h"					  // guide tree (-z container -o matrix, -g matrix)
+#include "arrow_ipc.h"				  // Arrow columns (-a sequences pairs output)
+#include "characters_to_base.h"		  // for isBase (windows of the divergence track)
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -67,16 +84,38 @@ void usage_and_spec(int argc, char *argv[]) // spécification du programme
 {
 	fprintf(stderr,
 			"%s : bad number of arguments: 6 are required (but this execution is with %d instead).\n"
-			"Usage:   %s  file_1 begin_1 length_1 file_2 begin_2 length_2 \n\n"
+			"Usage:   %s  file_1 begin_1 length_1 file_2 begin_2 length_2 \n"
+			"         %s  -m manifest [-t threads] [-e engine] [-k kernel] [-P policy] [-R reserved] [-S split] [-B budget] [-C period] [-L log [-K cache]] \n"
+			"         %s  -z container [name_1 name_2 | -o matrix] \n"
+			"         %s  -g matrix [-u] [-t threads] [-p prefix] [-o tree] \n"
+			"         %s  -a sequences pairs output [-c column] [-i first,second] [-t threads] [-e engine] \n"
+			"         %s  -s precision [-w window] [-t threads] [-e engine] file_1 begin_1 length_1 file_2 begin_2 length_2 \n"
+			"         %s  -d output [-k k] [-p pixels] [-x sampling] [-o max_occ] [-t threads] file_1 begin_1 length_1 file_2 begin_2 length_2 \n"
+			"         %s  -b output [-w window] [-c chrom] [-e engine] file_1 begin_1 length_1 file_2 begin_2 length_2 \n"
+			"         %s  -A output [-B budget] file_1 begin_1 length_1 file_2 begin_2 length_2 \n"
+			"         %s  -G graph [-A output] [-B budget] file begin length \n"
+			"         %s  -f band [-c chunk] stream_1 stream_2 \n"
+			"         %s  --serve-shm /name [-t threads] [-r ring_bytes] [-q entries] [-l max_length] [-M metrics] [-R reserved] [-S split] [-B budget] [-C period] [-L log [-K cache]] \n\n"
 			"%s prints the edit distance between two genetic sequences seq[i] for i=1..2  where \n"
 			"seq[i] denotes the sequence of <length_i> char in <file_i> from position <begin_i>.",
-			argv[0], argc - 1, argv[0], argv[0]);
+			argv[0], argc - 1, argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0], argv[0]);
 
 	fprintf(stderr, "\n"
 					"\nNAME"
 					"\n     distanceEdition - compute edit distance between two substrings, each from a file"
 					"\nSYNOPSIS"
 					"\n     distanceEdition file_1 b1 L_1 file_2 b_2 L_2"
+					"\n     distanceEdition -m manifest [-t threads] [-e engine] [-k kernel] [-P policy] [-R reserved] [-S split] [-B budget] [-C period] [-L log [-K cache]]"
+					"\n     distanceEdition -z container [name_1 name_2 | -o matrix]"
+					"\n     distanceEdition -g matrix [-u] [-t threads] [-p prefix] [-o tree]"
+					"\n     distanceEdition -a sequences pairs output [-c column] [-i first,second] [-t threads] [-e engine]"
+					"\n     distanceEdition -s precision [-w window] [-t threads] [-e engine] file_1 b1 L_1 file_2 b_2 L_2"
+					"\n     distanceEdition -d output [-k k] [-p pixels] [-x sampling] [-o max_occ] [-t threads] file_1 b1 L_1 file_2 b_2 L_2"
+					"\n     distanceEdition -b output [-w window] [-c chrom] [-e engine] file_1 b1 L_1 file_2 b_2 L_2"
+					"\n     distanceEdition -A output [-B budget] file_1 b1 L_1 file_2 b_2 L_2"
+					"\n     distanceEdition -G graph [-A output] [-B budget] file b L"
+					"\n     distanceEdition -f band [-c chunk] stream_1 stream_2"
+					"\n     distanceEdition --serve-shm /name [-t threads] [-r ring_bytes] [-q entries] [-l max_length] [-M metrics] [-R reserved] [-S split] [-B budget] [-C period] [-L log [-K cache]]"
 					"\nDESCRIPTION"
 					"\n     distanceEdition computes the edit distance between two arrays of"
 					"\n     characters array_file_1[b_1, b_1+L_1( and array_file2[b_2,b_2+L_2( where:"
@@ -92,6 +131,107 @@ void usage_and_spec(int argc, char *argv[]) // spécification du programme
 					"\n           editDistance( array_file_1 + b_1, L_1, array_file_2, + b_2, L_2 )"
 					"\n        where the extern C function has prototype :"
 					"\n           editDistance( char* A, size_t lengthA, char* B, size_t lengthB);"
+					"\nBATCH MODE"
+					"\n     With -m, distanceEdition reads a manifest (\"-\" for stdin) with one pair per line:"
+					"\n           file_1 b_1 L_1 file_2 b_2 L_2 [name [priority [deadline]]]"
+					"\n     (or file_1 b_1 e_1 file_2 b_2 e_2 ... with end positions if the manifest ends with .bedpe)."
+					"\n     Each distinct file is mapped once, the pairs are computed by <threads> threads (default: number"
+					"\n     of processors) with engine rec, iteratif, cache_aware (default), multilevel or cache_oblivious,"
+					"\n     and one line \"name distance L_1 L_2 seconds\" is printed per pair on stdout as soon as it is"
+					"\n     computed. The pairs are queued by size class, the highest priority (default 0) first, then the"
+					"\n     earliest deadline (seconds after the start; a pair not started by then gets distance NA):"
+					"\n     <reserved> threads (default: a quarter) only compute the pairs of less than 10^6 cells, and the"
+					"\n     pairs of at least <split> cells (default 10^8) are computed by tiles interleaved with the small"
+					"\n     pairs. Each pair reserves its predicted peak memory from <budget> bytes (default: half of the"
+					"\n     physical memory) when it starts: a pair which does not fit waits, or is computed by the engine"
+					"\n     iteratif if it fits then (with a warning on stderr), and a pair larger than the budget gets"
+					"\n     distance NA. The tile kernel of the linear space engines is scalar (default) or antidiag"
+					"\n     (option -k or environment variable NW_KERNEL)."
+					"\n     The files of a network filesystem are read in memory by large blocks when they are opened instead"
+					"\n     of mapped (environment variable NW_MAP=map|read to force either)."
+					"\n     The soft-masked (lowercase) intervals of the sequences are aligned as the other bases (policy"
+					"\n     align, default), within a band of w columns (band[:w], default 64; an upper bound of the"
+					"\n     distance), or removed at cost c per masked base (skip[:c], default 0.5) (option -P or"
+					"\n     environment variable NW_MASK). The pairs are not split in tiles with the policies band and skip."
+					"\n     With -C, a controller measures the throughput (cells per second) every <period> seconds and moves"
+					"\n     the number of workers taking the large pairs to the best one: when the memory bandwidth is"
+					"\n     saturated, fewer workers compute as fast. The number chosen is printed on stderr at the end."
+					"\nCOMPRESSED MODE"
+					"\n     With -z, the sequences are read in a block compressed container built by nwpack. The distance"
+					"\n     between the sequences name_1 and name_2 (names or indexes) is printed, or if they are not given one"
+					"\n     line \"name_1 name_2 distance\" per pair of sequences. The tiles of the pairs of blocks already met"
+					"\n     with the same input boundaries are not computed again (statistics on stderr). With -o, the"
+					"\n     distances of all the pairs are written in the binary matrix file <matrix> instead (cf tree.h)."
+					"\nGUIDE TREE"
+					"\n     With -g, the guide tree of the sequences of a matrix file written by -z container -o matrix is"
+					"\n     built by neighbour joining (or UPGMA with -u) on <threads> threads and written in the Newick"
+					"\n     format in <tree> (default: stdout). Each node keeps its <prefix> nearest nodes sorted (default 256),"
+					"\n     so that most of the matrix is not read again at each merge."
+					"\nARROW MODE"
+					"\n     With -a, the sequences are the strings (Binary or Utf8) of <column> (default: the first one) of the"
+					"\n     Arrow IPC file or stream <sequences>, read without copy, and the pairs are the rows of the integer"
+					"\n     columns <first> and <second> (default: the first two) of <pairs> (possibly the same file), indexes"
+					"\n     of rows of <sequences>. The distances are written in <output> (- for a stream on stdout) as the"
+					"\n     Int64 column \"distance\" of the rows of <pairs>, null for a pair with a null index or sequence."
+					"\n     An input \"-\" is a stream read on stdin. The pairs are computed as by NW_RunPairs (batch.h)."
+					"\nESTIMATE MODE"
+					"\n     With -s, the distance is estimated from a random sample of windows of <window> characters of"
+					"\n     the first sequence (default 4096), each aligned with the window of the second one found by k-mer"
+					"\n     anchors. The sample is doubled until the 95%% confidence interval is narrower than <precision>"
+					"\n     times the estimate (eg 0.05), at most all the windows but one. Prints \"estimate low high windows"
+					"\n     total_windows seconds\"; the bound of the error of placement of the windows, which does not"
+					"\n     decrease with the sample, is written on stderr."
+					"\nDOT PLOT MODE"
+					"\n     With -d, the k-mers (default k = 20) shared by the two sequences on the same or on opposite strands"
+					"\n     are written in <output>: a PGM image of <pixels> pixels on its longest side (default 1000) if"
+					"\n     <output> ends with .pgm, else one line \"position_1 position_2 strand\" per hit. One k-mer out of"
+					"\n     <sampling> is used (default 1) and the k-mers found more than <max_occ> times are ignored."
+					"\nDIVERGENCE MODE"
+					"\n     With -b, an optimal alignment is computed in linear space and the costs of its operations are"
+					"\n     summed by windows of <window> bases of the first sequence (default 10000), written in <output>"
+					"\n     as a bedGraph track \"chrom start end cost\" in base coordinates of its FASTA record (the bases"
+					"\n     from the line after its '>' header), with <chrom> as name (default: the first word of the"
+					"\n     header, or file_1 without header). Prints the distance (the sum of the costs)."
+					"\nALIGNMENT MODE"
+					"\n     With -A, an optimal alignment is computed with a full table of 2 bit moves by anti-diagonal"
+					"\n     (about L_1 L_2 / 4 bytes) and written in <output> (- for stdout) as an extended CIGAR string"
+					"\n     of the bases (=, X, D, I; file_1 is the reference). The table has to fit in <budget> bytes"
+					"\n     (default: half of the physical memory), else use -b. Prints the distance."
+					"\nGRAPH MODE"
+					"\n     With -G, the sequence of L characters of file from position b is aligned to the acyclic graph of"
+					"\n     sequences of the GFA file <graph> (segments S and links L + to + without overlap, eg a reference"
+					"\n     and its variants as bubbles): prints the least distance to the sequence of a path from a source"
+					"\n     to a sink, computed node by node in topological order at about the cost of one linear alignment."
+					"\n     With -A, the path (names of its nodes separated by commas), a tab and the extended CIGAR string"
+					"\n     of the alignment with the sequence of the path are written in <output> (- for stdout), the"
+					"\n     tables of moves having to fit in <budget> bytes (default: half of the physical memory)."
+					"\nSTREAMING MODE"
+					"\n     With -f, the bases of stream_1 and stream_2 (files, pipes, or - for stdin) are read by chunks of"
+					"\n     <chunk> bytes (default 65536) until their ends and aligned within an adaptive band of <band>"
+					"\n     cells per anti-diagonal (default 2048), in memory independent of their lengths. Prints"
+					"\n     \"distance exact|constrained length_1 length_2 peak_bytes\": exact if no path leaving the band"
+					"\n     can be shorter, else constrained (the distance is then an upper bound, possibly equal)."
+					"\n     A regular file is read with 7 chunks in flight (io_uring, else threads calling pread; environment"
+					"\n     variable NW_READER=uring|pread) while the current chunk is decoded and aligned."
+					"\nSHARED MEMORY SERVICE"
+					"\n     With --serve-shm, distanceEdition creates the POSIX shared memory object /name with a data ring of"
+					"\n     <ring_bytes> bytes (default 256 MiB) and submission and completion queues of <entries> entries"
+					"\n     (default 256), and serves the requests of a local client (cf nwshm and shm_service.h) on <threads>"
+					"\n     workers, which read the sequences in the ring without copy, until a shutdown request (nwshm -x)."
+					"\n     The requests are scheduled as the pairs of the batch mode (size classes, priorities, deadlines,"
+					"\n     <reserved> workers for the small ones, tiles for the ones of at least <split> cells, memory"
+					"\n     <budget>): a request larger than the budget fails with ENOMEM, and the server stops reading the"
+					"\n     submission queue while the requests waiting for memory exceed the budget. With -C, the number of"
+					"\n     workers is adjusted as in the batch mode (gauge nw_active_workers, choice printed at the shutdown)."
+					"\n     The sequences are at most <max_length> characters long (default 4 Mi). With -M, the metrics of the"
+					"\n     jobs (throughput, latency histograms by size class, queue depth, peak memory) are served in the"
+					"\n     Prometheus text format on <metrics>: a port of 127.0.0.1, or the path of a Unix socket."
+					"\nCAPTURE AND REPLAY"
+					"\n     With -L (batch mode and shared memory service), each job computed is logged in the binary file <log>:"
+					"\n     fingerprints and lengths of its sequences, engine, mode, priority, deadline, submission time, time in"
+					"\n     the queues, computation time and result (cf capture.h). With -K, each distinct sequence is also"
+					"\n     written once in the directory <cache>. nwreplay submits the jobs of a log again, at their original"
+					"\n     times or at maximal speed, on the cached sequences or on synthetic ones of the same lengths."
 					"\nEXIT STATUS"
 					"\n     The program exits 0 on success, and >0 if an error occurs."
 					"\nEXAMPLE"
@@ -107,6 +247,677 @@ void usage_and_spec(int argc, char *argv[]) // spécification du programme
 
 /********************************************************************************/
 
+/**
+ * \fn int main_batch(int argc, char *argv[])
+ * \brief batch mode: distanceEdition -m manifest [-t threads] [-e engine] [-k kernel] [-P policy] [-R reserved] [-S split] [-B budget] [-C period] [-L log [-K cache]]
+ * \param argc : argc from main
+ * \param argv : argv from main (the caller given parameters)
+ */
+int main_batch(int argc, char *argv[])
+{
+	const char *manifest = NULL, *log = NULL, *cache = NULL;
+	struct NW_SchedParams sched = {0, 0, 0, 0, 0, 0, 0, 0};
+	enum NW_Engine engine = NW_ENGINE_CACHE_AWARE;
+	for (int a = 1; a < argc; ++a)
+	{
+		if (strcmp(argv[a], "-m") == 0 && a + 1 < argc)
+			manifest = argv[++a];
+		else if (strcmp(argv[a], "-t") == 0 && a + 1 < argc)
+			sched.nthreads = atoi(argv[++a]);
+		else if (strcmp(argv[a], "-R") == 0 && a + 1 < argc)
+			sched.reserved = atoi(argv[++a]);
+		else if (strcmp(argv[a], "-S") == 0 && a + 1 < argc)
+			sched.split = atof(argv[++a]);
+		else if (strcmp(argv[a], "-B") == 0 && a + 1 < argc)
+			sched.memory = (size_t)atol(argv[++a]);
+		else if (strcmp(argv[a], "-C") == 0 && a + 1 < argc)
+			sched.adapt = atof(argv[++a]);
+		else if (strcmp(argv[a], "-L") == 0 && a + 1 < argc)
+			log = argv[++a];
+		else if (strcmp(argv[a], "-K") == 0 && a + 1 < argc)
+			cache = argv[++a];
+		else if (strcmp(argv[a], "-k") == 0 && a + 1 < argc)
+		{
+			const struct NW_Kernel *kernel = NW_KernelFromName(argv[++a]);
+			if (kernel == NULL)
+			{
+				fprintf(stderr, "%s: unknown kernel %s.\n", argv[0], argv[a]);
+				return EXIT_FAILURE;
+			}
+			NW_SetDefaultKernel(kernel);
+		}
+		else if (strcmp(argv[a], "-P") == 0 && a + 1 < argc)
+		{
+			struct NW_Mask mask;
+			if (NW_MaskFromName(argv[++a], &mask) != 0)
+			{
+				fprintf(stderr, "%s: unknown mask policy %s.\n", argv[0], argv[a]);
+				return EXIT_FAILURE;
+			}
+			NW_SetDefaultMask(&mask);
+		}
+		else if (strcmp(argv[a], "-e") == 0 && a + 1 < argc)
+		{
+			if (NW_EngineFromName(argv[++a], &engine) != 0)
+			{
+				fprintf(stderr, "%s: unknown engine %s.\n", argv[0], argv[a]);
+				return EXIT_FAILURE;
+			}
+		}
+		else
+		{
+			usage_and_spec(argc, argv);
+			return EXIT_FAILURE;
+		}
+	}
+	if (manifest == NULL || (cache != NULL && log == NULL))
+	{
+		usage_and_spec(argc, argv);
+		return EXIT_FAILURE;
+	}
+	struct NW_Capture *capture = NULL;
+	if (log != NULL && (capture = NW_CaptureOpen(log, cache)) == NULL)
+		return EXIT_FAILURE;
+	int status = NW_RunManifest(manifest, engine, &sched, capture, stdout);
+	if (capture != NULL)
+		NW_CaptureClose(capture);
+	return status;
+}
+
+/**
+ * \fn int main_compressed(int argc, char *argv[])
+ * \brief compressed mode: distanceEdition -z container [name_1 name_2 | -o matrix]
+ * \param argc : argc from main
+ * \param argv : argv from main (the caller given parameters)
+ */
+int main_compressed(int argc, char *argv[])
+{
+	struct NWZ_Container c;
+	if ((argc != 3 && argc != 5) || NWZ_Open(&c, argv[2]) != 0)
+	{
+		usage_and_spec(argc, argv);
+		return EXIT_FAILURE;
+	}
+	struct NW_BlockMemo *memo = NW_BlockMemoCreate(NW_DEFAULT_MEMO_BYTES);
+	if (argc == 5 && strcmp(argv[3], "-o") == 0)
+	{
+		size_t n = c.header->nseqs;
+		const char **names = (const char **)malloc(n * sizeof(char *));
+		size_t *lengths = (size_t *)malloc(n * sizeof(size_t));
+		if (names == NULL || lengths == NULL)
+		{
+			perror("main_compressed: malloc of the names");
+			exit(EXIT_FAILURE);
+		}
+		for (size_t i = 0; i < n; ++i)
+		{
+			names[i] = c.seqs[i].name;
+			lengths[i] = c.seqs[i].name_length;
+		}
+		struct NW_Matrix m;
+		int status = NW_MatrixCreate(&m, argv[4], n, names, lengths);
+		free(names);
+		free(lengths);
+		if (status != 0)
+			return status;
+		for (size_t i = 1; i < n; ++i)
+			for (size_t j = 0; j < i; ++j)
+				m.d[NW_MATRIX_INDEX(i, j)] = (float)EditDistance_NW_compressed(&c, &c.seqs[j], &c.seqs[i], memo);
+		NW_MatrixClose(&m);
+	}
+	else if (argc == 5)
+	{
+		const struct NWZ_Seq *seq[2] = {NWZ_Find(&c, argv[3]), NWZ_Find(&c, argv[4])};
+		for (int i = 0; i < 2; ++i)
+		{
+			if (seq[i] == NULL)
+			{
+				fprintf(stderr, "%s: no sequence %s in %s.\n", argv[0], argv[3 + i], argv[2]);
+				return EXIT_FAILURE;
+			}
+		}
+		printf("%ld\n", EditDistance_NW_compressed(&c, seq[0], seq[1], memo));
+	}
+	else
+	{
+		for (size_t i = 0; i < c.header->nseqs; ++i)
+			for (size_t j = i + 1; j < c.header->nseqs; ++j)
+			{
+				long res = EditDistance_NW_compressed(&c, &c.seqs[i], &c.seqs[j], memo);
+				printf("%.*s %.*s %ld\n", (int)c.seqs[i].name_length, c.seqs[i].name,
+					   (int)c.seqs[j].name_length, c.seqs[j].name, res);
+				fflush(stdout);
+			}
+	}
+	size_t tiles, hits, cells;
+	NW_BlockMemoStats(memo, &tiles, &hits, &cells);
+	fprintf(stderr, "%zu tiles, %zu found in the table (%.1f%%), %zu cells computed\n", tiles, hits,
+			(tiles == 0) ? 0.0 : 100.0 * (double)hits / (double)tiles, cells);
+	NW_BlockMemoFree(memo);
+	NWZ_Close(&c);
+	return 0;
+}
+
+/**
+ * \fn int main_tree(int argc, char *argv[])
+ * \brief guide tree: distanceEdition -g matrix [-u] [-t threads] [-p prefix] [-o tree]
+ * \param argc : argc from main
+ * \param argv : argv from main (the caller given parameters)
+ */
+int main_tree(int argc, char *argv[])
+{
+	const char *matrix = NULL, *output = NULL;
+	enum NW_TreeMethod method = NW_TREE_NJ;
+	int nthreads = 0;
+	size_t prefix = 0;
+	for (int a = 1; a < argc; ++a)
+	{
+		if (strcmp(argv[a], "-g") == 0 && a + 1 < argc)
+			matrix = argv[++a];
+		else if (strcmp(argv[a], "-u") == 0)
+			method = NW_TREE_UPGMA;
+		else if (strcmp(argv[a], "-t") == 0 && a + 1 < argc)
+			nthreads = atoi(argv[++a]);
+		else if (strcmp(argv[a], "-p") == 0 && a + 1 < argc)
+			prefix = (size_t)atol(argv[++a]);
+		else if (strcmp(argv[a], "-o") == 0 && a + 1 < argc)
+			output = argv[++a];
+		else
+		{
+			usage_and_spec(argc, argv);
+			return EXIT_FAILURE;
+		}
+	}
+	struct NW_Matrix m;
+	if (matrix == NULL)
+	{
+		usage_and_spec(argc, argv);
+		return EXIT_FAILURE;
+	}
+	if (NW_MatrixOpen(&m, matrix) != 0)
+		return EXIT_FAILURE;
+	FILE *out = (output == NULL) ? stdout : fopen(output, "w");
+	if (out == NULL)
+	{
+		perror(output);
+		NW_MatrixClose(&m);
+		return EXIT_FAILURE;
+	}
+	int status = NW_Tree(&m, method, nthreads, prefix, out);
+	if (out != stdout && fclose(out) != 0)
+	{
+		perror(output);
+		status = EXIT_FAILURE;
+	}
+	NW_MatrixClose(&m);
+	return status;
+}
+
+/**
+ * \fn int main_arrow(int argc, char *argv[])
+ * \brief Arrow mode: distanceEdition -a sequences pairs output [-c column] [-i first,second] [-t threads] [-e engine]
+ * \param argc : argc from main
+ * \param argv : argv from main (the caller given parameters)
+ */
+int main_arrow(int argc, char *argv[])
+{
+	const char *column = NULL;
+	char *first = NULL, *second = NULL;
+	int nthreads = 0;
+	enum NW_Engine engine = NW_ENGINE_CACHE_AWARE;
+	if (argc < 5)
+	{
+		usage_and_spec(argc, argv);
+		return EXIT_FAILURE;
+	}
+	for (int a = 5; a < argc; ++a)
+	{
+		if (strcmp(argv[a], "-c") == 0 && a + 1 < argc)
+			column = argv[++a];
+		else if (strcmp(argv[a], "-i") == 0 && a + 1 < argc && strchr(argv[a + 1], ',') != NULL)
+		{
+			first = argv[++a];
+			second = strchr(first, ',');
+			*second++ = '\0';
+		}
+		else if (strcmp(argv[a], "-t") == 0 && a + 1 < argc)
+			nthreads = atoi(argv[++a]);
+		else if (strcmp(argv[a], "-e") == 0 && a + 1 < argc)
+		{
+			if (NW_EngineFromName(argv[++a], &engine) != 0)
+			{
+				fprintf(stderr, "%s: unknown engine %s.\n", argv[0], argv[a]);
+				return EXIT_FAILURE;
+			}
+		}
+		else
+		{
+			usage_and_spec(argc, argv);
+			return EXIT_FAILURE;
+		}
+	}
+	return NW_RunArrow(argv[2], column, argv[3], first, second, argv[4], engine, nthreads);
+}
+
+/**
+ * \fn int read_regions(struct SeqFileSet *files, char *args[6], char *seq[2], long length[2])
+ * \brief decodes the two regions "file_1 begin_1 length_1 file_2 begin_2 length_2" of the options modes
+ * \return : 0 on success, >0 (with a message on stderr) if a beginning exceeds the end of its file
+ */
+int read_regions(struct SeqFileSet *files, char *args[6], char *seq[2], long length[2])
+{
+	for (int i = 0; i < 2; ++i)
+	{
+		struct SeqFile *file = SeqFileSet_open(files, args[3 * i]);
+		NW_PROBE2(decode_start, atol(args[3 * i + 1]), atol(args[3 * i + 2]));
+		enum SeqRegionStatus status = SeqRegion(file, atol(args[3 * i + 1]), atol(args[3 * i + 2]), &seq[i], &length[i], NULL);
+		NW_PROBE2(decode_end, seq[i], length[i]);
+		if (status == SEQ_REGION_ERROR)
+		{
+			fprintf(stderr, "Error: given sequence beginning %s exceeds end of file of %ld bytes, or length %s is negative.\n",
+					args[3 * i + 1], file->length, args[3 * i + 2]);
+			return EXIT_FAILURE;
+		}
+	}
+	return 0;
+}
+
+/**
+ * \fn int main_estimate(int argc, char *argv[])
+ * \brief estimate mode: distanceEdition -s precision [-w window] [-t threads] [-e engine] file_1 b1 L_1 file_2 b_2 L_2
+ * \param argc : argc from main
+ * \param argv : argv from main (the caller given parameters)
+ */
+int main_estimate(int argc, char *argv[])
+{
+	struct NW_EstimateParams params = {0, 0.05, 0, 1, NW_ENGINE_MULTILEVEL};
+	int a = 1;
+	for (; a + 1 < argc && argv[a][0] == '-'; a += 2)
+	{
+		if (strcmp(argv[a], "-s") == 0)
+			params.precision = atof(argv[a + 1]);
+		else if (strcmp(argv[a], "-w") == 0)
+			params.window = (size_t)atol(argv[a + 1]);
+		else if (strcmp(argv[a], "-t") == 0)
+			params.nthreads = atoi(argv[a + 1]);
+		else if (strcmp(argv[a], "-e") == 0 && NW_EngineFromName(argv[a + 1], &params.engine) == 0)
+			continue;
+		else
+			break;
+	}
+	if (argc - a != 6)
+	{
+		usage_and_spec(argc, argv);
+		return EXIT_FAILURE;
+	}
+
+	struct SeqFileSet files;
+	SeqFileSet_init(&files);
+	char *seq[2];
+	long length[2];
+	if (read_regions(&files, argv + a, seq, length) != 0)
+		return EXIT_FAILURE;
+
+	struct NW_EstimateResult res;
+	NW_Estimate(seq[0], length[0], seq[1], length[1], &params, &res);
+	fprintf(stderr, "%zu windows of %zu aligned (%zu placed by anchors), placement error at most %.0f\n", res.windows,
+			res.total, res.anchored, res.placement);
+	printf("%.0f %.0f %.0f %zu %zu %.3f\n", res.distance, res.low, res.high, res.windows, res.total, res.seconds);
+	SeqFileSet_close(&files);
+	return 0;
+}
+
+/**
+ * \fn int main_dotplot(int argc, char *argv[])
+ * \brief dot plot mode: distanceEdition -d output [-k k] [-p pixels] [-x sampling] [-o max_occ] [-t threads] file_1 b1 L_1 file_2 b_2 L_2
+ * \param argc : argc from main
+ * \param argv : argv from main (the caller given parameters)
+ */
+int main_dotplot(int argc, char *argv[])
+{
+	struct NW_DotplotParams params = {0, 1, 0, 0, 0};
+	const char *output = NULL;
+	int a = 1;
+	for (; a + 1 < argc && argv[a][0] == '-'; a += 2)
+	{
+		if (strcmp(argv[a], "-d") == 0)
+			output = argv[a + 1];
+		else if (strcmp(argv[a], "-k") == 0)
+			params.k = atoi(argv[a + 1]);
+		else if (strcmp(argv[a], "-p") == 0)
+			params.pixels = (size_t)atol(argv[a + 1]);
+		else if (strcmp(argv[a], "-x") == 0)
+			params.sampling = (unsigned)atoi(argv[a + 1]);
+		else if (strcmp(argv[a], "-o") == 0)
+			params.max_occ = (size_t)atol(argv[a + 1]);
+		else if (strcmp(argv[a], "-t") == 0)
+			params.nthreads = atoi(argv[a + 1]);
+		else
+			break;
+	}
+	if (argc - a != 6 || output == NULL)
+	{
+		usage_and_spec(argc, argv);
+		return EXIT_FAILURE;
+	}
+
+	struct SeqFileSet files;
+	SeqFileSet_init(&files);
+	char *seq[2];
+	long length[2];
+	if (read_regions(&files, argv + a, seq, length) != 0)
+		return EXIT_FAILURE;
+	FILE *out = fopen(output, "w");
+	if (out == NULL)
+		err(1, "fopen %s", output);
+	size_t len = strlen(output);
+	int image = (len >= 4 && strcmp(output + len - 4, ".pgm") == 0);
+	size_t hits = NW_Dotplot(seq[0], length[0], seq[1], length[1], &params, image ? out : NULL, image ? NULL : out);
+	if (fclose(out) != 0)
+		err(1, "fclose %s", output);
+	fprintf(stderr, "%zu hits\n", hits);
+	SeqFileSet_close(&files);
+	return 0;
+}
+
+/**
+ * \fn int main_divergence(int argc, char *argv[])
+ * \brief divergence mode: distanceEdition -b output [-w window] [-c chrom] [-e engine] file_1 b1 L_1 file_2 b_2 L_2
+ * \param argc : argc from main
+ * \param argv : argv from main (the caller given parameters)
+ */
+int main_divergence(int argc, char *argv[])
+{
+	enum NW_Engine engine = NW_ENGINE_MULTILEVEL;
+	size_t window = NW_DIVERGENCE_WINDOW;
+	const char *output = NULL, *chrom = NULL;
+	int a = 1;
+	for (; a + 1 < argc && argv[a][0] == '-'; a += 2)
+	{
+		if (strcmp(argv[a], "-b") == 0)
+			output = argv[a + 1];
+		else if (strcmp(argv[a], "-w") == 0)
+			window = (size_t)atol(argv[a + 1]);
+		else if (strcmp(argv[a], "-c") == 0)
+			chrom = argv[a + 1];
+		else if (strcmp(argv[a], "-e") == 0 && NW_EngineFromName(argv[a + 1], &engine) == 0)
+			continue;
+		else
+			break;
+	}
+	if (argc - a != 6 || output == NULL || window == 0)
+	{
+		usage_and_spec(argc, argv);
+		return EXIT_FAILURE;
+	}
+
+	struct SeqFileSet files;
+	SeqFileSet_init(&files);
+	char *seq[2];
+	long length[2];
+	if (read_regions(&files, argv + a, seq, length) != 0)
+		return EXIT_FAILURE;
+	long *costs = (long *)malloc(((size_t)length[0] / window + 1) * sizeof(long));
+	if (costs == NULL)
+	{
+		perror("main_divergence: malloc of costs");
+		exit(EXIT_FAILURE);
+	}
+	long distance = NW_DivergenceTrack(seq[0], length[0], seq[1], length[1], engine, window, costs);
+	// base coordinates in the FASTA record of the first region, named by its header by default
+	const char *name;
+	size_t name_length, bases = 0;
+	long offset = SeqRecordPosition(SeqFileSet_open(&files, argv[a]), seq[0], &name, &name_length);
+	for (long i = 0; i < length[0]; ++i)
+		bases += isBase(seq[0][i]);
+	char *record = (name != NULL && name_length > 0) ? strndup(name, name_length) : strdup(argv[a]);
+	FILE *out = fopen(output, "w");
+	if (out == NULL)
+		err(1, "fopen %s", output);
+	NW_WriteBedGraph(out, (chrom != NULL) ? chrom : record, offset, bases, window, costs);
+	if (fclose(out) != 0)
+		err(1, "fclose %s", output);
+	printf("%ld\n", distance);
+	free(record);
+	free(costs);
+	SeqFileSet_close(&files);
+	return 0;
+}
+
+/**
+ * \fn int main_align(int argc, char *argv[])
+ * \brief alignment mode: distanceEdition -A output [-B budget] file_1 b1 L_1 file_2 b_2 L_2
+ * \param argc : argc from main
+ * \param argv : argv from main (the caller given parameters)
+ */
+int main_align(int argc, char *argv[])
+{
+	size_t budget = (size_t)(NW_SCHED_MEMORY * (double)sysconf(_SC_PHYS_PAGES) * (double)sysconf(_SC_PAGESIZE));
+	const char *output = NULL;
+	int a = 1;
+	for (; a + 1 < argc && argv[a][0] == '-'; a += 2)
+	{
+		if (strcmp(argv[a], "-A") == 0)
+			output = argv[a + 1];
+		else if (strcmp(argv[a], "-B") == 0)
+			budget = (size_t)atol(argv[a + 1]);
+		else
+			break;
+	}
+	if (argc - a != 6 || output == NULL)
+	{
+		usage_and_spec(argc, argv);
+		return EXIT_FAILURE;
+	}
+
+	struct SeqFileSet files;
+	SeqFileSet_init(&files);
+	char *seq[2];
+	long length[2];
+	if (read_regions(&files, argv + a, seq, length) != 0)
+		return EXIT_FAILURE;
+	size_t bytes = NW_TracebackBytes(length[0], length[1]);
+	if (bytes > budget)
+	{
+		fprintf(stderr, "%s: the table of the alignment takes %zu bytes, more than the budget of %zu bytes (use -b).\n",
+				argv[0], bytes, budget);
+		SeqFileSet_close(&files);
+		return EXIT_FAILURE;
+	}
+	unsigned char *moves = (unsigned char *)malloc((size_t)(length[0] + length[1]) + 1);
+	if (moves == NULL)
+	{
+		perror("main_align: malloc of moves");
+		exit(EXIT_FAILURE);
+	}
+	size_t nmoves;
+	long distance = EditDistance_NW_traceback(seq[0], length[0], seq[1], length[1], moves, &nmoves);
+	FILE *out = (strcmp(output, "-") == 0) ? stdout : fopen(output, "w");
+	if (out == NULL)
+		err(1, "fopen %s", output);
+	NW_WriteCigar(out, seq[0], seq[1], moves, nmoves);
+	if (out != stdout && fclose(out) != 0)
+		err(1, "fclose %s", output);
+	printf("%ld\n", distance);
+	free(moves);
+	SeqFileSet_close(&files);
+	return 0;
+}
+
+/**
+ * \fn int main_graph(int argc, char *argv[])
+ * \brief graph mode: distanceEdition -G graph [-A output] [-B budget] file b L
+ * \param argc : argc from main
+ * \param argv : argv from main (the caller given parameters)
+ */
+int main_graph(int argc, char *argv[])
+{
+	size_t budget = (size_t)(NW_SCHED_MEMORY * (double)sysconf(_SC_PHYS_PAGES) * (double)sysconf(_SC_PAGESIZE));
+	const char *graph = NULL, *output = NULL;
+	int a = 1;
+	for (; a + 1 < argc && argv[a][0] == '-'; a += 2)
+	{
+		if (strcmp(argv[a], "-G") == 0)
+			graph = argv[a + 1];
+		else if (strcmp(argv[a], "-A") == 0)
+			output = argv[a + 1];
+		else if (strcmp(argv[a], "-B") == 0)
+			budget = (size_t)atol(argv[a + 1]);
+		else
+			break;
+	}
+	if (argc - a != 3 || graph == NULL)
+	{
+		usage_and_spec(argc, argv);
+		return EXIT_FAILURE;
+	}
+	struct NW_Graph g;
+	if (NW_GraphLoad(&g, graph) != 0)
+		return EXIT_FAILURE;
+
+	struct SeqFileSet files;
+	SeqFileSet_init(&files);
+	struct SeqFile *file = SeqFileSet_open(&files, argv[a]);
+	char *seq, *comment;
+	long length;
+	if (SeqRegion(file, atol(argv[a + 1]), atol(argv[a + 2]), &seq, &length, &comment) == SEQ_REGION_ERROR)
+	{
+		fprintf(stderr, "Error: given sequence beginning %s exceeds end of file of %ld bytes, or length %s is negative.\n",
+				argv[a + 1], file->length, argv[a + 2]);
+		return EXIT_FAILURE;
+	}
+	long distance;
+	if (output == NULL)
+		distance = EditDistance_NW_graph(&g, seq, length);
+	else if (NW_GraphAlignBytes(&g, length) > budget)
+	{
+		fprintf(stderr, "%s: the tables of the alignment take %zu bytes, more than the budget of %zu bytes.\n",
+				argv[0], NW_GraphAlignBytes(&g, length), budget);
+		return EXIT_FAILURE;
+	}
+	else
+	{
+		size_t *path = (size_t *)malloc(g.nnodes * sizeof(size_t)), npath, nmoves;
+		unsigned char *moves = (unsigned char *)malloc(g.length + (size_t)length + 1);
+		char *spelled = (char *)malloc(g.length + 1);
+		if (path == NULL || moves == NULL || spelled == NULL)
+		{
+			perror("main_graph: malloc of the alignment");
+			exit(EXIT_FAILURE);
+		}
+		distance = NW_GraphAlign(&g, seq, length, path, &npath, moves, &nmoves);
+		FILE *out = (strcmp(output, "-") == 0) ? stdout : fopen(output, "w");
+		if (out == NULL)
+			err(1, "fopen %s", output);
+		size_t spelled_length = 0;
+		for (size_t k = 0; k < npath; ++k)
+		{
+			const struct NW_GraphNode *node = &g.nodes[path[k]];
+			fprintf(out, "%s%s", (k > 0) ? "," : "", node->name);
+			memcpy(spelled + spelled_length, node->seq, node->length);
+			spelled_length += node->length;
+		}
+		fputc('\t', out);
+		NW_WriteCigar(out, spelled, seq, moves, nmoves);
+		if (out != stdout && fclose(out) != 0)
+			err(1, "fclose %s", output);
+		free(path);
+		free(moves);
+		free(spelled);
+	}
+	printf("%ld\n", distance);
+	NW_GraphFree(&g);
+	SeqFileSet_close(&files);
+	return 0;
+}
+
+/**
+ * \fn int main_stream(int argc, char *argv[])
+ * \brief streaming mode: distanceEdition -f band [-c chunk] stream_1 stream_2
+ * \param argc : argc from main
+ * \param argv : argv from main (the caller given parameters)
+ */
+int main_stream(int argc, char *argv[])
+{
+	struct NW_StreamParams params = {0, 0};
+	int a = 1;
+	for (; a + 1 < argc && argv[a][0] == '-' && argv[a][1] != '\0'; a += 2)
+	{
+		if (strcmp(argv[a], "-f") == 0)
+			params.band = (size_t)atol(argv[a + 1]);
+		else if (strcmp(argv[a], "-c") == 0)
+			params.chunk = (size_t)atol(argv[a + 1]);
+		else
+			break;
+	}
+	if (argc - a != 2 || (strcmp(argv[a], "-") == 0 && strcmp(argv[a + 1], "-") == 0))
+	{
+		usage_and_spec(argc, argv);
+		return EXIT_FAILURE;
+	}
+
+	FILE *in[2];
+	for (int i = 0; i < 2; ++i)
+	{
+		in[i] = (strcmp(argv[a + i], "-") == 0) ? stdin : fopen(argv[a + i], "r");
+		if (in[i] == NULL)
+			err(1, "fopen %s", argv[a + i]);
+	}
+	struct NW_StreamResult res;
+	NW_StreamBanded(in[0], in[1], &params, &res);
+	printf("%ld %s %zu %zu %zu\n", res.distance, res.constrained ? "constrained" : "exact", res.lengthA, res.lengthB,
+		   res.peak_bytes);
+	for (int i = 0; i < 2; ++i)
+		if (in[i] != stdin)
+			fclose(in[i]);
+	return 0;
+}
+
+/**
+ * \fn int main_serve_shm(int argc, char *argv[])
+ * \brief shared memory service: distanceEdition --serve-shm /name [-t threads] [-r ring_bytes] [-q entries] [-l max_length] [-M metrics] [-R reserved] [-S split] [-B budget] [-C period] [-L log [-K cache]]
+ * \param argc : argc from main
+ * \param argv : argv from main (the caller given parameters)
+ */
+int main_serve_shm(int argc, char *argv[])
+{
+	struct NW_ShmParams params = {0, 0, 0, 0, 0, 0, 0, NULL, NULL, NULL, 0};
+	int a = 3;
+	for (; a + 1 < argc; a += 2)
+	{
+		if (strcmp(argv[a], "-t") == 0)
+			params.nthreads = atoi(argv[a + 1]);
+		else if (strcmp(argv[a], "-r") == 0)
+			params.data_size = (size_t)atol(argv[a + 1]);
+		else if (strcmp(argv[a], "-q") == 0)
+			params.entries = (unsigned)atoi(argv[a + 1]);
+		else if (strcmp(argv[a], "-l") == 0)
+			params.max_length = (size_t)atol(argv[a + 1]);
+		else if (strcmp(argv[a], "-M") == 0)
+			params.metrics = argv[a + 1];
+		else if (strcmp(argv[a], "-R") == 0)
+			params.reserved = atoi(argv[a + 1]);
+		else if (strcmp(argv[a], "-S") == 0)
+			params.split = atof(argv[a + 1]);
+		else if (strcmp(argv[a], "-B") == 0)
+			params.memory = (size_t)atol(argv[a + 1]);
+		else if (strcmp(argv[a], "-C") == 0)
+			params.adapt = atof(argv[a + 1]);
+		else if (strcmp(argv[a], "-L") == 0)
+			params.capture = argv[a + 1];
+		else if (strcmp(argv[a], "-K") == 0)
+			params.cache = argv[a + 1];
+		else
+			break;
+	}
+	if (argc < 3 || a != argc || argv[2][0] != '/' || (params.cache != NULL && params.capture == NULL))
+	{
+		usage_and_spec(argc, argv);
+		return EXIT_FAILURE;
+	}
+	return NW_ShmServe(argv[2], &params);
+}
+
 /** \fn int main(int argc, char *argv[])
  * \brief main : see function usage_and_spec(argc, argv) for specification
  * \param argc : argc from main
@@ -114,62 +925,70 @@ void usage_and_spec(int argc, char *argv[]) // spécification du programme
  */
 int main(int argc, char *argv[])
 {
+	if (argc > 1 && strcmp(argv[1], "-z") == 0)
+		return main_compressed(argc, argv);
+	if (argc > 1 && strcmp(argv[1], "-g") == 0)
+		return main_tree(argc, argv);
+	if (argc > 1 && strcmp(argv[1], "-a") == 0)
+		return main_arrow(argc, argv);
+	if (argc > 1 && strcmp(argv[1], "-s") == 0)
+		return main_estimate(argc, argv);
+	if (argc > 1 && strcmp(argv[1], "-d") == 0)
+		return main_dotplot(argc, argv);
+	if (argc > 1 && strcmp(argv[1], "-b") == 0)
+		return main_divergence(argc, argv);
+	if (argc > 1 && strcmp(argv[1], "-A") == 0)
+		return main_align(argc, argv);
+	if (argc > 1 && strcmp(argv[1], "-G") == 0)
+		return main_graph(argc, argv);
+	if (argc > 1 && strcmp(argv[1], "-f") == 0)
+		return main_stream(argc, argv);
+	if (argc > 1 && strcmp(argv[1], "--serve-shm") == 0)
+		return main_serve_shm(argc, argv);
+	if (argc > 1 && argv[1][0] == '-' && argv[1][1] != '\0')
+		return main_batch(argc, argv);
 	if (argc != 7)
 	{
 		usage_and_spec(argc, argv);
 		exit(EXIT_FAILURE);
 	}
 
-	int fd[2];			 // The 2 fles descriptor correspoding for file1 and file2
-	char *mmap_fd[2];	 // adress in virtual memory of file fd[i]
-	long mmap_length[2]; // length of the mapping in virtual memory of file fd[i]
-	char *seq[2];		 // corresponding genetic sequence to file[i]*/
-	long length[2];		 // the length of corresponding genetic sequence seq[i] */
+	struct SeqFileSet files; // each distinct file is mapped only once
+	SeqFileSet_init(&files);
+	char *seq[2];	// corresponding genetic sequence to file[i]*/
+	long length[2]; // the length of corresponding genetic sequence seq[i] */
 
 	for (int i = 0; i < 2; ++i, argv += 3) // defines content and length of seq[i] for i=0..1
 	{
-		fd[i] = open(argv[1], O_RDONLY);
-		if (fd[i] == -1)
-			err(1, "open");
-		struct stat s;
-		if (fstat(fd[i], &s) == -1)
-			err(1, "fstat");
-		mmap_fd[i] = (char *)mmap(NULL, s.st_size, PROT_READ, MAP_PRIVATE, fd[i], 0);
-		if (mmap_fd[i] == MAP_FAILED)
-			err(1, "mmap");
-		mmap_length[i] = (long)s.st_size;
-
-		{ // Assign seq[i] to the begining of the sequence, excluding comment lines starting by '<'
-			long debut;
+		struct SeqFile *file = SeqFileSet_open(&files, argv[1]);
+
+		{ // Assign seq[i] to the begining of the sequence, excluding comment lines starting by '<' and length[i] to the given length for seq[i]
+			long debut, given_length;
+			char *comment;
 			sscanf(argv[2], "%ld", &debut);
-			seq[i] = mmap_fd[i] + debut; // beginning of the sequence
-			long n_exceed = mmap_length[i] - debut;
-			if (n_exceed < 0)
+			sscanf(argv[3], "%ld", &given_length);
+			NW_PROBE2(decode_start, debut, given_length);
+			enum SeqRegionStatus status = SeqRegion(file, debut, given_length, &seq[i], &length[i], &comment);
+			NW_PROBE2(decode_end, seq[i], length[i]);
+			switch (status)
 			{
-				fprintf(stderr, "Error: given sequence beginning %ld exceeds end of file of %ld bytes.\n",
-						debut, n_exceed);
+			case SEQ_REGION_ERROR:
+				fprintf(stderr, "Error: given sequence beginning %ld exceeds end of file of %ld bytes, or length %ld is negative.\n",
+						debut, file->length, given_length);
 				exit(1);
+			case SEQ_REGION_TRUNCATED:
+				fprintf(stderr, "Warning: given sequence length %ld exceeds end of file of %ld bytes; "
+								"sequence length is truncated to %ld.\n",
+						given_length, given_length - length[i], length[i]);
+				break;
+			default:
+				break;
 			}
-			if (*seq[i] == '>') /* Skip and print the first line starting by '<' */
+			if (comment != NULL) /* Print the first line starting by '<' */
 			{
-				char *endofline = strchr(seq[i], '\n');
 				fprintf(stderr, "Sequence comment in preamble: ");
-				for (char *c = seq[i]; c <= endofline; ++c)
+				for (char *c = comment; c < seq[i]; ++c)
 					fprintf(stderr, "%c", *c);
-				if (*endofline == '\n')
-					seq[i] = endofline + 1; // first character of next line
-			}
-		}
-
-		{ // assign length[i] to the given length for seq[i]
-			sscanf(argv[3], "%ld", &length[i]);
-			long n_exceed = mmap_fd[i] + mmap_length[i] - 1 - (seq[i] + length[i]);
-			if (n_exceed < 0)
-			{
-				fprintf(stderr, "Warning: given sequence length %ld exceeds end of file of %ld bytes; "
-								"sequence length is truncated to %ld.\n",
-						length[i], -n_exceed, length[i] + n_exceed);
-				length[i] = length[i] + n_exceed;
 			}
 		}
 
@@ -197,18 +1016,12 @@ int main(int argc, char *argv[])
 
 	//long res = EditDistance_NW_Rec(seq[0], length[0], seq[1], length[1]);
 	//long res = EditDistance_NW_iteratif(seq[0], length[0], seq[1], length[1]);
+	NW_PROBE3(job_start, NW_ENGINE_CACHE_AWARE, length[0], length[1]);
 	long res = EditDistance_NW_cache_aware(seq[0], length[0], seq[1], length[1], 4096);
+	NW_PROBE4(job_end, NW_ENGINE_CACHE_AWARE, length[0], length[1], res);
 	//long res = EditDistance_NW_cache_oblivious(seq[0], length[0], seq[1], length[1], 100);
 
-	{
-		for (int i = 0; i < 2; ++i)
-		{
-			if (munmap(mmap_fd[i], (off_t)mmap_length[i]) != 0)
-				err(1, "munmap");
-			if (close(fd[i]) != 0)
-				err(1, "close");
-		}
-	}
+	SeqFileSet_close(&files);
 
 	printf("%ld\n", res); // print the distance on stdout
 	return 0;
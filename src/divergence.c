@@ -0,0 +1,174 @@
+/**
+ * \file divergence.c
+ * \brief divergence track: costs of the optimal alignment summed by windows of the reference, as a bedGraph
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see divergence.h
+ *
+ * As the chars that are not bases are skipped (a row of such a char copies the row above, a column copies
+ * the column on its left), D is the distance between the sequences of bases, so that the distance between
+ * the reversed sequences is the same and the method of Hirschberg applies.
+ */
+
+#include "divergence.h"
+#include "arena.h" /* tables and reversed sequences */
+#include "Needleman-Wunsch-traceback.h" /* for the leaves */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> /* for memset */
+
+#include "characters_to_base.h" /* mapping from char to base */
+
+/** \struct _track
+ * \brief data shared by the recursive calls
+ */
+struct _track
+{
+	const char *A, *B;	 /*!< the sequences */
+	const char *RA, *RB; /*!< the reversed sequences */
+	size_t M, N;		 /*!< their lengths */
+	enum NW_Engine engine;
+	size_t window;
+	long *costs;		 /*!< sums of the costs by window of bases of A */
+	size_t nbases;		 /*!< bases of A */
+	size_t cursor, bases; /*!< bases of A before A[cursor] (the path goes down A, cf _add) */
+	long *F, *R;		 /*!< profiles of the two halves (N + 1 longs each) */
+};
+
+/*
+ * static void _add(struct _track *t, size_t i, long cost)
+ * \brief adds the cost of an operation on the character A[i] (or before it) to the window of its base
+ *
+ * The operations come in the order of the path, i never decreasing: the bases before A[i] are counted
+ * from the previous call.
+ */
+static void _add(struct _track *t, size_t i, long cost)
+{
+	if (i >= t->M)
+		i = t->M - 1;
+	for (; t->cursor < i; ++t->cursor)
+		t->bases += isBase(t->A[t->cursor]);
+	size_t k = (t->bases < t->nbases) ? t->bases : t->nbases - 1; // the chars after the last base
+	t->costs[k / t->window] += cost;
+}
+
+/*
+ * static void _traceback(struct _track *t, size_t i0, size_t i1, size_t j0, size_t j1)
+ * \brief aligns A[i0 .. i1-1] and B[j0 .. j1-1] with a full table of moves and adds the costs of the path
+ */
+static void _traceback(struct _track *t, size_t i0, size_t i1, size_t j0, size_t j1)
+{
+	const char *X = t->A + i0, *Y = t->B + j0;
+	struct NW_ArenaMark mark = NW_ArenaGet();
+	unsigned char *moves = (unsigned char *)NW_ArenaAlloc(i1 - i0 + j1 - j0 + 1);
+	size_t n;
+	EditDistance_NW_traceback(X, i1 - i0, Y, j1 - j0, moves, &n);
+	size_t i = 0, j = 0;
+	for (size_t k = 0; k < n; ++k)
+	{
+		if (moves[k] == NW_MOVE_DIAGONAL)
+		{
+			_add(t, i0 + i, isSameBase(X[i], Y[j]) ? 0 : SUBSTITUTION_COST);
+			++i;
+			++j;
+		}
+		else if (moves[k] == NW_MOVE_UP) // suppression de X[i]
+		{
+			if (isBase(X[i]))
+				_add(t, i0 + i, INSERTION_COST);
+			++i;
+		}
+		else // insertion de Y[j] avant X[i]
+		{
+			if (isBase(Y[j]))
+				_add(t, i0 + i, INSERTION_COST);
+			++j;
+		}
+	}
+	NW_ArenaRelease(mark);
+}
+
+/*
+ * static void _solve(struct _track *t, size_t i0, size_t i1, size_t j0, size_t j1)
+ * \brief aligns A[i0 .. i1-1] and B[j0 .. j1-1] and adds the costs of the path (Hirschberg)
+ */
+static void _solve(struct _track *t, size_t i0, size_t i1, size_t j0, size_t j1)
+{
+	size_t h = i1 - i0, w = j1 - j0;
+	if (h <= 1 || w == 0 || (h + 1) * (w + 1) <= NW_TRACEBACK_CELLS)
+	{
+		_traceback(t, i0, i1, j0, j1);
+		return;
+	}
+	size_t mid = i0 + h / 2;
+	// F[j] = D(A[i0 .. mid-1], B[j0 .. j0+j-1]) et R[k] = D(A[mid .. i1-1], B[j1-k .. j1-1]) (sur les inverses)
+	struct NW_Profile forward = {t->F, NULL, 1}, backward = {t->R, NULL, 1};
+	EditDistance_NW_profile(t->engine, (char *)t->A + i0, mid - i0, (char *)t->B + j0, w, &forward);
+	EditDistance_NW_profile(t->engine, (char *)t->RA + (t->M - i1), i1 - mid, (char *)t->RB + (t->N - j1), w, &backward);
+	size_t split = 0;
+	long best = t->F[0] + t->R[w];
+	for (size_t j = 1; j <= w; ++j)
+	{
+		if (t->F[j] + t->R[w - j] < best)
+		{
+			best = t->F[j] + t->R[w - j];
+			split = j;
+		}
+	}
+	_solve(t, i0, mid, j0, j0 + split);
+	_solve(t, mid, i1, j0 + split, j1);
+}
+
+/* NW_DivergenceTrack : see .h file for documentation
+ */
+long NW_DivergenceTrack(const char *A, size_t lengthA, const char *B, size_t lengthB, enum NW_Engine engine, size_t window,
+						long *costs)
+{
+	if (window == 0)
+		window = NW_DIVERGENCE_WINDOW;
+	size_t nbases = 0;
+	for (size_t i = 0; i < lengthA; ++i)
+		nbases += isBase(A[i]);
+	size_t nwindows = (nbases + window - 1) / window;
+	memset(costs, 0, nwindows * sizeof(long));
+	if (nbases == 0)
+		return EditDistance_NW(engine, (char *)A, lengthA, (char *)B, lengthB);
+
+	struct _track t = {A, B, NULL, NULL, lengthA, lengthB, engine, window, costs, nbases, 0, 0, NULL, NULL};
+	struct NW_ArenaMark mark = NW_ArenaGet();
+	char *RA = (char *)NW_ArenaAlloc(lengthA + 1), *RB = (char *)NW_ArenaAlloc(lengthB + 1);
+	t.F = (long *)NW_ArenaAlloc((lengthB + 1) * sizeof(long));
+	t.R = (long *)NW_ArenaAlloc((lengthB + 1) * sizeof(long));
+	for (size_t i = 0; i < lengthA; ++i)
+		RA[i] = A[lengthA - 1 - i];
+	for (size_t j = 0; j < lengthB; ++j)
+		RB[j] = B[lengthB - 1 - j];
+	t.RA = RA;
+	t.RB = RB;
+
+	_solve(&t, 0, lengthA, 0, lengthB);
+
+	long total = 0;
+	for (size_t k = 0; k < nwindows; ++k)
+		total += costs[k];
+	NW_ArenaRelease(mark);
+	return total;
+}
+
+/* NW_WriteBedGraph : see .h file for documentation
+ */
+void NW_WriteBedGraph(FILE *out, const char *chrom, long offset, size_t bases, size_t window, const long *costs)
+{
+	if (window == 0)
+		window = NW_DIVERGENCE_WINDOW;
+	fprintf(out, "track type=bedGraph name=\"edit distance\" description=\"edit cost per %zu bp window\"\n", window);
+	for (size_t k = 0; k * window < bases; ++k)
+	{
+		size_t end = (k + 1) * window;
+		if (end > bases)
+			end = bases;
+		fprintf(out, "%s\t%ld\t%ld\t%ld\n", chrom, offset + (long)(k * window), offset + (long)end, costs[k]);
+	}
+}
@@ -0,0 +1,54 @@
+/**
+ * \file divergence.h
+ * \brief divergence track: costs of the optimal alignment summed by windows of the reference, as a bedGraph
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * The optimal alignment is found in linear space by the method of Hirschberg: the distance profiles
+ * (cf struct NW_Profile) of the first half of the rows and of the reversed second half give the column
+ * where the optimal path crosses the middle row, and both halves are solved recursively. The
+ * sub-problems of at most NW_TRACEBACK_CELLS cells are solved with a full table of 2 bit moves and a
+ * traceback (cf Needleman-Wunsch-traceback.h), which is cheaper than recursing down. The cost of each
+ * operation of the path is added to the window of the reference (the first sequence) where it occurs; the
+ * windows are counted in bases, the chars that are not bases (eg '\n') being skipped as by the engines.
+ */
+
+#ifndef __DIVERGENCE_H__
+#define __DIVERGENCE_H__
+
+#include <stdio.h>	/* for FILE */
+#include <stdlib.h> /* for size_t */
+#include "Needleman-Wunsch-recmemo.h" /* for enum NW_Engine */
+
+/** \def NW_DIVERGENCE_WINDOW
+ *  \brief default length of the windows of the reference
+ */
+#define NW_DIVERGENCE_WINDOW 10000
+
+/** \def NW_TRACEBACK_CELLS
+ *  \brief sub-problems of at most NW_TRACEBACK_CELLS cells are solved with a full table (64 MB of moves, which
+ *  the arena keeps, cf NW_ARENA_KEEP)
+ */
+#define NW_TRACEBACK_CELLS (1 << 28)
+
+/**
+ * \fn long NW_DivergenceTrack(const char *A, size_t lengthA, const char *B, size_t lengthB, enum NW_Engine engine, size_t window, long *costs);
+ * \brief computes the optimal alignment of A (the reference) and B and the sum of its costs by window of A
+ * \param engine : the linear space engine computing the profiles
+ * \param window : number of bases of the windows of A
+ * \param costs : receives ceil(bases / window) sums, bases being the number of bases of A (at most
+ *        ceil(lengthA / window)); costs[k] is the cost of the operations on the bases k window .. (k+1) window - 1
+ *        of A plus the insertions of B before the next base of A
+ * \return : the edit distance between A and B (the sum of costs)
+ */
+long NW_DivergenceTrack(const char *A, size_t lengthA, const char *B, size_t lengthB, enum NW_Engine engine, size_t window,
+						long *costs);
+
+/**
+ * \fn void NW_WriteBedGraph(FILE *out, const char *chrom, long offset, size_t bases, size_t window, const long *costs);
+ * \brief writes the costs of the windows of A of bases bases as bedGraph lines "chrom start end cost", the window k
+ * starting at offset + k window (base coordinates: offset is the number of bases of the record of chrom before A)
+ */
+void NW_WriteBedGraph(FILE *out, const char *chrom, long offset, size_t bases, size_t window, const long *costs);
+
+#endif /* __DIVERGENCE_H__ */
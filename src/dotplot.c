@@ -0,0 +1,312 @@
+/**
+ * \file dotplot.c
+ * \brief dot plot of two sequences (or of a sequence against itself) from shared k-mers on both strands
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see dotplot.h
+ */
+
+#include "dotplot.h"
+#include "thread_pool.h" /* workers */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h> /* for uint64_t */
+#include <string.h> /* for memset */
+#include <math.h>	/* for log */
+
+#include "characters_to_base.h" /* mapping from char to base */
+
+/** \def NW_DOTPLOT_BAND
+ *  \brief number of rows of the image computed by one task
+ */
+#define NW_DOTPLOT_BAND 16
+
+/* 2 bits code of a base (U is T), 4 for N, 5 if not a base */
+static const unsigned char _code[] = {
+	[SKIP_BASE] = 5, [ADENINE] = 0, [CYTOSINE] = 1, [GUANINE] = 2, [THYMINE] = 3, [URACILE] = 3, [UNKOWN_BASE] = 4};
+
+/** \struct _canonical_iterator
+ * \brief enumerates the canonical k-mers of a sequence, skipping the chars that are not bases
+ */
+struct _canonical_iterator
+{
+	const char *s;	   /*!< the sequence */
+	size_t i, length;  /*!< next position and length of the sequence */
+	int k;			   /*!< length of the k-mers */
+	uint64_t mask;	   /*!< 2 k bits */
+	uint64_t fwd, rev; /*!< the last k bases and their reverse complement */
+	size_t n;		   /*!< number of bases read since the last N */
+	size_t pos[32];	   /*!< positions of the last k bases (circular) */
+};
+
+/*
+ * static void _iterator_init(struct _canonical_iterator *it, const char *s, size_t begin, size_t length, int k)
+ * \brief starts the enumeration of the k-mers of s[begin .. length-1]
+ */
+static void _iterator_init(struct _canonical_iterator *it, const char *s, size_t begin, size_t length, int k)
+{
+	it->s = s;
+	it->i = begin;
+	it->length = length;
+	it->k = k;
+	it->mask = (k == 32) ? ~(uint64_t)0 : ((uint64_t)1 << (2 * k)) - 1;
+	it->fwd = it->rev = 0;
+	it->n = 0;
+}
+
+/*
+ * static int _next_canonical(struct _canonical_iterator *it, uint64_t *code, size_t *pos, int *strand)
+ * \brief sets code to the next canonical k-mer, pos to the position of its first base and strand to 1
+ * if it is the reverse complement of the k-mer read; returns 0 at the end of the sequence
+ */
+static int _next_canonical(struct _canonical_iterator *it, uint64_t *code, size_t *pos, int *strand)
+{
+	while (it->i < it->length)
+	{
+		size_t i = it->i++;
+		unsigned x = _code[CharToBase(it->s[i])];
+		if (x == 5)
+			continue;
+		if (x == 4)
+		{
+			it->n = 0;
+			continue;
+		}
+		it->fwd = ((it->fwd << 2) | x) & it->mask;
+		it->rev = (it->rev >> 2) | ((uint64_t)(3 - x) << (2 * it->k - 2));
+		it->pos[it->n % it->k] = i;
+		if (++it->n >= (size_t)it->k)
+		{
+			*strand = (it->rev < it->fwd);
+			*code = *strand ? it->rev : it->fwd;
+			*pos = it->pos[it->n % it->k];
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * static uint64_t _mix(uint64_t x)
+ * \brief hash of a k-mer code (finalizer of MurmurHash3)
+ */
+static uint64_t _mix(uint64_t x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ull;
+	return x ^ (x >> 33);
+}
+
+/** \struct _hit
+ * \brief a k-mer of A found in B
+ */
+struct _hit
+{
+	size_t i, j; /*!< positions in A and B */
+	int strand;	 /*!< 1 if the k-mers are reverse complement */
+};
+
+/** \struct _dotplot
+ * \brief data shared by the tasks
+ */
+struct _dotplot
+{
+	const char *A;
+	size_t lengthA;
+	int k;
+	uint64_t sampling_mask;	   /*!< a k-mer is used iff (hash & sampling_mask) == 0 */
+	size_t max_occ;
+	int bits;				   /*!< log2 of the number of buckets */
+	size_t *start;			   /*!< the bucket b is codes[start[b] .. start[b+1]-1] */
+	uint64_t *codes;		   /*!< canonical k-mers of B, by bucket */
+	uint64_t *where;		   /*!< position in B << 1 | strand, by bucket */
+	size_t scale;			   /*!< characters per pixel */
+	size_t width;			   /*!< pixels per row */
+	uint32_t *counts;		   /*!< hits per pixel */
+	struct _hit **hits;		   /*!< hits of each band (if the hits are listed) */
+	size_t *nhits;			   /*!< number of hits of each band */
+};
+
+/*
+ * static void _band(size_t index, int worker, void *arg)
+ * \brief task of NW_ParallelFor: the hits of the k-mers of A starting in the rows of band index
+ */
+static void _band(size_t index, int worker, void *arg)
+{
+	struct _dotplot *d = (struct _dotplot *)arg;
+	size_t begin = index * NW_DOTPLOT_BAND * d->scale, end = begin + NW_DOTPLOT_BAND * d->scale;
+	struct _canonical_iterator it;
+	uint64_t code;
+	size_t pos, capacity = 0, n = 0;
+	int strand;
+	struct _hit *hits = NULL;
+	(void)worker;
+
+	_iterator_init(&it, d->A, begin, d->lengthA, d->k);
+	while (_next_canonical(&it, &code, &pos, &strand) && pos < end) // a k-mer may end in the next band
+	{
+		uint64_t h = _mix(code);
+		if ((h & d->sampling_mask) != 0)
+			continue;
+		size_t b = (size_t)(h >> (64 - d->bits));
+		const uint64_t *codes = d->codes + d->start[b];
+		size_t size = d->start[b + 1] - d->start[b], occ = 0;
+		for (size_t k = 0; k < size; ++k) // vectorized comparison of the bucket
+			occ += (codes[k] == code);
+		if (occ == 0 || (d->max_occ != 0 && occ > d->max_occ))
+			continue;
+		uint32_t *row = d->counts + (pos / d->scale) * d->width;
+		for (size_t k = 0; k < size; ++k)
+		{
+			if (codes[k] != code)
+				continue;
+			size_t j = (size_t)(d->where[d->start[b] + k] >> 1);
+			row[j / d->scale]++;
+			if (d->hits != NULL)
+			{
+				if (n == capacity)
+				{
+					capacity = (capacity == 0) ? 256 : 2 * capacity;
+					hits = (struct _hit *)realloc(hits, capacity * sizeof(struct _hit));
+					if (hits == NULL)
+					{
+						perror("NW_Dotplot: realloc of hits");
+						exit(EXIT_FAILURE);
+					}
+				}
+				hits[n].i = pos;
+				hits[n].j = j;
+				hits[n++].strand = strand ^ (int)(d->where[d->start[b] + k] & 1);
+			}
+		}
+	}
+	if (d->hits != NULL)
+	{
+		d->hits[index] = hits;
+		d->nhits[index] = n;
+	}
+}
+
+/* NW_Dotplot : see .h file for documentation
+ */
+size_t NW_Dotplot(const char *A, size_t lengthA, const char *B, size_t lengthB, const struct NW_DotplotParams *params,
+				  FILE *image, FILE *hits)
+{
+	struct _dotplot d;
+	memset(&d, 0, sizeof(d));
+	d.A = A;
+	d.lengthA = lengthA;
+	d.k = (params->k <= 0 || params->k > 32) ? NW_DOTPLOT_K : params->k;
+	d.sampling_mask = (params->sampling <= 1) ? 0 : (uint64_t)params->sampling - 1;
+	d.max_occ = params->max_occ;
+	size_t pixels = (params->pixels == 0) ? NW_DOTPLOT_PIXELS : params->pixels;
+	size_t longest = (lengthA > lengthB) ? lengthA : lengthB;
+	d.scale = (longest + pixels - 1) / pixels;
+	if (d.scale == 0)
+		d.scale = 1;
+	d.width = (lengthB + d.scale - 1) / d.scale;
+	size_t height = (lengthA + d.scale - 1) / d.scale;
+
+	// sampled canonical k-mers of B, sorted by bucket (counting sort on the high bits of their hash)
+	size_t n = 0;
+	{
+		struct _canonical_iterator it;
+		uint64_t code;
+		size_t pos;
+		int strand;
+		_iterator_init(&it, B, 0, lengthB, d.k);
+		while (_next_canonical(&it, &code, &pos, &strand))
+			n += ((_mix(code) & d.sampling_mask) == 0);
+		d.bits = 1;
+		while (((size_t)1 << d.bits) < n / 2)
+			++d.bits;
+		d.start = (size_t *)calloc(((size_t)1 << d.bits) + 1, sizeof(size_t));
+		d.codes = (uint64_t *)malloc((n + 1) * sizeof(uint64_t));
+		d.where = (uint64_t *)malloc((n + 1) * sizeof(uint64_t));
+		if (d.start == NULL || d.codes == NULL || d.where == NULL)
+		{
+			perror("NW_Dotplot: malloc of the index of B");
+			exit(EXIT_FAILURE);
+		}
+		for (int pass = 0; pass < 2; ++pass) // count, then place
+		{
+			_iterator_init(&it, B, 0, lengthB, d.k);
+			while (_next_canonical(&it, &code, &pos, &strand))
+			{
+				uint64_t h = _mix(code);
+				if ((h & d.sampling_mask) != 0)
+					continue;
+				size_t b = (size_t)(h >> (64 - d.bits));
+				if (pass == 0)
+					d.start[b + 1]++;
+				else
+				{
+					d.codes[d.start[b]] = code;
+					d.where[d.start[b]++] = (uint64_t)pos << 1 | (uint64_t)strand;
+				}
+			}
+			if (pass == 0)
+				for (size_t b = 1; b <= ((size_t)1 << d.bits); ++b)
+					d.start[b] += d.start[b - 1];
+		}
+		memmove(d.start + 1, d.start, ((size_t)1 << d.bits) * sizeof(size_t)); // start[b] was moved to start[b+1]
+		d.start[0] = 0;
+	}
+
+	size_t nbands = (height + NW_DOTPLOT_BAND - 1) / NW_DOTPLOT_BAND;
+	d.counts = (uint32_t *)calloc(height * d.width + 1, sizeof(uint32_t));
+	if (hits != NULL)
+	{
+		d.hits = (struct _hit **)calloc(nbands + 1, sizeof(struct _hit *));
+		d.nhits = (size_t *)calloc(nbands + 1, sizeof(size_t));
+	}
+	if (d.counts == NULL || (hits != NULL && (d.hits == NULL || d.nhits == NULL)))
+	{
+		perror("NW_Dotplot: malloc of the image");
+		exit(EXIT_FAILURE);
+	}
+	NW_ParallelFor(nbands, NULL, params->nthreads, 0, _band, &d);
+
+	size_t total = 0;
+	uint32_t max = 0;
+	for (size_t p = 0; p < height * d.width; ++p)
+	{
+		total += d.counts[p];
+		if (d.counts[p] > max)
+			max = d.counts[p];
+	}
+	if (image != NULL)
+	{
+		unsigned char *line = (unsigned char *)malloc(d.width + 1);
+		double norm = (max == 0) ? 1 : log(1.0 + max);
+		fprintf(image, "P5\n# dot plot: %zu x %zu characters, %zu characters per pixel, k = %d\n%zu %zu\n255\n",
+				lengthA, lengthB, d.scale, d.k, d.width, height);
+		for (size_t r = 0; r < height; ++r)
+		{
+			for (size_t c = 0; c < d.width; ++c)
+				line[c] = (unsigned char)(255 - (int)(255 * log(1.0 + d.counts[r * d.width + c]) / norm));
+			fwrite(line, 1, d.width, image);
+		}
+		free(line);
+	}
+	if (hits != NULL)
+	{
+		for (size_t b = 0; b < nbands; ++b)
+		{
+			for (size_t h = 0; h < d.nhits[b]; ++h)
+				fprintf(hits, "%zu %zu %c\n", d.hits[b][h].i, d.hits[b][h].j, d.hits[b][h].strand ? '-' : '+');
+			free(d.hits[b]);
+		}
+		free(d.hits);
+		free(d.nhits);
+	}
+	free(d.counts);
+	free(d.start);
+	free(d.codes);
+	free(d.where);
+	return total;
+}
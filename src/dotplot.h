@@ -0,0 +1,54 @@
+/**
+ * \file dotplot.h
+ * \brief dot plot of two sequences (or of a sequence against itself) from shared k-mers on both strands
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * The sampled k-mers of B are stored in a table of buckets; A is cut into bands of rows of the image,
+ * scanned in parallel, and each sampled k-mer of A is searched in its bucket of B. A k-mer and its
+ * reverse complement are the same canonical k-mer, so that the hits on the reverse strand (inversions)
+ * are found by the same lookup.
+ */
+
+#ifndef __DOTPLOT_H__
+#define __DOTPLOT_H__
+
+#include <stdio.h>	/* for FILE */
+#include <stdlib.h> /* for size_t */
+
+/** \def NW_DOTPLOT_K
+ *  \brief default length of the k-mers (at most 32)
+ */
+#define NW_DOTPLOT_K 20
+
+/** \def NW_DOTPLOT_PIXELS
+ *  \brief default number of pixels of the longest side of the image
+ */
+#define NW_DOTPLOT_PIXELS 1000
+
+/** \struct NW_DotplotParams
+ * \brief parameters of NW_Dotplot
+ */
+struct NW_DotplotParams
+{
+	int k;			  /*!< length of the k-mers, in 1..32 (0 for NW_DOTPLOT_K) */
+	unsigned sampling; /*!< one canonical k-mer out of sampling (a power of 2) is used, according to its hash (0 for 1) */
+	size_t max_occ;	  /*!< k-mers found more often in B are ignored (0 for no limit) */
+	size_t pixels;	  /*!< pixels of the longest side of the image (0 for NW_DOTPLOT_PIXELS) */
+	int nthreads;	  /*!< number of threads (if <= 0: the number of online processors) */
+};
+
+/**
+ * \fn size_t NW_Dotplot(const char *A, size_t lengthA, const char *B, size_t lengthB, const struct NW_DotplotParams *params, FILE *image, FILE *hits);
+ * \brief computes the dot plot of A (rows) against B (columns)
+ * \param image : if not NULL, receives a PGM image (P5) of the density of hits, black for the densest pixels
+ * \param hits : if not NULL, receives one line "position_in_A position_in_B strand" per hit (strand + or -)
+ * \return : the number of hits
+ *
+ * The chars that are not A, C, G, T or U are skipped; an N starts a new k-mer.
+ * The gray level of a pixel is logarithmic in its number of hits.
+ */
+size_t NW_Dotplot(const char *A, size_t lengthA, const char *B, size_t lengthB, const struct NW_DotplotParams *params,
+				  FILE *image, FILE *hits);
+
+#endif /* __DOTPLOT_H__ */
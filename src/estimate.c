@@ -0,0 +1,319 @@
+/**
+ * \file estimate.c
+ * \brief estimate of the edit distance of two long sequences from a random sample of anchored windows
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see estimate.h
+ */
+
+#include "estimate.h"
+#include "batch.h"		 /* for NW_Now and NW_StackSize */
+#include "thread_pool.h" /* workers */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h> /* for uint64_t */
+#include <math.h>	/* for sqrt */
+
+#include "characters_to_base.h" /* mapping from char to base */
+
+/** \def NW_ANCHOR_SAMPLING
+ *  \brief one k-mer out of NW_ANCHOR_SAMPLING (a power of 2) is sampled, according to its hash
+ */
+#define NW_ANCHOR_SAMPLING 16
+
+/** \def NW_ANCHOR_ENDS
+ *  \brief number of anchors at each end of a window whose median diagonal places the end of the window in B
+ */
+#define NW_ANCHOR_ENDS 5
+
+/** \def NW_ANCHOR_MAX_OCC
+ *  \brief k-mers found more often in B are repeats and are not used as anchors
+ */
+#define NW_ANCHOR_MAX_OCC 4
+
+/** \struct _kmer
+ * \brief a sampled k-mer and the position of its first base
+ */
+struct _kmer
+{
+	uint64_t code; /*!< 3 bits per base */
+	size_t pos;	   /*!< position of the first base in the sequence */
+};
+
+/** \struct _kmer_iterator
+ * \brief enumerates the sampled k-mers of a sequence, skipping the chars that are not bases
+ */
+struct _kmer_iterator
+{
+	const char *s;			  /*!< the sequence */
+	size_t i, end;			  /*!< next position and end of the enumeration */
+	uint64_t code;			  /*!< the last NW_ANCHOR_K bases */
+	size_t n;				  /*!< number of bases read */
+	size_t pos[NW_ANCHOR_K];  /*!< positions of the last NW_ANCHOR_K bases (circular) */
+};
+
+/*
+ * static uint64_t _mix(uint64_t x)
+ * \brief hash of a k-mer code (finalizer of MurmurHash3)
+ */
+static uint64_t _mix(uint64_t x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ull;
+	return x ^ (x >> 33);
+}
+
+/*
+ * static int _next_kmer(struct _kmer_iterator *it, struct _kmer *kmer)
+ * \brief sets kmer to the next sampled k-mer; returns 0 at the end of the enumeration
+ */
+static int _next_kmer(struct _kmer_iterator *it, struct _kmer *kmer)
+{
+	const uint64_t mask = ((uint64_t)1 << (3 * NW_ANCHOR_K)) - 1;
+	while (it->i < it->end)
+	{
+		size_t i = it->i++;
+		enum Base b = CharToBase(it->s[i]);
+		if (b == SKIP_BASE)
+			continue;
+		it->code = ((it->code << 3) | (uint64_t)b) & mask;
+		it->pos[it->n % NW_ANCHOR_K] = i;
+		it->n++;
+		if (it->n >= NW_ANCHOR_K && (_mix(it->code) & (NW_ANCHOR_SAMPLING - 1)) == 0)
+		{
+			kmer->code = it->code;
+			kmer->pos = it->pos[it->n % NW_ANCHOR_K]; // oldest base of the circular buffer
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int _compare_kmers(const void *a, const void *b)
+{
+	const struct _kmer *x = (const struct _kmer *)a, *y = (const struct _kmer *)b;
+	if (x->code != y->code)
+		return (x->code < y->code) ? -1 : 1;
+	return (x->pos < y->pos) ? -1 : (x->pos > y->pos);
+}
+
+static int _compare_longs(const void *a, const void *b)
+{
+	long x = *(const long *)a, y = *(const long *)b;
+	return (x < y) ? -1 : (x > y);
+}
+
+/** \struct _estimate
+ * \brief data shared by the workers aligning the windows
+ */
+struct _estimate
+{
+	const char *A, *B;
+	size_t lengthA, lengthB;
+	size_t window;			 /*!< length of the windows of A */
+	struct _kmer *index;	 /*!< sampled k-mers of B, sorted */
+	size_t nindex;			 /*!< number of elements in index */
+	enum NW_Engine engine;
+	const size_t *sample;	 /*!< windows of the current round */
+	double *distance;		 /*!< distance of the windows of the round */
+	double *length;			 /*!< length of the windows of A of the round */
+	double *error;			 /*!< bound of the error of placement of the windows of the round */
+	int *anchored;			 /*!< 1 if the window of the round was placed by anchors */
+};
+
+/*
+ * static void _align_window(size_t index, int worker, void *arg)
+ * \brief task of NW_ParallelFor: aligns the window sample[index] of A with its window of B
+ */
+static void _align_window(size_t index, int worker, void *arg)
+{
+	struct _estimate *e = (struct _estimate *)arg;
+	size_t p = e->sample[index] * e->window;
+	size_t wa = (e->lengthA - p < e->window) ? e->lengthA - p : e->window;
+	size_t wb = (size_t)((double)wa * (double)e->lengthB / (double)e->lengthA + 0.5);
+	(void)worker;
+
+	// diagonals j - i of the anchors of the window
+	long diag[wa / NW_ANCHOR_SAMPLING * 4 + 64];
+	size_t ndiag = 0, max = sizeof(diag) / sizeof(long);
+	struct _kmer_iterator it = {e->A, p, p + wa, 0, 0, {0}};
+	struct _kmer kmer;
+	while (_next_kmer(&it, &kmer) && ndiag < max)
+	{
+		size_t lo = 0, hi = e->nindex; // first k-mer of index not less than kmer
+		while (lo < hi)
+		{
+			size_t mid = (lo + hi) / 2;
+			if (e->index[mid].code < kmer.code)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		size_t occ = 0;
+		while (lo + occ < e->nindex && e->index[lo + occ].code == kmer.code)
+			++occ;
+		for (size_t k = 0; k < occ && occ <= NW_ANCHOR_MAX_OCC && ndiag < max; ++k)
+			diag[ndiag++] = (long)e->index[lo + k].pos - (long)kmer.pos;
+	}
+
+	// the window of B starts on the diagonal of the first anchors and ends on the one of the last anchors
+	long q = (long)((double)p * (double)e->lengthB / (double)e->lengthA), q_end = q + (long)wb, spread = -1;
+	if (ndiag > 0)
+	{
+		size_t m = (ndiag < NW_ANCHOR_ENDS) ? ndiag : NW_ANCHOR_ENDS;
+		long first[NW_ANCHOR_ENDS], last[NW_ANCHOR_ENDS];
+		for (size_t k = 0; k < m; ++k)
+		{
+			first[k] = diag[k];
+			last[k] = diag[ndiag - m + k];
+		}
+		qsort(first, m, sizeof(long), _compare_longs);
+		qsort(last, m, sizeof(long), _compare_longs);
+		q = (long)p + first[m / 2];
+		q_end = (long)(p + wa) + last[m / 2];
+		if (q_end < q)
+			q_end = q;
+		// the ends may be misplaced by the spread of the middle anchors: as many insertions at each end
+		spread = (first[m - 1 - m / 4] - first[m / 4]) + (last[m - 1 - m / 4] - last[m / 4]);
+	}
+	if (q_end > q + 2 * (long)e->window) // anchors in a repeat (and the stack of the workers)
+		q_end = q + 2 * (long)e->window;
+	if (q < 0)
+		q = 0;
+	if (q > (long)e->lengthB)
+		q = (long)e->lengthB;
+	if (q_end > (long)e->lengthB)
+		q_end = (long)e->lengthB;
+	wb = (q_end > q) ? (size_t)(q_end - q) : 0;
+
+	e->distance[index] = (double)EditDistance_NW(e->engine, (char *)e->A + p, wa, (char *)e->B + q, wb);
+	e->length[index] = (double)wa;
+	e->anchored[index] = (ndiag > 0);
+	// without anchors the window of B may be anywhere: up to an insertion per base of A
+	e->error[index] = (spread < 0) ? (double)(INSERTION_COST * wa) : (double)(INSERTION_COST * spread);
+}
+
+/* NW_Estimate : see .h file for documentation
+ * The estimate is the ratio estimator lengthA * sum(d) / sum(l) over the windows of lengths l and distances d.
+ */
+void NW_Estimate(const char *A, size_t lengthA, const char *B, size_t lengthB, const struct NW_EstimateParams *params,
+				 struct NW_EstimateResult *result)
+{
+	double start = NW_Now();
+	struct _estimate e = {A, B, lengthA, lengthB, params->window, NULL, 0, params->engine, NULL, NULL, NULL, NULL, NULL};
+	if (e.window == 0)
+		e.window = NW_ESTIMATE_WINDOW;
+	result->total = (lengthA + e.window - 1) / e.window;
+	result->windows = result->anchored = 0;
+	result->distance = result->low = result->high = result->placement = 0;
+	if (result->total <= 1 || lengthB == 0) // A fits in one window
+	{
+		result->distance = result->low = result->high =
+			(double)EditDistance_NW(params->engine, (char *)A, lengthA, (char *)B, lengthB);
+		result->seconds = NW_Now() - start;
+		return;
+	}
+
+	// index of the sampled k-mers of B
+	{
+		size_t capacity = lengthB / NW_ANCHOR_SAMPLING * 2 + 16;
+		e.index = (struct _kmer *)malloc(capacity * sizeof(struct _kmer));
+		if (e.index == NULL)
+		{
+			perror("NW_Estimate: malloc of index");
+			exit(EXIT_FAILURE);
+		}
+		struct _kmer_iterator it = {B, 0, lengthB, 0, 0, {0}};
+		while (_next_kmer(&it, &e.index[e.nindex]))
+		{
+			if (++e.nindex == capacity)
+			{
+				capacity *= 2;
+				e.index = (struct _kmer *)realloc(e.index, capacity * sizeof(struct _kmer));
+				if (e.index == NULL)
+				{
+					perror("NW_Estimate: realloc of index");
+					exit(EXIT_FAILURE);
+				}
+			}
+		}
+		qsort(e.index, e.nindex, sizeof(struct _kmer), _compare_kmers);
+	}
+
+	// random order of the windows (Fisher-Yates): each round takes the next ones
+	size_t n = result->total;
+	size_t *order = (size_t *)malloc(n * sizeof(size_t));
+	double *distance = (double *)malloc(n * sizeof(double));
+	double *length = (double *)malloc(n * sizeof(double));
+	double *error = (double *)malloc(n * sizeof(double));
+	int *anchored = (int *)malloc(n * sizeof(int));
+	if (order == NULL || distance == NULL || length == NULL || error == NULL || anchored == NULL)
+	{
+		perror("NW_Estimate: malloc of the sample");
+		exit(EXIT_FAILURE);
+	}
+	unsigned seed = params->seed;
+	for (size_t k = 0; k < n; ++k)
+		order[k] = k;
+	for (size_t k = n; k > 1; --k)
+	{
+		size_t r = (((size_t)rand_r(&seed) << 16) ^ (size_t)rand_r(&seed)) % k;
+		size_t t = order[k - 1];
+		order[k - 1] = order[r];
+		order[r] = t;
+	}
+
+	// a sample is at most n - 1 windows: the sum of all the windows is not the distance either
+	size_t done = 0, round = 16;
+	double sum_d = 0, sum_l = 0, sum_e = 0;
+	while (done < n - 1)
+	{
+		size_t count = (n - 1 - done < round) ? n - 1 - done : round;
+		e.sample = order + done;
+		e.distance = distance + done;
+		e.length = length + done;
+		e.error = error + done;
+		e.anchored = anchored + done;
+		NW_ParallelFor(count, NULL, params->nthreads, NW_StackSize(e.window, 2 * e.window), _align_window, &e);
+		for (size_t k = done; k < done + count; ++k)
+		{
+			sum_d += distance[k];
+			sum_l += length[k];
+			sum_e += error[k];
+			result->anchored += (size_t)anchored[k];
+		}
+		done += count;
+		round = done; // the sample doubles at each round
+
+		// ratio estimator and its variance, with the finite population correction
+		double ratio = sum_d / sum_l, s2 = 0;
+		for (size_t k = 0; k < done; ++k)
+		{
+			double r = distance[k] - ratio * length[k];
+			s2 += r * r;
+		}
+		s2 = (done > 1) ? s2 / (double)(done - 1) : 0;
+		double mean_l = sum_l / (double)done;
+		double half = 1.96 * (double)lengthA / mean_l * sqrt(s2 / (double)done * (1 - (double)done / (double)n));
+		result->placement = (double)lengthA * sum_e / sum_l; // does not decrease with the sample
+		result->distance = ratio * (double)lengthA;
+		result->low = result->distance - half;
+		result->high = result->distance + half;
+		if (result->low < 0)
+			result->low = 0;
+		if (done >= 8 && 2 * half <= params->precision * result->distance)
+			break;
+	}
+	result->windows = done;
+	free(order);
+	free(distance);
+	free(length);
+	free(error);
+	free(anchored);
+	free(e.index);
+	result->seconds = NW_Now() - start;
+}
@@ -0,0 +1,81 @@
+/**
+ * \file estimate.h
+ * \brief estimate of the edit distance of two long sequences from a random sample of anchored windows
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * A is cut into windows of a fixed length. A random sample of them (without replacement) is aligned
+ * with the window of B found through k-mer anchors, and the total distance is extrapolated from the
+ * mean distance of the sampled windows, with a 95% confidence interval. The sample is doubled until
+ * the interval is narrow enough.
+ */
+
+#ifndef __ESTIMATE_H__
+#define __ESTIMATE_H__
+
+#include <stdlib.h> /* for size_t */
+#include "Needleman-Wunsch-recmemo.h" /* for enum NW_Engine */
+
+/** \def NW_ANCHOR_K
+ *  \brief length in bases of the k-mers used as anchors
+ */
+#define NW_ANCHOR_K 20
+
+/** \def NW_ESTIMATE_WINDOW
+ *  \brief default length of a window of A
+ */
+#define NW_ESTIMATE_WINDOW 4096
+
+/** \struct NW_EstimateParams
+ * \brief parameters of NW_Estimate
+ */
+struct NW_EstimateParams
+{
+	size_t window;		  /*!< length of the windows of A (0 for NW_ESTIMATE_WINDOW) */
+	double precision;	  /*!< stop when the width of the interval is at most precision times the estimate (eg 0.05) */
+	int nthreads;		  /*!< number of threads (if <= 0: the number of online processors) */
+	unsigned seed;		  /*!< seed of the random sample */
+	enum NW_Engine engine; /*!< engine used for the windows */
+};
+
+/** \struct NW_EstimateResult
+ * \brief result of NW_Estimate
+ */
+struct NW_EstimateResult
+{
+	double distance;  /*!< estimate of the edit distance */
+	double low, high; /*!< 95% confidence interval of the sampling error */
+	double placement; /*!< bound of the error of placement of the windows (not in the interval) */
+	size_t windows;	  /*!< number of windows aligned */
+	size_t total;	  /*!< number of windows of A */
+	size_t anchored;  /*!< number of windows aligned found by anchors (the others are placed proportionally) */
+	double seconds;	  /*!< wall clock time */
+};
+
+/**
+ * \fn void NW_Estimate(const char *A, size_t lengthA, const char *B, size_t lengthB, const struct NW_EstimateParams *params, struct NW_EstimateResult *result);
+ * \brief estimates the edit distance between A[0 .. lengthA-1] and B[0 .. lengthB-1]
+ * \param params : the parameters
+ * \param result : the estimate and its confidence interval
+ *
+ * A is cut into total = ceil(lengthA / window) windows. The window k of A is aligned with a window of B
+ * placed by anchors: the sampled k-mers of NW_ANCHOR_K bases of the window found in B at most 4 times
+ * (a k-mer is sampled according to its hash, so that the same k-mers are sampled in A and B). The window
+ * of B starts on the median diagonal of the first anchors and ends on the one of the last anchors; without
+ * anchors, it is placed proportionally (length window * lengthB / lengthA); it is at most 2 window long.
+ * Rounds of 16, 32, 64 ... new windows are aligned in parallel until the width of the interval is at most
+ * precision times the estimate, or until total - 1 windows are aligned (the sum of the distances of all
+ * the windows is not the distance either). If A fits in one window, the distance is computed by
+ * params->engine on the whole sequences instead, and the interval is reduced to it. The estimate is
+ * the ratio estimator lengthA sum(d) / sum(l) over the n windows of lengths l and distances d, and the half
+ * width of the interval is the sampling error 1.96 total s / sqrt(n) sqrt(1 - n / total) (s: standard
+ * deviation of the residuals d - l sum(d) / sum(l), rescaled to windows of mean length). The error of
+ * placement of the windows, the sum of their distances differing from the global distance by the
+ * alignments crossing their boundaries, does not decrease with n: it is reported apart as
+ * lengthA sum(e) / sum(l), where e bounds the error of a window: INSERTION_COST times the spread of the
+ * diagonals of the middle anchors at its ends, or times its length without anchors.
+ */
+void NW_Estimate(const char *A, size_t lengthA, const char *B, size_t lengthB, const struct NW_EstimateParams *params,
+				 struct NW_EstimateResult *result);
+
+#endif /* __ESTIMATE_H__ */
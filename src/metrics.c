@@ -0,0 +1,327 @@
+/**
+ * \file metrics.c
+ * \brief registry of counters of the jobs (throughput, latency, caches), exposed in the Prometheus text format
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see metrics.h
+ */
+
+#include "metrics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>	   /* for uint64_t */
+#include <stdatomic.h> /* for the counters of the slots */
+#include <stddef.h>	   /* for offsetof */
+#include <string.h>	   /* for memset and strchr */
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>		  /* for close */
+#include <sys/socket.h>
+#include <sys/un.h>		  /* for struct sockaddr_un */
+#include <netinet/in.h>	  /* for struct sockaddr_in */
+#include <arpa/inet.h>	  /* for htonl */
+#include <sys/resource.h> /* for getrusage */
+
+/** \def NW_MAX_GAUGES
+ *  \brief maximal number of gauges registered by NW_MetricsGauge
+ */
+#define NW_MAX_GAUGES 16
+
+/* names of the size classes, cf NW_SizeClass */
+static const char *_class_name[NW_SIZE_CLASSES] = {"tiny", "small", "medium", "large", "huge"};
+
+/* upper bounds of the latency buckets, in seconds */
+static const char *_bound_name[NW_LATENCY_BUCKETS] = {"1e-05", "0.0001", "0.001", "0.01", "0.1", "1", "10", "100"};
+
+/** \struct _slot
+ * \brief the counters of one thread (a single writer)
+ */
+struct _slot
+{
+	_Atomic uint64_t jobs[NW_ENGINE_COUNT];
+	_Atomic uint64_t cells;
+	_Atomic uint64_t nanoseconds;
+	_Atomic uint64_t latency[NW_SIZE_CLASSES][NW_LATENCY_BUCKETS + 1]; /*!< jobs by size class and latency bucket */
+	_Atomic uint64_t latency_ns[NW_SIZE_CLASSES];					   /*!< sum of the latencies by size class */
+	_Atomic uint64_t cache_hits, cache_misses;
+	struct _slot *next; /*!< slots of the other threads */
+} __attribute__((aligned(64)));
+
+/** \struct _gauge
+ * \brief a gauge registered by NW_MetricsGauge
+ */
+struct _gauge
+{
+	const char *name, *help;
+	NW_GaugeFunction value;
+	void *arg;
+};
+
+static __thread struct _slot *_mine; // slot of the calling thread
+static struct _slot *_slots;		  // all the slots
+static struct _gauge _gauges[NW_MAX_GAUGES];
+static int _ngauges;
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER; // registration of the slots and gauges
+
+/** \def _ADD(counter, v)
+ *  \brief adds v to a counter of the slot of the calling thread (its only writer)
+ */
+#define _ADD(counter, v) \
+	atomic_store_explicit(&(counter), atomic_load_explicit(&(counter), memory_order_relaxed) + (v), memory_order_relaxed)
+
+/*
+ * static struct _slot *_slot(void)
+ * \brief returns the slot of the calling thread, registered at its first call
+ */
+static struct _slot *_slot(void)
+{
+	if (_mine == NULL)
+	{
+		_mine = (struct _slot *)aligned_alloc(64, sizeof(struct _slot));
+		if (_mine == NULL)
+		{
+			perror("NW_Metrics: malloc of a slot");
+			exit(EXIT_FAILURE);
+		}
+		memset(_mine, 0, sizeof(struct _slot));
+		pthread_mutex_lock(&_lock);
+		_mine->next = _slots;
+		_slots = _mine;
+		pthread_mutex_unlock(&_lock);
+	}
+	return _mine;
+}
+
+/* NW_SizeClass : see .h file for documentation
+ */
+int NW_SizeClass(size_t lengthA, size_t lengthB)
+{
+	double cells = (double)lengthA * (double)lengthB, bound = 1e4;
+	int c = 0;
+	while (c < NW_SIZE_CLASSES - 1 && cells >= bound)
+	{
+		++c;
+		bound *= 100;
+	}
+	return c;
+}
+
+/* NW_MetricsJob : see .h file for documentation
+ */
+void NW_MetricsJob(enum NW_Engine engine, size_t lengthA, size_t lengthB, double seconds)
+{
+	struct _slot *s = _slot();
+	int c = NW_SizeClass(lengthA, lengthB), b = 0;
+	double bound = 1e-5;
+	while (b < NW_LATENCY_BUCKETS && seconds > bound)
+	{
+		++b;
+		bound *= 10;
+	}
+	uint64_t ns = (uint64_t)(seconds * 1e9);
+	if ((unsigned)engine < NW_ENGINE_COUNT)
+		_ADD(s->jobs[engine], 1);
+	_ADD(s->cells, (uint64_t)lengthA * lengthB);
+	_ADD(s->nanoseconds, ns);
+	_ADD(s->latency[c][b], 1);
+	_ADD(s->latency_ns[c], ns);
+}
+
+/* NW_MetricsCache : see .h file for documentation
+ */
+void NW_MetricsCache(size_t hits, size_t misses)
+{
+	struct _slot *s = _slot();
+	_ADD(s->cache_hits, hits);
+	_ADD(s->cache_misses, misses);
+}
+
+/* NW_MetricsGauge : see .h file for documentation
+ */
+void NW_MetricsGauge(const char *name, const char *help, NW_GaugeFunction value, void *arg)
+{
+	pthread_mutex_lock(&_lock);
+	if (_ngauges < NW_MAX_GAUGES)
+		_gauges[_ngauges++] = (struct _gauge){name, help, value, arg};
+	pthread_mutex_unlock(&_lock);
+}
+
+/* NW_MetricsUnregister : see .h file for documentation
+ */
+void NW_MetricsUnregister(void *arg)
+{
+	pthread_mutex_lock(&_lock);
+	int kept = 0;
+	for (int g = 0; g < _ngauges; ++g)
+		if (_gauges[g].arg != arg)
+			_gauges[kept++] = _gauges[g];
+	_ngauges = kept;
+	pthread_mutex_unlock(&_lock);
+}
+
+/* NW_MetricsWrite : see .h file for documentation
+ */
+void NW_MetricsWrite(FILE *out)
+{
+	struct _slot sum;
+	memset(&sum, 0, sizeof(sum));
+	pthread_mutex_lock(&_lock);
+	for (struct _slot *s = _slots; s != NULL; s = s->next)
+	{
+		const _Atomic uint64_t *from = (const _Atomic uint64_t *)s;
+		_Atomic uint64_t *to = (_Atomic uint64_t *)&sum;
+		for (size_t k = 0; k < offsetof(struct _slot, next) / sizeof(uint64_t); ++k)
+			to[k] += atomic_load_explicit(&from[k], memory_order_relaxed);
+	}
+
+	fprintf(out, "# HELP nw_jobs_total Jobs computed, by engine.\n# TYPE nw_jobs_total counter\n");
+	for (int e = 0; e < NW_ENGINE_COUNT; ++e)
+		fprintf(out, "nw_jobs_total{engine=\"%s\"} %lu\n", NW_EngineName((enum NW_Engine)e), (unsigned long)sum.jobs[e]);
+	fprintf(out, "# HELP nw_cells_total Cells of the matrices of the jobs.\n# TYPE nw_cells_total counter\n");
+	fprintf(out, "nw_cells_total %lu\n", (unsigned long)sum.cells);
+	fprintf(out, "# HELP nw_job_seconds_total Time spent in the jobs.\n# TYPE nw_job_seconds_total counter\n");
+	fprintf(out, "nw_job_seconds_total %.9f\n", sum.nanoseconds * 1e-9);
+	fprintf(out, "# HELP nw_gcups Cells per nanosecond of job.\n# TYPE nw_gcups gauge\n");
+	fprintf(out, "nw_gcups %.6f\n", (sum.nanoseconds == 0) ? 0.0 : (double)sum.cells / (double)sum.nanoseconds);
+
+	fprintf(out, "# HELP nw_job_latency_seconds Latency of the jobs, by size class (cells < 1e4, 1e6, 1e8, 1e10, more).\n"
+				 "# TYPE nw_job_latency_seconds histogram\n");
+	for (int c = 0; c < NW_SIZE_CLASSES; ++c)
+	{
+		uint64_t count = 0;
+		for (int b = 0; b < NW_LATENCY_BUCKETS; ++b)
+		{
+			count += sum.latency[c][b];
+			fprintf(out, "nw_job_latency_seconds_bucket{class=\"%s\",le=\"%s\"} %lu\n", _class_name[c], _bound_name[b],
+					(unsigned long)count);
+		}
+		count += sum.latency[c][NW_LATENCY_BUCKETS];
+		fprintf(out, "nw_job_latency_seconds_bucket{class=\"%s\",le=\"+Inf\"} %lu\n", _class_name[c], (unsigned long)count);
+		fprintf(out, "nw_job_latency_seconds_sum{class=\"%s\"} %.9f\n", _class_name[c], sum.latency_ns[c] * 1e-9);
+		fprintf(out, "nw_job_latency_seconds_count{class=\"%s\"} %lu\n", _class_name[c], (unsigned long)count);
+	}
+
+	uint64_t lookups = sum.cache_hits + sum.cache_misses;
+	fprintf(out, "# HELP nw_tile_cache_lookups_total Lookups of the tile cache, by result.\n"
+				 "# TYPE nw_tile_cache_lookups_total counter\n");
+	fprintf(out, "nw_tile_cache_lookups_total{result=\"hit\"} %lu\n", (unsigned long)sum.cache_hits);
+	fprintf(out, "nw_tile_cache_lookups_total{result=\"miss\"} %lu\n", (unsigned long)sum.cache_misses);
+	fprintf(out, "# HELP nw_tile_cache_hit_ratio Hits per lookup of the tile cache.\n# TYPE nw_tile_cache_hit_ratio gauge\n");
+	fprintf(out, "nw_tile_cache_hit_ratio %.6f\n", (lookups == 0) ? 0.0 : (double)sum.cache_hits / (double)lookups);
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	fprintf(out, "# HELP nw_peak_resident_bytes Maximum resident set size of the process.\n"
+				 "# TYPE nw_peak_resident_bytes gauge\n");
+	fprintf(out, "nw_peak_resident_bytes %lu\n", (unsigned long)usage.ru_maxrss * 1024);
+
+	for (int g = 0; g < _ngauges; ++g)
+	{
+		fprintf(out, "# HELP %s %s\n# TYPE %s gauge\n", _gauges[g].name, _gauges[g].help, _gauges[g].name);
+		fprintf(out, "%s %.17g\n", _gauges[g].name, _gauges[g].value(_gauges[g].arg));
+	}
+	pthread_mutex_unlock(&_lock);
+}
+
+/*
+ * static void *_endpoint(void *arg)
+ * \brief answers the metrics to each connection on the listening socket
+ */
+static void *_endpoint(void *arg)
+{
+	int listener = (int)(intptr_t)arg;
+	for (;;)
+	{
+		int fd = accept(listener, NULL, NULL);
+		if (fd < 0)
+		{
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			perror("NW_MetricsListen: accept");
+			return NULL;
+		}
+		char request[4096];
+		if (recv(fd, request, sizeof(request), 0) < 0) // the request is not parsed: any path gets the metrics
+		{
+			close(fd);
+			continue;
+		}
+		char *body = NULL;
+		size_t length = 0;
+		FILE *out = open_memstream(&body, &length);
+		if (out != NULL)
+		{
+			NW_MetricsWrite(out);
+			fclose(out);
+			char header[256];
+			int n = snprintf(header, sizeof(header),
+							 "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\n"
+							 "Connection: close\r\n\r\n",
+							 length);
+			if (send(fd, header, (size_t)n, MSG_NOSIGNAL) == n)
+				send(fd, body, length, MSG_NOSIGNAL);
+			free(body);
+		}
+		close(fd);
+	}
+}
+
+/* NW_MetricsListen : see .h file for documentation
+ */
+int NW_MetricsListen(const char *address)
+{
+	int fd;
+	if (strchr(address, '/') != NULL)
+	{
+		struct sockaddr_un un;
+		memset(&un, 0, sizeof(un));
+		un.sun_family = AF_UNIX;
+		if (strlen(address) >= sizeof(un.sun_path))
+		{
+			fprintf(stderr, "Error: metrics socket path %s is too long.\n", address);
+			return EXIT_FAILURE;
+		}
+		strcpy(un.sun_path, address);
+		unlink(address);
+		fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0 || bind(fd, (struct sockaddr *)&un, sizeof(un)) != 0)
+		{
+			fprintf(stderr, "Error: metrics socket %s: %s.\n", address, strerror(errno));
+			return EXIT_FAILURE;
+		}
+	}
+	else
+	{
+		struct sockaddr_in in;
+		memset(&in, 0, sizeof(in));
+		in.sin_family = AF_INET;
+		in.sin_port = htons((uint16_t)atoi(address));
+		in.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // local only
+		int one = 1;
+		fd = socket(AF_INET, SOCK_STREAM, 0);
+		if (fd >= 0)
+			setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+		if (fd < 0 || bind(fd, (struct sockaddr *)&in, sizeof(in)) != 0)
+		{
+			fprintf(stderr, "Error: metrics port %s: %s.\n", address, strerror(errno));
+			return EXIT_FAILURE;
+		}
+	}
+	if (listen(fd, 16) != 0)
+	{
+		fprintf(stderr, "Error: metrics listen %s: %s.\n", address, strerror(errno));
+		close(fd);
+		return EXIT_FAILURE;
+	}
+	pthread_t thread;
+	int e = pthread_create(&thread, NULL, _endpoint, (void *)(intptr_t)fd);
+	if (e != 0)
+	{
+		fprintf(stderr, "NW_MetricsListen: pthread_create: %s\n", strerror(e));
+		exit(EXIT_FAILURE);
+	}
+	pthread_detach(thread);
+	return 0;
+}
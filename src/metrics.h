@@ -0,0 +1,86 @@
+/**
+ * \file metrics.h
+ * \brief registry of counters of the jobs (throughput, latency, caches), exposed in the Prometheus text format
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Each thread counts in its own slot, allocated and registered at its first job: a slot has a single
+ * writer, which updates it with relaxed loads and stores (no locked instruction, no shared cache line),
+ * and the slots are summed only when the metrics are scraped. The counters are updated once per job (or
+ * per tile of the tile cache), never in the loops of the engines.
+ *
+ * The endpoint is a thread answering any request on a localhost TCP port or on a Unix socket with the
+ * text exposition format (HTTP/1.0 200, Content-Type: text/plain; version=0.0.4).
+ */
+
+#ifndef __METRICS_H__
+#define __METRICS_H__
+
+#include <stdio.h>	/* for FILE */
+#include <stdlib.h> /* for size_t */
+
+#include "Needleman-Wunsch-recmemo.h" /* for enum NW_Engine */
+
+/** \def NW_SIZE_CLASSES
+ *  \brief number of size classes of the jobs, by cells lengthA * lengthB: < 10^4, < 10^6, < 10^8, < 10^10, more
+ */
+#define NW_SIZE_CLASSES 5
+
+/** \def NW_LATENCY_BUCKETS
+ *  \brief number of finite upper bounds of the latency histograms: 10 us .. 100 s by powers of 10
+ */
+#define NW_LATENCY_BUCKETS 8
+
+/**
+ * \fn int NW_SizeClass(size_t lengthA, size_t lengthB);
+ * \brief returns the size class of a job, in 0 .. NW_SIZE_CLASSES - 1
+ */
+int NW_SizeClass(size_t lengthA, size_t lengthB);
+
+/**
+ * \fn void NW_MetricsJob(enum NW_Engine engine, size_t lengthA, size_t lengthB, double seconds);
+ * \brief counts a job of the calling thread, its cells and its latency
+ */
+void NW_MetricsJob(enum NW_Engine engine, size_t lengthA, size_t lengthB, double seconds);
+
+/**
+ * \fn void NW_MetricsCache(size_t hits, size_t misses);
+ * \brief counts the lookups of the tile cache (cf NW_BlockMemo) of the calling thread
+ */
+void NW_MetricsCache(size_t hits, size_t misses);
+
+/** \typedef NW_GaugeFunction
+ * \brief returns the current value of a gauge
+ */
+typedef double (*NW_GaugeFunction)(void *arg);
+
+/**
+ * \fn void NW_MetricsGauge(const char *name, const char *help, NW_GaugeFunction value, void *arg);
+ * \brief registers a gauge evaluated at each scrape (eg the depth of a queue); name and help are not copied
+ */
+void NW_MetricsGauge(const char *name, const char *help, NW_GaugeFunction value, void *arg);
+
+/**
+ * \fn void NW_MetricsUnregister(void *arg);
+ * \brief removes the gauges registered with arg (before arg is freed)
+ */
+void NW_MetricsUnregister(void *arg);
+
+/**
+ * \fn void NW_MetricsWrite(FILE *out);
+ * \brief writes the sum of the counters of all the threads and the gauges in the Prometheus text format
+ *
+ * Besides the counters and the registered gauges: nw_gcups (cells per nanosecond of the jobs) and
+ * nw_peak_resident_bytes (the maximum resident set size of the process).
+ */
+void NW_MetricsWrite(FILE *out);
+
+/**
+ * \fn int NW_MetricsListen(const char *address);
+ * \brief starts the thread of the endpoint on address: a port of 127.0.0.1, or the path of a Unix socket
+ *        (containing a '/')
+ * \return : 0 on success, >0 (with a message on stderr) if the socket cannot be bound
+ */
+int NW_MetricsListen(const char *address);
+
+#endif /* __METRICS_H__ */
@@ -0,0 +1,388 @@
+/**
+ * \file nwmodule.c
+ * \brief Python extension module "nw": edit distance of genetic sequences from Python
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Build with: python3 setup.py build_ext --inplace (cf setup.py).
+ *
+ * The sequences are passed as any object supporting the buffer protocol with contiguous bytes
+ * (bytes, bytearray, memoryview, mmap, NumPy arrays of dtype uint8 or S1, ...): they are read in
+ * place, without any copy, and the GIL is released during the computation so that other Python
+ * threads may run. Arrays of results are returned as NumPy arrays of int64 when NumPy is
+ * installed, else as memoryviews of format 'q'.
+ *
+ *     nw.distance(a, b, engine="cache_aware") -> int
+ *     nw.batch(seqs_a, seqs_b, engine="cache_aware", threads=0) -> array of len(seqs_a) distances
+ *     nw.all_vs_all(seqs, engine="cache_aware", threads=0) -> len(seqs) x len(seqs) matrix
+ *     nw.profile(a, b, row=None, col=None, step=1, engine="cache_aware") -> int
+ *     nw.engines() -> tuple of the engine names
+ *
+ * threads=0 uses all the online processors (cf NW_RunPairs in batch.h).
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "Needleman-Wunsch-recmemo.h"
+#include "batch.h"
+
+/*
+ * static int _parse_engine(const char *name, enum NW_Engine *engine)
+ * \brief converts an engine name, raising ValueError if it is unknown
+ */
+static int _parse_engine(const char *name, enum NW_Engine *engine)
+{
+	if (name == NULL)
+	{
+		*engine = NW_ENGINE_CACHE_AWARE;
+		return 0;
+	}
+	if (NW_EngineFromName(name, engine) != 0)
+	{
+		PyErr_Format(PyExc_ValueError, "unknown engine '%s'", name);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * static Py_buffer *_get_buffers(PyObject *seq, Py_ssize_t *n)
+ * \brief acquires the buffers of all the elements of the sequence seq (to be released by _release_buffers)
+ */
+static Py_buffer *_get_buffers(PyObject *seq, Py_ssize_t *n)
+{
+	PyObject *fast = PySequence_Fast(seq, "expected a sequence of bytes-like objects");
+	if (fast == NULL)
+		return NULL;
+	*n = PySequence_Fast_GET_SIZE(fast);
+	Py_buffer *views = (Py_buffer *)PyMem_Calloc((size_t)*n + 1, sizeof(Py_buffer));
+	if (views == NULL)
+	{
+		Py_DECREF(fast);
+		PyErr_NoMemory();
+		return NULL;
+	}
+	for (Py_ssize_t k = 0; k < *n; ++k)
+	{
+		if (PyObject_GetBuffer(PySequence_Fast_GET_ITEM(fast, k), &views[k], PyBUF_C_CONTIGUOUS) != 0)
+		{
+			for (Py_ssize_t l = 0; l < k; ++l)
+				PyBuffer_Release(&views[l]);
+			PyMem_Free(views);
+			Py_DECREF(fast);
+			return NULL;
+		}
+	}
+	Py_DECREF(fast);
+	return views;
+}
+
+/*
+ * static void _release_buffers(Py_buffer *views, Py_ssize_t n)
+ * \brief releases the buffers acquired by _get_buffers
+ */
+static void _release_buffers(Py_buffer *views, Py_ssize_t n)
+{
+	for (Py_ssize_t k = 0; k < n; ++k)
+		PyBuffer_Release(&views[k]);
+	PyMem_Free(views);
+}
+
+/*
+ * static PyObject *_as_array(PyObject *bytes, Py_ssize_t rows, Py_ssize_t cols)
+ * \brief wraps (without copy) a bytearray of int64 as a NumPy array if NumPy is available, else as a memoryview
+ * \param bytes : the bytearray (reference stolen)
+ * \param rows : number of rows
+ * \param cols : number of columns, or 0 for a one dimensional array
+ */
+static PyObject *_as_array(PyObject *bytes, Py_ssize_t rows, Py_ssize_t cols)
+{
+	PyObject *numpy = PyImport_ImportModule("numpy");
+	PyObject *res;
+	if (numpy != NULL)
+	{
+		res = PyObject_CallMethod(numpy, "frombuffer", "Os", bytes, "int64");
+		if (res != NULL && cols > 0)
+		{
+			PyObject *shaped = PyObject_CallMethod(res, "reshape", "nn", rows, cols);
+			Py_DECREF(res);
+			res = shaped;
+		}
+		Py_DECREF(numpy);
+	}
+	else
+	{
+		PyErr_Clear();
+		PyObject *view = PyMemoryView_FromObject(bytes);
+		if (view == NULL)
+			res = NULL;
+		else if (cols > 0)
+		{
+			PyObject *shape = Py_BuildValue("(nn)", rows, cols);
+			res = (shape == NULL) ? NULL : PyObject_CallMethod(view, "cast", "sO", "q", shape);
+			Py_XDECREF(shape);
+			Py_DECREF(view);
+		}
+		else
+		{
+			res = PyObject_CallMethod(view, "cast", "s", "q");
+			Py_DECREF(view);
+		}
+	}
+	Py_DECREF(bytes);
+	return res;
+}
+
+/*
+ * static PyObject *nw_distance(PyObject *self, PyObject *args, PyObject *kwargs)
+ * \brief nw.distance(a, b, engine="cache_aware") -> int
+ */
+static PyObject *nw_distance(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+	static char *kwlist[] = {"a", "b", "engine", NULL};
+	Py_buffer a, b;
+	const char *name = NULL;
+	enum NW_Engine engine;
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "y*y*|z", kwlist, &a, &b, &name))
+		return NULL;
+	if (_parse_engine(name, &engine) != 0)
+	{
+		PyBuffer_Release(&a);
+		PyBuffer_Release(&b);
+		return NULL;
+	}
+	long res;
+	Py_BEGIN_ALLOW_THREADS
+	res = EditDistance_NW(engine, (char *)a.buf, (size_t)a.len, (char *)b.buf, (size_t)b.len);
+	Py_END_ALLOW_THREADS
+	PyBuffer_Release(&a);
+	PyBuffer_Release(&b);
+	return PyLong_FromLong(res);
+}
+
+/*
+ * static int _get_vector(PyObject *obj, Py_buffer *view, size_t n, const char *name)
+ * \brief acquires the writable buffer of obj (if not None), of at least n int64, raising ValueError if it is too short
+ */
+static int _get_vector(PyObject *obj, Py_buffer *view, size_t n, const char *name)
+{
+	view->buf = NULL;
+	if (obj == NULL || obj == Py_None)
+		return 0;
+	if (PyObject_GetBuffer(obj, view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0)
+		return -1;
+	if ((size_t)view->len < n * sizeof(long))
+	{
+		PyErr_Format(PyExc_ValueError, "%s must hold at least %zu int64", name, n);
+		PyBuffer_Release(view);
+		view->buf = NULL;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * static PyObject *nw_profile(PyObject *self, PyObject *args, PyObject *kwargs)
+ * \brief nw.profile(a, b, row=None, col=None, step=1, engine="cache_aware") -> int
+ *
+ * Writes row[k] = distance(a, b[:k*step]) and col[k] = distance(a[:k*step], b) into the given writable
+ * buffers of int64 (eg numpy.empty(len(b) // step + 1, dtype=numpy.int64)), cf struct NW_Profile.
+ */
+static PyObject *nw_profile(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+	static char *kwlist[] = {"a", "b", "row", "col", "step", "engine", NULL};
+	Py_buffer a, b, row, col;
+	PyObject *row_obj = NULL, *col_obj = NULL;
+	Py_ssize_t step = 1;
+	const char *name = NULL;
+	enum NW_Engine engine;
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "y*y*|OOnz", kwlist, &a, &b, &row_obj, &col_obj, &step, &name))
+		return NULL;
+	row.buf = col.buf = NULL;
+	if (step < 1)
+		PyErr_SetString(PyExc_ValueError, "step must be positive");
+	else if (_parse_engine(name, &engine) == 0 &&
+			 _get_vector(row_obj, &row, (size_t)b.len / (size_t)step + 1, "row") == 0 &&
+			 _get_vector(col_obj, &col, (size_t)a.len / (size_t)step + 1, "col") == 0)
+	{
+		struct NW_Profile profile = {(long *)row.buf, (long *)col.buf, (size_t)step};
+		long res;
+		Py_BEGIN_ALLOW_THREADS
+		res = EditDistance_NW_profile(engine, (char *)a.buf, (size_t)a.len, (char *)b.buf, (size_t)b.len, &profile);
+		Py_END_ALLOW_THREADS
+		if (row.buf != NULL)
+			PyBuffer_Release(&row);
+		if (col.buf != NULL)
+			PyBuffer_Release(&col);
+		PyBuffer_Release(&a);
+		PyBuffer_Release(&b);
+		return PyLong_FromLong(res);
+	}
+	if (row.buf != NULL)
+		PyBuffer_Release(&row);
+	PyBuffer_Release(&a);
+	PyBuffer_Release(&b);
+	return NULL;
+}
+
+/*
+ * static PyObject *nw_batch(PyObject *self, PyObject *args, PyObject *kwargs)
+ * \brief nw.batch(seqs_a, seqs_b, engine="cache_aware", threads=0) -> distances of the pairs (seqs_a[k], seqs_b[k])
+ */
+static PyObject *nw_batch(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+	static char *kwlist[] = {"seqs_a", "seqs_b", "engine", "threads", NULL};
+	PyObject *seqs_a, *seqs_b;
+	const char *name = NULL;
+	int nthreads = 0;
+	enum NW_Engine engine;
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|zi", kwlist, &seqs_a, &seqs_b, &name, &nthreads))
+		return NULL;
+	if (_parse_engine(name, &engine) != 0)
+		return NULL;
+
+	Py_ssize_t na, nb;
+	Py_buffer *va = _get_buffers(seqs_a, &na);
+	if (va == NULL)
+		return NULL;
+	Py_buffer *vb = _get_buffers(seqs_b, &nb);
+	if (vb == NULL)
+	{
+		_release_buffers(va, na);
+		return NULL;
+	}
+	if (na != nb)
+	{
+		_release_buffers(va, na);
+		_release_buffers(vb, nb);
+		return PyErr_Format(PyExc_ValueError, "seqs_a and seqs_b have different lengths (%zd != %zd)", na, nb);
+	}
+
+	PyObject *out = PyByteArray_FromStringAndSize(NULL, na * (Py_ssize_t)sizeof(long long));
+	struct NW_Pair *pairs = (struct NW_Pair *)PyMem_Calloc((size_t)na + 1, sizeof(struct NW_Pair));
+	if (out == NULL || pairs == NULL)
+	{
+		Py_XDECREF(out);
+		PyMem_Free(pairs);
+		_release_buffers(va, na);
+		_release_buffers(vb, nb);
+		return PyErr_NoMemory();
+	}
+	for (Py_ssize_t k = 0; k < na; ++k)
+	{
+		pairs[k].A = (char *)va[k].buf;
+		pairs[k].lengthA = (size_t)va[k].len;
+		pairs[k].B = (char *)vb[k].buf;
+		pairs[k].lengthB = (size_t)vb[k].len;
+	}
+	long long *res = (long long *)PyByteArray_AS_STRING(out);
+	Py_BEGIN_ALLOW_THREADS
+	NW_RunPairs(pairs, (size_t)na, engine, nthreads);
+	for (Py_ssize_t k = 0; k < na; ++k)
+		res[k] = pairs[k].distance;
+	Py_END_ALLOW_THREADS
+	PyMem_Free(pairs);
+	_release_buffers(va, na);
+	_release_buffers(vb, nb);
+	return _as_array(out, na, 0);
+}
+
+/*
+ * static PyObject *nw_all_vs_all(PyObject *self, PyObject *args, PyObject *kwargs)
+ * \brief nw.all_vs_all(seqs, engine="cache_aware", threads=0) -> symmetric matrix of the distances
+ */
+static PyObject *nw_all_vs_all(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+	static char *kwlist[] = {"seqs", "engine", "threads", NULL};
+	PyObject *seqs;
+	const char *name = NULL;
+	int nthreads = 0;
+	enum NW_Engine engine;
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|zi", kwlist, &seqs, &name, &nthreads))
+		return NULL;
+	if (_parse_engine(name, &engine) != 0)
+		return NULL;
+
+	Py_ssize_t n;
+	Py_buffer *v = _get_buffers(seqs, &n);
+	if (v == NULL)
+		return NULL;
+	size_t npairs = (size_t)n * (size_t)(n > 0 ? n - 1 : 0) / 2;
+	PyObject *out = PyByteArray_FromStringAndSize(NULL, n * n * (Py_ssize_t)sizeof(long long));
+	struct NW_Pair *pairs = (struct NW_Pair *)PyMem_Calloc(npairs + 1, sizeof(struct NW_Pair));
+	if (out == NULL || pairs == NULL)
+	{
+		Py_XDECREF(out);
+		PyMem_Free(pairs);
+		_release_buffers(v, n);
+		return PyErr_NoMemory();
+	}
+	long long *res = (long long *)PyByteArray_AS_STRING(out);
+	Py_BEGIN_ALLOW_THREADS
+	size_t p = 0;
+	for (Py_ssize_t i = 0; i < n; ++i)
+		for (Py_ssize_t j = i + 1; j < n; ++j, ++p)
+		{
+			pairs[p].A = (char *)v[i].buf;
+			pairs[p].lengthA = (size_t)v[i].len;
+			pairs[p].B = (char *)v[j].buf;
+			pairs[p].lengthB = (size_t)v[j].len;
+		}
+	NW_RunPairs(pairs, npairs, engine, nthreads);
+	p = 0;
+	for (Py_ssize_t i = 0; i < n; ++i)
+	{
+		res[i * n + i] = 0;
+		for (Py_ssize_t j = i + 1; j < n; ++j, ++p)
+			res[i * n + j] = res[j * n + i] = pairs[p].distance;
+	}
+	Py_END_ALLOW_THREADS
+	PyMem_Free(pairs);
+	_release_buffers(v, n);
+	return _as_array(out, n, n);
+}
+
+/*
+ * static PyObject *nw_engines(PyObject *self, PyObject *unused)
+ * \brief nw.engines() -> tuple of the names accepted by the engine arguments
+ */
+static PyObject *nw_engines(PyObject *self, PyObject *unused)
+{
+	PyObject *names = PyTuple_New(NW_ENGINE_COUNT);
+	if (names == NULL)
+		return NULL;
+	for (int e = 0; e < NW_ENGINE_COUNT; ++e)
+	{
+		PyObject *name = PyUnicode_FromString(NW_EngineName((enum NW_Engine)e));
+		if (name == NULL)
+		{
+			Py_DECREF(names);
+			return NULL;
+		}
+		PyTuple_SET_ITEM(names, e, name);
+	}
+	return names;
+}
+
+static PyMethodDef nw_methods[] = {
+	{"distance", (PyCFunction)(void (*)(void))nw_distance, METH_VARARGS | METH_KEYWORDS,
+	 "distance(a, b, engine='cache_aware') -> edit distance between the bytes-like sequences a and b"},
+	{"batch", (PyCFunction)(void (*)(void))nw_batch, METH_VARARGS | METH_KEYWORDS,
+	 "batch(seqs_a, seqs_b, engine='cache_aware', threads=0) -> int64 array of the distances of the pairs"},
+	{"all_vs_all", (PyCFunction)(void (*)(void))nw_all_vs_all, METH_VARARGS | METH_KEYWORDS,
+	 "all_vs_all(seqs, engine='cache_aware', threads=0) -> int64 matrix of the distances between all sequences"},
+	{"profile", (PyCFunction)(void (*)(void))nw_profile, METH_VARARGS | METH_KEYWORDS,
+	 "profile(a, b, row=None, col=None, step=1, engine='cache_aware') -> edit distance; fills row[k] = distance(a, b[:k*step]) and col[k] = distance(a[:k*step], b)"},
+	{"engines", nw_engines, METH_NOARGS, "engines() -> names of the available engines"},
+	{NULL, NULL, 0, NULL}};
+
+static struct PyModuleDef nw_module = {
+	PyModuleDef_HEAD_INIT, "nw",
+	"Edit distance between genetic sequences (Needleman-Wunsch), computed without copy and without the GIL.",
+	-1, nw_methods};
+
+PyMODINIT_FUNC PyInit_nw(void)
+{
+	return PyModule_Create(&nw_module);
+}
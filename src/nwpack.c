@@ -0,0 +1,131 @@
+/**
+ * \file nwpack.c
+ * \brief companion tool of distanceEdition -z: builds a block compressed container from FASTA files
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Usage : nwpack [-b average] -o container file_1.fna [file_2.fna ...]
+ * cf function usage below.
+ */
+
+#include "block_container.h" /* the container */
+#include "sequence_map.h"	 /* shared mapping of the files */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> /* for strcmp and memchr */
+
+/**
+ * \fn void usage(char *argv[])
+ * \brief prints how to use the program
+ */
+void usage(char *argv[])
+{
+	fprintf(stderr,
+			"Usage:   %s [-b average] -o container file_1.fna [file_2.fna ...]\n"
+			"\nDESCRIPTION"
+			"\n     Each record of the FASTA files (a line \">name ...\" followed by the lines of the sequence; a file"
+			"\n     without '>' is one sequence named by its pathname) is added to the container without its line breaks."
+			"\n     The sequences are cut into blocks of <average> characters on average (default %d) at positions"
+			"\n     chosen by their content, and each distinct block is stored once, so that a collection of nearly"
+			"\n     identical genomes is stored about once."
+			"\n     The distance between two sequences of the container is then computed by:"
+			"\n           distanceEdition -z container name_1 name_2"
+			"\n",
+			argv[0], NWZ_DEFAULT_BLOCK);
+}
+
+/**
+ * \fn static void add_record(struct NWZ_Writer *w, const char *name, size_t name_length, const char *begin, const char *end, char *buf)
+ * \brief adds the sequence begin[0 .. end-begin-1] without its line breaks
+ * \param buf : an array of at least end-begin chars
+ */
+static void add_record(struct NWZ_Writer *w, const char *name, size_t name_length, const char *begin, const char *end, char *buf)
+{
+	size_t length = 0;
+	for (const char *c = begin; c < end; ++c)
+		if (*c != '\n' && *c != '\r')
+			buf[length++] = *c;
+	NWZ_WriterAdd(w, name, name_length, buf, length);
+	fprintf(stderr, "%.*s: %zu characters\n", (int)name_length, name, length);
+}
+
+/** \fn int main(int argc, char *argv[])
+ * \brief main : see function usage(argv) for specification
+ */
+int main(int argc, char *argv[])
+{
+	const char *output = NULL;
+	size_t average = NWZ_DEFAULT_BLOCK;
+	int a = 1;
+	for (; a < argc && argv[a][0] == '-'; ++a)
+	{
+		if (strcmp(argv[a], "-o") == 0 && a + 1 < argc)
+			output = argv[++a];
+		else if (strcmp(argv[a], "-b") == 0 && a + 1 < argc)
+			average = (size_t)atol(argv[++a]);
+		else
+			break;
+	}
+	if (output == NULL || a >= argc || argv[a][0] == '-')
+	{
+		usage(argv);
+		return EXIT_FAILURE;
+	}
+
+	struct SeqFileSet files;
+	struct NWZ_Writer w;
+	SeqFileSet_init(&files);
+	NWZ_WriterInit(&w, average);
+	for (; a < argc; ++a)
+	{
+		struct SeqFile *file = SeqFileSet_open(&files, argv[a]);
+		const char *data = file->data, *end = file->data + file->length;
+		char *buf = (char *)malloc(file->length + 1);
+		if (buf == NULL)
+		{
+			perror("nwpack: malloc of buf");
+			return EXIT_FAILURE;
+		}
+		if (file->length == 0 || data[0] != '>')
+			add_record(&w, argv[a], strlen(argv[a]), data, end, buf);
+		else
+		{
+			while (data < end) // data: beginning of a line ">name ..."
+			{
+				const char *name = data + 1, *name_end = name;
+				while (name_end < end && *name_end != ' ' && *name_end != '\t' && *name_end != '\n' && *name_end != '\r')
+					++name_end;
+				const char *seq = memchr(data, '\n', end - data);
+				seq = (seq == NULL) ? end : seq + 1;
+				const char *next = seq;
+				while (next < end && *next != '>')
+				{
+					const char *eol = memchr(next, '\n', end - next);
+					next = (eol == NULL) ? end : eol + 1;
+				}
+				add_record(&w, name, name_end - name, seq, next, buf);
+				data = next;
+			}
+		}
+		free(buf);
+	}
+
+	uint64_t nblocks = w.nblocks, text_size = w.text_size, total = w.total;
+	FILE *out = fopen(output, "wb");
+	if (out == NULL)
+	{
+		perror(output);
+		return EXIT_FAILURE;
+	}
+	if (NWZ_WriterSave(&w, out) != 0 || fclose(out) != 0)
+	{
+		perror(output);
+		return EXIT_FAILURE;
+	}
+	SeqFileSet_close(&files);
+	fprintf(stderr, "%s: %llu distinct blocks, %llu characters stored for %llu (ratio %.1f)\n", output,
+			(unsigned long long)nblocks, (unsigned long long)text_size, (unsigned long long)total,
+			(text_size == 0) ? 0.0 : (double)total / (double)text_size);
+	return 0;
+}
@@ -0,0 +1,408 @@
+/**
+ * \file nwreplay.c
+ * \brief replays the jobs of a log captured by distanceEdition -L (batch mode or shared memory service)
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Usage : nwreplay [-m | -x speed] [-c cache] [-e engine] [-t threads] [-R reserved] [-S split] [-B budget] log
+ * cf function usage below.
+ */
+
+#include "capture.h"				  /* the log */
+#include "scheduler.h"				  /* the jobs are submitted as by the capturing program */
+#include "metrics.h"				  /* for NW_SizeClass */
+#include "estimate.h"				  /* for NW_Estimate */
+#include "batch.h"					  /* for NW_Now */
+#include "Needleman-Wunsch-recmemo.h" /* for NW_EngineFromName */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> /* for strcmp and memcmp */
+#include <errno.h>
+#include <time.h> /* for nanosleep */
+#include <stdatomic.h>
+
+/**
+ * \def NB_CLASSES
+ * \brief number of size classes of the summary (cf NW_SizeClass)
+ */
+#define NB_CLASSES 5
+
+/** \struct replay
+ * \brief one job of the log and its replay
+ */
+struct replay
+{
+	struct NW_Job job;			   /*!< job->arg is the replay */
+	const struct NW_CaptureRecord *r; /*!< its record */
+	int cached;					   /*!< 1 if the sequences were read in the cache */
+	double latency;				   /*!< from the submission to the completion */
+};
+
+/** \var mismatches
+ * \brief jobs computed on the cached sequences whose distance differs from the captured one
+ */
+static _Atomic long mismatches = 0;
+
+/**
+ * \fn void usage(char *argv[])
+ * \brief prints how to use the program
+ */
+void usage(char *argv[])
+{
+	fprintf(stderr,
+			"Usage:   %s [-m | -x speed] [-c cache] [-e engine] [-t threads] [-R reserved] [-S split] [-B budget] [-C period] log\n"
+			"\nDESCRIPTION"
+			"\n     Submits again the jobs of a log captured by distanceEdition -L (cf capture.h) to a scheduler"
+			"\n     of <threads> workers (options -R, -S, -B and -C as in distanceEdition -m), with their engine (or"
+			"\n     <engine>), priority and deadline: at their original times divided by <speed> (default 1), or"
+			"\n     all at once with -m. The sequences are read in the directory <cache> written by distanceEdition -K"
+			"\n     when they are found there (and the distances are checked against the captured ones), else they are"
+			"\n     synthetic sequences of the same lengths and of about the same distance."
+			"\n     Prints per size class the number of jobs and the median and 99th percentile of their latency"
+			"\n     (from the submission to the completion) in the capture and in the replay, then the makespan (and"
+			"\n     the number of workers chosen by the concurrency controller with -C)."
+			"\n",
+			argv[0]);
+}
+
+/**
+ * \fn static uint64_t next(uint64_t *state)
+ * \brief splitmix64 generator of the synthetic sequences
+ */
+static uint64_t next(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+/**
+ * \fn static char *load(const char *cache, uint64_t fingerprint, uint64_t length)
+ * \brief returns the sequence of the cache of this fingerprint and length (to be freed), or NULL
+ */
+static char *load(const char *cache, uint64_t fingerprint, uint64_t length)
+{
+	char path[4096];
+	snprintf(path, sizeof(path), "%s/%016llx.seq", cache, (unsigned long long)fingerprint);
+	FILE *f = fopen(path, "rb");
+	if (f == NULL)
+		return NULL;
+	char *s = (char *)malloc(length + 1);
+	if (s == NULL)
+	{
+		perror("load: malloc of a sequence");
+		exit(EXIT_FAILURE);
+	}
+	size_t n = fread(s, 1, length, f);
+	fclose(f);
+	if (n != length || NW_Fingerprint(s, length) != fingerprint)
+	{
+		fprintf(stderr, "Warning: %s is not the captured sequence.\n", path);
+		free(s);
+		return NULL;
+	}
+	return s;
+}
+
+/**
+ * \fn static void synthesize(const struct NW_CaptureRecord *r, char **A, char **B)
+ * \brief generates random sequences A and B of the lengths of the record, B being A with the indels needed
+ * for its length and substitutions for the rest of the captured distance (insertion cost 2, substitution 1)
+ */
+static void synthesize(const struct NW_CaptureRecord *r, char **A, char **B)
+{
+	static const char bases[4] = {'A', 'C', 'G', 'T'};
+	uint64_t lA = r->lengthA, lB = r->lengthB;
+	*A = (char *)malloc(lA + 1);
+	*B = (char *)malloc(lB + 1);
+	if (*A == NULL || *B == NULL)
+	{
+		perror("synthesize: malloc of the sequences");
+		exit(EXIT_FAILURE);
+	}
+	uint64_t state = r->fingerprintA;
+	for (uint64_t i = 0; i < lA; ++i)
+		(*A)[i] = bases[next(&state) & 3];
+
+	// indels spread evenly, copy of A elsewhere
+	uint64_t common = (lA < lB) ? lA : lB, indels = (lA < lB) ? lB - lA : lA - lB;
+	uint64_t step = (indels == 0) ? 0 : common / indels + 1;
+	uint64_t i = 0, j = 0, done = 0;
+	while (j < lB)
+	{
+		if (done < indels && step > 0 && (i + j) % step == 0)
+		{
+			if (lB > lA)
+				(*B)[j++] = bases[next(&state) & 3]; // insertion in B
+			else
+				++i; // deletion from A
+			++done;
+		}
+		else if (i < lA)
+			(*B)[j++] = (*A)[i++];
+		else
+			(*B)[j++] = bases[next(&state) & 3];
+	}
+
+	// substitutions for the rest of the distance (10 % of the bases if it is unknown)
+	int64_t rest = (r->distance >= 0) ? r->distance - 2 * (int64_t)indels : (int64_t)(lB / 10);
+	for (int64_t k = 0; k < rest && lB > 0; ++k)
+	{
+		uint64_t p = next(&state) % lB;
+		int b = 0;
+		while (b < 3 && bases[b] != (*B)[p])
+			++b;
+		(*B)[p] = bases[(b + 1 + next(&state) % 3) & 3]; // another base
+	}
+}
+
+/**
+ * \fn static void estimate(struct NW_Job *job)
+ * \brief computes a job captured in the estimate mode of the shared memory service
+ */
+static void estimate(struct NW_Job *job)
+{
+	struct replay *p = (struct replay *)job->arg;
+	struct NW_EstimateParams params = {0, (p->r->precision > 0) ? p->r->precision : 0.05, 1, 1, job->engine};
+	struct NW_EstimateResult res;
+	NW_Estimate(job->A, job->lengthA, job->B, job->lengthB, &params, &res);
+	job->distance = (long)(res.distance + 0.5);
+}
+
+/**
+ * \fn static void done(struct NW_Job *job)
+ * \brief records the latency of a replayed job, checks its distance and frees its sequences
+ */
+static void done(struct NW_Job *job)
+{
+	struct replay *p = (struct replay *)job->arg;
+	p->latency = NW_Now() - job->submitted;
+	if (p->cached && job->status == 0 && p->r->status == 0 && p->r->mode == 0 && job->distance != p->r->distance)
+	{
+		fprintf(stderr, "Mismatch: %016llx x %016llx: %ld instead of %lld.\n", (unsigned long long)p->r->fingerprintA,
+				(unsigned long long)p->r->fingerprintB, job->distance, (long long)p->r->distance);
+		atomic_fetch_add(&mismatches, 1);
+	}
+	free((char *)job->A);
+	free((char *)job->B);
+	job->A = job->B = NULL;
+}
+
+/**
+ * \fn static int by_submission(const void *x, const void *y)
+ * \brief orders the records by submission time
+ */
+static int by_submission(const void *x, const void *y)
+{
+	uint64_t a = ((const struct NW_CaptureRecord *)x)->submit_ns, b = ((const struct NW_CaptureRecord *)y)->submit_ns;
+	return (a > b) - (a < b);
+}
+
+/**
+ * \fn static int by_value(const void *x, const void *y)
+ * \brief orders doubles
+ */
+static int by_value(const void *x, const void *y)
+{
+	double a = *(const double *)x, b = *(const double *)y;
+	return (a > b) - (a < b);
+}
+
+/**
+ * \fn static double quantile(double *v, size_t n, double q)
+ * \brief returns the quantile q of v[0 .. n-1] (sorted in place), 0 if n = 0
+ */
+static double quantile(double *v, size_t n, double q)
+{
+	if (n == 0)
+		return 0;
+	qsort(v, n, sizeof(double), by_value);
+	return v[(size_t)(q * (n - 1) + 0.5)];
+}
+
+/**
+ * \fn static struct NW_CaptureRecord *read_log(const char *path, size_t *n)
+ * \brief returns the records of the log path (to be freed) and their number in *n, or NULL
+ */
+static struct NW_CaptureRecord *read_log(const char *path, size_t *n)
+{
+	FILE *f = fopen(path, "rb");
+	if (f == NULL)
+	{
+		perror(path);
+		return NULL;
+	}
+	struct NW_CaptureHeader h;
+	if (fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, NW_CAPTURE_MAGIC, 8) != 0 ||
+		h.version != NW_CAPTURE_VERSION || h.record_size != sizeof(struct NW_CaptureRecord))
+	{
+		fprintf(stderr, "Error: %s is not a capture log of version %d.\n", path, NW_CAPTURE_VERSION);
+		fclose(f);
+		return NULL;
+	}
+	size_t capacity = 1024;
+	struct NW_CaptureRecord *records = NULL;
+	*n = 0;
+	do
+	{
+		capacity *= 2;
+		records = (struct NW_CaptureRecord *)realloc(records, capacity * sizeof(struct NW_CaptureRecord));
+		if (records == NULL)
+		{
+			perror("read_log: realloc of the records");
+			exit(EXIT_FAILURE);
+		}
+		*n += fread(records + *n, sizeof(struct NW_CaptureRecord), capacity - *n, f);
+	} while (*n == capacity);
+	fclose(f);
+	return records;
+}
+
+/**
+ * \fn int main(int argc, char *argv[])
+ * \brief main : see function usage(argv) for specification
+ */
+int main(int argc, char *argv[])
+{
+	struct NW_SchedParams sched = {0, 0, 0, 0, 0, 0, 0, 0};
+	const char *cache = NULL;
+	double speed = 1;
+	int max_speed = 0, force = 0;
+	enum NW_Engine engine = NW_ENGINE_CACHE_AWARE;
+	int a = 1;
+	for (; a < argc - 1; ++a)
+	{
+		if (strcmp(argv[a], "-m") == 0)
+			max_speed = 1;
+		else if (strcmp(argv[a], "-x") == 0 && a + 2 < argc && (speed = atof(argv[++a])) > 0)
+			continue;
+		else if (strcmp(argv[a], "-c") == 0 && a + 2 < argc)
+			cache = argv[++a];
+		else if (strcmp(argv[a], "-t") == 0 && a + 2 < argc)
+			sched.nthreads = atoi(argv[++a]);
+		else if (strcmp(argv[a], "-R") == 0 && a + 2 < argc)
+			sched.reserved = atoi(argv[++a]);
+		else if (strcmp(argv[a], "-S") == 0 && a + 2 < argc)
+			sched.split = atof(argv[++a]);
+		else if (strcmp(argv[a], "-B") == 0 && a + 2 < argc)
+			sched.memory = (size_t)atol(argv[++a]);
+		else if (strcmp(argv[a], "-C") == 0 && a + 2 < argc)
+			sched.adapt = atof(argv[++a]);
+		else if (strcmp(argv[a], "-e") == 0 && a + 2 < argc && NW_EngineFromName(argv[++a], &engine) == 0)
+			force = 1;
+		else
+			break;
+	}
+	if (a != argc - 1)
+	{
+		usage(argv);
+		return EXIT_FAILURE;
+	}
+	size_t n;
+	struct NW_CaptureRecord *records = read_log(argv[a], &n);
+	if (records == NULL)
+		return EXIT_FAILURE;
+	qsort(records, n, sizeof(struct NW_CaptureRecord), by_submission);
+
+	struct replay *replays = (struct replay *)calloc(n + 1, sizeof(struct replay));
+	if (replays == NULL)
+	{
+		perror("main: malloc of the replays");
+		exit(EXIT_FAILURE);
+	}
+	for (size_t k = 0; k < n; ++k)
+	{
+		size_t s = NW_StackSize(records[k].lengthA, records[k].lengthB);
+		if (s > sched.stack_size)
+			sched.stack_size = s;
+	}
+	struct NW_Scheduler *scheduler = NW_SchedulerCreate(&sched);
+	size_t cached = 0;
+	double start = NW_Now();
+	for (size_t k = 0; k < n; ++k)
+	{
+		const struct NW_CaptureRecord *r = &records[k];
+		struct replay *p = &replays[k];
+		struct NW_Job *job = &p->job;
+		char *A = NULL, *B = NULL;
+		if (cache != NULL && (A = load(cache, r->fingerprintA, r->lengthA)) != NULL &&
+			(B = load(cache, r->fingerprintB, r->lengthB)) != NULL)
+			p->cached = 1;
+		else
+		{
+			free(A);
+			synthesize(r, &A, &B);
+		}
+		cached += p->cached;
+		if (!max_speed) // until the original submission time
+		{
+			double wait = start + 1e-9 * r->submit_ns / speed - NW_Now();
+			if (wait > 0)
+			{
+				struct timespec t = {(time_t)wait, (long)((wait - (time_t)wait) * 1e9)};
+				while (nanosleep(&t, &t) != 0 && errno == EINTR)
+					;
+			}
+		}
+		p->r = r;
+		job->A = A;
+		job->lengthA = r->lengthA;
+		job->B = B;
+		job->lengthB = r->lengthB;
+		job->engine = force ? engine : (r->engine < NW_ENGINE_COUNT) ? (enum NW_Engine)r->engine : engine;
+		job->priority = r->priority;
+		job->deadline = (r->deadline_ms == 0) ? 0 : NW_Now() + 1e-3 * r->deadline_ms;
+		job->run = (r->mode == 1) ? estimate : NULL;
+		job->peak = (r->mode == 1) ? 16 * (r->lengthA + r->lengthB) : 0;
+		job->done = done;
+		job->arg = p;
+		NW_SchedulerSubmit(scheduler, job);
+	}
+	NW_SchedulerWait(scheduler);
+	double makespan = NW_Now() - start, rate;
+	int chosen = NW_SchedulerConcurrency(scheduler, NULL, &rate);
+	NW_SchedulerDestroy(scheduler);
+
+	// summary by size class
+	double *captured = (double *)malloc((n + 1) * sizeof(double));
+	double *replayed = (double *)malloc((n + 1) * sizeof(double));
+	if (captured == NULL || replayed == NULL)
+	{
+		perror("main: malloc of the latencies");
+		exit(EXIT_FAILURE);
+	}
+	static const char *classes[NB_CLASSES] = {"tiny", "small", "medium", "large", "huge"};
+	printf("#class\tjobs\tfailed\tcapture_p50\tcapture_p99\treplay_p50\treplay_p99\n");
+	for (int c = 0; c < NB_CLASSES; ++c)
+	{
+		size_t m = 0, failed = 0;
+		for (size_t k = 0; k < n; ++k)
+			if (NW_SizeClass(records[k].lengthA, records[k].lengthB) == c)
+			{
+				captured[m] = 1e-9 * (records[k].queue_ns + records[k].run_ns);
+				replayed[m++] = replays[k].latency;
+				failed += (replays[k].job.status != 0);
+			}
+		if (m > 0)
+			printf("%s\t%zu\t%zu\t%.6f\t%.6f\t%.6f\t%.6f\n", classes[c], m, failed, quantile(captured, m, 0.5),
+				   quantile(captured, m, 0.99), quantile(replayed, m, 0.5), quantile(replayed, m, 0.99));
+	}
+	double captured_makespan = 0;
+	for (size_t k = 0; k < n; ++k)
+	{
+		double end = 1e-9 * (records[k].submit_ns + records[k].queue_ns + records[k].run_ns);
+		if (end > captured_makespan)
+			captured_makespan = end;
+	}
+	printf("#%zu jobs (%zu on cached sequences, %ld mismatches), makespan %.6f s (captured %.6f s)\n", n, cached,
+		   (long)atomic_load(&mismatches), makespan, captured_makespan);
+	if (sched.adapt > 0)
+		printf("#concurrency %d workers (%.3g cells/s)\n", chosen, rate);
+	free(captured);
+	free(replayed);
+	free(replays);
+	free(records);
+	return (atomic_load(&mismatches) == 0) ? 0 : EXIT_FAILURE;
+}
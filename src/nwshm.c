@@ -0,0 +1,217 @@
+/**
+ * \file nwshm.c
+ * \brief companion tool of distanceEdition --serve-shm: submits the pairs of a manifest through shared memory
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Usage : nwshm [-e engine] [-s precision] [-x] /name [manifest]
+ * cf function usage below.
+ */
+
+#include "shm_service.h"			  /* the client */
+#include "sequence_map.h"			  /* shared mapping of the files */
+#include "Needleman-Wunsch-recmemo.h" /* for NW_EngineFromName */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> /* for strcmp and memcpy */
+#include <errno.h>
+#include <err.h>
+
+/**
+ * \fn void usage(char *argv[])
+ * \brief prints how to use the program
+ */
+void usage(char *argv[])
+{
+	fprintf(stderr,
+			"Usage:   %s [-e engine] [-s precision] [-x] /name [manifest]\n"
+			"\nDESCRIPTION"
+			"\n     Connects to the server started by: distanceEdition --serve-shm /name"
+			"\n     and submits each pair \"file_1 begin_1 length_1 file_2 begin_2 length_2 [name [priority [deadline]]]\""
+			"\n     of the manifest (default: stdin, as in distanceEdition -m; deadline in seconds after the submission):"
+			"\n     the regions are copied in the data ring of the server, where its engines read them. One line"
+			"\n     \"name distance\" (or \"name estimate low high\" with -s) is printed per pair, in completion order, and"
+			"\n     \"name NA\" with a warning for a malformed line or a region out of its file. With -x, the server is"
+			"\n     stopped at the end (without manifest: only stopped)."
+			"\n",
+			argv[0]);
+}
+
+/**
+ * \fn static void print(const struct NW_ShmCompletion *c, char **names, int estimate)
+ * \brief prints the result of a completion and frees the name of its pair
+ */
+static void print(const struct NW_ShmCompletion *c, char **names, int estimate)
+{
+	char *name = names[c->user_data];
+	if (c->status != 0)
+		fprintf(stderr, "%s: %s\n", name, strerror((int)-c->status));
+	else if (estimate)
+		printf("%s %ld %ld %ld\n", name, (long)c->distance, (long)c->low, (long)c->high);
+	else
+		printf("%s %ld\n", name, (long)c->distance);
+	free(name);
+	names[c->user_data] = NULL;
+}
+
+/**
+ * \fn static char *reserve(struct NW_ShmClient *client, size_t length, uint64_t *offset, char **names, int estimate)
+ * \brief reserves space in the data ring, reaping completions until it is available
+ */
+static char *reserve(struct NW_ShmClient *client, size_t length, uint64_t *offset, char **names, int estimate)
+{
+	struct NW_ShmCompletion c;
+	char *p;
+	while ((p = NW_ShmReserve(client, length, offset)) == NULL)
+	{
+		if (errno != EAGAIN || !NW_ShmReap(client, &c, 1))
+			return NULL;
+		print(&c, names, estimate);
+	}
+	return p;
+}
+
+/**
+ * \fn int main(int argc, char *argv[])
+ * \brief main : see function usage(argv) for specification
+ */
+int main(int argc, char *argv[])
+{
+	struct NW_ShmRequest r;
+	memset(&r, 0, sizeof(r));
+	r.engine = NW_ENGINE_MULTILEVEL;
+	r.mode = NW_SHM_DISTANCE;
+	int stop = 0, a = 1;
+	for (; a < argc && argv[a][0] == '-' && argv[a][1] != '\0'; ++a)
+	{
+		enum NW_Engine engine;
+		if (strcmp(argv[a], "-e") == 0 && a + 1 < argc && NW_EngineFromName(argv[a + 1], &engine) == 0)
+			r.engine = engine;
+		else if (strcmp(argv[a], "-s") == 0 && a + 1 < argc)
+		{
+			r.mode = NW_SHM_ESTIMATE;
+			r.precision = atof(argv[a + 1]);
+		}
+		else if (strcmp(argv[a], "-x") == 0)
+		{
+			stop = 1;
+			continue;
+		}
+		else
+		{
+			usage(argv);
+			return EXIT_FAILURE;
+		}
+		++a;
+	}
+	if (a >= argc || argc - a > 2)
+	{
+		usage(argv);
+		return EXIT_FAILURE;
+	}
+	struct NW_ShmClient client;
+	if (NW_ShmConnect(&client, argv[a]) != 0)
+		err(1, "connecting to %s", argv[a]);
+	FILE *manifest = (stop && argc - a == 1) ? NULL : stdin; // -x alone only stops the server
+	if (argc - a == 2 && strcmp(argv[a + 1], "-") != 0 && (manifest = fopen(argv[a + 1], "r")) == NULL)
+		err(1, "fopen %s", argv[a + 1]);
+
+	struct SeqFileSet files;
+	SeqFileSet_init(&files);
+	char **names = NULL, line[4096];
+	size_t n = 0, capacity = 0;
+	int status = 0;
+	struct NW_ShmCompletion c;
+	for (size_t number = 1; manifest != NULL && fgets(line, sizeof(line), manifest) != NULL; ++number)
+	{
+		char file[2][2048], name[1024];
+		long begin[2], length[2];
+		int priority = 0;
+		double deadline = 0;
+		int fields = sscanf(line, "%2047s %ld %ld %2047s %ld %ld %1023s %d %lf", file[0], &begin[0], &length[0], file[1],
+							&begin[1], &length[1], name, &priority, &deadline);
+		if (fields <= 0 || file[0][0] == '#')
+			continue;
+		if (fields < 7)
+			snprintf(name, sizeof(name), "%zu", number);
+		if (fields < 6) // the pairs already submitted are still reaped
+		{
+			fprintf(stderr, "Warning: line %zu of the manifest is malformed.\n", number);
+			printf("%s NA\n", name);
+			status = EXIT_FAILURE;
+			continue;
+		}
+		if (n == capacity)
+		{
+			capacity = (capacity == 0) ? 256 : 2 * capacity;
+			names = (char **)realloc(names, capacity * sizeof(char *));
+			if (names == NULL)
+			{
+				perror("nwshm: realloc of names");
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		char *seq[2];
+		int i = 0;
+		for (; i < 2; ++i)
+		{
+			struct SeqFile *f = SeqFileSet_open(&files, file[i]);
+			if (SeqRegion(f, begin[i], length[i], &seq[i], &length[i], NULL) == SEQ_REGION_ERROR)
+			{
+				fprintf(stderr, "Warning: pair %s: region %ld %ld out of file %s of %ld bytes.\n", name, begin[i],
+						length[i], file[i], f->length);
+				break;
+			}
+		}
+		uint64_t offset[2];
+		for (int j = 0; i == 2 && j < 2; ++j)
+		{
+			char *p = reserve(&client, (size_t)length[j], &offset[j], names, r.mode == NW_SHM_ESTIMATE);
+			if (p == NULL) // the space reserved for the first region goes with the next request
+			{
+				fprintf(stderr, "Warning: pair %s: region of %ld characters: %s\n", name, length[j], strerror(errno));
+				i = j;
+				break;
+			}
+			memcpy(p, seq[j], (size_t)length[j]);
+		}
+		if (i < 2)
+		{
+			printf("%s NA\n", name);
+			status = EXIT_FAILURE;
+			continue;
+		}
+		names[n] = strdup(name);
+		r.user_data = n++;
+		r.offsetA = offset[0];
+		r.lengthA = (uint64_t)length[0];
+		r.offsetB = offset[1];
+		r.lengthB = (uint64_t)length[1];
+		r.priority = priority;
+		r.deadline_ms = (deadline > 0) ? (uint32_t)(deadline * 1000 + 0.5) : 0;
+		while (NW_ShmSubmit(&client, &r) != 0)
+		{
+			if (NW_ShmReap(&client, &c, 1))
+				print(&c, names, r.mode == NW_SHM_ESTIMATE);
+		}
+	}
+	while (NW_ShmReap(&client, &c, 1))
+		print(&c, names, r.mode == NW_SHM_ESTIMATE);
+
+	if (stop)
+	{
+		struct NW_ShmRequest s;
+		memset(&s, 0, sizeof(s));
+		s.mode = NW_SHM_SHUTDOWN;
+		NW_ShmSubmit(&client, &s);
+		NW_ShmReap(&client, &c, 1);
+	}
+	if (manifest != NULL && manifest != stdin)
+		fclose(manifest);
+	free(names);
+	SeqFileSet_close(&files);
+	NW_ShmDisconnect(&client);
+	return status;
+}
@@ -0,0 +1,109 @@
+/**
+ * \file probes.h
+ * \brief USDT (SystemTap SDT) static probes of provider nw, for bpftrace, perf and systemtap
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * A probe is a nop instruction and an ELF note in section .note.stapsdt giving its address, its provider
+ * and name, and the location of its arguments: its cost is the evaluation of its arguments when no tracer
+ * is attached (no semaphore). The probes of a binary are listed by
+ *     readelf -n distanceEdition | grep -A4 stapsdt        or        bpftrace -l 'usdt:./distanceEdition:*'
+ * and for example
+ *     bpftrace -e 'usdt:./distanceEdition:nw:job_end { @us[arg0] = hist((nsecs - @t[tid]) / 1000); }
+ *                  usdt:./distanceEdition:nw:job_start { @t[tid] = nsecs; }'
+ *
+ * The probes, all arguments being integers (pointers to strings for the paths):
+ *     job_start(engine, lengthA, lengthB)               job_end(engine, lengthA, lengthB, distance)
+ *         EditDistance_NW and the single pair mode of distanceEdition (enum NW_Engine)
+ *     strip_start(i, rows, columns)                     strip_end(i, rows)
+ *         the strips of rows i+1 .. i+rows of the cache aware engine
+ *     tile_start(level, i0, j0, cells)                  tile_end(level, i0, j0)
+ *         the tiles of the multilevel engine (level 2: last level cache, 1: L2, 0: L1) at row i0, column j0
+ *     split_tile_start(job, row, col, cells)            split_tile_end(job, row, col)
+ *         the tiles of the jobs split by the scheduler (job: submission number, row and col of the tile)
+ *     sched_concurrency(from, to, rate)
+ *         the changes of the workers taking the large jobs by the concurrency controller (rate: cells per second)
+ *     cache_lookup(blockA, blockB, cells, hit)
+ *         the lookups of the tiles of pairs of blocks of the compressed engine (hit is 1 if found)
+ *     map_start(path)                                   map_end(path, bytes)
+ *         the mapping of a sequence file or of a container
+ *     decode_start(begin, length)                       decode_end(sequence, length)
+ *         the decoding of a region of a sequence file (header skipped, length truncated)
+ *
+ * <sys/sdt.h> is used when available; else the notes are emitted by the macros below on x86-64 and
+ * AArch64 (ELF). Elsewhere, or with -DNW_NO_PROBES, the probes are empty.
+ */
+
+#ifndef __PROBES_H__
+#define __PROBES_H__
+
+#if !defined(NW_NO_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define _NW_PROBES_SDT 1
+#endif
+#endif
+
+#if defined(_NW_PROBES_SDT)
+#include <sys/sdt.h>
+
+#define NW_PROBE1(name, a1) DTRACE_PROBE1(nw, name, a1)
+#define NW_PROBE2(name, a1, a2) DTRACE_PROBE2(nw, name, a1, a2)
+#define NW_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(nw, name, a1, a2, a3)
+#define NW_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(nw, name, a1, a2, a3, a4)
+
+#elif !defined(NW_NO_PROBES) && defined(__GNUC__) && defined(__ELF__) && (defined(__x86_64__) || defined(__aarch64__))
+
+/* Each argument is converted to a long (signed 8 bytes: "-8@operand" in the note) */
+#if defined(__x86_64__)
+#define _NW_PROBE_ARG(x) "nor"((long)(x))
+#else
+#define _NW_PROBE_ARG(x) "r"((long)(x))
+#endif
+
+/* Layout of sys/sdt.h (version 3 of the notes): address of the probe, address of _.stapsdt.base (to
+ * relocate the address when the binary is prelinked), address of the semaphore (none), then the strings */
+#define _NW_PROBE(name, args, ...)                                                                     \
+	__asm__ __volatile__("990: nop\n"                                                                  \
+						 ".pushsection .note.stapsdt,\"?\",\"note\"\n"                                 \
+						 ".balign 4\n"                                                                 \
+						 ".4byte 992f-991f, 994f-993f, 3\n"                                            \
+						 "991: .asciz \"stapsdt\"\n"                                                   \
+						 "992: .balign 4\n"                                                            \
+						 "993: .8byte 990b\n"                                                          \
+						 ".8byte _.stapsdt.base\n"                                                     \
+						 ".8byte 0\n"                                                                  \
+						 ".asciz \"nw\"\n"                                                             \
+						 ".asciz \"" #name "\"\n"                                                      \
+						 ".asciz \"" args "\"\n"                                                       \
+						 "994: .balign 4\n"                                                            \
+						 ".popsection\n"                                                               \
+						 ".ifndef _.stapsdt.base\n"                                                    \
+						 ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"       \
+						 ".weak _.stapsdt.base\n"                                                      \
+						 ".hidden _.stapsdt.base\n"                                                    \
+						 "_.stapsdt.base: .space 1\n"                                                  \
+						 ".size _.stapsdt.base, 1\n"                                                   \
+						 ".popsection\n"                                                               \
+						 ".endif\n"                                                                    \
+						 :                                                                             \
+						 : __VA_ARGS__)
+
+#define NW_PROBE1(name, a1) _NW_PROBE(name, "-8@%[_nw1]", [_nw1] _NW_PROBE_ARG(a1))
+#define NW_PROBE2(name, a1, a2) _NW_PROBE(name, "-8@%[_nw1] -8@%[_nw2]", [_nw1] _NW_PROBE_ARG(a1), [_nw2] _NW_PROBE_ARG(a2))
+#define NW_PROBE3(name, a1, a2, a3)                                                                    \
+	_NW_PROBE(name, "-8@%[_nw1] -8@%[_nw2] -8@%[_nw3]", [_nw1] _NW_PROBE_ARG(a1), [_nw2] _NW_PROBE_ARG(a2),      \
+			  [_nw3] _NW_PROBE_ARG(a3))
+#define NW_PROBE4(name, a1, a2, a3, a4)                                                                \
+	_NW_PROBE(name, "-8@%[_nw1] -8@%[_nw2] -8@%[_nw3] -8@%[_nw4]", [_nw1] _NW_PROBE_ARG(a1), [_nw2] _NW_PROBE_ARG(a2), \
+			  [_nw3] _NW_PROBE_ARG(a3), [_nw4] _NW_PROBE_ARG(a4))
+
+#else
+
+#define NW_PROBE1(name, a1) ((void)0)
+#define NW_PROBE2(name, a1, a2) ((void)0)
+#define NW_PROBE3(name, a1, a2, a3) ((void)0)
+#define NW_PROBE4(name, a1, a2, a3, a4) ((void)0)
+
+#endif
+
+#endif /* __PROBES_H__ */
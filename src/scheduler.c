@@ -0,0 +1,688 @@
+/**
+ * \file scheduler.c
+ * \brief scheduler of alignment jobs by size class, with priorities and deadlines (batch and service modes)
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see scheduler.h
+ */
+
+#include "scheduler.h"
+#include "Needleman-Wunsch-kernel.h" /* the tiles of the split jobs */
+#include "metrics.h"				 /* for NW_SizeClass and NW_MetricsJob */
+#include "batch.h"					 /* for NW_Now */
+#include "thread_pool.h"			 /* for NW_DefaultThreads */
+#include "probes.h"				 /* USDT probes */
+#include "arena.h"				 /* for NW_ArenaReset */
+#include "Needleman-Wunsch-masked.h" /* for NW_DefaultMask */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> /* for strerror */
+#include <errno.h>	/* for ETIMEDOUT */
+#include <unistd.h> /* for sysconf */
+#include <pthread.h>
+
+#include "characters_to_base.h" /* mapping from char to base */
+
+/** \struct NW_Split
+ * \brief boundaries and dependencies of the tiles of a split job; the tile (r, c) covers the rows
+ * r * tile + 1 .. and the columns c * tile + 1 .. of the matrix
+ */
+struct NW_Split
+{
+	size_t rows, cols;		  /*!< number of tiles in each dimension */
+	long *row;				  /*!< D[i][0..lengthB] below the last tile computed in each column of tiles */
+	long *col;				  /*!< for each row of tiles r, at r * (tile + 1): the corner then the left boundary of its next tile */
+	unsigned char *waiting;	  /*!< neighbours (top and left) not yet computed, for each tile */
+	size_t remaining;		  /*!< tiles not yet computed */
+};
+
+/** \struct _task
+ * \brief entry of a queue: a job not split, or one tile of a split job
+ */
+struct _task
+{
+	struct NW_Job *job;
+	size_t tile; /*!< r * cols + c */
+};
+
+/** \struct _queue
+ * \brief binary heap of tasks, the best one first
+ */
+struct _queue
+{
+	struct _task *heap;
+	size_t n, capacity;
+};
+
+/** \struct NW_Scheduler
+ * \brief the queues and the workers
+ */
+struct NW_Scheduler
+{
+	struct _queue queue[NW_SIZE_CLASSES]; /*!< one per size class */
+	int small_classes;					  /*!< the classes of the small jobs are 0 .. small_classes - 1 */
+	int cursor;							  /*!< first queue examined by the next worker (round robin) */
+	double split;						  /*!< cells from which a job is split */
+	size_t tile;						  /*!< side of the tiles */
+	size_t memory;						  /*!< budget of memory */
+	size_t reserved_bytes;				  /*!< memory reserved by the jobs in progress */
+	struct _queue waiting;				  /*!< first tasks of the jobs waiting for memory */
+	size_t waiting_bytes;				  /*!< memory needed by them */
+	pthread_cond_t admitted;			  /*!< signaled when memory is released */
+	uint64_t submitted;					  /*!< jobs submitted */
+	size_t pending;						  /*!< jobs submitted and not completed */
+	int stop;							  /*!< 1 once the workers have to exit */
+	pthread_mutex_t lock;				  /*!< protects all the above and the splits of the jobs */
+	pthread_cond_t work;				  /*!< signaled when a task is queued (or at stop) */
+	pthread_cond_t small_work;			  /*!< the same for the reserved workers, when a small job is queued */
+	int sleeping_reserved;				  /*!< reserved workers waiting on small_work */
+	pthread_cond_t idle;				  /*!< signaled when pending becomes 0 */
+	int nthreads, reserved;
+	pthread_t *threads;
+	/* concurrency controller */
+	double adapt;			  /*!< period of the measures (0: no controller) */
+	int active;				  /*!< workers taking the large jobs allowed to take tasks, in 1 .. nthreads - reserved */
+	pthread_cond_t unpark;	  /*!< signaled when active grows (or at stop) */
+	double period_start;	  /*!< NW_Now() at the beginning of the current period */
+	double period_cells;	  /*!< cells of the tasks completed in the current period */
+	size_t period_tasks;	  /*!< tasks completed in the current period */
+	int period_skip;		  /*!< 1 if the current period is not measured */
+	unsigned long periods;	  /*!< periods measured */
+	double *rate;			  /*!< for each number of active workers: its throughput in cells per second */
+	unsigned long *measured;  /*!< the period of its last measure (0: never measured) */
+	double *held;			  /*!< the time during which it was the number of active workers */
+};
+
+/** \struct _worker_arg
+ * \brief argument of a worker thread
+ */
+struct _worker_arg
+{
+	struct NW_Scheduler *s;
+	int reserved; /*!< 1 if the worker only takes small jobs */
+	int rank;	  /*!< number among the workers taking the large jobs (runs iff rank < s->active) */
+};
+
+/*
+ * static int _before(const struct _task *a, const struct _task *b)
+ * \brief returns 1 iff task a has to be taken before task b: higher priority, earlier deadline, earlier job, smaller tile
+ */
+static int _before(const struct _task *a, const struct _task *b)
+{
+	const struct NW_Job *x = a->job, *y = b->job;
+	if (x->priority != y->priority)
+		return x->priority > y->priority;
+	if (x->deadline != y->deadline)
+		return (y->deadline == 0) || (x->deadline != 0 && x->deadline < y->deadline);
+	if (x->seq != y->seq)
+		return x->seq < y->seq;
+	return a->tile < b->tile;
+}
+
+/*
+ * static int _urgent(const struct _task *a, const struct _task *b)
+ * \brief as _before, but only by priority and deadline (the ties between the queues are broken round robin)
+ */
+static int _urgent(const struct _task *a, const struct _task *b)
+{
+	const struct NW_Job *x = a->job, *y = b->job;
+	if (x->priority != y->priority)
+		return x->priority > y->priority;
+	return (x->deadline != y->deadline) && ((y->deadline == 0) || (x->deadline != 0 && x->deadline < y->deadline));
+}
+
+/*
+ * static void _push(struct _queue *q, struct _task t)
+ * \brief inserts a task in a heap
+ */
+static void _push(struct _queue *q, struct _task t)
+{
+	if (q->n == q->capacity)
+	{
+		q->capacity = (q->capacity == 0) ? 64 : 2 * q->capacity;
+		q->heap = (struct _task *)realloc(q->heap, q->capacity * sizeof(struct _task));
+		if (q->heap == NULL)
+		{
+			perror("NW_SchedulerSubmit: realloc of a queue");
+			exit(EXIT_FAILURE);
+		}
+	}
+	size_t k = q->n++;
+	while (k > 0 && _before(&t, &q->heap[(k - 1) / 2]))
+	{
+		q->heap[k] = q->heap[(k - 1) / 2];
+		k = (k - 1) / 2;
+	}
+	q->heap[k] = t;
+}
+
+/*
+ * static struct _task _pop(struct _queue *q)
+ * \brief removes the first task of a non empty heap
+ */
+static struct _task _pop(struct _queue *q)
+{
+	struct _task first = q->heap[0], last = q->heap[--q->n];
+	size_t k = 0;
+	for (;;)
+	{
+		size_t child = 2 * k + 1;
+		if (child >= q->n)
+			break;
+		if (child + 1 < q->n && _before(&q->heap[child + 1], &q->heap[child]))
+			++child;
+		if (!_before(&q->heap[child], &last))
+			break;
+		q->heap[k] = q->heap[child];
+		k = child;
+	}
+	if (q->n > 0)
+		q->heap[k] = last;
+	return first;
+}
+
+/*
+ * static int _take(struct NW_Scheduler *s, int reserved, struct _task *t)
+ * \brief takes the best task for a worker, the lock held; returns 0 if there is none
+ */
+static int _take(struct NW_Scheduler *s, int reserved, struct _task *t)
+{
+	int classes = reserved ? s->small_classes : NW_SIZE_CLASSES, best = -1;
+	for (int k = 0; k < classes; ++k)
+	{
+		int c = (s->cursor + k) % classes;
+		if (s->queue[c].n > 0 && (best < 0 || _urgent(&s->queue[c].heap[0], &s->queue[best].heap[0])))
+			best = c;
+	}
+	if (best < 0)
+		return 0;
+	s->cursor = (best + 1) % NW_SIZE_CLASSES;
+	*t = _pop(&s->queue[best]);
+	return 1;
+}
+
+/*
+ * static void _wake(struct NW_Scheduler *s, int size_class)
+ * \brief wakes a worker able to take a task of size_class just queued, the lock held
+ */
+static void _wake(struct NW_Scheduler *s, int size_class)
+{
+	if (size_class < s->small_classes && s->sleeping_reserved > 0)
+		pthread_cond_signal(&s->small_work);
+	else
+		pthread_cond_signal(&s->work);
+}
+
+/*
+ * static int _stale(const struct NW_Scheduler *s, int active)
+ * \brief returns 1 iff the throughput with active workers has to be measured (again)
+ */
+static int _stale(const struct NW_Scheduler *s, int active)
+{
+	return s->measured[active] == 0 || s->periods - s->measured[active] > NW_SCHED_ADAPT_STALE;
+}
+
+/*
+ * static void _adapt(struct NW_Scheduler *s, double cells)
+ * \brief counts a task of cells completed, the lock held; at the end of a period, measures its throughput and
+ * moves the number of active workers (cf scheduler.h)
+ */
+static void _adapt(struct NW_Scheduler *s, double cells)
+{
+	if (s->adapt == 0)
+		return;
+	s->period_cells += cells;
+	s->period_tasks++;
+	double now = NW_Now(), elapsed = now - s->period_start;
+	if (elapsed < s->adapt || s->period_tasks < (size_t)s->active) // a task per worker at least
+		return;
+	int g = s->active, general = s->nthreads - s->reserved;
+	s->held[g] += elapsed;
+	if (s->period_skip)
+		s->period_skip = 0;
+	else
+	{
+		double r = s->period_cells / elapsed;
+		s->rate[g] = (s->measured[g] == 0) ? r : 0.5 * (s->rate[g] + r);
+		s->measured[g] = ++s->periods;
+		int step = (g / 8 > 1) ? g / 8 : 1;
+		int lo = (g - step > 1) ? g - step : 1, hi = (g + step < general) ? g + step : general;
+		int up = (hi > g && !_stale(s, hi) && s->rate[hi] > s->rate[g]); // hi measured better
+		int next = g;
+		if (lo < g && !_stale(s, lo) && s->rate[lo] >= s->rate[g])
+			next = lo;
+		else if (up && s->rate[hi] > (1 + NW_SCHED_ADAPT_GAIN) * s->rate[g])
+			next = hi;
+		else if (lo < g && _stale(s, lo) && !up)
+			next = lo;
+		else if (hi > g && _stale(s, hi))
+			next = hi;
+		if (next != g)
+		{
+			NW_PROBE3(sched_concurrency, g, next, (long)r);
+			s->active = next;
+			s->period_skip = 1; // the workers finish their tasks, or start
+			if (next > g)
+				pthread_cond_broadcast(&s->unpark);
+		}
+	}
+	s->period_start = now;
+	s->period_cells = 0;
+	s->period_tasks = 0;
+}
+
+/*
+ * static struct NW_Split *_split(const struct NW_Job *job, size_t tile)
+ * \brief allocates the tiles of a job and initializes the first row and column of its matrix
+ */
+static struct NW_Split *_split(const struct NW_Job *job, size_t tile)
+{
+	struct NW_Split *p = (struct NW_Split *)malloc(sizeof(struct NW_Split));
+	if (p == NULL)
+	{
+		perror("NW_SchedulerSubmit: malloc of a split job");
+		exit(EXIT_FAILURE);
+	}
+	p->rows = (job->lengthA + tile - 1) / tile;
+	p->cols = (job->lengthB + tile - 1) / tile;
+	p->remaining = p->rows * p->cols;
+	p->row = (long *)malloc((job->lengthB + 1) * sizeof(long));
+	p->col = (long *)malloc(p->rows * (tile + 1) * sizeof(long));
+	p->waiting = (unsigned char *)malloc(p->remaining);
+	if (p->row == NULL || p->col == NULL || p->waiting == NULL)
+	{
+		perror("NW_SchedulerSubmit: malloc of the boundaries of a split job");
+		exit(EXIT_FAILURE);
+	}
+	p->row[0] = 0;
+	for (size_t j = 0; j < job->lengthB; ++j)
+		p->row[j + 1] = p->row[j] + (isBase(job->B[j]) ? INSERTION_COST : 0);
+	long d = 0; // D[i][0]
+	for (size_t r = 0; r < p->rows; ++r)
+	{
+		long *col = p->col + r * (tile + 1);
+		size_t i0 = r * tile, h = (job->lengthA - i0 < tile) ? job->lengthA - i0 : tile;
+		col[0] = d;
+		for (size_t k = 0; k < h; ++k)
+			col[k + 1] = col[k] + (isBase(job->A[i0 + k]) ? INSERTION_COST : 0);
+		d = col[h];
+	}
+	for (size_t r = 0; r < p->rows; ++r)
+		for (size_t c = 0; c < p->cols; ++c)
+			p->waiting[r * p->cols + c] = (r > 0) + (c > 0);
+	return p;
+}
+
+/*
+ * static void _free_split(struct NW_Split *p)
+ * \brief frees the tiles of a job
+ */
+static void _free_split(struct NW_Split *p)
+{
+	free(p->row);
+	free(p->col);
+	free(p->waiting);
+	free(p);
+}
+
+/*
+ * static size_t _split_bytes(const struct NW_Job *job, size_t tile)
+ * \brief returns the memory of the tiles of a job (cf _split)
+ */
+static size_t _split_bytes(const struct NW_Job *job, size_t tile)
+{
+	size_t rows = (job->lengthA + tile - 1) / tile, cols = (job->lengthB + tile - 1) / tile;
+	return (job->lengthB + 1) * sizeof(long) + rows * (tile + 1) * sizeof(long) + rows * cols;
+}
+
+/*
+ * static size_t _tile(struct NW_Scheduler *s, struct NW_Job *job, size_t tile)
+ * \brief computes the tile number tile of a split job; its top and left neighbours are computed, and
+ * no other task reads or writes its boundaries meanwhile; returns its cells
+ */
+static size_t _tile(struct NW_Scheduler *s, struct NW_Job *job, size_t tile)
+{
+	struct NW_Split *p = job->split;
+	size_t r = tile / p->cols, c = tile % p->cols;
+	size_t i0 = r * s->tile, j0 = c * s->tile;
+	size_t h = (job->lengthA - i0 < s->tile) ? job->lengthA - i0 : s->tile;
+	size_t w = (job->lengthB - j0 < s->tile) ? job->lengthB - j0 : s->tile;
+	long *col = p->col + r * (s->tile + 1), *top = p->row + j0 + 1;
+	long next_corner = top[w - 1]; // D[i0][j0 + w], overwritten by the tile
+	NW_PROBE4(split_tile_start, job->seq, r, c, h * w);
+	NW_DefaultKernel()->tile(job->A + i0, h, job->B + j0, w, col[0], top, col + 1);
+	NW_PROBE3(split_tile_end, job->seq, r, c);
+	col[0] = next_corner;
+	return h * w;
+}
+
+/*
+ * static void _complete(struct NW_Scheduler *s, struct NW_Job *job, size_t reserved)
+ * \brief calls the done function of a job, the lock not held, counts it and releases its memory: the
+ * jobs waiting for memory are queued again
+ */
+static void _complete(struct NW_Scheduler *s, struct NW_Job *job, size_t reserved)
+{
+	double cells = (job->status == 0 && !job->tiled) ? (double)job->lengthA * (double)job->lengthB : -1;
+	if (job->status == 0)
+	{
+		job->seconds = NW_Now() - job->start;
+		NW_MetricsJob(job->engine, job->lengthA, job->lengthB, job->seconds);
+	}
+	if (job->done != NULL)
+		job->done(job); // may free the job
+	pthread_mutex_lock(&s->lock);
+	if (cells >= 0) // the tiles are counted one by one
+		_adapt(s, cells);
+	if (reserved > 0)
+	{
+		s->reserved_bytes -= reserved;
+		if (s->waiting.n > 0)
+		{
+			while (s->waiting.n > 0)
+			{
+				struct _task t = _pop(&s->waiting);
+				_push(&s->queue[t.job->size_class], t);
+			}
+			s->waiting_bytes = 0;
+			pthread_cond_broadcast(&s->work);
+			pthread_cond_broadcast(&s->small_work);
+			pthread_cond_broadcast(&s->admitted);
+		}
+	}
+	if (--s->pending == 0)
+		pthread_cond_broadcast(&s->idle);
+	pthread_mutex_unlock(&s->lock);
+}
+
+/*
+ * static void *_worker(void *p)
+ * \brief body of a worker: runs the tasks until the stop
+ */
+static void *_worker(void *p)
+{
+	struct _worker_arg *w = (struct _worker_arg *)p;
+	struct NW_Scheduler *s = w->s;
+	pthread_mutex_lock(&s->lock);
+	for (;;)
+	{
+		struct _task t;
+		if (!w->reserved && w->rank >= s->active) // parked by the concurrency controller
+		{
+			if (s->stop)
+				break;
+			pthread_cond_signal(&s->work); // in case this worker was woken up for a task
+			pthread_cond_wait(&s->unpark, &s->lock);
+			continue;
+		}
+		if (!_take(s, w->reserved, &t))
+		{
+			if (s->stop)
+				break;
+			if (!w->reserved && s->pending > 0) // the throughput is bounded by the work
+				s->period_skip = 1;
+			if (w->reserved)
+			{
+				s->sleeping_reserved++;
+				pthread_cond_wait(&s->small_work, &s->lock);
+				s->sleeping_reserved--;
+			}
+			else
+				pthread_cond_wait(&s->work, &s->lock);
+			continue;
+		}
+		struct NW_Job *job = t.job;
+		if (t.tile == 0 && job->split == NULL) // first task of the job
+		{
+			job->start = NW_Now();
+			if (job->deadline != 0 && job->start > job->deadline)
+			{
+				pthread_mutex_unlock(&s->lock);
+				job->status = ETIMEDOUT;
+				_complete(s, job, 0);
+				pthread_mutex_lock(&s->lock);
+				continue;
+			}
+			if (s->reserved_bytes + job->peak > s->memory)
+			{
+				size_t low = NW_PeakBytes(NW_ENGINE_ITERATIF, job->lengthA, job->lengthB);
+				if (job->tiled || job->run != NULL || low >= job->peak || s->reserved_bytes + low > s->memory)
+				{
+					_push(&s->waiting, t); // until a job completes
+					s->waiting_bytes += job->peak;
+					continue;
+				}
+				job->engine = NW_ENGINE_ITERATIF;
+				job->peak = low;
+				job->downgraded = 1;
+			}
+			s->reserved_bytes += job->peak;
+		}
+		pthread_mutex_unlock(&s->lock);
+
+		if (!job->tiled)
+		{
+			if (job->run != NULL)
+				job->run(job);
+			else
+				job->distance = EditDistance_NW(job->engine, (char *)job->A, job->lengthA, (char *)job->B, job->lengthB);
+			NW_ArenaReset(0); // the buffers of the job are free: trims the arena after a large job
+			_complete(s, job, job->peak);
+			pthread_mutex_lock(&s->lock);
+			continue;
+		}
+		if (job->split == NULL)
+			job->split = _split(job, s->tile);
+		struct NW_Split *split = job->split;
+
+		size_t cells = _tile(s, job, t.tile);
+		pthread_mutex_lock(&s->lock);
+		_adapt(s, (double)cells);
+		size_t r = t.tile / split->cols, c = t.tile % split->cols;
+		int queued = 0; // this worker takes the first task queued
+		if (r + 1 < split->rows && --split->waiting[t.tile + split->cols] == 0)
+		{
+			_push(&s->queue[job->size_class], (struct _task){job, t.tile + split->cols});
+			++queued;
+		}
+		if (c + 1 < split->cols && --split->waiting[t.tile + 1] == 0)
+		{
+			_push(&s->queue[job->size_class], (struct _task){job, t.tile + 1});
+			++queued;
+		}
+		if (queued == 2)
+			_wake(s, job->size_class);
+		if (--split->remaining == 0)
+		{
+			pthread_mutex_unlock(&s->lock);
+			job->distance = split->row[job->lengthB];
+			_free_split(split);
+			_complete(s, job, job->peak);
+			pthread_mutex_lock(&s->lock);
+		}
+	}
+	pthread_mutex_unlock(&s->lock);
+	return NULL;
+}
+
+/* NW_SchedulerCreate : see .h file for documentation
+ */
+struct NW_Scheduler *NW_SchedulerCreate(const struct NW_SchedParams *params)
+{
+	struct NW_Scheduler *s = (struct NW_Scheduler *)calloc(1, sizeof(struct NW_Scheduler));
+	if (s == NULL)
+	{
+		perror("NW_SchedulerCreate: malloc of the scheduler");
+		exit(EXIT_FAILURE);
+	}
+	s->nthreads = (params->nthreads <= 0) ? NW_DefaultThreads() : params->nthreads;
+	s->reserved = (params->reserved < 0) ? 0 : (params->reserved == 0) ? s->nthreads / 4 : params->reserved;
+	if (s->reserved > s->nthreads - 1) // at least one worker takes the large jobs
+		s->reserved = s->nthreads - 1;
+	double small = (params->small > 0) ? params->small : NW_SCHED_SMALL;
+	s->small_classes = NW_SizeClass((size_t)small, 1);
+	if (s->small_classes == 0)
+		s->small_classes = 1;
+	s->split = (params->split > 0) ? params->split : NW_SCHED_SPLIT;
+	s->tile = (params->tile > 0) ? params->tile : NW_SCHED_TILE;
+	s->memory = params->memory;
+	if (s->memory == 0)
+		s->memory = (size_t)(NW_SCHED_MEMORY * (double)sysconf(_SC_PHYS_PAGES) * (double)sysconf(_SC_PAGESIZE));
+	pthread_mutex_init(&s->lock, NULL);
+	pthread_cond_init(&s->admitted, NULL);
+	pthread_cond_init(&s->work, NULL);
+	pthread_cond_init(&s->small_work, NULL);
+	pthread_cond_init(&s->idle, NULL);
+	pthread_cond_init(&s->unpark, NULL);
+	s->adapt = (params->adapt > 0) ? params->adapt : 0;
+	s->active = s->nthreads - s->reserved;
+	s->rate = (double *)calloc(s->active + 1, 2 * sizeof(double) + sizeof(unsigned long));
+	if (s->rate == NULL)
+	{
+		perror("NW_SchedulerCreate: malloc of the controller");
+		exit(EXIT_FAILURE);
+	}
+	s->held = s->rate + (s->active + 1);
+	s->measured = (unsigned long *)(s->held + (s->active + 1));
+	s->period_start = NW_Now();
+	s->period_skip = 1; // the queues fill up
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	if (params->stack_size > 0)
+	{
+		size_t current;
+		pthread_attr_getstacksize(&attr, &current);
+		if (params->stack_size > current)
+			pthread_attr_setstacksize(&attr, params->stack_size);
+	}
+	s->threads = (pthread_t *)malloc(s->nthreads * (sizeof(pthread_t) + sizeof(struct _worker_arg)));
+	if (s->threads == NULL)
+	{
+		perror("NW_SchedulerCreate: malloc of the workers");
+		exit(EXIT_FAILURE);
+	}
+	struct _worker_arg *args = (struct _worker_arg *)(s->threads + s->nthreads);
+	for (int t = 0; t < s->nthreads; ++t)
+	{
+		args[t].s = s;
+		args[t].reserved = (t < s->reserved);
+		args[t].rank = t - s->reserved;
+		int e = pthread_create(&s->threads[t], &attr, _worker, &args[t]);
+		if (e != 0)
+		{
+			fprintf(stderr, "NW_SchedulerCreate: pthread_create: %s\n", strerror(e));
+			exit(EXIT_FAILURE);
+		}
+	}
+	pthread_attr_destroy(&attr);
+	return s;
+}
+
+/* NW_SchedulerSubmit : see .h file for documentation
+ */
+void NW_SchedulerSubmit(struct NW_Scheduler *s, struct NW_Job *job)
+{
+	job->status = 0;
+	job->distance = -1;
+	job->seconds = 0;
+	job->downgraded = 0;
+	job->submitted = NW_Now();
+	job->start = 0;
+	job->requested = job->engine;
+	job->size_class = NW_SizeClass(job->lengthA, job->lengthB);
+	job->split = NULL;
+	job->tiled = (job->run == NULL && job->lengthA > 0 && job->lengthB > 0 &&
+				  (double)job->lengthA * (double)job->lengthB >= s->split &&
+				  NW_DefaultMask()->policy == NW_MASK_ALIGN); // the tiles align the masked bases
+	if (job->peak == 0)
+		job->peak = job->tiled ? _split_bytes(job, s->tile) : NW_PeakBytes(job->engine, job->lengthA, job->lengthB);
+	if (job->peak > s->memory && !job->tiled && job->run == NULL &&
+		NW_PeakBytes(NW_ENGINE_ITERATIF, job->lengthA, job->lengthB) <= s->memory)
+	{
+		job->engine = NW_ENGINE_ITERATIF;
+		job->peak = NW_PeakBytes(NW_ENGINE_ITERATIF, job->lengthA, job->lengthB);
+		job->downgraded = 1;
+	}
+	if (job->peak > s->memory) // would wait forever
+	{
+		job->status = ENOMEM;
+		if (job->done != NULL)
+			job->done(job);
+		return;
+	}
+	pthread_mutex_lock(&s->lock);
+	while (s->waiting_bytes > 0 && s->waiting_bytes >= s->memory) // back-pressure
+		pthread_cond_wait(&s->admitted, &s->lock);
+	job->seq = s->submitted++;
+	s->pending++;
+	_push(&s->queue[job->size_class], (struct _task){job, 0});
+	_wake(s, job->size_class);
+	pthread_mutex_unlock(&s->lock);
+}
+
+/* NW_SchedulerMemory : see .h file for documentation
+ */
+void NW_SchedulerMemory(struct NW_Scheduler *s, size_t *reserved, size_t *waiting)
+{
+	pthread_mutex_lock(&s->lock);
+	*reserved = s->reserved_bytes;
+	*waiting = s->waiting_bytes;
+	pthread_mutex_unlock(&s->lock);
+}
+
+/* NW_SchedulerConcurrency : see .h file for documentation
+ */
+int NW_SchedulerConcurrency(struct NW_Scheduler *s, int *active, double *rate)
+{
+	pthread_mutex_lock(&s->lock);
+	int chosen = s->nthreads - s->reserved;
+	for (int g = 1; g < s->nthreads - s->reserved; ++g)
+		if (s->held[g] > s->held[chosen])
+			chosen = g;
+	if (active != NULL)
+		*active = s->reserved + s->active;
+	if (rate != NULL)
+		*rate = s->rate[chosen];
+	pthread_mutex_unlock(&s->lock);
+	return s->reserved + chosen;
+}
+
+/* NW_SchedulerWait : see .h file for documentation
+ */
+void NW_SchedulerWait(struct NW_Scheduler *s)
+{
+	pthread_mutex_lock(&s->lock);
+	while (s->pending > 0)
+		pthread_cond_wait(&s->idle, &s->lock);
+	pthread_mutex_unlock(&s->lock);
+}
+
+/* NW_SchedulerDestroy : see .h file for documentation
+ */
+void NW_SchedulerDestroy(struct NW_Scheduler *s)
+{
+	NW_SchedulerWait(s);
+	pthread_mutex_lock(&s->lock);
+	s->stop = 1;
+	pthread_cond_broadcast(&s->work);
+	pthread_cond_broadcast(&s->small_work);
+	pthread_cond_broadcast(&s->unpark);
+	pthread_mutex_unlock(&s->lock);
+	for (int t = 0; t < s->nthreads; ++t)
+		pthread_join(s->threads[t], NULL);
+	for (int c = 0; c < NW_SIZE_CLASSES; ++c)
+		free(s->queue[c].heap);
+	free(s->waiting.heap);
+	pthread_cond_destroy(&s->admitted);
+	pthread_mutex_destroy(&s->lock);
+	pthread_cond_destroy(&s->work);
+	pthread_cond_destroy(&s->small_work);
+	pthread_cond_destroy(&s->idle);
+	pthread_cond_destroy(&s->unpark);
+	free(s->rate);
+	free(s->threads);
+	free(s);
+}
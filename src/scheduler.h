@@ -0,0 +1,179 @@
+/**
+ * \file scheduler.h
+ * \brief scheduler of alignment jobs by size class, with priorities and deadlines (batch and service modes)
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * The cost of a job is predicted by the cells lengthA * lengthB of its matrix, and each size class (cf
+ * NW_SizeClass in metrics.h) has its own queue, ordered by priority (highest first), then deadline
+ * (earliest first), then submission. A worker takes the best head of the queues, the ties between the
+ * queues being broken round robin: a large job queued before thousands of small ones does not delay them.
+ *
+ * Besides, the jobs of at least <split> cells are split into tiles of <tile> x <tile> cells (computed by
+ * the tile kernel of NW_DefaultKernel, cf Needleman-Wunsch-kernel.h), queued as soon as their top and left
+ * neighbours are computed: a large job is a stream of short tasks interleaved with the small jobs, and its
+ * wavefront of tiles is computed by several workers at once. <reserved> workers only take the jobs of less
+ * than <small> cells, so that small jobs always find a worker. The jobs are not split when the soft-mask
+ * policy is not align (cf Needleman-Wunsch-masked.h): the tiles would align the masked bases.
+ *
+ * A job whose deadline has passed when a worker takes it is not computed (status ETIMEDOUT).
+ *
+ * Admission control: a job reserves its predicted peak memory (NW_PeakBytes, or the boundaries of its
+ * tiles) from the budget <memory> when it starts, and releases it when it completes. A job which does not
+ * fit is computed by NW_ENGINE_ITERATIF (the engine of the smallest peak) if that fits, else waits for the
+ * completion of other jobs; a job which could never fit is not computed (status ENOMEM). NW_SchedulerSubmit
+ * blocks while the jobs waiting for memory need more than the whole budget: the callers stop taking new
+ * jobs (eg the shared memory server stops reading its SQ, and its client gets EAGAIN).
+ *
+ * Concurrency controller: the linear space engines and the tiles stream their rows of longs through the
+ * memory, and the bandwidth of the DRAM is often saturated by fewer workers than processors; the other
+ * workers only add contention. With a period <adapt>, the throughput (cells of the jobs and tiles completed
+ * per second) is measured over each period, and the number of workers taking the large jobs is moved by
+ * hill climbing: the lower neighbour (by an eighth of the workers, at least 1) is tried first, kept if its
+ * throughput is at least the current one, and the upper neighbour is kept only if it is better by more than
+ * NW_SCHED_ADAPT_GAIN; each neighbour is measured again after NW_SCHED_ADAPT_STALE periods, so that the
+ * controller follows the changes of the workload. A period in which one of these workers found no task
+ * (the throughput is then bounded by the work, not by the workers), or which follows a change, is not
+ * measured. The workers beyond the count wait without taking tasks; the reserved workers are not limited.
+ */
+
+#ifndef __SCHEDULER_H__
+#define __SCHEDULER_H__
+
+#include <stdlib.h> /* for size_t */
+#include <stdint.h> /* for uint64_t */
+
+#include "Needleman-Wunsch-recmemo.h" /* for enum NW_Engine */
+
+/** \def NW_SCHED_SMALL
+ *  \brief default cells below which a job is small (and may run on the reserved workers)
+ */
+#define NW_SCHED_SMALL 1e6
+
+/** \def NW_SCHED_SPLIT
+ *  \brief default cells from which a job is split into tiles
+ */
+#define NW_SCHED_SPLIT 1e8
+
+/** \def NW_SCHED_TILE
+ *  \brief default side of the tiles of the split jobs
+ */
+#define NW_SCHED_TILE 4096
+
+/** \def NW_SCHED_MEMORY
+ *  \brief default budget of memory of the jobs, as a fraction of the physical memory
+ */
+#define NW_SCHED_MEMORY 0.5
+
+/** \def NW_SCHED_ADAPT_GAIN
+ *  \brief relative gain of throughput above which the controller adds workers
+ */
+#define NW_SCHED_ADAPT_GAIN 0.05
+
+/** \def NW_SCHED_ADAPT_STALE
+ *  \brief periods after which the throughput of a number of workers is measured again
+ */
+#define NW_SCHED_ADAPT_STALE 8
+
+struct NW_Job;
+
+/** \typedef NW_JobRun
+ * \brief computes a job (sets job->distance) instead of EditDistance_NW; such a job is never split
+ */
+typedef void (*NW_JobRun)(struct NW_Job *job);
+
+/** \typedef NW_JobDone
+ * \brief called by the worker which completed the job (or found its deadline passed)
+ */
+typedef void (*NW_JobDone)(struct NW_Job *job);
+
+/** \struct NW_Job
+ * \brief a job submitted to the scheduler; it must remain valid until done is called
+ */
+struct NW_Job
+{
+	const char *A;		   /*!< first sequence */
+	size_t lengthA;		   /*!< number of elements in A */
+	const char *B;		   /*!< second sequence */
+	size_t lengthB;		   /*!< number of elements in B */
+	enum NW_Engine engine; /*!< implementation used if the job is not split */
+	int priority;		   /*!< the highest priorities are taken first */
+	double deadline;	   /*!< NW_Now() time after which the job is not started (0: none) */
+	NW_JobRun run;		   /*!< if not NULL, computes the job */
+	NW_JobDone done;	   /*!< if not NULL, called once the job is completed */
+	void *arg;			   /*!< free for the caller */
+	size_t peak;		   /*!< predicted peak memory in bytes (0: predicted by the scheduler) */
+	long distance;		   /*!< output: the edit distance between A and B */
+	int status;			   /*!< output: 0, or ETIMEDOUT if the deadline passed before the job started, or ENOMEM
+								if its peak memory exceeds the budget */
+	int downgraded;		   /*!< output: 1 if the job was computed by NW_ENGINE_ITERATIF for lack of memory */
+	double seconds;		   /*!< output: wall clock time from the start of the job to its completion */
+	double submitted;	   /*!< output: NW_Now() at its submission */
+	enum NW_Engine requested; /*!< output: engine at its submission (before a downgrade) */
+	/* used by the scheduler */
+	uint64_t seq;		   /*!< number of the job in submission order */
+	int size_class;		   /*!< queue of the job */
+	double start;		   /*!< NW_Now() when its first task started (0 until then) */
+	int tiled;			   /*!< 1 if the job is split into tiles */
+	struct NW_Split *split; /*!< boundaries and dependencies of the tiles, once the job started */
+};
+
+/** \struct NW_SchedParams
+ * \brief parameters of NW_SchedulerCreate
+ */
+struct NW_SchedParams
+{
+	int nthreads;	   /*!< number of workers (if <= 0: the number of online processors) */
+	int reserved;	   /*!< workers reserved to the small jobs (0 for a quarter of the workers, < 0 for none) */
+	double small;	   /*!< cells below which a job is small (0 for NW_SCHED_SMALL) */
+	double split;	   /*!< cells from which a job is split into tiles (0 for NW_SCHED_SPLIT) */
+	size_t tile;	   /*!< side of the tiles (0 for NW_SCHED_TILE) */
+	size_t stack_size; /*!< minimal stack size of the workers, for the engines of the jobs not split */
+	size_t memory;	   /*!< budget of the peak memory of the jobs in progress, in bytes (0 for NW_SCHED_MEMORY) */
+	double adapt;	   /*!< period of the concurrency controller in seconds (0: no controller, all the workers) */
+};
+
+/**
+ * \fn struct NW_Scheduler *NW_SchedulerCreate(const struct NW_SchedParams *params);
+ * \brief starts the workers of a scheduler
+ */
+struct NW_Scheduler *NW_SchedulerCreate(const struct NW_SchedParams *params);
+
+/**
+ * \fn void NW_SchedulerSubmit(struct NW_Scheduler *s, struct NW_Job *job);
+ * \brief queues a job (thread safe); its outputs are set when its done function is called
+ *
+ * May block while the jobs waiting for memory need more than the budget; a job which can never fit in
+ * the budget is completed at once (status ENOMEM).
+ */
+void NW_SchedulerSubmit(struct NW_Scheduler *s, struct NW_Job *job);
+
+/**
+ * \fn void NW_SchedulerMemory(struct NW_Scheduler *s, size_t *reserved, size_t *waiting);
+ * \brief returns the memory reserved by the jobs in progress and the memory needed by the jobs waiting for it
+ */
+void NW_SchedulerMemory(struct NW_Scheduler *s, size_t *reserved, size_t *waiting);
+
+/**
+ * \fn int NW_SchedulerConcurrency(struct NW_Scheduler *s, int *active, double *rate);
+ * \brief returns the number of workers chosen by the concurrency controller: the one (reserved workers
+ *        included) which ran the longest, or all the workers without controller
+ * \param active : if not NULL, receives the number of workers currently allowed to take tasks
+ * \param rate : if not NULL, receives the throughput measured with the chosen number (cells per second, 0 if
+ *        it was never measured)
+ */
+int NW_SchedulerConcurrency(struct NW_Scheduler *s, int *active, double *rate);
+
+/**
+ * \fn void NW_SchedulerWait(struct NW_Scheduler *s);
+ * \brief waits until all the jobs submitted are completed
+ */
+void NW_SchedulerWait(struct NW_Scheduler *s);
+
+/**
+ * \fn void NW_SchedulerDestroy(struct NW_Scheduler *s);
+ * \brief waits for the jobs submitted, then stops the workers and frees the scheduler
+ */
+void NW_SchedulerDestroy(struct NW_Scheduler *s);
+
+#endif /* __SCHEDULER_H__ */
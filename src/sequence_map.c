@@ -0,0 +1,238 @@
+/**
+ * \file sequence_map.c
+ * \brief mapping of FASTA files in virtual memory, shared by all the sequences extracted from them
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see sequence_map.h
+ */
+
+#include "sequence_map.h"
+#include "probes.h" /* USDT probes */
+#include "characters_to_base.h" /* for isBase */
+#include "async_read.h" /* files of the network filesystems */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <err.h>
+#include <string.h>	  /* for memchr and strdup */
+#include <fcntl.h>	  /* for open */
+#include <unistd.h>	  /* for close */
+#include <sys/mman.h> /* for mmap and munmap */
+#include <sys/stat.h> /* for file length */
+#include <sys/vfs.h>  /* for fstatfs */
+
+/*
+ * static int _read_in_memory(int fd)
+ * \brief returns 1 if the file fd has to be read in memory instead of mapped: NW_MAP, else if it is on a
+ * network filesystem
+ */
+static int _read_in_memory(int fd)
+{
+	const char *mode = getenv(NW_MAP_ENV);
+	if (mode != NULL && strcmp(mode, "read") == 0)
+		return 1;
+	if (mode != NULL && strcmp(mode, "map") == 0)
+		return 0;
+	struct statfs fs;
+	if (fstatfs(fd, &fs) != 0)
+		return 0;
+	switch ((unsigned long)fs.f_type)
+	{
+	case 0x6969UL:		/* NFS */
+	case 0x517BUL:		/* SMB */
+	case 0xFF534D42UL: /* CIFS */
+	case 0xFE534D42UL: /* SMB2 */
+	case 0x65735546UL: /* FUSE */
+	case 0x00C36400UL: /* Ceph */
+	case 0x0BD00BD0UL: /* Lustre */
+	case 0x01021997UL: /* 9P */
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/* SeqFileSet_init : see .h file for documentation
+ */
+void SeqFileSet_init(struct SeqFileSet *set)
+{
+	set->files = NULL;
+	set->count = 0;
+	set->capacity = 0;
+}
+
+/* SeqFileSet_open : see .h file for documentation
+ */
+struct SeqFile *SeqFileSet_open(struct SeqFileSet *set, const char *path)
+{
+	for (size_t i = 0; i < set->count; ++i) // same pathname: no need to stat it again
+		if (strcmp(set->files[i]->path, path) == 0)
+			return set->files[i];
+
+	int fd = open(path, O_RDONLY);
+	if (fd == -1)
+		err(1, "open %s", path);
+	struct stat s;
+	if (fstat(fd, &s) == -1)
+		err(1, "fstat %s", path);
+	for (size_t i = 0; i < set->count; ++i) // same file under another pathname
+	{
+		if (set->files[i]->dev == s.st_dev && set->files[i]->ino == s.st_ino)
+		{
+			close(fd);
+			return set->files[i];
+		}
+	}
+
+	struct SeqFile *file = (struct SeqFile *)malloc(sizeof(struct SeqFile));
+	if (file == NULL)
+	{
+		perror("SeqFileSet_open: malloc of file");
+		exit(EXIT_FAILURE);
+	}
+	file->path = strdup(path);
+	file->fd = fd;
+	file->dev = s.st_dev;
+	file->ino = s.st_ino;
+	file->length = (long)s.st_size;
+	file->mapped = !_read_in_memory(fd);
+	NW_PROBE1(map_start, path);
+	if (file->mapped)
+	{
+		file->data = (char *)mmap(NULL, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (file->data == MAP_FAILED)
+			err(1, "mmap %s", path);
+	}
+	else
+	{
+		file->data = (char *)malloc((size_t)s.st_size + 1);
+		if (file->data == NULL)
+			err(1, "malloc of %s", path);
+		if (NW_ReadAll(fd, file->data, (size_t)s.st_size) != 0)
+			errx(1, "%s: shorter than its size", path);
+	}
+	NW_PROBE2(map_end, path, s.st_size);
+
+	if (set->count == set->capacity)
+	{
+		set->capacity = (set->capacity == 0) ? 4 : 2 * set->capacity;
+		set->files = (struct SeqFile **)realloc(set->files, set->capacity * sizeof(struct SeqFile *));
+		if (set->files == NULL)
+		{
+			perror("SeqFileSet_open: realloc of set->files");
+			exit(EXIT_FAILURE);
+		}
+	}
+	set->files[set->count++] = file;
+	return file;
+}
+
+/* SeqFileSet_close : see .h file for documentation
+ */
+void SeqFileSet_close(struct SeqFileSet *set)
+{
+	for (size_t i = 0; i < set->count; ++i)
+	{
+		struct SeqFile *file = set->files[i];
+		if (!file->mapped)
+			free(file->data);
+		else if (munmap(file->data, (size_t)file->length) != 0)
+			err(1, "munmap");
+		if (close(file->fd) != 0)
+			err(1, "close");
+		free(file->path);
+		free(file);
+	}
+	free(set->files);
+	SeqFileSet_init(set);
+}
+
+/* SeqRegion : see .h file for documentation
+ */
+enum SeqRegionStatus SeqRegion(const struct SeqFile *file, long begin, long length,
+							   char **seq, long *seq_length, char **comment)
+{
+	enum SeqRegionStatus status = SEQ_REGION_OK;
+	if (comment != NULL)
+		*comment = NULL;
+	if (begin < 0 || begin > file->length || length < 0) // eg a bedpe end before its beginning
+		return SEQ_REGION_ERROR;
+
+	char *s = file->data + begin; // beginning of the sequence
+	char *end = file->data + file->length;
+	if (s < end && *s == '>') /* Skip the first line starting by '>' */
+	{
+		char *endofline = (char *)memchr(s, '\n', (size_t)(end - s));
+		if (comment != NULL)
+			*comment = s;
+		if (endofline != NULL)
+			s = endofline + 1; // first character of next line
+	}
+
+	/* same convention as the single pair mode: the last character of the file (usually '\n') is excluded */
+	long n_exceed = file->length - 1 - (long)(s - file->data) - length;
+	if (n_exceed < 0)
+	{
+		length = length + n_exceed;
+		if (length < 0)
+			length = 0;
+		status = SEQ_REGION_TRUNCATED;
+	}
+	*seq = s;
+	*seq_length = length;
+	return status;
+}
+
+/* SeqRecordPosition : see .h file for documentation
+ */
+long SeqRecordPosition(const struct SeqFile *file, const char *seq, const char **name, size_t *name_length)
+{
+	const char *p = seq, *record = file->data;
+	*name = NULL;
+	*name_length = 0;
+	while (p > file->data && !(*(p - 1) == '>' && (p - 1 == file->data || *(p - 2) == '\n')))
+		--p;
+	if (p > file->data) // p follows the '>' of the header of the record
+	{
+		*name = p;
+		while (*name_length < (size_t)(seq - p) && p[*name_length] != ' ' && p[*name_length] != '\t' &&
+			   p[*name_length] != '\r' && p[*name_length] != '\n')
+			++*name_length;
+		record = (const char *)memchr(p, '\n', (size_t)(seq - p));
+		record = (record != NULL) ? record + 1 : seq;
+	}
+	long bases = 0;
+	for (; record < seq; ++record)
+		bases += isBase(*record);
+	return bases;
+}
+
+/* SeqMaskIntervals : see .h file for documentation
+ */
+size_t SeqMaskIntervals(const char *seq, size_t length, struct SeqInterval *intervals)
+{
+	size_t n = 0, k = 0;
+	while (k < length)
+	{
+		while (k < length && !(isBase(seq[k]) && seq[k] >= 'a' && seq[k] <= 'z'))
+			++k;
+		if (k == length)
+			break;
+		size_t begin = k, end = ++k;
+		for (; k < length; ++k)
+			if (isBase(seq[k]))
+			{
+				if (seq[k] < 'a' || seq[k] > 'z')
+					break;
+				end = k + 1;
+			}
+		if (intervals != NULL)
+		{
+			intervals[n].begin = begin;
+			intervals[n].end = end;
+		}
+		++n;
+	}
+	return n;
+}
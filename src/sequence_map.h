@@ -0,0 +1,134 @@
+/**
+ * \file sequence_map.h
+ * \brief mapping of FASTA files in virtual memory, shared by all the sequences extracted from them
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * A SeqFileSet maps each distinct file once (two pathnames designating the same inode share
+ * the same mapping). Regions are then decoded on demand by SeqRegion, using the same rules as
+ * the single pair mode of distanceEdition: a first line starting by '>' is skipped and a length
+ * exceeding the end of file is truncated.
+ *
+ * The files of a network filesystem (NFS, SMB, FUSE, Ceph, Lustre, 9P) are not mapped but read in memory
+ * when they are opened, by large blocks with several reads in flight (cf async_read.h): the page faults
+ * of a mapping would be served one round trip at a time inside the workers. The environment variable
+ * NW_MAP forces the mapping ("map") or the reading ("read") of all the files.
+ */
+
+#ifndef __SEQUENCE_MAP_H__
+#define __SEQUENCE_MAP_H__
+
+#include <stdlib.h>	   /* for size_t */
+#include <sys/types.h> /* for dev_t and ino_t */
+
+/** \def NW_MAP_ENV
+ *  \brief name of the environment variable that forces the mapping ("map") or the reading ("read") of the files
+ */
+#define NW_MAP_ENV "NW_MAP"
+
+/** \struct SeqFile
+ * \brief a file mapped read-only in virtual memory
+ */
+struct SeqFile
+{
+	char *path;	  /*!< pathname used to open the file (first one if several name the same inode) */
+	int fd;		  /*!< file descriptor */
+	dev_t dev;	  /*!< device of the file, to detect the same file under two pathnames */
+	ino_t ino;	  /*!< inode of the file */
+	char *data;	  /*!< address of the mapping (or of the copy in memory) */
+	long length;  /*!< length of the file (and of the mapping) */
+	int mapped;	  /*!< 1 if data is a mapping, 0 if the file was read in memory */
+};
+
+/** \struct SeqFileSet
+ * \brief the set of files mapped by one process
+ */
+struct SeqFileSet
+{
+	struct SeqFile **files; /*!< the mapped files */
+	size_t count;			/*!< number of elements in files */
+	size_t capacity;		/*!< allocated size of files */
+};
+
+/**
+ * \fn void SeqFileSet_init(struct SeqFileSet *set);
+ * \brief initializes an empty set of mapped files
+ */
+void SeqFileSet_init(struct SeqFileSet *set);
+
+/**
+ * \fn struct SeqFile *SeqFileSet_open(struct SeqFileSet *set, const char *path);
+ * \brief returns the mapping of file path, mapping it if it is not yet in the set
+ * \param set : the set of already mapped files
+ * \param path : pathname of the file
+ * \return : the mapped file; exits with an error message if the file cannot be mapped
+ *
+ * Not thread safe: all the files have to be opened before the workers start.
+ */
+struct SeqFile *SeqFileSet_open(struct SeqFileSet *set, const char *path);
+
+/**
+ * \fn void SeqFileSet_close(struct SeqFileSet *set);
+ * \brief unmaps (or frees) and closes all the files of the set
+ */
+void SeqFileSet_close(struct SeqFileSet *set);
+
+/** \enum SeqRegionStatus
+ * \brief result of SeqRegion
+ */
+enum SeqRegionStatus
+{
+	SEQ_REGION_OK = 0,		 /*!< the region is entirely in the file */
+	SEQ_REGION_TRUNCATED = 1, /*!< the length exceeded the end of file and was truncated */
+	SEQ_REGION_ERROR = -1	 /*!< the beginning exceeds the end of file, or the length is negative */
+};
+
+/**
+ * \fn enum SeqRegionStatus SeqRegion(const struct SeqFile *file, long begin, long length, char **seq, long *seq_length, char **comment);
+ * \brief decodes the region of length characters starting at position begin in file
+ * \param file : the mapped file
+ * \param begin : position of the first character in the file
+ * \param length : number of characters
+ * \param seq : set to the first character of the sequence
+ * \param seq_length : set to the (possibly truncated) length of the sequence
+ * \param comment : if not NULL, set to the skipped line starting by '>' (or NULL if there is none)
+ * \return : the status of the region
+ *
+ * Reentrant: SeqRegion only reads the mapping and may be called by several threads.
+ */
+enum SeqRegionStatus SeqRegion(const struct SeqFile *file, long begin, long length,
+							   char **seq, long *seq_length, char **comment);
+
+/**
+ * \fn long SeqRecordPosition(const struct SeqFile *file, const char *seq, const char **name, size_t *name_length);
+ * \brief finds the FASTA record of file containing seq: the last line starting by '>' before seq
+ * \param seq : a position in the mapping of file
+ * \param name : set to the name of the record (the first word of its '>' line), or NULL if there is no such line
+ * \param name_length : set to the length of the name
+ * \return : the number of bases of the record before seq (the base coordinate of seq in the record)
+ *
+ * Reentrant, as SeqRegion.
+ */
+long SeqRecordPosition(const struct SeqFile *file, const char *seq, const char **name, size_t *name_length);
+
+/** \struct SeqInterval
+ * \brief interval [begin, end( of positions of a decoded sequence
+ */
+struct SeqInterval
+{
+	size_t begin; /*!< first position */
+	size_t end;	  /*!< position after the last one */
+};
+
+/**
+ * \fn size_t SeqMaskIntervals(const char *seq, size_t length, struct SeqInterval *intervals);
+ * \brief finds the soft-masked intervals of seq[0 .. length-1]: the maximal runs of lowercase bases (the
+ * characters which are not bases, eg '\n', do not interrupt a run), from its first to its last base
+ * \param intervals : if not NULL, receives the intervals in increasing order
+ * \return : the number of intervals (call with intervals NULL to size the array)
+ *
+ * Reentrant, as SeqRegion.
+ */
+size_t SeqMaskIntervals(const char *seq, size_t length, struct SeqInterval *intervals);
+
+#endif /* __SEQUENCE_MAP_H__ */
@@ -0,0 +1,33 @@
+"""Build of the Python extension module nw (cf nwmodule.c).
+
+    python3 setup.py build_ext --inplace
+"""
+from setuptools import Extension, setup
+
+setup(
+    name="nw",
+    version="0.1",
+    ext_modules=[
+        Extension(
+            "nw",
+            sources=[
+                "nwmodule.c",
+                "Needleman-Wunsch-recmemo.c",
+                "Needleman-Wunsch-short.c",
+                "Needleman-Wunsch-tiled.c",
+                "Needleman-Wunsch-kernel.c",
+                "Needleman-Wunsch-masked.c",
+                "arena.c",
+                "batch.c",
+                "metrics.c",
+                "scheduler.c",
+                "capture.c",
+                "sequence_map.c",
+                "async_read.c",
+                "thread_pool.c",
+            ],
+            extra_compile_args=["-O3", "-pthread"],
+            extra_link_args=["-pthread"],
+        )
+    ],
+)
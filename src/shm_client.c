@@ -0,0 +1,170 @@
+/**
+ * \file shm_client.c
+ * \brief alignment service over shared memory: the client
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see shm_service.h
+ */
+
+#include "shm_service.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>	  /* for memset */
+#include <errno.h>
+#include <fcntl.h>	  /* for O_RDWR */
+#include <sys/mman.h> /* for shm_open and mmap */
+#include <sys/stat.h> /* for fstat */
+
+/* NW_ShmConnect : see .h file for documentation
+ */
+int NW_ShmConnect(struct NW_ShmClient *c, const char *name)
+{
+	memset(c, 0, sizeof(*c));
+	int fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0)
+		return -1;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct NW_ShmHeader))
+	{
+		close(fd);
+		errno = EPROTO;
+		return -1;
+	}
+	c->map_size = (size_t)st.st_size;
+	c->map = mmap(NULL, c->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (c->map == MAP_FAILED)
+		return -1;
+	c->h = (struct NW_ShmHeader *)c->map;
+	if (c->h->magic != NW_SHM_MAGIC || c->h->version != NW_SHM_VERSION ||
+		c->h->data_offset + c->h->data_size > c->map_size)
+	{
+		munmap(c->map, c->map_size);
+		errno = EPROTO;
+		return -1;
+	}
+	atomic_thread_fence(memory_order_acquire);
+	c->sq = (struct NW_ShmRequest *)((char *)c->map + c->h->sq_offset);
+	c->cq = (struct NW_ShmCompletion *)((char *)c->map + c->h->cq_offset);
+	c->data = (char *)c->map + c->h->data_offset;
+	c->data_end = (uint64_t *)calloc(c->h->entries, sizeof(uint64_t));
+	c->done = (unsigned char *)calloc(c->h->entries, 1);
+	if (c->data_end == NULL || c->done == NULL)
+	{
+		perror("NW_ShmConnect: malloc of the requests in flight");
+		exit(EXIT_FAILURE);
+	}
+
+	// waits for the completion of the requests of the previous clients, and discards their completions
+	struct NW_ShmHeader *h = c->h;
+	uint32_t done, tail;
+	while ((done = atomic_load(&h->cq_done)) != (tail = atomic_load(&h->sq_tail)))
+	{
+		atomic_fetch_add(&h->cq_waiters, 1);
+		NW_FutexWait(&h->cq_done, done);
+		atomic_fetch_sub(&h->cq_waiters, 1);
+	}
+	atomic_store(&h->cq_head, tail);
+	c->submitted = c->released = tail;
+	return 0;
+}
+
+/* NW_ShmReserve : see .h file for documentation
+ */
+char *NW_ShmReserve(struct NW_ShmClient *c, size_t length, uint64_t *offset)
+{
+	uint64_t size = c->h->data_size;
+	if (length > size)
+	{
+		errno = E2BIG;
+		return NULL;
+	}
+	uint64_t position = c->data_tail, off = position % size;
+	if (off + length > size) // not across the end of the ring
+	{
+		position += size - off;
+		off = 0;
+	}
+	if (position + length - c->data_head > size)
+	{
+		errno = EAGAIN;
+		return NULL;
+	}
+	c->data_tail = position + length;
+	*offset = off;
+	return c->data + off;
+}
+
+/* NW_ShmSubmit : see .h file for documentation
+ */
+int NW_ShmSubmit(struct NW_ShmClient *c, const struct NW_ShmRequest *r)
+{
+	uint32_t mask = c->h->entries - 1;
+	if (c->submitted - c->released == c->h->entries) // the entries of the requests not released are in use
+	{
+		errno = EAGAIN;
+		return -1;
+	}
+	uint32_t i = c->submitted++;
+	c->sq[i & mask] = *r;
+	c->data_end[i & mask] = c->data_tail;
+	c->done[i & mask] = 0;
+	c->in_flight++;
+	atomic_store_explicit(&c->h->sq_tail, c->submitted, memory_order_release);
+	if (atomic_load(&c->h->sq_waiters) > 0)
+		NW_FutexWake(&c->h->sq_tail, 1);
+	return 0;
+}
+
+/* NW_ShmReap : see .h file for documentation
+ */
+int NW_ShmReap(struct NW_ShmClient *c, struct NW_ShmCompletion *completion, int wait)
+{
+	struct NW_ShmHeader *h = c->h;
+	uint32_t mask = h->entries - 1;
+	if (c->in_flight == 0)
+		return 0;
+	uint32_t head = atomic_load(&h->cq_head);
+	struct NW_ShmCompletion *e = &c->cq[head & mask];
+	for (;;)
+	{
+		uint32_t done = atomic_load(&h->cq_done);
+		if (atomic_load_explicit(&e->seq, memory_order_acquire) == head + 1)
+			break;
+		if (!wait)
+			return 0;
+		atomic_fetch_add(&h->cq_waiters, 1);
+		if (atomic_load_explicit(&e->seq, memory_order_acquire) != head + 1)
+			NW_FutexWait(&h->cq_done, done);
+		atomic_fetch_sub(&h->cq_waiters, 1);
+	}
+	completion->user_data = e->user_data;
+	completion->index = e->index;
+	completion->distance = e->distance;
+	completion->low = e->low;
+	completion->high = e->high;
+	completion->status = e->status;
+	atomic_store(&h->cq_head, head + 1);
+	c->in_flight--;
+
+	// the data of the oldest requests completed may be reused
+	c->done[(uint32_t)completion->index & mask] = 1;
+	while (c->released != c->submitted && c->done[c->released & mask])
+	{
+		c->data_head = c->data_end[c->released & mask];
+		c->released++;
+	}
+	return 1;
+}
+
+/* NW_ShmDisconnect : see .h file for documentation
+ */
+void NW_ShmDisconnect(struct NW_ShmClient *c)
+{
+	munmap(c->map, c->map_size);
+	free(c->data_end);
+	free(c->done);
+	memset(c, 0, sizeof(*c));
+}
@@ -0,0 +1,418 @@
+/**
+ * \file shm_service.c
+ * \brief alignment service over shared memory: the server
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see shm_service.h
+ */
+
+#include "shm_service.h"
+#include "Needleman-Wunsch-recmemo.h" /* the engines */
+#include "estimate.h"				  /* NW_SHM_ESTIMATE */
+#include "batch.h"					  /* for NW_StackSize */
+#include "thread_pool.h"			  /* for NW_DefaultThreads */
+#include "metrics.h"				  /* for NW_MetricsGauge */
+#include "capture.h"				  /* for NW_CaptureJob */
+#include "scheduler.h"				  /* the requests are jobs */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>	  /* for strerror */
+#include <errno.h>
+#include <fcntl.h>	  /* for O_CREAT */
+#include <sys/mman.h> /* for shm_open and mmap */
+#include <pthread.h>
+
+/** \struct _server
+ * \brief data shared by the workers
+ */
+struct _server
+{
+	struct NW_ShmHeader *h;
+	struct NW_ShmRequest *sq;
+	struct NW_ShmCompletion *cq;
+	char *data;
+	uint32_t mask;			/*!< entries - 1 */
+	_Atomic uint64_t served; /*!< requests served */
+	struct _request *requests; /*!< entries requests */
+	struct _request **free;	   /*!< the ones not taken or completed */
+	uint32_t nfree;			   /*!< number of elements in free */
+	pthread_mutex_t lock;	   /*!< protects free */
+	pthread_cond_t freed;	   /*!< signaled when a request is completed */
+	struct NW_Capture *capture; /*!< log of the requests, or NULL */
+};
+
+/** \struct _request
+ * \brief a request taken from the SQ, job of the scheduler until its completion
+ */
+struct _request
+{
+	struct NW_Job job;			 /*!< job->arg is the request */
+	struct NW_ShmCompletion c;	 /*!< its completion */
+	struct _server *s;
+	double precision;			 /*!< NW_SHM_ESTIMATE */
+};
+
+/*
+ * static struct _request *_acquire(struct _server *s)
+ * \brief returns a free request, waiting for a completion while entries requests are not completed (the
+ * client is not trusted to keep at most entries requests in flight)
+ */
+static struct _request *_acquire(struct _server *s)
+{
+	pthread_mutex_lock(&s->lock);
+	while (s->nfree == 0)
+		pthread_cond_wait(&s->freed, &s->lock);
+	struct _request *q = s->free[--s->nfree];
+	pthread_mutex_unlock(&s->lock);
+	return q;
+}
+
+/*
+ * static void _release(struct _server *s, struct _request *q)
+ * \brief gives back a request once completed
+ */
+static void _release(struct _server *s, struct _request *q)
+{
+	pthread_mutex_lock(&s->lock);
+	s->free[s->nfree++] = q;
+	pthread_cond_signal(&s->freed);
+	pthread_mutex_unlock(&s->lock);
+}
+
+/*
+ * static int _take(struct _server *s, struct NW_ShmRequest *r, uint32_t *index)
+ * \brief takes the next request of the SQ, waiting for it; returns 0 after a shutdown, once the SQ is empty
+ */
+static int _take(struct _server *s, struct NW_ShmRequest *r, uint32_t *index)
+{
+	struct NW_ShmHeader *h = s->h;
+	for (;;)
+	{
+		uint32_t head = atomic_load(&h->sq_head);
+		uint32_t tail = atomic_load_explicit(&h->sq_tail, memory_order_acquire);
+		if (head == tail)
+		{
+			if (atomic_load(&h->shutdown))
+				return 0;
+			atomic_fetch_add(&h->sq_waiters, 1);
+			if (atomic_load(&h->sq_tail) == tail && !atomic_load(&h->shutdown))
+				NW_FutexWait(&h->sq_tail, tail);
+			atomic_fetch_sub(&h->sq_waiters, 1);
+			continue;
+		}
+		*r = s->sq[head & s->mask]; // the client does not overwrite it before head moves
+		if (atomic_compare_exchange_weak(&h->sq_head, &head, head + 1))
+		{
+			*index = head;
+			return 1;
+		}
+	}
+}
+
+/*
+ * static void _complete(struct _server *s, const struct NW_ShmCompletion *c)
+ * \brief publishes a completion in the CQ and wakes the client if it waits
+ */
+static void _complete(struct _server *s, const struct NW_ShmCompletion *c)
+{
+	struct NW_ShmHeader *h = s->h;
+	uint32_t slot = atomic_fetch_add(&h->cq_tail, 1);
+	struct NW_ShmCompletion *e = &s->cq[slot & s->mask];
+	e->user_data = c->user_data;
+	e->index = c->index;
+	e->distance = c->distance;
+	e->low = c->low;
+	e->high = c->high;
+	e->status = c->status;
+	atomic_store_explicit(&e->seq, slot + 1, memory_order_release);
+	atomic_fetch_add(&h->cq_done, 1);
+	if (atomic_load(&h->cq_waiters) > 0)
+		NW_FutexWake(&h->cq_done, INT_MAX);
+}
+
+/*
+ * static int _check(const struct _server *s, uint64_t offset, uint64_t length)
+ * \brief returns 0 if the sequence is in the data ring, -EINVAL if not, -E2BIG if it is too long
+ */
+static int _check(const struct _server *s, uint64_t offset, uint64_t length)
+{
+	if (offset > s->h->data_size || length > s->h->data_size - offset)
+		return -EINVAL;
+	return (length > s->h->max_length) ? -E2BIG : 0;
+}
+
+/*
+ * static void _estimate(struct NW_Job *job)
+ * \brief computes a NW_SHM_ESTIMATE request
+ */
+static void _estimate(struct NW_Job *job)
+{
+	struct _request *q = (struct _request *)job->arg;
+	struct NW_EstimateParams params = {0, (q->precision > 0) ? q->precision : 0.05, 1, 1, job->engine};
+	struct NW_EstimateResult res;
+	NW_Estimate((char *)job->A, job->lengthA, (char *)job->B, job->lengthB, &params, &res);
+	job->distance = (long)(res.distance + 0.5);
+	q->c.low = (int64_t)(res.low + 0.5);
+	q->c.high = (int64_t)(res.high + 0.5);
+}
+
+/*
+ * static void _done(struct NW_Job *job)
+ * \brief completes a request computed by the scheduler
+ */
+static void _done(struct NW_Job *job)
+{
+	struct _request *q = (struct _request *)job->arg;
+	struct _server *s = q->s; // q may be reused once completed
+	q->c.distance = job->distance;
+	if (job->run == NULL)
+		q->c.low = q->c.high = job->distance;
+	q->c.status = -job->status;
+	if (job->status != 0)
+		q->c.distance = q->c.low = q->c.high = -1;
+	if (s->capture != NULL) // the sequences are in the ring until the completion
+		NW_CaptureJob(s->capture, job, (job->run == NULL) ? NW_SHM_DISTANCE : NW_SHM_ESTIMATE, q->precision);
+	atomic_fetch_add(&s->served, 1);
+	_complete(s, &q->c);
+	_release(s, q);
+}
+
+/*
+ * static void _serve(struct _server *s, struct NW_Scheduler *scheduler, struct _request *q, const struct NW_ShmRequest *r, uint32_t index)
+ * \brief checks a request and submits it to the scheduler as q (or completes it at once); the engines read
+ * the sequences in the data ring
+ */
+static void _serve(struct _server *s, struct NW_Scheduler *scheduler, struct _request *q, const struct NW_ShmRequest *r,
+				   uint32_t index)
+{
+	struct NW_ShmCompletion *c = &q->c;
+	c->user_data = r->user_data;
+	c->index = index;
+	c->distance = c->low = c->high = -1;
+	c->status = 0;
+	if (r->mode == NW_SHM_SHUTDOWN)
+	{
+		atomic_store(&s->h->shutdown, 1); // _take returns 0 once the SQ is empty
+		c->distance = c->low = c->high = 0;
+		_complete(s, c);
+		_release(s, q);
+		atomic_fetch_add(&s->served, 1);
+		return;
+	}
+	if (r->mode > NW_SHM_SHUTDOWN || r->engine >= NW_ENGINE_COUNT)
+		c->status = -EINVAL;
+	else if ((c->status = _check(s, r->offsetA, r->lengthA)) == 0)
+		c->status = _check(s, r->offsetB, r->lengthB);
+	if (c->status != 0)
+	{
+		_complete(s, c);
+		_release(s, q);
+		atomic_fetch_add(&s->served, 1);
+		return;
+	}
+
+	struct NW_Job *job = &q->job;
+	memset(job, 0, sizeof(*job));
+	job->A = s->data + r->offsetA;
+	job->lengthA = r->lengthA;
+	job->B = s->data + r->offsetB;
+	job->lengthB = r->lengthB;
+	job->engine = (enum NW_Engine)r->engine;
+	job->priority = r->priority;
+	job->deadline = (r->deadline_ms == 0) ? 0 : NW_Now() + 1e-3 * r->deadline_ms;
+	job->run = (r->mode == NW_SHM_ESTIMATE) ? _estimate : NULL;
+	job->peak = (r->mode == NW_SHM_ESTIMATE) ? 16 * (r->lengthA + r->lengthB) : 0; // k-mer index of B, windows
+	job->done = _done;
+	job->arg = q;
+	q->s = s;
+	q->precision = r->precision;
+	NW_SchedulerSubmit(scheduler, job);
+}
+
+/*
+ * static double _queue_depth(void *arg)
+ * \brief gauge nw_shm_queue_depth: requests submitted and not taken by a worker
+ */
+static double _queue_depth(void *arg)
+{
+	struct NW_ShmHeader *h = ((struct _server *)arg)->h;
+	return (double)(uint32_t)(atomic_load(&h->sq_tail) - atomic_load(&h->sq_head));
+}
+
+/*
+ * static double _in_flight(void *arg)
+ * \brief gauge nw_shm_in_flight: requests taken by a worker and not completed
+ */
+static double _in_flight(void *arg)
+{
+	struct NW_ShmHeader *h = ((struct _server *)arg)->h;
+	return (double)(uint32_t)(atomic_load(&h->sq_head) - atomic_load(&h->cq_done));
+}
+
+/*
+ * static double _memory_reserved(void *arg)
+ * \brief gauge nw_memory_reserved_bytes: memory reserved by the requests in progress
+ */
+static double _memory_reserved(void *arg)
+{
+	size_t reserved, waiting;
+	NW_SchedulerMemory((struct NW_Scheduler *)arg, &reserved, &waiting);
+	return (double)reserved;
+}
+
+/*
+ * static double _active_workers(void *arg)
+ * \brief gauge nw_active_workers: workers allowed to take requests by the concurrency controller
+ */
+static double _active_workers(void *arg)
+{
+	int active;
+	NW_SchedulerConcurrency((struct NW_Scheduler *)arg, &active, NULL);
+	return (double)active;
+}
+
+/*
+ * static double _memory_waiting(void *arg)
+ * \brief gauge nw_memory_waiting_bytes: memory needed by the requests waiting for it
+ */
+static double _memory_waiting(void *arg)
+{
+	size_t reserved, waiting;
+	NW_SchedulerMemory((struct NW_Scheduler *)arg, &reserved, &waiting);
+	return (double)waiting;
+}
+
+/* NW_ShmServe : see .h file for documentation
+ */
+int NW_ShmServe(const char *name, const struct NW_ShmParams *params)
+{
+	size_t data_size = (params->data_size == 0) ? NW_SHM_DATA : params->data_size;
+	size_t max_length = (params->max_length == 0) ? NW_SHM_MAX_LENGTH : params->max_length;
+	uint32_t entries = 1;
+	while (entries < ((params->entries == 0) ? NW_SHM_ENTRIES : params->entries))
+		entries *= 2;
+	int nthreads = (params->nthreads <= 0) ? NW_DefaultThreads() : params->nthreads;
+
+	// header, SQ, CQ, then the data ring on a page boundary
+	uint64_t sq_offset = (sizeof(struct NW_ShmHeader) + 63) & ~(uint64_t)63;
+	uint64_t cq_offset = (sq_offset + entries * sizeof(struct NW_ShmRequest) + 63) & ~(uint64_t)63;
+	uint64_t data_offset = (cq_offset + entries * sizeof(struct NW_ShmCompletion) + 4095) & ~(uint64_t)4095;
+	size_t size = data_offset + data_size;
+
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0)
+	{
+		fprintf(stderr, "Error: shm_open %s: %s (remove /dev/shm%s if no server runs).\n", name, strerror(errno), name);
+		return EXIT_FAILURE;
+	}
+	void *map = MAP_FAILED;
+	if (ftruncate(fd, (off_t)size) == 0)
+		map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+	{
+		fprintf(stderr, "Error: mapping %zu bytes of %s: %s.\n", size, name, strerror(errno));
+		shm_unlink(name);
+		return EXIT_FAILURE;
+	}
+
+	struct NW_ShmHeader *h = (struct NW_ShmHeader *)map; // zeroed by ftruncate
+	h->version = NW_SHM_VERSION;
+	h->entries = entries;
+	h->max_length = (uint32_t)((max_length > UINT32_MAX) ? UINT32_MAX : max_length);
+	h->sq_offset = sq_offset;
+	h->cq_offset = cq_offset;
+	h->data_offset = data_offset;
+	h->data_size = data_size;
+	atomic_thread_fence(memory_order_release);
+	h->magic = NW_SHM_MAGIC;
+
+	struct _server s;
+	s.h = h;
+	s.sq = (struct NW_ShmRequest *)((char *)map + sq_offset);
+	s.cq = (struct NW_ShmCompletion *)((char *)map + cq_offset);
+	s.data = (char *)map + data_offset;
+	s.mask = entries - 1;
+	atomic_init(&s.served, 0);
+	s.capture = NULL;
+	if (params->capture != NULL && (s.capture = NW_CaptureOpen(params->capture, params->cache)) == NULL)
+	{
+		munmap(map, size);
+		shm_unlink(name);
+		return EXIT_FAILURE;
+	}
+	if (params->metrics != NULL)
+	{
+		NW_MetricsGauge("nw_shm_queue_depth", "Requests submitted and not taken by a worker.", _queue_depth, &s);
+		NW_MetricsGauge("nw_shm_in_flight", "Requests taken by a worker and not completed.", _in_flight, &s);
+		if (NW_MetricsListen(params->metrics) != 0)
+		{
+			NW_MetricsUnregister(&s);
+			if (s.capture != NULL)
+				NW_CaptureClose(s.capture);
+			munmap(map, size);
+			shm_unlink(name);
+			return EXIT_FAILURE;
+		}
+	}
+	fprintf(stderr, "serving %s: %zu bytes of data, %u entries, %d workers\n", name, data_size, entries, nthreads);
+
+	s.requests = (struct _request *)malloc(entries * sizeof(struct _request));
+	s.free = (struct _request **)malloc(entries * sizeof(struct _request *));
+	if (s.requests == NULL || s.free == NULL)
+	{
+		perror("NW_ShmServe: malloc of the requests");
+		exit(EXIT_FAILURE);
+	}
+	for (uint32_t k = 0; k < entries; ++k)
+		s.free[k] = &s.requests[entries - 1 - k];
+	s.nfree = entries;
+	pthread_mutex_init(&s.lock, NULL);
+	pthread_cond_init(&s.freed, NULL);
+	struct NW_SchedParams sched = {nthreads, params->reserved, 0, params->split, 0,
+								   NW_StackSize(h->max_length, h->max_length), params->memory, params->adapt};
+	struct NW_Scheduler *scheduler = NW_SchedulerCreate(&sched);
+	if (params->metrics != NULL)
+	{
+		NW_MetricsGauge("nw_memory_reserved_bytes", "Memory reserved by the requests in progress.", _memory_reserved,
+						scheduler);
+		NW_MetricsGauge("nw_memory_waiting_bytes", "Memory needed by the requests waiting for it.", _memory_waiting,
+						scheduler);
+		NW_MetricsGauge("nw_active_workers", "Workers allowed to take requests.", _active_workers, scheduler);
+	}
+	struct NW_ShmRequest r;
+	uint32_t index;
+	for (;;) // the calling thread dispatches the requests
+	{
+		struct _request *q = _acquire(&s); // before the request is taken from the SQ
+		if (!_take(&s, &r, &index))
+		{
+			_release(&s, q);
+			break;
+		}
+		_serve(&s, scheduler, q, &r, index);
+	}
+	NW_MetricsUnregister(scheduler);
+	if (params->adapt > 0)
+	{
+		double rate;
+		NW_SchedulerWait(scheduler);
+		int chosen = NW_SchedulerConcurrency(scheduler, NULL, &rate);
+		fprintf(stderr, "%s: concurrency %d of %d workers (%.3g cells/s)\n", name, chosen, nthreads, rate);
+	}
+	NW_SchedulerDestroy(scheduler);
+	pthread_mutex_destroy(&s.lock);
+	pthread_cond_destroy(&s.freed);
+	free(s.free);
+	free(s.requests);
+	if (s.capture != NULL)
+		NW_CaptureClose(s.capture);
+
+	fprintf(stderr, "%s: %lu requests served\n", name, (unsigned long)atomic_load(&s.served));
+	NW_MetricsUnregister(&s);
+	munmap(map, size);
+	shm_unlink(name);
+	return 0;
+}
@@ -0,0 +1,241 @@
+/**
+ * \file shm_service.h
+ * \brief alignment service over shared memory: zero-copy transport for local clients
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * The server (distanceEdition --serve-shm name) creates the POSIX shared memory object /name holding
+ * a header, a submission queue (SQ), a completion queue (CQ) and a data ring. The client writes its
+ * sequences in the data ring, pushes descriptors (offsets and lengths in the ring, engine, mode) in the SQ
+ * and pops the results from the CQ; the engines of the server read the sequences in the ring, without copy.
+ *
+ * Both queues are lock-free rings of 32 bits counters: the SQ has one producer (the client) and several
+ * consumers (the workers of the server, which take an entry with a compare and swap on sq_head); the CQ has
+ * several producers (the workers reserve an entry with a fetch and add on cq_tail, then publish it by its
+ * sequence number) and one consumer (the client). A side waits on an empty queue with a futex on the counter
+ * of the other side, which wakes it only if it announced itself in the waiters count.
+ *
+ * The server takes the requests in the order of the SQ and hands them out to a scheduler (cf scheduler.h):
+ * the requests are computed by size class, priority and deadline, and completed in any order.
+ *
+ * A client keeps at most <entries> requests in flight (NW_ShmSubmit fails with EAGAIN beyond), so that
+ * neither queue can overflow, and does not overwrite the data of a request before its completion
+ * (NW_ShmReserve only returns the space of the requests completed, as well as all the previous ones).
+ * The server does not rely on it: it stops taking requests from the SQ while <entries> requests taken are
+ * not completed, so that a client submitting faster than it reaps only stalls its own SQ.
+ */
+
+#ifndef __SHM_SERVICE_H__
+#define __SHM_SERVICE_H__
+
+#include <stdlib.h>		  /* for size_t */
+#include <stdint.h>		  /* for uint32_t and uint64_t */
+#include <stdatomic.h>	  /* for the counters of the queues */
+#include <limits.h>		  /* for INT_MAX */
+#include <unistd.h>		  /* for syscall */
+#include <sys/syscall.h>  /* for SYS_futex */
+#include <linux/futex.h>  /* for FUTEX_WAIT and FUTEX_WAKE */
+
+/** \def NW_SHM_MAGIC
+ *  \brief first word of the shared memory object ("NWSM")
+ */
+#define NW_SHM_MAGIC 0x4d53574eu
+
+/** \def NW_SHM_VERSION
+ *  \brief version of the layout of the shared memory object
+ */
+#define NW_SHM_VERSION 2
+
+/** \def NW_SHM_ENTRIES
+ *  \brief default number of entries of the queues (a power of 2)
+ */
+#define NW_SHM_ENTRIES 256
+
+/** \def NW_SHM_DATA
+ *  \brief default size of the data ring in bytes
+ */
+#define NW_SHM_DATA (256UL << 20)
+
+/** \def NW_SHM_MAX_LENGTH
+ *  \brief default maximal length of a sequence (the stacks of the workers are sized for it)
+ */
+#define NW_SHM_MAX_LENGTH (1UL << 22)
+
+/** \enum NW_ShmMode
+ * \brief what a request computes
+ */
+enum NW_ShmMode
+{
+	NW_SHM_DISTANCE = 0, /*!< EditDistance_NW */
+	NW_SHM_ESTIMATE,	 /*!< NW_Estimate (distance, low and high) */
+	NW_SHM_SHUTDOWN		 /*!< the server stops once the queued requests are served */
+};
+
+/** \struct NW_ShmRequest
+ * \brief entry of the submission queue
+ */
+struct NW_ShmRequest
+{
+	uint64_t user_data;			/*!< copied in the completion */
+	uint64_t offsetA, lengthA;	/*!< first sequence: data[offsetA .. offsetA + lengthA - 1] */
+	uint64_t offsetB, lengthB;	/*!< second sequence */
+	uint32_t engine;			/*!< enum NW_Engine */
+	uint32_t mode;				/*!< enum NW_ShmMode */
+	double precision;			/*!< NW_SHM_ESTIMATE: precision (0 for 0.05) */
+	int32_t priority;			/*!< the highest priorities are computed first (cf scheduler.h) */
+	uint32_t deadline_ms;		/*!< milliseconds after which the request is not started (0: none) */
+};
+
+/** \struct NW_ShmCompletion
+ * \brief entry of the completion queue
+ */
+struct NW_ShmCompletion
+{
+	uint64_t user_data;	 /*!< of the request */
+	uint64_t index;		 /*!< number of the request in the submission queue */
+	int64_t distance;	 /*!< the distance (or the estimate) */
+	int64_t low, high;	 /*!< NW_SHM_ESTIMATE: the 95% confidence interval, else distance */
+	int32_t status;		 /*!< 0, or -errno (EINVAL: bad descriptor, E2BIG: sequence too long, ETIMEDOUT: deadline
+							  passed, ENOMEM: larger than the memory budget of the server) */
+	_Atomic uint32_t seq; /*!< the entry of position p of the queue is published when seq = p + 1 */
+};
+
+/** \struct NW_ShmHeader
+ * \brief beginning of the shared memory object; the counters written by different sides are in
+ * different cache lines
+ */
+struct NW_ShmHeader
+{
+	uint32_t magic, version;
+	uint32_t entries;			   /*!< entries of each queue */
+	uint32_t max_length;		   /*!< maximal length of a sequence */
+	uint64_t sq_offset, cq_offset; /*!< offsets of the queues in the object */
+	uint64_t data_offset, data_size;
+	_Alignas(64) _Atomic uint32_t sq_tail; /*!< written by the client (futex of the workers) */
+	_Atomic uint32_t sq_waiters;		   /*!< workers waiting on sq_tail */
+	_Alignas(64) _Atomic uint32_t sq_head; /*!< taken by the workers */
+	_Alignas(64) _Atomic uint32_t cq_tail; /*!< reserved by the workers */
+	_Alignas(64) _Atomic uint32_t cq_done; /*!< completions published (futex of the client) */
+	_Atomic uint32_t cq_waiters;		   /*!< clients waiting on cq_done */
+	_Alignas(64) _Atomic uint32_t cq_head; /*!< consumed by the client */
+	_Atomic uint32_t shutdown;			   /*!< 1 once a NW_SHM_SHUTDOWN request was taken */
+};
+
+/*
+ * static inline void NW_FutexWait(_Atomic uint32_t *word, uint32_t value)
+ * \brief sleeps while *word == value (or until a signal); the futex is shared between processes
+ */
+static inline void NW_FutexWait(_Atomic uint32_t *word, uint32_t value)
+{
+	syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT, value, NULL, NULL, 0);
+}
+
+/*
+ * static inline void NW_FutexWake(_Atomic uint32_t *word, int n)
+ * \brief wakes up to n waiters of *word
+ */
+static inline void NW_FutexWake(_Atomic uint32_t *word, int n)
+{
+	syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE, n, NULL, NULL, 0);
+}
+
+/*********************************************************************
+ * Server
+ */
+
+/** \struct NW_ShmParams
+ * \brief parameters of NW_ShmServe
+ */
+struct NW_ShmParams
+{
+	size_t data_size;  /*!< size of the data ring (0 for NW_SHM_DATA) */
+	unsigned entries;  /*!< entries of each queue, rounded up to a power of 2 (0 for NW_SHM_ENTRIES) */
+	int nthreads;	   /*!< number of workers (if <= 0: the number of online processors) */
+	int reserved;	   /*!< workers reserved to the small requests (cf struct NW_SchedParams) */
+	double split;	   /*!< cells from which a request is computed by tiles (cf struct NW_SchedParams) */
+	size_t memory;	   /*!< budget of memory of the requests in progress (cf struct NW_SchedParams) */
+	size_t max_length; /*!< maximal length of a sequence (0 for NW_SHM_MAX_LENGTH) */
+	const char *metrics; /*!< address of the metrics endpoint (cf NW_MetricsListen), or NULL */
+	const char *capture; /*!< log in which the requests are captured (cf capture.h), or NULL */
+	const char *cache;	 /*!< directory in which the captured sequences are written, or NULL */
+	double adapt;		 /*!< period of the concurrency controller (cf struct NW_SchedParams), 0 for none */
+};
+
+/**
+ * \fn int NW_ShmServe(const char *name, const struct NW_ShmParams *params);
+ * \brief creates the shared memory object /name and serves its requests until a NW_SHM_SHUTDOWN request
+ * \return : 0 on success, >0 (with a message on stderr) if the object cannot be created
+ *
+ * The object is removed on return. With a metrics endpoint, the gauges nw_shm_queue_depth (requests
+ * submitted and not taken) and nw_shm_in_flight (requests taken, queued in the scheduler or computed) are exported besides
+ * the counters of the jobs, as well as nw_memory_reserved_bytes and nw_memory_waiting_bytes (cf
+ * NW_SchedulerMemory), and nw_active_workers (cf NW_SchedulerConcurrency). With a capture log, each request computed is logged (cf capture.h), before its
+ * completion is published.
+ */
+int NW_ShmServe(const char *name, const struct NW_ShmParams *params);
+
+/*********************************************************************
+ * Client (shm_client.c)
+ */
+
+/** \struct NW_ShmClient
+ * \brief connection of a client to a server
+ */
+struct NW_ShmClient
+{
+	void *map;			   /*!< the shared memory object */
+	size_t map_size;
+	struct NW_ShmHeader *h;
+	struct NW_ShmRequest *sq;
+	struct NW_ShmCompletion *cq;
+	char *data;			   /*!< the data ring */
+	uint64_t data_head;	   /*!< positions (not reduced modulo data_size) of the data in use */
+	uint64_t data_tail;
+	uint64_t *data_end;	   /*!< data_tail when the request of index i was submitted, at i % entries */
+	unsigned char *done;   /*!< 1 once the request of index i is completed, at i % entries */
+	uint32_t submitted;	   /*!< requests submitted */
+	uint32_t released;	   /*!< first request whose data may be in use */
+	uint32_t in_flight;	   /*!< requests submitted and not reaped */
+};
+
+/**
+ * \fn int NW_ShmConnect(struct NW_ShmClient *c, const char *name);
+ * \brief connects to the server of the shared memory object /name
+ * \return : 0 on success, -1 (and errno) on failure
+ *
+ * A server has one client at a time: the completions of the requests of a previous client (eg killed
+ * before reaping them) are awaited and discarded.
+ */
+int NW_ShmConnect(struct NW_ShmClient *c, const char *name);
+
+/**
+ * \fn char *NW_ShmReserve(struct NW_ShmClient *c, size_t length, uint64_t *offset);
+ * \brief reserves length contiguous bytes of the data ring, to be used by the next request submitted
+ * \param offset : set to the offset of the space in the data ring (for the descriptor of the request)
+ * \return : the address of the space, where the client writes its sequence, or NULL (and errno) if
+ *           the space is still used by requests in flight (EAGAIN: reap some) or if length is larger than the ring (E2BIG)
+ */
+char *NW_ShmReserve(struct NW_ShmClient *c, size_t length, uint64_t *offset);
+
+/**
+ * \fn int NW_ShmSubmit(struct NW_ShmClient *c, const struct NW_ShmRequest *r);
+ * \brief submits a request whose sequences were written in the space reserved since the previous submission
+ * \return : 0 on success, -1 and errno = EAGAIN if entries requests are in flight, or completed after
+ *           a request still in flight (reap some)
+ */
+int NW_ShmSubmit(struct NW_ShmClient *c, const struct NW_ShmRequest *r);
+
+/**
+ * \fn int NW_ShmReap(struct NW_ShmClient *c, struct NW_ShmCompletion *completion, int wait);
+ * \brief pops a completion (in completion order), waiting for it if wait
+ * \return : 1 if a completion was popped, 0 if none is available (or no request is in flight)
+ */
+int NW_ShmReap(struct NW_ShmClient *c, struct NW_ShmCompletion *completion, int wait);
+
+/**
+ * \fn void NW_ShmDisconnect(struct NW_ShmClient *c);
+ * \brief unmaps the shared memory object
+ */
+void NW_ShmDisconnect(struct NW_ShmClient *c);
+
+#endif /* __SHM_SERVICE_H__ */
@@ -0,0 +1,328 @@
+/**
+ * \file stream_banded.c
+ * \brief banded edit distance of two streams (pipes, sockets) in bounded memory
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see stream_banded.h
+ */
+
+#include "stream_banded.h"
+#include "async_read.h" /* reads in flight of the regular files */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> /* for memmove */
+#include <limits.h> /* for LONG_MAX */
+#include <err.h>
+#include <unistd.h>	  /* for lseek */
+#include <sys/stat.h> /* for fstat */
+
+#include "characters_to_base.h"		  /* mapping from char to base */
+#include "Needleman-Wunsch-recmemo.h" /* for INSERTION_COST and SUBSTITUTION_COST */
+
+/** \def _INF
+ *  \brief value of the cells out of the band (may be incremented without overflow)
+ */
+#define _INF (LONG_MAX / 4)
+
+/** \struct _memory
+ * \brief bytes allocated
+ */
+struct _memory
+{
+	size_t current, peak;
+};
+
+/*
+ * static void *_realloc(struct _memory *m, void *p, size_t old_size, size_t size)
+ * \brief realloc accounted in m
+ */
+static void *_realloc(struct _memory *m, void *p, size_t old_size, size_t size)
+{
+	p = realloc(p, size);
+	if (p == NULL)
+	{
+		perror("NW_StreamBanded: realloc");
+		exit(EXIT_FAILURE);
+	}
+	m->current += size - old_size;
+	if (m->current > m->peak)
+		m->peak = m->current;
+	return p;
+}
+
+/** \struct _stream
+ * \brief the bases of a stream, from the index base to base + length - 1
+ */
+struct _stream
+{
+	FILE *f;
+	struct NW_Reader *reader; /*!< for a regular file: the next chunks are read while this one is aligned */
+	char *raw;		   /*!< chunk read (without reader) */
+	size_t chunk;	   /*!< size of raw */
+	char *buf;		   /*!< buf[k] is the base of index base + k */
+	size_t cap;		   /*!< size of buf */
+	size_t base, len;  /*!< indexes of the bases in buf */
+	size_t keep;	   /*!< the bases before keep may be discarded */
+	int eof;		   /*!< 1 at the end of the stream: base + len bases were read */
+	int line_start;	   /*!< 1 if the next char starts a line */
+	int header;		   /*!< 1 in a line starting by '>' */
+	struct _memory *m;
+};
+
+/*
+ * static void _refill(struct _stream *s)
+ * \brief discards the bases before s->keep and appends the bases of the next chunk
+ */
+static void _refill(struct _stream *s)
+{
+	if (s->keep > s->base)
+	{
+		size_t shift = s->keep - s->base;
+		if (shift > s->len)
+			shift = s->len;
+		memmove(s->buf, s->buf + shift, s->len - shift);
+		s->base += shift;
+		s->len -= shift;
+	}
+	if (s->cap - s->len < s->chunk)
+	{
+		s->buf = (char *)_realloc(s->m, s->buf, s->cap, s->len + s->chunk);
+		s->cap = s->len + s->chunk;
+	}
+	const char *raw = s->raw;
+	size_t n = (s->reader != NULL) ? NW_ReaderNext(s->reader, &raw) : fread(s->raw, 1, s->chunk, s->f);
+	if (n == 0)
+	{
+		if (s->reader == NULL && ferror(s->f))
+			err(1, "NW_StreamBanded: fread");
+		s->eof = 1;
+		return;
+	}
+	for (size_t k = 0; k < n; ++k)
+	{
+		char c = raw[k];
+		if (s->line_start)
+			s->header = (c == '>');
+		s->line_start = (c == '\n');
+		if (!s->header && isBase(c))
+			s->buf[s->len++] = c;
+	}
+}
+
+/*
+ * static int _ensure(struct _stream *s, size_t index)
+ * \brief reads the stream until its base of index index; returns 0 if the stream is shorter
+ */
+static int _ensure(struct _stream *s, size_t index)
+{
+	while (s->base + s->len <= index)
+	{
+		if (s->eof)
+			return 0;
+		_refill(s);
+	}
+	return 1;
+}
+
+/*
+ * static void _stream_open(struct _stream *s, FILE *f, size_t chunk, struct _memory *m)
+ * \brief sets s to read f by chunks: with a NW_Reader of NW_READER_DEPTH chunks if f is a regular file, else
+ * with fread
+ */
+static void _stream_open(struct _stream *s, FILE *f, size_t chunk, struct _memory *m)
+{
+	memset(s, 0, sizeof(struct _stream));
+	s->f = f;
+	s->chunk = chunk;
+	s->line_start = 1;
+	s->m = m;
+	struct stat st;
+	off_t position = lseek(fileno(f), 0, SEEK_CUR);
+	if (fstat(fileno(f), &st) == 0 && S_ISREG(st.st_mode) && position >= 0)
+	{
+		struct NW_ReaderParams params = {chunk, NW_READER_DEPTH, NW_READER_AUTO};
+		s->reader = NW_ReaderOpen(fileno(f), position, st.st_size - position, &params);
+		m->current += NW_READER_DEPTH * chunk;
+	}
+	else
+		s->raw = (char *)_realloc(m, NULL, 0, chunk);
+	if (m->current > m->peak)
+		m->peak = m->current;
+}
+
+/** \struct _envelope
+ * \brief edge cells (e = i - j, v = D[i][j]) from which a path may leave the band, sorted by e; none is
+ * dominated by another one (v >= v' + INSERTION_COST |e - e'|)
+ */
+struct _envelope
+{
+	long *e, *v;
+	size_t n, cap;
+	struct _memory *m;
+};
+
+/*
+ * static long _envelope_min(const struct _envelope *en, long delta)
+ * \brief lower bound of the cost of a path to the cell (M, N) through one of the cells of en, with delta = M - N
+ */
+static long _envelope_min(const struct _envelope *en, long delta)
+{
+	long best = _INF;
+	for (size_t p = 0; p < en->n; ++p)
+	{
+		long c = en->v[p] + INSERTION_COST * labs(delta - en->e[p]);
+		if (c < best)
+			best = c;
+	}
+	return best;
+}
+
+/*
+ * static void _envelope_add(struct _envelope *en, long e, long v)
+ * \brief adds the cell (e, v) to en unless it is dominated, and removes the cells it dominates
+ */
+static void _envelope_add(struct _envelope *en, long e, long v)
+{
+	size_t p = 0, q = en->n; // first cell with en->e[p] >= e
+	while (p < q)
+	{
+		size_t h = (p + q) / 2;
+		if (en->e[h] < e)
+			p = h + 1;
+		else
+			q = h;
+	}
+	// the nearest cells on each side dominate the farther ones
+	if ((p > 0 && en->v[p - 1] + INSERTION_COST * (e - en->e[p - 1]) <= v) ||
+		(p < en->n && en->v[p] + INSERTION_COST * (en->e[p] - e) <= v))
+		return;
+	size_t first = p, last = p;
+	while (first > 0 && en->v[first - 1] >= v + INSERTION_COST * (e - en->e[first - 1]))
+		--first;
+	while (last < en->n && en->v[last] >= v + INSERTION_COST * (en->e[last] - e))
+		++last;
+	if (first == last && en->n == en->cap)
+	{
+		size_t cap = (en->cap == 0) ? 64 : 2 * en->cap;
+		en->e = (long *)_realloc(en->m, en->e, en->cap * sizeof(long), cap * sizeof(long));
+		en->v = (long *)_realloc(en->m, en->v, en->cap * sizeof(long), cap * sizeof(long));
+		en->cap = cap;
+	}
+	// the cells first .. last - 1 are replaced by (e, v)
+	memmove(en->e + first + 1, en->e + last, (en->n - last) * sizeof(long));
+	memmove(en->v + first + 1, en->v + last, (en->n - last) * sizeof(long));
+	en->e[first] = e;
+	en->v[first] = v;
+	en->n += first + 1 - last;
+}
+
+/* NW_StreamBanded : see .h file for documentation
+ */
+long NW_StreamBanded(FILE *A, FILE *B, const struct NW_StreamParams *params, struct NW_StreamResult *result)
+{
+	long W = (params->band == 0) ? NW_STREAM_BAND : (long)params->band;
+	size_t chunk = (params->chunk == 0) ? NW_STREAM_CHUNK : params->chunk;
+	struct _memory m = {0, 0};
+	struct _stream sa, sb;
+	_stream_open(&sa, A, chunk, &m);
+	_stream_open(&sb, B, chunk, &m);
+
+	// three anti-diagonals: d[1 + t] is the cell i = lo + t, d[0] and d[W + 1] stay _INF
+	long *d = (long *)_realloc(&m, NULL, 0, 3 * (W + 2) * sizeof(long));
+	for (long t = 0; t < 3 * (W + 2); ++t)
+		d[t] = _INF;
+	long *prev2 = d, *prev1 = d + (W + 2), *cur = d + 2 * (W + 2);
+	long lo2 = 0, lo1 = 0, best_t = 0;
+	prev1[1] = 0; // D[0][0] on the anti-diagonal 0
+	result->constrained = 0;
+	struct _envelope edges = {NULL, NULL, 0, 0, &m};
+
+	long M = -1, N = -1; // unknown until the end of the streams
+	for (long k = 0;; ++k)
+	{
+		// prev1 is the anti-diagonal k; reads the bases of the anti-diagonal k + 1
+		if (M < 0 && !_ensure(&sa, (size_t)(lo1 + W - 1)))
+			M = (long)(sa.base + sa.len);
+		if (N < 0 && !_ensure(&sb, (size_t)(k - lo1)))
+			N = (long)(sb.base + sb.len);
+		if (M >= 0 && N >= 0 && k == M + N)
+		{
+			result->distance = prev1[1 + M - lo1];
+			result->lengthA = (size_t)M;
+			result->lengthB = (size_t)N;
+			// a path leaving the band costs at least the value of its last cell in the band plus an insertion
+			// per unit of difference of the remaining lengths
+			result->constrained = (_envelope_min(&edges, M - N) < result->distance);
+			break;
+		}
+		sa.keep = (lo1 > 0) ? (size_t)(lo1 - 1) : 0;
+		sb.keep = (k - lo1 - W > 0) ? (size_t)(k - lo1 - W) : 0;
+
+		// the band moves down if its best cell is in its lower half, but stays in the matrix
+		long kn = k + 1, lo = lo1 + (2 * best_t >= W);
+		if (M >= 0 && lo > M)
+			lo = M;
+		if (N >= 0 && lo + W - 1 < kn - N)
+			lo = kn - N - W + 1;
+
+		long best = _INF;
+		best_t = 0;
+		for (long t = 0; t < W; ++t)
+		{
+			long i = lo + t, j = kn - i, v;
+			if (j < 0 || (M >= 0 && i > M) || (N >= 0 && j > N))
+				v = _INF;
+			else if (i == 0)
+				v = INSERTION_COST * j;
+			else if (j == 0)
+				v = INSERTION_COST * i;
+			else
+			{
+				char x = sa.buf[i - 1 - (long)sa.base], y = sb.buf[j - 1 - (long)sb.base];
+				long up = prev1[i - lo1], left = prev1[1 + i - lo1], diag = prev2[i - lo2];
+				v = ((up < left) ? up : left) + INSERTION_COST;
+				diag += isSameBase(x, y) ? 0 : SUBSTITUTION_COST;
+				if (diag < v)
+					v = diag;
+			}
+			cur[1 + t] = v;
+			if (v < best)
+			{
+				best = v;
+				best_t = t;
+			}
+		}
+		// the cells of the previous anti-diagonals with a neighbour of the matrix left out of this one: the
+		// right or down neighbours of k, the diagonal neighbours of k - 1
+		for (long i = lo1; i < lo1 + W; ++i)
+			if (prev1[1 + i - lo1] < _INF &&
+				((i < lo && (N < 0 || k - i < N)) || (i >= lo + W - 1 && (M < 0 || i < M))))
+				_envelope_add(&edges, 2 * i - k, prev1[1 + i - lo1]);
+		for (long i = lo2; i < lo2 + W; ++i)
+			if (prev2[1 + i - lo2] < _INF && (i + 1 < lo || i + 1 > lo + W - 1) && (M < 0 || i < M) &&
+				(N < 0 || k - 1 - i < N))
+				_envelope_add(&edges, 2 * i - (k - 1), prev2[1 + i - lo2]);
+
+		long *tmp = prev2;
+		prev2 = prev1;
+		prev1 = cur;
+		cur = tmp;
+		lo2 = lo1;
+		lo1 = lo;
+	}
+	result->peak_bytes = m.peak;
+	free(d);
+	free(edges.e);
+	free(edges.v);
+	free(sa.raw);
+	free(sb.raw);
+	if (sa.reader != NULL)
+		NW_ReaderClose(sa.reader);
+	if (sb.reader != NULL)
+		NW_ReaderClose(sb.reader);
+	free(sa.buf);
+	free(sb.buf);
+	return result->distance;
+}
@@ -0,0 +1,73 @@
+/**
+ * \file stream_banded.h
+ * \brief banded edit distance of two streams (pipes, sockets) in bounded memory
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * The two inputs are read by chunks and only the bases are kept (the chars that are not bases and the
+ * lines starting by '>' are skipped, as in the other engines). D is computed by anti-diagonals i + j = k,
+ * each restricted to a band of <band> cells: after each anti-diagonal the band moves one cell down if
+ * its best cell is in its lower half, else one cell right (adaptive band), so that the band follows the
+ * optimal path. Only three anti-diagonals and the characters of the band are kept: the input behind the
+ * band is discarded.
+ *
+ * A regular file is read by a NW_Reader (cf async_read.h): NW_READER_DEPTH - 1 chunks are read (by io_uring
+ * or by a pool of threads) while the current one is decoded and aligned. A pipe is read by fread.
+ *
+ * The distance is an upper bound of the edit distance, equal to it if the optimal path stays in the band.
+ * A path leaving the band costs at least D[i][j] + INSERTION_COST |(M - i) - (N - j)| where (i, j) is its
+ * last cell in the band; the least of these bounds over the cells with a neighbour left out of the band is
+ * kept (without the dominated cells) and the band is reported as constraining the optimum when it is lower
+ * than the distance. For example, a random sequence Q of 1500 bases against Q without its bases 700 to 899,
+ * or without its first 200 bases (distance 400), gives more than 700 with a band of 32, then constrained,
+ * and 400 exact with a band of 512.
+ */
+
+#ifndef __STREAM_BANDED_H__
+#define __STREAM_BANDED_H__
+
+#include <stdio.h>	/* for FILE */
+#include <stdlib.h> /* for size_t */
+
+/** \def NW_STREAM_BAND
+ *  \brief default number of cells of an anti-diagonal of the band
+ */
+#define NW_STREAM_BAND 2048
+
+/** \def NW_STREAM_CHUNK
+ *  \brief default number of bytes read at once in each stream
+ */
+#define NW_STREAM_CHUNK (1 << 16)
+
+/** \struct NW_StreamParams
+ * \brief parameters of NW_StreamBanded
+ */
+struct NW_StreamParams
+{
+	size_t band;  /*!< cells of an anti-diagonal of the band (0 for NW_STREAM_BAND) */
+	size_t chunk; /*!< bytes read at once (0 for NW_STREAM_CHUNK) */
+};
+
+/** \struct NW_StreamResult
+ * \brief result of NW_StreamBanded
+ */
+struct NW_StreamResult
+{
+	long distance;			 /*!< distance along the band (an upper bound of the edit distance) */
+	int constrained;		 /*!< 1 unless no path leaving the band can be shorter than distance */
+	size_t lengthA, lengthB; /*!< number of bases read in each stream */
+	size_t peak_bytes;		 /*!< largest memory allocated at the same time */
+};
+
+/**
+ * \fn long NW_StreamBanded(FILE *A, FILE *B, const struct NW_StreamParams *params, struct NW_StreamResult *result);
+ * \brief computes the banded edit distance between the bases read in A and in B until the end of the streams
+ * \return : result->distance
+ *
+ * The memory is O(band + NW_READER_DEPTH chunk), whatever the lengths of the streams, plus the cells kept for
+ * the bound of the paths leaving the band (a few in practice). The regular files are
+ * read from their current offset: A and B must not have been read through their FILE buffers.
+ */
+long NW_StreamBanded(FILE *A, FILE *B, const struct NW_StreamParams *params, struct NW_StreamResult *result);
+
+#endif /* __STREAM_BANDED_H__ */
@@ -0,0 +1,119 @@
+/**
+ * \file thread_pool.c
+ * \brief minimal pool of POSIX threads running independent tasks in a given order
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see thread_pool.h
+ */
+
+#include "thread_pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> /* for strerror */
+#include <unistd.h> /* for sysconf */
+#include <pthread.h>
+#include <stdatomic.h>
+
+/** \struct NW_PoolContext
+ * \brief data shared by all the workers of one NW_ParallelFor
+ */
+struct NW_PoolContext
+{
+	size_t n;			  /*!< number of tasks */
+	const size_t *order;  /*!< order of the tasks, or NULL */
+	NW_Task task;		  /*!< function run for each task */
+	void *arg;			  /*!< argument of task */
+	atomic_size_t next;	  /*!< next position in order to hand out */
+};
+
+/** \struct NW_Worker
+ * \brief argument of one worker thread
+ */
+struct NW_Worker
+{
+	struct NW_PoolContext *ctx; /*!< shared context */
+	int id;						/*!< number of the worker */
+	pthread_t thread;			/*!< the thread running the worker */
+};
+
+/* NW_DefaultThreads : see .h file for documentation
+ */
+int NW_DefaultThreads(void)
+{
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return (n < 1) ? 1 : (int)n;
+}
+
+/*
+ * static void *_worker(void *p)
+ * \brief body of a worker: takes tasks until all of them are handed out
+ */
+static void *_worker(void *p)
+{
+	struct NW_Worker *w = (struct NW_Worker *)p;
+	struct NW_PoolContext *ctx = w->ctx;
+	for (;;)
+	{
+		size_t k = atomic_fetch_add_explicit(&ctx->next, 1, memory_order_relaxed);
+		if (k >= ctx->n)
+			break;
+		ctx->task((ctx->order == NULL) ? k : ctx->order[k], w->id, ctx->arg);
+	}
+	return NULL;
+}
+
+/* NW_ParallelFor : see .h file for documentation
+ */
+void NW_ParallelFor(size_t n, const size_t *order, int nthreads, size_t stack_size, NW_Task task, void *arg)
+{
+	struct NW_PoolContext ctx;
+	ctx.n = n;
+	ctx.order = order;
+	ctx.task = task;
+	ctx.arg = arg;
+	atomic_init(&ctx.next, 0);
+
+	if (nthreads <= 0)
+		nthreads = NW_DefaultThreads();
+	if ((size_t)nthreads > n)
+		nthreads = (n == 0) ? 1 : (int)n;
+	if (nthreads == 1)
+	{
+		struct NW_Worker w = {&ctx, 0};
+		_worker(&w);
+		return;
+	}
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	if (stack_size > 0)
+	{
+		size_t current;
+		pthread_attr_getstacksize(&attr, &current);
+		if (stack_size > current)
+			pthread_attr_setstacksize(&attr, stack_size);
+	}
+	struct NW_Worker *workers = (struct NW_Worker *)malloc(nthreads * sizeof(struct NW_Worker));
+	if (workers == NULL)
+	{
+		perror("NW_ParallelFor: malloc of workers");
+		exit(EXIT_FAILURE);
+	}
+	for (int t = 0; t < nthreads; ++t)
+	{
+		workers[t].ctx = &ctx;
+		workers[t].id = t;
+		int e = pthread_create(&workers[t].thread, &attr, _worker, &workers[t]);
+		if (e != 0)
+		{
+			fprintf(stderr, "NW_ParallelFor: pthread_create: %s\n", strerror(e));
+			exit(EXIT_FAILURE);
+		}
+	}
+	for (int t = 0; t < nthreads; ++t)
+		pthread_join(workers[t].thread, NULL);
+	pthread_attr_destroy(&attr);
+	free(workers);
+}
@@ -0,0 +1,45 @@
+/**
+ * \file thread_pool.h
+ * \brief minimal pool of POSIX threads running independent tasks in a given order
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * The tasks are numbered 0..n-1 and are handed out to the workers in the order given by the
+ * caller (eg. the longest pairs first), through a shared atomic counter.
+ */
+
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <stdlib.h> /* for size_t */
+
+/** \typedef NW_Task
+ * \brief function run by a worker for task number index
+ * \param index : number of the task, in 0..n-1
+ * \param worker : number of the worker running the task, in 0..nthreads-1
+ * \param arg : argument given to NW_ParallelFor
+ */
+typedef void (*NW_Task)(size_t index, int worker, void *arg);
+
+/**
+ * \fn int NW_DefaultThreads(void);
+ * \brief returns the number of online processors (at least 1)
+ */
+int NW_DefaultThreads(void);
+
+/**
+ * \fn void NW_ParallelFor(size_t n, const size_t *order, int nthreads, size_t stack_size, NW_Task task, void *arg);
+ * \brief runs task(order[k], ...) for k = 0..n-1 on nthreads threads and waits for their completion
+ * \param n : number of tasks
+ * \param order : the order in which tasks are started (if NULL: 0, 1, .., n-1)
+ * \param nthreads : number of workers (if <= 0: NW_DefaultThreads())
+ * \param stack_size : minimal stack size of each worker in bytes (0 for the default one);
+ *        the engines store their rows in variable length arrays on the stack
+ * \param task : the function run for each task
+ * \param arg : argument passed to task
+ *
+ * If nthreads is 1, the tasks are run by the calling thread.
+ */
+void NW_ParallelFor(size_t n, const size_t *order, int nthreads, size_t stack_size, NW_Task task, void *arg);
+
+#endif /* __THREAD_POOL_H__ */
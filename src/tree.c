@@ -0,0 +1,692 @@
+/**
+ * \file tree.c
+ * \brief binary distance matrix and guide tree (neighbour joining or UPGMA) in the Newick format
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Documentation: see tree.h
+ */
+
+#include "tree.h"
+#include "thread_pool.h" /* for NW_ParallelFor */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h> /* for memcpy and strerror */
+#include <errno.h>
+#include <fcntl.h>	  /* for open */
+#include <unistd.h>	  /* for ftruncate */
+#include <sys/mman.h> /* for mmap */
+#include <sys/stat.h> /* for fstat */
+
+/** \def NW_TREE_CHUNK
+ *  \brief rows per task: the tasks do not depend on the number of threads, nor their sums
+ */
+#define NW_TREE_CHUNK 2048
+
+/*****************************************************************************
+ * Matrix file
+ */
+
+/* NW_MatrixCreate : see .h file for documentation
+ */
+int NW_MatrixCreate(struct NW_Matrix *m, const char *path, size_t n, const char *const *names, const size_t *lengths)
+{
+	struct NW_MatrixHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, NW_MATRIX_MAGIC, 8);
+	h.version = NW_MATRIX_VERSION;
+	h.n = n;
+	h.names_offset = sizeof(h);
+	for (size_t k = 0; k < n; ++k)
+		h.names_size += lengths[k] + 1;
+	h.data_offset = (h.names_offset + h.names_size + 4095) & ~(uint64_t)4095;
+	size_t size = h.data_offset + ((n > 1) ? n * (n - 1) / 2 : 0) * sizeof(float);
+
+	int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0 || ftruncate(fd, (off_t)size) != 0)
+	{
+		fprintf(stderr, "Error: matrix %s: %s.\n", path, strerror(errno));
+		if (fd >= 0)
+			close(fd);
+		return EXIT_FAILURE;
+	}
+	void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+	{
+		fprintf(stderr, "Error: mapping %zu bytes of %s: %s.\n", size, path, strerror(errno));
+		return EXIT_FAILURE;
+	}
+	memcpy(map, &h, sizeof(h));
+	char *p = (char *)map + h.names_offset;
+	for (size_t k = 0; k < n; ++k, ++p)
+	{
+		memcpy(p, names[k], lengths[k]);
+		p += lengths[k];
+		*p = '\0';
+	}
+	m->n = n;
+	m->names = NULL;
+	m->d = (float *)((char *)map + h.data_offset);
+	m->map = map;
+	m->size = size;
+	return 0;
+}
+
+/* NW_MatrixOpen : see .h file for documentation
+ */
+int NW_MatrixOpen(struct NW_Matrix *m, const char *path)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		perror(path);
+		return EXIT_FAILURE;
+	}
+	struct stat s;
+	if (fstat(fd, &s) != 0 || (size_t)s.st_size < sizeof(struct NW_MatrixHeader))
+	{
+		fprintf(stderr, "Error: %s is not a matrix file (too short).\n", path);
+		close(fd);
+		return EXIT_FAILURE;
+	}
+	size_t size = (size_t)s.st_size;
+	void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0); // copy on write
+	close(fd);
+	if (map == MAP_FAILED)
+	{
+		fprintf(stderr, "Error: mapping %zu bytes of %s: %s.\n", size, path, strerror(errno));
+		return EXIT_FAILURE;
+	}
+	const struct NW_MatrixHeader *h = (const struct NW_MatrixHeader *)map;
+	if (memcmp(h->magic, NW_MATRIX_MAGIC, 8) != 0 || h->version != NW_MATRIX_VERSION ||
+		h->names_offset + h->names_size > size || h->data_offset > size || h->n > UINT32_MAX / 2 ||
+		(size - h->data_offset) / sizeof(float) < ((h->n > 1) ? h->n * (h->n - 1) / 2 : 0))
+	{
+		fprintf(stderr, "Error: %s is not a matrix file of version %d.\n", path, NW_MATRIX_VERSION);
+		munmap(map, size);
+		return EXIT_FAILURE;
+	}
+	m->n = h->n;
+	m->names = (const char **)malloc((m->n + 1) * sizeof(char *));
+	if (m->names == NULL)
+	{
+		perror("NW_MatrixOpen: malloc of the names");
+		exit(EXIT_FAILURE);
+	}
+	const char *p = (const char *)map + h->names_offset, *end = p + h->names_size;
+	for (size_t k = 0; k < m->n; ++k)
+	{
+		const char *z = (const char *)memchr(p, '\0', (size_t)(end - p));
+		if (z == NULL)
+		{
+			fprintf(stderr, "Error: %s: truncated names.\n", path);
+			free(m->names);
+			munmap(map, size);
+			return EXIT_FAILURE;
+		}
+		m->names[k] = p;
+		p = z + 1;
+	}
+	m->d = (float *)((char *)map + h->data_offset);
+	m->map = map;
+	m->size = size;
+	return 0;
+}
+
+/* NW_MatrixClose : see .h file for documentation
+ */
+void NW_MatrixClose(struct NW_Matrix *m)
+{
+	free(m->names);
+	munmap(m->map, m->size);
+	m->map = NULL;
+	m->names = NULL;
+}
+
+/*****************************************************************************
+ * Tree
+ */
+
+/** \struct _entry
+ * \brief a node in the sorted row of another one
+ */
+struct _entry
+{
+	float d;	 /*!< distance between both nodes */
+	uint32_t id; /*!< the node */
+};
+
+/** \struct _row
+ * \brief the nearest nodes of a node, in increasing distance, when the row was built
+ */
+struct _row
+{
+	struct _entry *e;
+	uint32_t len;	  /*!< entries */
+	uint32_t pos;	  /*!< entries before pos are removed nodes */
+	int full;		  /*!< 1 if the row has all the nodes of its time (else the nearest prefix ones) */
+};
+
+/** \struct _best
+ * \brief best pair found by a task
+ */
+struct _best
+{
+	double q;	 /*!< Q (neighbour joining) or distance (UPGMA) */
+	uint32_t a;	 /*!< smallest node of the pair */
+	uint32_t b;	 /*!< largest node of the pair */
+};
+
+/** \struct _tree
+ * \brief the data of NW_Tree; nodes 0 .. n-1 are the sequences, n + k is created by the merge k
+ */
+struct _tree
+{
+	struct NW_Matrix *m;
+	enum NW_TreeMethod method;
+	size_t n;
+	size_t prefix;
+	uint32_t *slot;			/*!< row of each node in the matrix (the merged node takes the row of its first child) */
+	unsigned char *alive;	/*!< 1 for the nodes not merged yet */
+	double *u;				/*!< neighbour joining: sums of the rows */
+	double *height;			/*!< UPGMA: heights of the nodes */
+	uint32_t *size;			/*!< UPGMA: sequences under the nodes */
+	uint32_t *child;		/*!< children of node n + k: child[2k], child[2k+1] */
+	double *length;			/*!< length of the branch above each node */
+	struct _row *rows;		/*!< sorted row of each node alive */
+	uint32_t *active;		/*!< the nodes alive */
+	size_t r;				/*!< number of nodes alive */
+	double umax;			/*!< max of u on the nodes alive */
+	struct _entry **scratch; /*!< a buffer of n entries per worker */
+	struct _best *bests;	/*!< result of each task */
+	double *sums;			/*!< result of each task */
+	uint32_t x, i, j;		/*!< merge in progress: new node x of children i and j */
+	double dij;
+};
+
+/*
+ * static inline float _d(const struct _tree *t, uint32_t a, uint32_t b)
+ * \brief distance between the nodes alive a and b
+ */
+static inline float _d(const struct _tree *t, uint32_t a, uint32_t b)
+{
+	return t->m->d[NW_MATRIX_INDEX(t->slot[a], t->slot[b])];
+}
+
+/*
+ * static int _less(const struct _entry *x, const struct _entry *y)
+ * \brief order of the entries of the rows: distance, then node
+ */
+static inline int _less(const struct _entry *x, const struct _entry *y)
+{
+	return (x->d < y->d) || (x->d == y->d && x->id < y->id);
+}
+
+/*
+ * static int _compare_entries(const void *x, const void *y)
+ * \brief qsort function of _less
+ */
+static int _compare_entries(const void *x, const void *y)
+{
+	const struct _entry *a = (const struct _entry *)x, *b = (const struct _entry *)y;
+	return _less(a, b) ? -1 : _less(b, a) ? 1 : 0;
+}
+
+/*
+ * static void _consider(struct _best *best, double q, uint32_t a, uint32_t b)
+ * \brief keeps the pair a, b if it is better than best (ties broken by the numbers of the nodes)
+ */
+static inline void _consider(struct _best *best, double q, uint32_t a, uint32_t b)
+{
+	if (a > b)
+	{
+		uint32_t c = a;
+		a = b;
+		b = c;
+	}
+	if (q < best->q || (q == best->q && (a < best->a || (a == best->a && b < best->b))))
+	{
+		best->q = q;
+		best->a = a;
+		best->b = b;
+	}
+}
+
+/*
+ * static void _build_row(struct _tree *t, uint32_t i, struct _entry *all, size_t count)
+ * \brief sets the row of i to the prefix nearest of the count entries all (which are reordered)
+ */
+static void _build_row(struct _tree *t, uint32_t i, struct _entry *all, size_t count)
+{
+	size_t keep = (count < t->prefix) ? count : t->prefix;
+	if (keep < count) // max heap of the keep nearest in all[0 .. keep-1]
+	{
+		for (size_t k = 1; k < keep; ++k)
+			for (size_t c = k; c > 0 && _less(&all[(c - 1) / 2], &all[c]); c = (c - 1) / 2)
+			{
+				struct _entry e = all[c];
+				all[c] = all[(c - 1) / 2];
+				all[(c - 1) / 2] = e;
+			}
+		for (size_t k = keep; k < count; ++k)
+			if (_less(&all[k], &all[0]))
+			{
+				all[0] = all[k];
+				for (size_t c = 0;;)
+				{
+					size_t l = 2 * c + 1, g = c;
+					if (l < keep && _less(&all[g], &all[l]))
+						g = l;
+					if (l + 1 < keep && _less(&all[g], &all[l + 1]))
+						g = l + 1;
+					if (g == c)
+						break;
+					struct _entry e = all[c];
+					all[c] = all[g];
+					all[g] = e;
+					c = g;
+				}
+			}
+	}
+	qsort(all, keep, sizeof(struct _entry), _compare_entries);
+	struct _row *row = &t->rows[i];
+	if (row->e == NULL || row->len < keep)
+	{
+		free(row->e);
+		row->e = (struct _entry *)malloc((keep + 1) * sizeof(struct _entry));
+		if (row->e == NULL)
+		{
+			perror("NW_Tree: malloc of a row");
+			exit(EXIT_FAILURE);
+		}
+	}
+	memcpy(row->e, all, keep * sizeof(struct _entry));
+	row->len = (uint32_t)keep;
+	row->pos = 0;
+	row->full = (keep == count);
+}
+
+/*
+ * static size_t _gather(const struct _tree *t, uint32_t i, struct _entry *all)
+ * \brief writes in all the distances between i and the other nodes alive, returns their number
+ */
+static size_t _gather(const struct _tree *t, uint32_t i, struct _entry *all)
+{
+	size_t count = 0;
+	for (size_t k = 0; k < t->r; ++k)
+	{
+		uint32_t id = t->active[k];
+		if (id != i)
+		{
+			all[count].d = _d(t, i, id);
+			all[count++].id = id;
+		}
+	}
+	return count;
+}
+
+/*
+ * static void _init_task(size_t task, int worker, void *arg)
+ * \brief task of NW_ParallelFor: builds the rows of a chunk of the sequences and their sums
+ */
+static void _init_task(size_t task, int worker, void *arg)
+{
+	struct _tree *t = (struct _tree *)arg;
+	size_t end = (task + 1) * NW_TREE_CHUNK < t->n ? (task + 1) * NW_TREE_CHUNK : t->n;
+	for (size_t i = task * NW_TREE_CHUNK; i < end; ++i)
+	{
+		size_t count = _gather(t, (uint32_t)i, t->scratch[worker]);
+		double u = 0;
+		for (size_t k = 0; k < count; ++k)
+			u += t->scratch[worker][k].d;
+		t->u[i] = u;
+		_build_row(t, (uint32_t)i, t->scratch[worker], count);
+	}
+}
+
+/*
+ * static void _search_task(size_t task, int worker, void *arg)
+ * \brief task of NW_ParallelFor: best pair in the rows of a chunk of the nodes alive (the bound starts from
+ * the best pair of the seed in t->bests[task])
+ */
+static void _search_task(size_t task, int worker, void *arg)
+{
+	struct _tree *t = (struct _tree *)arg;
+	struct _best *best = &t->bests[task];
+	size_t end = (task + 1) * NW_TREE_CHUNK < t->r ? (task + 1) * NW_TREE_CHUNK : t->r;
+	double r2 = (double)t->r - 2;
+	for (size_t k = task * NW_TREE_CHUNK; k < end; ++k)
+	{
+		uint32_t i = t->active[k];
+		struct _row *row = &t->rows[i];
+		while (row->pos < row->len && !t->alive[row->e[row->pos].id])
+			row->pos++;
+		int bounded = 0;
+		for (uint32_t p = row->pos; p < row->len && !bounded; ++p)
+		{
+			const struct _entry *e = &row->e[p];
+			if (!t->alive[e->id])
+				continue;
+			if (t->method == NW_TREE_UPGMA)
+			{
+				_consider(best, e->d, i, e->id);
+				bounded = 1; // the next ones are farther
+			}
+			else if (r2 * e->d - t->u[i] - t->umax > best->q)
+				bounded = 1;
+			else
+				_consider(best, r2 * e->d - t->u[i] - t->u[e->id], i, e->id);
+		}
+		if (!bounded && !row->full) // prefix used up: the whole row, then a new prefix
+		{
+			struct _entry *all = t->scratch[worker];
+			size_t count = _gather(t, i, all);
+			for (size_t c = 0; c < count; ++c)
+				_consider(best, (t->method == NW_TREE_UPGMA) ? all[c].d : r2 * all[c].d - t->u[i] - t->u[all[c].id], i,
+						  all[c].id);
+			_build_row(t, i, all, count);
+		}
+	}
+}
+
+/*
+ * static void _merge_task(size_t task, int worker, void *arg)
+ * \brief task of NW_ParallelFor: distances between the new node and the nodes alive of a chunk, also written
+ * in t->scratch[0] at the same positions (node UINT32_MAX for i and j) to build the row of the new node
+ */
+static void _merge_task(size_t task, int worker, void *arg)
+{
+	struct _tree *t = (struct _tree *)arg;
+	size_t end = (task + 1) * NW_TREE_CHUNK < t->r ? (task + 1) * NW_TREE_CHUNK : t->r;
+	double sum = 0;
+	float *d = t->m->d;
+	size_t si = t->slot[t->i], sj = t->slot[t->j];
+	double wi = (t->method == NW_TREE_UPGMA) ? t->size[t->i] : 1, wj = (t->method == NW_TREE_UPGMA) ? t->size[t->j] : 1;
+	for (size_t k = task * NW_TREE_CHUNK; k < end; ++k)
+	{
+		uint32_t id = t->active[k];
+		t->scratch[0][k].id = UINT32_MAX;
+		if (id == t->i || id == t->j)
+			continue;
+		size_t sk = t->slot[id];
+		float *dik = &d[NW_MATRIX_INDEX(si, sk)];
+		double a = *dik, b = d[NW_MATRIX_INDEX(sj, sk)];
+		float dx = (float)((t->method == NW_TREE_UPGMA) ? (wi * a + wj * b) / (wi + wj) : (a + b - t->dij) / 2);
+		*dik = dx; // the new node takes the row of i
+		if (t->method == NW_TREE_NJ)
+			t->u[id] += (double)dx - a - b;
+		sum += dx;
+		t->scratch[0][k].d = dx;
+		t->scratch[0][k].id = id;
+	}
+	t->sums[task] = sum;
+}
+
+/*
+ * static void _merge(struct _tree *t, uint32_t i, uint32_t j, int nthreads)
+ * \brief replaces the nodes i and j by the next node
+ */
+static void _merge(struct _tree *t, uint32_t i, uint32_t j, int nthreads)
+{
+	uint32_t x = (uint32_t)(t->n + (t->n - t->r)); // n + number of merges done
+	double dij = _d(t, i, j);
+	double li, lj;
+	if (t->method == NW_TREE_UPGMA)
+	{
+		t->height[x] = dij / 2;
+		li = t->height[x] - t->height[i];
+		lj = t->height[x] - t->height[j];
+		t->size[x] = t->size[i] + t->size[j];
+	}
+	else
+	{
+		li = dij / 2 + (t->u[i] - t->u[j]) / (2 * ((double)t->r - 2));
+		lj = dij - li;
+	}
+	t->length[i] = (li < 0) ? 0 : li;
+	t->length[j] = (lj < 0) ? 0 : lj;
+	t->child[2 * (x - t->n)] = i;
+	t->child[2 * (x - t->n) + 1] = j;
+
+	t->x = x;
+	t->i = i;
+	t->j = j;
+	t->dij = dij;
+	size_t tasks = (t->r + NW_TREE_CHUNK - 1) / NW_TREE_CHUNK;
+	NW_ParallelFor(tasks, NULL, nthreads, 0, _merge_task, t);
+	double u = 0;
+	for (size_t k = 0; k < tasks; ++k)
+		u += t->sums[k];
+	size_t count = 0;
+	for (size_t k = 0; k < t->r; ++k)
+		if (t->scratch[0][k].id != UINT32_MAX)
+			t->scratch[0][count++] = t->scratch[0][k];
+
+	t->slot[x] = t->slot[i];
+	t->alive[i] = t->alive[j] = 0;
+	t->alive[x] = 1;
+	if (t->method == NW_TREE_NJ)
+		t->u[x] = u;
+	free(t->rows[i].e);
+	free(t->rows[j].e);
+	t->rows[i].e = t->rows[j].e = NULL;
+	for (size_t k = 0; k < t->r; ++k) // x in place of i, the last one in place of j
+		if (t->active[k] == i)
+			t->active[k] = x;
+	for (size_t k = 0; k < t->r; ++k)
+		if (t->active[k] == j)
+		{
+			t->active[k] = t->active[--t->r];
+			break;
+		}
+	_build_row(t, x, t->scratch[0], count);
+}
+
+/*
+ * static void _print_name(FILE *out, const char *name)
+ * \brief prints a name of sequence, quoted if it contains characters of the Newick syntax
+ */
+static void _print_name(FILE *out, const char *name)
+{
+	if (name[0] != '\0' && strpbrk(name, " \t\n()[]':;,") == NULL)
+	{
+		fputs(name, out);
+		return;
+	}
+	fputc('\'', out);
+	for (const char *c = name; *c != '\0'; ++c)
+	{
+		if (*c == '\'')
+			fputc('\'', out);
+		fputc(*c, out);
+	}
+	fputc('\'', out);
+}
+
+/*
+ * static void _print(const struct _tree *t, const uint32_t *roots, int nroots, FILE *out)
+ * \brief prints the tree whose root has the children roots[0 .. nroots-1], without recursion
+ */
+static void _print(const struct _tree *t, const uint32_t *roots, int nroots, FILE *out)
+{
+	struct
+	{
+		uint32_t id;
+		int next; /*!< next child to print */
+	} *stack = malloc((2 * t->n + 2) * sizeof(*stack));
+	if (stack == NULL)
+	{
+		perror("NW_Tree: malloc of the stack");
+		exit(EXIT_FAILURE);
+	}
+	fputc('(', out);
+	for (int c = 0; c < nroots; ++c)
+	{
+		if (c > 0)
+			fputc(',', out);
+		size_t top = 0;
+		stack[top].id = roots[c];
+		stack[top++].next = 0;
+		while (top > 0)
+		{
+			uint32_t id = stack[top - 1].id;
+			if (id < t->n)
+			{
+				_print_name(out, t->m->names[id]);
+				fprintf(out, ":%.6g", t->length[id]);
+				--top;
+			}
+			else if (stack[top - 1].next < 2)
+			{
+				fputc((stack[top - 1].next == 0) ? '(' : ',', out);
+				uint32_t child = t->child[2 * (id - t->n) + stack[top - 1].next++];
+				stack[top].id = child;
+				stack[top++].next = 0;
+			}
+			else
+			{
+				fprintf(out, "):%.6g", t->length[id]);
+				--top;
+			}
+		}
+	}
+	fputs(");\n", out);
+	free(stack);
+}
+
+/* NW_Tree : see .h file for documentation
+ */
+int NW_Tree(struct NW_Matrix *m, enum NW_TreeMethod method, int nthreads, size_t prefix, FILE *out)
+{
+	size_t n = m->n;
+	if (n == 0)
+		return EXIT_FAILURE;
+	if (n == 1)
+	{
+		_print_name(out, m->names[0]);
+		fputs(";\n", out);
+		return 0;
+	}
+	if (nthreads <= 0)
+		nthreads = NW_DefaultThreads();
+	struct _tree t;
+	memset(&t, 0, sizeof(t));
+	t.m = m;
+	t.method = method;
+	t.n = n;
+	t.prefix = (prefix == 0) ? NW_TREE_PREFIX : prefix;
+	t.r = n;
+	size_t nodes = 2 * n;
+	size_t tasks = (n + NW_TREE_CHUNK - 1) / NW_TREE_CHUNK;
+	t.slot = (uint32_t *)malloc(nodes * sizeof(uint32_t));
+	t.alive = (unsigned char *)calloc(nodes, 1);
+	t.u = (double *)calloc(nodes, sizeof(double));
+	t.height = (double *)calloc(nodes, sizeof(double));
+	t.size = (uint32_t *)calloc(nodes, sizeof(uint32_t));
+	t.child = (uint32_t *)malloc(2 * n * sizeof(uint32_t));
+	t.length = (double *)calloc(nodes, sizeof(double));
+	t.rows = (struct _row *)calloc(nodes, sizeof(struct _row));
+	t.active = (uint32_t *)malloc(n * sizeof(uint32_t));
+	t.scratch = (struct _entry **)calloc(nthreads, sizeof(struct _entry *));
+	t.bests = (struct _best *)malloc(tasks * sizeof(struct _best));
+	t.sums = (double *)malloc(tasks * sizeof(double));
+	if (t.slot == NULL || t.alive == NULL || t.u == NULL || t.height == NULL || t.size == NULL || t.child == NULL ||
+		t.length == NULL || t.rows == NULL || t.active == NULL || t.scratch == NULL || t.bests == NULL || t.sums == NULL)
+	{
+		perror("NW_Tree: malloc of the nodes");
+		exit(EXIT_FAILURE);
+	}
+	for (int w = 0; w < nthreads; ++w)
+		if ((t.scratch[w] = (struct _entry *)malloc(n * sizeof(struct _entry))) == NULL)
+		{
+			perror("NW_Tree: malloc of the buffers");
+			exit(EXIT_FAILURE);
+		}
+	for (uint32_t i = 0; i < n; ++i)
+	{
+		t.slot[i] = i;
+		t.alive[i] = 1;
+		t.size[i] = 1;
+		t.active[i] = i;
+	}
+	NW_ParallelFor(tasks, NULL, nthreads, 0, _init_task, &t);
+
+	size_t last = (method == NW_TREE_NJ) ? 3 : 2;
+	while (t.r >= last)
+	{
+		if (method == NW_TREE_NJ && t.r == 3)
+			break;
+		int threads = (t.r >= 4 * NW_TREE_CHUNK) ? nthreads : 1;
+		t.umax = -1e300;
+		for (size_t k = 0; k < t.r; ++k)
+			if (t.u[t.active[k]] > t.umax)
+				t.umax = t.u[t.active[k]];
+
+		// seed: the first pair of each row; then the bound of each task starts from it
+		struct _best seed = {1e300, UINT32_MAX, UINT32_MAX};
+		double r2 = (double)t.r - 2;
+		for (size_t k = 0; k < t.r; ++k)
+		{
+			uint32_t i = t.active[k];
+			const struct _row *row = &t.rows[i];
+			for (uint32_t p = row->pos; p < row->len; ++p)
+				if (t.alive[row->e[p].id])
+				{
+					uint32_t id = row->e[p].id;
+					_consider(&seed, (method == NW_TREE_UPGMA) ? row->e[p].d : r2 * row->e[p].d - t.u[i] - t.u[id], i,
+							  id);
+					break;
+				}
+		}
+		size_t ntasks = (t.r + NW_TREE_CHUNK - 1) / NW_TREE_CHUNK;
+		for (size_t k = 0; k < ntasks; ++k)
+			t.bests[k] = seed;
+		NW_ParallelFor(ntasks, NULL, threads, 0, _search_task, &t);
+		struct _best best = seed;
+		for (size_t k = 0; k < ntasks; ++k)
+			_consider(&best, t.bests[k].q, t.bests[k].a, t.bests[k].b);
+		_merge(&t, best.a, best.b, threads);
+	}
+
+	uint32_t roots[3];
+	int nroots = (int)t.r;
+	for (size_t k = 0; k < t.r; ++k)
+		roots[k] = t.active[k];
+	if (nroots == 1) // UPGMA: the children of the last merge
+	{
+		uint32_t x = roots[0];
+		roots[0] = t.child[2 * (x - n)];
+		roots[1] = t.child[2 * (x - n) + 1];
+		nroots = 2;
+	}
+	else if (nroots == 2) // two sequences
+		t.length[roots[0]] = t.length[roots[1]] = _d(&t, roots[0], roots[1]) / 2;
+	else // neighbour joining: the three last nodes around the root
+	{
+		double ab = _d(&t, roots[0], roots[1]), ac = _d(&t, roots[0], roots[2]), bc = _d(&t, roots[1], roots[2]);
+		double l[3] = {(ab + ac - bc) / 2, (ab + bc - ac) / 2, (ac + bc - ab) / 2};
+		for (int k = 0; k < 3; ++k)
+			t.length[roots[k]] = (l[k] < 0) ? 0 : l[k];
+	}
+	_print(&t, roots, nroots, out);
+
+	for (size_t k = 0; k < nodes; ++k)
+		free(t.rows[k].e);
+	for (int w = 0; w < nthreads; ++w)
+		free(t.scratch[w]);
+	free(t.scratch);
+	free(t.slot);
+	free(t.alive);
+	free(t.u);
+	free(t.height);
+	free(t.size);
+	free(t.child);
+	free(t.length);
+	free(t.rows);
+	free(t.active);
+	free(t.bests);
+	free(t.sums);
+	return 0;
+}
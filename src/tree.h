@@ -0,0 +1,119 @@
+/**
+ * \file tree.h
+ * \brief binary distance matrix of all the pairs of a set of sequences, and guide tree (neighbour joining or
+ * UPGMA) built from it in the Newick format
+ * \version 0.1
+ * \date 18/10/2026
+ *
+ * Matrix file: a struct NW_MatrixHeader, the n names (each terminated by '\0') at names_offset, then at
+ * data_offset (a multiple of 4096) the strictly lower triangle of the distances as float (in the byte order
+ * of the machine), row after row: d(i, j) for j < i is the element i (i - 1) / 2 + j. A matrix of 50000
+ * sequences takes 5 GB. It is written by distanceEdition -z container -o matrix.
+ *
+ * The tree is built on the mapping of the matrix (private and writable: the pages of the rows updated by
+ * the merges are copied by the kernel, the file is not modified), in the manner of RapidNJ: each node keeps
+ * the <prefix> nearest other nodes in increasing distance, so that the search of the pair minimizing
+ * Q(i, j) = (r - 2) d(i, j) - u(i) - u(j) (u: sums of the rows, r: nodes left) stops reading a row as soon
+ * as (r - 2) d(i, j) - u(i) - max u exceeds the best Q found; a row whose prefix is used up without this
+ * bound is rebuilt from the matrix. The rows are searched and updated by <threads> threads. UPGMA merges the
+ * pair of minimal distance, found at the beginning of the rows. The ties are broken by the numbers of the
+ * nodes, so that the tree does not depend on the number of threads.
+ */
+
+#ifndef __TREE_H__
+#define __TREE_H__
+
+#include <stdio.h>	/* for FILE */
+#include <stdint.h> /* for uint64_t */
+#include <stdlib.h> /* for size_t */
+
+/** \def NW_MATRIX_MAGIC
+ *  \brief first 8 bytes of a matrix file
+ */
+#define NW_MATRIX_MAGIC "NWDMATRX"
+
+/** \def NW_MATRIX_VERSION
+ *  \brief version of the layout
+ */
+#define NW_MATRIX_VERSION 1
+
+/** \def NW_TREE_PREFIX
+ *  \brief default number of nearest nodes kept sorted per node
+ */
+#define NW_TREE_PREFIX 256
+
+/** \struct NW_MatrixHeader
+ * \brief beginning of a matrix file
+ */
+struct NW_MatrixHeader
+{
+	char magic[8];		   /*!< NW_MATRIX_MAGIC */
+	uint32_t version;	   /*!< NW_MATRIX_VERSION */
+	uint32_t reserved;	   /*!< 0 */
+	uint64_t n;			   /*!< number of sequences */
+	uint64_t names_offset; /*!< offset of the names */
+	uint64_t names_size;   /*!< bytes of the names */
+	uint64_t data_offset;  /*!< offset of the distances */
+};
+
+/** \struct NW_Matrix
+ * \brief a mapped matrix file
+ */
+struct NW_Matrix
+{
+	size_t n;			 /*!< number of sequences */
+	const char **names;	 /*!< their names, in the mapping */
+	float *d;			 /*!< the lower triangle */
+	void *map;			 /*!< the mapping of the file */
+	size_t size;		 /*!< its size */
+};
+
+/** \def NW_MATRIX_INDEX
+ *  \brief index in NW_Matrix.d of d(i, j), for i != j
+ */
+#define NW_MATRIX_INDEX(i, j) \
+	(((i) > (j)) ? (size_t)(i) * ((size_t)(i)-1) / 2 + (size_t)(j) : (size_t)(j) * ((size_t)(j)-1) / 2 + (size_t)(i))
+
+/** \enum NW_TreeMethod
+ * \brief algorithm of NW_Tree
+ */
+enum NW_TreeMethod
+{
+	NW_TREE_NJ = 0,	   /*!< neighbour joining (unrooted tree, as a root of 3 children) */
+	NW_TREE_UPGMA = 1, /*!< average linkage (ultrametric rooted tree) */
+};
+
+/**
+ * \fn int NW_MatrixCreate(struct NW_Matrix *m, const char *path, size_t n, const char *const *names, const size_t *lengths);
+ * \brief creates the matrix file path for the sequences names[0 .. n-1] (of lengths[k] characters) and maps it
+ * to be filled: m->d[NW_MATRIX_INDEX(i, j)] = distance
+ * \return : 0 on success, >0 (with a message on stderr) if the file cannot be created
+ */
+int NW_MatrixCreate(struct NW_Matrix *m, const char *path, size_t n, const char *const *names, const size_t *lengths);
+
+/**
+ * \fn int NW_MatrixOpen(struct NW_Matrix *m, const char *path);
+ * \brief maps the matrix file path, privately: the changes of m->d are not written in the file
+ * \return : 0 on success, >0 (with a message on stderr) if it is not a valid matrix file
+ */
+int NW_MatrixOpen(struct NW_Matrix *m, const char *path);
+
+/**
+ * \fn void NW_MatrixClose(struct NW_Matrix *m);
+ * \brief unmaps the matrix (the distances of a created matrix are then in the file)
+ */
+void NW_MatrixClose(struct NW_Matrix *m);
+
+/**
+ * \fn int NW_Tree(struct NW_Matrix *m, enum NW_TreeMethod method, int nthreads, size_t prefix, FILE *out);
+ * \brief builds the guide tree of the sequences of m and writes it on out in the Newick format
+ * \param m : the matrix, opened by NW_MatrixOpen; its distances are overwritten by the merges
+ * \param nthreads : number of threads (if <= 0: the number of online processors)
+ * \param prefix : nearest nodes kept sorted per node (0 for NW_TREE_PREFIX)
+ * \return : 0 on success, >0 if m has no sequence
+ *
+ * The branch lengths of neighbour joining that would be negative are set to 0.
+ */
+int NW_Tree(struct NW_Matrix *m, enum NW_TreeMethod method, int nthreads, size_t prefix, FILE *out);
+
+#endif /* __TREE_H__ */